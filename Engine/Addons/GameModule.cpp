@@ -26,7 +26,7 @@ DLLEXPORT GameModule::GameModule(const std::string& filepath, const std::string&
     LoadedFromFile = file;
 
     // Load the file //
-    auto ofile = ObjectFileProcessor::ProcessObjectFile(file, Logger::Get());
+    auto ofile = ObjectFileProcessor::ProcessObjectFileCompiled(file, Logger::Get());
 
     if(!ofile) {
 
@@ -178,7 +178,7 @@ void GameModuleLoader::GameModuleReportDestruction(GameModule& module)
 bool GameModuleLoader::_LoadInfoFromModuleFile(
     const std::string& file, std::string& modulename, std::string& errorstring)
 {
-    auto ofile = ObjectFileProcessor::ProcessObjectFile(file, Logger::Get());
+    auto ofile = ObjectFileProcessor::ProcessObjectFileCompiled(file, Logger::Get());
 
     if(!ofile) {
         errorstring = "file has invalid syntax";
@@ -151,6 +151,10 @@ DLLEXPORT int LeviathanApplication::RunMessageLoop()
 
         Render();
 
+        // No waiting when running a simulation as fast as possible //
+        if(_Engine->GetTickAsFastAsPossible())
+            continue;
+
         // We could potentially wait here //
         //! TODO: make this wait happen only if tick wasn't actually and no frame was
         //! rendered
@@ -4,6 +4,7 @@
 #include "FileSystem.h"
 
 #include <boost/filesystem.hpp>
+#include <utility>
 using namespace Leviathan;
 // ------------------------------------ //
 DLLEXPORT Leviathan::GameConfiguration::GameConfiguration(const std::string& configfile) :
@@ -84,7 +85,7 @@ DLLEXPORT void Leviathan::GameConfiguration::SaveCheck()
             return;
 
         // Write the variables to the file //
-        auto vec = GameVars->GetVec();
+        auto vec = std::as_const(*GameVars).GetVec();
 
         for(size_t i = 0; i < vec->size(); i++) {
 
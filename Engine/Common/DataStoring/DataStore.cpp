@@ -6,6 +6,8 @@
 #include "FileSystem.h"
 #include "ObjectFiles/ObjectFileProcessor.h"
 
+#include <utility>
+
 using namespace Leviathan;
 // ------------------------------------ //
 DLLEXPORT Leviathan::DataStore::DataStore()
@@ -89,7 +91,8 @@ void Leviathan::DataStore::Load()
 void Leviathan::DataStore::Save()
 {
     std::string tosave = "";
-    std::vector<std::shared_ptr<NamedVariableList>>* tempvec = Values.GetVec();
+    const std::vector<std::shared_ptr<NamedVariableList>>* tempvec =
+        std::as_const(Values).GetVec();
 
     for(unsigned int i = 0; i < Persistencestates.size(); i++) {
         if(Persistencestates[i]) {
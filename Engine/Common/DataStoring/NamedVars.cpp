@@ -3,12 +3,25 @@
 
 #include "../../Iterators/StringIterator.h"
 #include "FileSystem.h"
+#include "utf8/checked.h"
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <limits.h>
 
 using namespace Leviathan;
 using namespace std;
 // ------------------------------------ //
+//! \brief Change counter of lists that are in multiple NamedVars
+//!
+//! A list can only notify one NamedVars about renames so those that contain lists that are
+//! also in another one check this as well
+static const std::shared_ptr<std::atomic<uint32_t>>& GetSharedListChanges()
+{
+    static const auto changes = std::make_shared<std::atomic<uint32_t>>(0);
+    return changes;
+}
+// ------------------------------------ //
 NamedVariableList::NamedVariableList() : Datas(0), Name("") {}
 
 DLLEXPORT NamedVariableList::NamedVariableList(const std::string& name) : Datas(0), Name(name)
@@ -68,9 +81,30 @@ DLLEXPORT NamedVariableList::NamedVariableList(const std::string& line,
     /*= NULL*/)
 {
     // using StringIterator makes this shorter //
-    StringIterator itr(&line);
+    StringIterator itr(std::make_unique<UTF8ViewDataIterator>(line));
+
+    std::unique_ptr<std::string> name;
+    std::unique_ptr<std::string> tempvar;
 
-    auto name = itr.GetUntilEqualityAssignment<std::string>(EQUALITYCHARACTER_TYPE_ALL);
+    // The iterator throws on invalid utf8 //
+    try {
+        name = itr.GetUntilEqualityAssignment<std::string>(EQUALITYCHARACTER_TYPE_ALL);
+
+        if(name) {
+            // skip whitespace //
+            itr.SkipWhiteSpace();
+
+            // get last part of it //
+            tempvar = itr.GetUntilNextCharacterOrAll<std::string>(L';');
+        }
+    } catch(const utf8::exception&) {
+#ifdef ALTERNATIVE_EXCEPTIONS_FATAL
+        errorreport->Error(std::string("invalid data on line (invalid utf8)"));
+        return;
+#else
+        throw InvalidArgument("invalid data on line (invalid utf8)");
+#endif // ALTERNATIVE_EXCEPTIONS_FATAL
+    }
 
     if(!name) {
         // no name //
@@ -84,12 +118,6 @@ DLLEXPORT NamedVariableList::NamedVariableList(const std::string& line,
 
     Name = *name;
 
-    // skip whitespace //
-    itr.SkipWhiteSpace();
-
-    // get last part of it //
-    auto tempvar = itr.GetUntilNextCharacterOrAll<std::string>(L';');
-
     if(!tempvar || tempvar->size() < 1) {
         // no variable //
 #ifdef ALTERNATIVE_EXCEPTIONS_FATAL
@@ -249,9 +277,20 @@ DLLEXPORT bool NamedVariableList::ConstructValuesForObject(const std::string& va
     if(variablestr[0] == L'[') {
 
         // Needs to be split into values //
-        StringIterator itr(variablestr);
+        StringIterator itr(std::make_unique<UTF8ViewDataIterator>(variablestr));
 
-        auto firstlevel = itr.GetStringInBracketsRecursive<string>();
+        std::unique_ptr<std::string> firstlevel;
+
+        try {
+            firstlevel = itr.GetStringInBracketsRecursive<string>();
+        } catch(const utf8::exception&) {
+#ifndef ALTERNATIVE_EXCEPTIONS_FATAL
+            throw InvalidArgument("invalid variable string, invalid utf8");
+#else
+            errorreport->Error(std::string("invalid variable string, invalid utf8"));
+            return false;
+#endif
+        }
 
         std::vector<VariableBlock*> parsedvalues;
 
@@ -479,7 +518,20 @@ DLLEXPORT void NamedVariableList::GetName(std::string& name) const
 
 void NamedVariableList::SetName(const std::string& name)
 {
+    Rename(name);
+}
+
+void NamedVariableList::Rename(const std::string& name)
+{
+    if(Name == name)
+        return;
+
     Name = name;
+
+    const auto owner = std::atomic_load(&OwnerChanges);
+
+    if(owner)
+        ++*owner;
 }
 
 bool NamedVariableList::CompareName(const std::string& name) const
@@ -569,7 +621,7 @@ DLLEXPORT std::string Leviathan::NamedVariableList::ToText(
 DLLEXPORT NamedVariableList& NamedVariableList::operator=(const NamedVariableList& other)
 {
     // copy values //
-    Name = other.Name;
+    Rename(other.Name);
 
     SAFE_DELETE_VECTOR(Datas);
     Datas.resize(other.Datas.size());
@@ -616,23 +668,30 @@ DLLEXPORT bool NamedVariableList::ProcessDataDump(const std::string& data,
     // Split to lines //
     std::vector<std::shared_ptr<std::string>> lines;
 
-    StringIterator itr(data);
+    StringIterator itr(std::make_unique<UTF8ViewDataIterator>(data));
 
     // Use string iterator to get the lines that are separated by ; //
     std::unique_ptr<std::string> curLine;
     size_t lineLength = 0;
 
-    do {
-        curLine = itr.GetUntilNextCharacterOrNothing<std::string>(';');
+    try {
+        do {
+            curLine = itr.GetUntilNextCharacterOrNothing<std::string>(';');
 
-        if(!curLine)
-            break;
+            if(!curLine)
+                break;
 
-        lineLength = curLine->size();
+            lineLength = curLine->size();
 
-        lines.push_back(std::shared_ptr<string>(curLine.release()));
+            lines.push_back(std::shared_ptr<string>(curLine.release()));
 
-    } while(lineLength != 0);
+        } while(lineLength != 0);
+
+    } catch(const utf8::exception&) {
+
+        errorreport->Error("NamedVar: ProcessDataDump: data is not valid utf8");
+        return false;
+    }
 
 
     if(lines.empty()) {
@@ -700,7 +759,7 @@ DLLEXPORT void NamedVariableList::SwitchValues(
 {
     // only overwrite name if there is one //
     if(donator.Name.size() > 0)
-        receiver.Name = donator.Name;
+        receiver.Rename(donator.Name);
 
 
     SAFE_DELETE_VECTOR(receiver.Datas);
@@ -784,17 +843,36 @@ NamedVars::NamedVars() : Variables()
 }
 NamedVars::NamedVars(const NamedVars& other)
 {
+    GUARD_LOCK_OTHER(other);
+
     // deep copy is required here //
     Variables.reserve(other.Variables.size());
     for(size_t i = 0; i < other.Variables.size(); i++) {
         Variables.push_back(
             shared_ptr<NamedVariableList>(new NamedVariableList(*other.Variables[i])));
     }
+
+    // The order and names are the same so the index can be reused //
+    if(other.IsIndexUpToDate(guard) && !other.IndexHasSharedLists) {
+
+        Changes = std::make_shared<std::atomic<uint32_t>>(0);
+
+        for(const auto& variable : Variables)
+            variable->OwnerChanges = Changes;
+
+        Index = other.Index;
+        IndexChanges = 0;
+        IndexValid = true;
+    }
 }
 
-DLLEXPORT NamedVars::NamedVars(NamedVars* stealfrom) : Variables(stealfrom->Variables)
+DLLEXPORT NamedVars::NamedVars(NamedVars* stealfrom) :
+    Variables(stealfrom->Variables), Changes(stealfrom->Changes)
 {
+    // The lists keep notifying the same counter, which is now the counter of this //
     stealfrom->Variables.clear();
+    stealfrom->Changes.reset();
+    stealfrom->MarkChanged();
 }
 
 DLLEXPORT NamedVars::NamedVars(const std::string& datadump, LErrorReporter* errorreport) :
@@ -831,7 +909,9 @@ DLLEXPORT NamedVars::NamedVars(NamedVariableList* takevariable) : Variables(1)
 
 NamedVars::~NamedVars()
 {
-    // no need to release due to smart pointers //
+    // Lists that are still used elsewhere can be adopted by another NamedVars //
+    for(const auto& variable : Variables)
+        ReleaseList(*variable);
 }
 // ------------------------------------ //
 #ifdef SFML_PACKETS
@@ -889,17 +969,20 @@ DLLEXPORT bool NamedVars::Add(std::shared_ptr<NamedVariableList> value)
     if(index >= Variables.size()) {
 
         Variables.push_back(value);
+        AddToIndex(guard);
         return true;
     }
 
+    ReleaseList(*Variables[index]);
     Variables[index] = value;
+    MarkChanged();
     return false;
 }
 
 DLLEXPORT bool NamedVars::SetValue(const std::string& name, const VariableBlock& value1)
 {
     GUARD_LOCK();
-    auto index = Find(name);
+    auto index = Find(guard, name);
 
     if(index >= Variables.size())
         return false;
@@ -926,7 +1009,7 @@ DLLEXPORT bool NamedVars::SetValue(
     const std::string& name, const vector<VariableBlock*>& values)
 {
     GUARD_LOCK();
-    auto index = Find(name);
+    auto index = Find(guard, name);
 
     if(index >= Variables.size())
         return false;
@@ -939,16 +1022,17 @@ DLLEXPORT bool NamedVars::SetValue(
 DLLEXPORT bool NamedVars::SetValue(NamedVariableList& nameandvalues)
 {
     GUARD_LOCK();
-    auto index = Find(nameandvalues.Name);
+    auto index = Find(guard, nameandvalues.Name);
     // index check //
     if(index >= Variables.size()) {
 
         Variables.push_back(
             shared_ptr<NamedVariableList>(new NamedVariableList(nameandvalues)));
+        AddToIndex(guard);
         return true;
     }
 
-    nameandvalues.Name.clear();
+    nameandvalues.Rename("");
     // set values with "swap" //
     NamedVariableList::SwitchValues(*Variables[index].get(), nameandvalues);
     return true;
@@ -1070,14 +1154,8 @@ DLLEXPORT bool NamedVars::GetValues(
     }
     vector<VariableBlock*>& tmpvals = Variables[index]->GetValues();
 
-    vector<const VariableBlock*> tmpconsted(tmpvals.size());
-
-    for(size_t i = 0; i < tmpconsted.size(); i++) {
-
-        tmpconsted[i] = const_cast<const VariableBlock*>(tmpvals[i]);
-    }
-
-    receiver = tmpconsted;
+    // Reuses the receiver's memory //
+    receiver.assign(tmpvals.begin(), tmpvals.end());
     return true;
 }
 
@@ -1193,6 +1271,7 @@ DLLEXPORT void NamedVars::AddVar(shared_ptr<NamedVariableList> values)
     RemoveIfExists(values->GetName(), guard);
     // just add to vector //
     Variables.push_back(values);
+    AddToIndex(guard);
 }
 
 DLLEXPORT void NamedVars::AddVar(NamedVariableList* newvaluetoadd)
@@ -1201,6 +1280,7 @@ DLLEXPORT void NamedVars::AddVar(NamedVariableList* newvaluetoadd)
     RemoveIfExists(newvaluetoadd->GetName(), guard);
     // create new smart pointer and push back //
     Variables.push_back(shared_ptr<NamedVariableList>(newvaluetoadd));
+    AddToIndex(guard);
 }
 
 DLLEXPORT void NamedVars::AddVar(const std::string& name, VariableBlock* valuetosteal)
@@ -1210,6 +1290,7 @@ DLLEXPORT void NamedVars::AddVar(const std::string& name, VariableBlock* valueto
     // create new smart pointer and push back //
     Variables.push_back(
         shared_ptr<NamedVariableList>(new NamedVariableList(name, valuetosteal)));
+    AddToIndex(guard);
 }
 // ------------------------------------ //
 void NamedVars::Remove(size_t index)
@@ -1217,7 +1298,9 @@ void NamedVars::Remove(size_t index)
     GUARD_LOCK();
 
     // smart pointers //
+    ReleaseList(*Variables[index]);
     Variables.erase(Variables.begin() + index);
+    MarkChanged();
 }
 
 DLLEXPORT void NamedVars::Remove(const std::string& name)
@@ -1235,32 +1318,198 @@ DLLEXPORT void NamedVars::RemoveIfExists(const std::string& name, Lock& guard)
         return;
 
 
+    ReleaseList(*Variables[index]);
     Variables.erase(Variables.begin() + index);
+    MarkChanged();
 }
 // ------------------------------------ //
 bool NamedVars::LoadVarsFromFile(const std::string& file, LErrorReporter* errorreport)
 {
+    MarkChanged();
+
     // call datadump loaded with this object's vector //
     return FileSystem::LoadDataDump(file, Variables, errorreport);
 }
 vector<shared_ptr<NamedVariableList>>* NamedVars::GetVec()
 {
+    MarkChanged();
+    VectorGivenOut = true;
     return &Variables;
 }
 void NamedVars::SetVec(vector<shared_ptr<NamedVariableList>>& vec)
 {
     GUARD_LOCK();
+
+    for(const auto& variable : Variables)
+        ReleaseList(*variable);
+
     Variables = vec;
+    MarkChanged();
 }
 // ------------------------------------ //
 DLLEXPORT size_t NamedVars::Find(Lock& guard, const std::string& name) const
 {
-    for(size_t i = 0; i < Variables.size(); i++) {
-        if(Variables[i]->CompareName(name))
-            return i;
+    // Comparing a few strings is faster than hashing //
+    if(Variables.size() < INDEX_MIN_VARIABLES || VectorGivenOut) {
+
+        for(size_t i = 0; i < Variables.size(); i++) {
+            if(Variables[i]->CompareName(name))
+                return i;
+        }
+
+        return std::numeric_limits<size_t>::max();
     }
 
-    return std::numeric_limits<size_t>::max();
+    if(!IsIndexUpToDate(guard))
+        RebuildIndex(guard);
+
+    const auto hash = HashName(name);
+    const size_t mask = Index.size() - 1;
+
+    for(size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+
+        const IndexSlot& current = Index[slot];
+
+        if(current.Position == 0)
+            return std::numeric_limits<size_t>::max();
+
+        if(current.Hash == hash && Variables[current.Position - 1]->CompareName(name))
+            return current.Position - 1;
+    }
+}
+// ------------------------------------ //
+bool NamedVars::IsIndexUpToDate(Lock& guard) const
+{
+    if(!IndexValid || VectorGivenOut || !Changes || IndexChanges != *Changes)
+        return false;
+
+    return !IndexHasSharedLists || IndexSharedListChanges == *GetSharedListChanges();
+}
+
+bool NamedVars::AdoptList(NamedVariableList& list) const
+{
+    const auto& shared = GetSharedListChanges();
+
+    auto owner = std::atomic_load(&list.OwnerChanges);
+
+    while(true) {
+
+        if(owner == Changes)
+            return true;
+
+        if(owner == shared)
+            return false;
+
+        // A list owned by another NamedVars becomes shared //
+        if(std::atomic_compare_exchange_weak(
+               &list.OwnerChanges, &owner, owner ? shared : Changes)) {
+
+            if(!owner)
+                return true;
+
+            // The other NamedVars needs to notice that the list is now shared when it next
+            // updates its index //
+            ++*owner;
+            return false;
+        }
+    }
+}
+
+void NamedVars::ReleaseList(NamedVariableList& list) const
+{
+    if(!Changes)
+        return;
+
+    auto owner = Changes;
+    std::atomic_compare_exchange_strong(&list.OwnerChanges, &owner, {});
+}
+
+void NamedVars::RebuildIndex(Lock& guard) const
+{
+    if(!Changes)
+        Changes = std::make_shared<std::atomic<uint32_t>>(0);
+
+    IndexChanges = *Changes;
+    IndexSharedListChanges = *GetSharedListChanges();
+    IndexHasSharedLists = false;
+
+    // Keep at most half of the slots full //
+    size_t size = 16;
+
+    while(size < Variables.size() * 2)
+        size *= 2;
+
+    Index.assign(size, IndexSlot{0, 0});
+    const size_t mask = size - 1;
+
+    for(size_t i = 0; i < Variables.size(); ++i) {
+
+        if(!AdoptList(*Variables[i]))
+            IndexHasSharedLists = true;
+
+        const auto& name = Variables[i]->Name;
+        const auto hash = HashName(name);
+
+        for(size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+
+            IndexSlot& current = Index[slot];
+
+            if(current.Position == 0) {
+                current.Hash = hash;
+                current.Position = static_cast<uint32_t>(i + 1);
+                break;
+            }
+
+            // Find returns the first one with a duplicate name //
+            if(current.Hash == hash && Variables[current.Position - 1]->CompareName(name))
+                break;
+        }
+    }
+
+    IndexValid = true;
+}
+
+void NamedVars::AddToIndex(Lock& guard)
+{
+    // Only an index that has everything else is updated, otherwise it is rebuilt when
+    // needed. All other changes to Variables call MarkChanged //
+    if(VectorGivenOut) {
+        MarkChanged();
+        return;
+    }
+
+    if(!IsIndexUpToDate(guard))
+        return;
+
+    // Rebuild into a larger table instead of filling this too much //
+    if(Variables.size() * 2 > Index.size()) {
+        RebuildIndex(guard);
+        return;
+    }
+
+    const size_t position = Variables.size() - 1;
+
+    if(!AdoptList(*Variables[position]) && !IndexHasSharedLists) {
+        IndexHasSharedLists = true;
+        IndexSharedListChanges = *GetSharedListChanges();
+    }
+
+    const auto hash = HashName(Variables[position]->Name);
+    const size_t mask = Index.size() - 1;
+
+    size_t slot = hash & mask;
+
+    while(Index[slot].Position != 0)
+        slot = (slot + 1) & mask;
+
+    Index[slot].Hash = hash;
+    Index[slot].Position = static_cast<uint32_t>(position + 1);
+}
+
+uint32_t NamedVars::HashName(const std::string& name)
+{
+    const uint64_t hash = std::hash<std::string>()(name);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
 }
 // ------------------ Script compatible functions ------------------ //
 #ifdef LEVIATHAN_USING_ANGELSCRIPT
@@ -1291,6 +1540,7 @@ bool NamedVars::AddScriptCompatibleValue(ScriptSafeVariableBlock* value)
     try {
 
         Variables.push_back(shared_ptr<NamedVariableList>(new NamedVariableList(value)));
+        AddToIndex(guard);
         success = true;
 
     } catch(...) {
@@ -2,6 +2,8 @@
 // ------------------------------------ //
 #include "Define.h"
 // ------------------------------------ //
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -172,12 +174,21 @@ public:
     DLLEXPORT static void SwitchValues(
         NamedVariableList& receiver, NamedVariableList& donator);
 
+private:
+    //! \brief Updates Name and invalidates the index of the NamedVars this is in
+    void Rename(const std::string& name);
+
 private:
     //! Data
     std::vector<VariableBlock*> Datas;
 
     //! Name
     std::string Name;
+
+    //! Change counter of the NamedVars this is in. Incremented on rename as this can be
+    //! renamed through the pointers that NamedVars gives out. Only accessed with the atomic
+    //! shared_ptr functions
+    std::shared_ptr<std::atomic<uint32_t>> OwnerChanges;
 };
 
 
@@ -351,7 +362,16 @@ public:
     // ------------------------------------ //
     DLLEXPORT bool LoadVarsFromFile(const std::string& file, LErrorReporter* errorreport);
 
+    //! \note As the vector can be modified through this, Find doesn't use the name index
+    //! until the next change made through the other methods, after which the returned vector
+    //! must not be modified anymore. Use the const version for reading
     DLLEXPORT std::vector<std::shared_ptr<NamedVariableList>>* GetVec();
+
+    inline const std::vector<std::shared_ptr<NamedVariableList>>* GetVec() const
+    {
+        return &Variables;
+    }
+
     DLLEXPORT void SetVec(std::vector<std::shared_ptr<NamedVariableList>>& vec);
 
     //! \brief Returns the size of the internal variable vector
@@ -370,6 +390,10 @@ public:
         return Find(guard, name);
     }
 
+    //! \brief Finds the index of the first variable called name
+    //!
+    //! Small sets of variables are searched linearly, larger ones use a hash index
+    //! \returns std::numeric_limits<size_t>::max() if not found
     DLLEXPORT size_t Find(Lock& guard, const std::string& name) const;
     // ------------------------------------ //
     template<class T>
@@ -392,8 +416,75 @@ public:
     }
 
 private:
+    //! \brief Marks the index as needing a full rebuild, called by all methods that change
+    //! Variables or the names
+    //!
+    //! This also ends the use of a vector given out by GetVec, so after this the index is
+    //! trusted again once it has been rebuilt
+    inline void MarkChanged()
+    {
+        IndexValid = false;
+        VectorGivenOut = false;
+    }
+
+    //! \brief Adds a variable pushed to the end of Variables to the index
+    void AddToIndex(Lock& guard);
+
+    void RebuildIndex(Lock& guard) const;
+
+    //! \returns True if the index can be used for lookups
+    bool IsIndexUpToDate(Lock& guard) const;
+
+    //! \brief Makes renames of list invalidate the index of this
+    //!
+    //! The owner of the list is swapped atomically as the same list can be adopted by
+    //! another NamedVars that holds a different lock
+    //! \returns False if list is also in another NamedVars
+    bool AdoptList(NamedVariableList& list) const;
+
+    //! \brief Called when list is no longer in this so that another NamedVars can adopt it
+    void ReleaseList(NamedVariableList& list) const;
+
+    static uint32_t HashName(const std::string& name);
+
+private:
+    //! \brief Slot in the open addressing name index
+    struct IndexSlot {
+        uint32_t Hash;
+
+        //! Index in Variables + 1, 0 means that the slot is empty
+        uint32_t Position;
+    };
+
+    //! Variables with fewer than this many entries aren't indexed
+    static constexpr size_t INDEX_MIN_VARIABLES = 8;
+
     std::vector<std::shared_ptr<NamedVariableList>> Variables;
 
+    //! Name index for Find, the size is always a power of two
+    mutable std::vector<IndexSlot> Index;
+
+    //! Rename counter shared with the contained lists so that they can invalidate the
+    //! index. Only created when the index is first built so that small NamedVars and their
+    //! copies don't need to allocate this
+    mutable std::shared_ptr<std::atomic<uint32_t>> Changes;
+
+    //! Value of Changes when the index was last updated
+    mutable uint32_t IndexChanges = 0;
+
+    //! Set when some lists are in multiple NamedVars. Those can't notify all of them so
+    //! SharedListChanges is also checked
+    mutable bool IndexHasSharedLists = false;
+
+    //! Value of SharedListChanges when the index was last updated
+    mutable uint32_t IndexSharedListChanges = 0;
+
+    mutable bool IndexValid = false;
+
+    //! Set when GetVec has given out the vector, after which the index can't be trusted
+    //! until the next change through the methods of this
+    bool VectorGivenOut = false;
+
     //! If set the input data was invalid and this is in invalid state
     bool StateIsInvalid = false;
 };
@@ -7,6 +7,67 @@
 // ------------------------------------ //
 namespace Leviathan {
 
+// ------------------------------------ //
+// CompactObjectID
+static void WriteVarint(sf::Packet& packet, uint32_t value)
+{
+    while(value >= 0x80) {
+        packet << static_cast<uint8_t>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+
+    packet << static_cast<uint8_t>(value);
+}
+
+static uint32_t ReadVarint(sf::Packet& packet)
+{
+    uint32_t value = 0;
+
+    // 32 bits fit in 5 bytes //
+    for(int shift = 0; shift < 35; shift += 7) {
+
+        uint8_t byte = 0;
+        packet >> byte;
+
+        if(!packet)
+            throw InvalidArgument("Invalid packet format for loading a varint, data ended");
+
+        // Only 4 bits are left for the last byte //
+        if(shift == 28 && byte > 0x0f)
+            throw InvalidArgument(
+                "Invalid packet format for loading a varint, too large value");
+
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+
+        if(!(byte & 0x80))
+            return value;
+    }
+
+    throw InvalidArgument("Invalid packet format for loading a varint, too many bytes");
+}
+
+DLLEXPORT sf::Packet& operator<<(sf::Packet& packet, const CompactObjectID& data)
+{
+    const auto id = static_cast<uint32_t>(data.ID);
+
+    WriteVarint(packet, id & ENTITY_ID_INDEX_MASK);
+    WriteVarint(packet, id >> ENTITY_ID_INDEX_BITS);
+    return packet;
+}
+
+DLLEXPORT sf::Packet& operator>>(sf::Packet& packet, CompactObjectID& data)
+{
+    const uint32_t index = ReadVarint(packet);
+    const uint32_t rest = ReadVarint(packet);
+
+    if(index > ENTITY_ID_INDEX_MASK || rest > (UINT32_MAX >> ENTITY_ID_INDEX_BITS))
+        throw InvalidArgument(
+            "Invalid packet format for loading an ObjectID, too large value");
+
+    data.ID = static_cast<ObjectID>((rest << ENTITY_ID_INDEX_BITS) | index);
+    return packet;
+}
+
 // ------------------------------------ //
 // Float2
 DLLEXPORT sf::Packet& operator<<(sf::Packet& packet, const Float2& data)
@@ -77,17 +138,16 @@ DLLEXPORT sf::Packet& operator>>(sf::Packet& packet, sf::Packet& packetinner)
     // if(!packet)
     //     throw InvalidArgument("Invalid packet format for loading sf::Packet, no size");
 
-    // TODO: make this more efficient
-    // if(size > 0){
-
-    std::string tmpstr;
-    packet >> tmpstr;
+    // The data is written with the same layout as a string. SFML 2.5 doesn't expose the read
+    // position so the data can't be appended straight from packet, instead it is read to a
+    // reused buffer first. With a reused packetinner (PooledPacket) this doesn't allocate
+    thread_local std::string buffer;
+    packet >> buffer;
 
     if(!packet)
         throw InvalidArgument("Invalid packet format for loading Packet, no size");
 
-    packetinner.append(tmpstr.c_str(), tmpstr.size());
-    //}
+    packetinner.append(buffer.data(), buffer.size());
 
     return packet;
 }
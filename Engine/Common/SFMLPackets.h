@@ -3,6 +3,7 @@
 #pragma once
 #include "Define.h"
 // ------------------------------------ //
+#include "Entities/EntityCommon.h"
 #include "Types.h"
 
 #include "SFML/Network/Packet.hpp"
@@ -22,6 +23,30 @@ class Plane;
 
 namespace Leviathan {
 
+//! \brief Sends an ObjectID in a packet as varints of its index and the rest of the bits
+//!
+//! Entity IDs are dense within a world so this is usually 2 or 3 bytes instead of 4. Used
+//! with serializeas in the generated network messages
+struct CompactObjectID {
+
+    CompactObjectID() = default;
+    explicit CompactObjectID(ObjectID id) : ID(id) {}
+
+    explicit operator ObjectID() const
+    {
+        return ID;
+    }
+
+    ObjectID ID = NULL_OBJECT;
+};
+
+// ------------------------------------ //
+// CompactObjectID
+DLLEXPORT sf::Packet& operator<<(sf::Packet& packet, const CompactObjectID& data);
+//! \exception InvalidArgument if the packet ends in the middle of the ID or has a too long
+//! varint or values that don't fit in an ObjectID
+DLLEXPORT sf::Packet& operator>>(sf::Packet& packet, CompactObjectID& data);
+
 // ------------------------------------ //
 // Float2
 DLLEXPORT sf::Packet& operator<<(sf::Packet& packet, const Float2& data);
@@ -230,6 +230,17 @@ DLLEXPORT bool Engine::Init(
                 return;
             }
 
+            // Games cache their built scripts unless disabled in the configuration //
+            bool cacheScripts = true;
+
+            ObjectFileProcessor::LoadValueFromNamedVars<bool>(
+                engine->Define->GetValues(), "CacheScriptBytecode", cacheScripts, true);
+
+            if(cacheScripts) {
+                engine->MainScript->SetBytecodeCacheFolder(
+                    FileSystem::GetDataFolder() + "Cache/Scripts/");
+            }
+
             // create console after script engine //
             engine->MainConsole = new ScriptConsole();
             if(!engine->MainConsole) {
@@ -862,18 +873,55 @@ void Engine::Tick()
         return;
     }
 
-    // Get the passed time since the last update //
-    auto CurTime = Time::GetTimeMs64();
-    TimePassed = (int)(CurTime - LastTickTime);
+    if(TickAsFastAsPossible) {
 
+        // The clock is kept at the start of the current tick so that rendering and
+        // GetTimeSinceLastTick see each tick as having just happened //
+        for(int i = 0; i < MaxTicksPerCall; ++i) {
+
+            const auto CurTime = Time::GetTimeMs64();
+            LastTickTime = CurTime;
+            TimePassed = TICKSPEED;
+            _RunTick(CurTime);
+        }
 
-    if((TimePassed < TICKSPEED)) {
-        // It's not tick time yet //
         return;
     }
 
+    // Run the ticks that are due, but at most MaxTicksPerCall to allow rendering and message
+    // handling to happen while catching up //
+    for(int i = 0; i < MaxTicksPerCall; ++i) {
+
+        // Get the passed time since the last update //
+        const auto CurTime = Time::GetTimeMs64();
+        TimePassed = (int)(CurTime - LastTickTime);
+
+        if(TimePassed < TICKSPEED) {
+            // It's not tick time yet //
+            return;
+        }
+
+        LastTickTime += TICKSPEED;
+        _RunTick(CurTime);
+    }
+
+    // If ticks take longer than TICKSPEED catching up would only make it worse, so the ticks
+    // that are too far behind are dropped //
+    const auto ticksBehind = (Time::GetTimeMs64() - LastTickTime) / TICKSPEED;
+
+    if(MaxTicksBehind > 0 && ticksBehind > MaxTicksBehind) {
 
-    LastTickTime += TICKSPEED;
+        const auto dropped = ticksBehind - MaxTicksBehind;
+        LastTickTime += dropped * TICKSPEED;
+        SkippedTicks += static_cast<int>(dropped);
+
+        LOG_WARNING("Engine: can't keep up, skipped " + std::to_string(dropped) +
+                    " ticks. Last tick took: " + std::to_string(TickTime) + "ms");
+    }
+}
+
+void Engine::_RunTick(int64_t CurTime)
+{
     TickCount++;
 
     // Update input //
@@ -902,17 +950,15 @@ void Engine::Tick()
     {
         Lock lock(GameWorldsLock);
 
-        // This will also update physics //
-        auto end = GameWorlds.end();
-        for(auto iter = GameWorlds.begin(); iter != end; ++iter) {
-
-            (*iter)->Tick(TickCount);
-        }
+        // This will also update physics. Worlds that allow it are ticked in parallel, this
+        // returns after all of them are done so the events and invokes they queued are
+        // handled after this point //
+        GameWorld::TickWorlds(GameWorlds, TickCount);
     }
 
 
     // Some dark magic here //
-    if(TickCount % 25 == 0) {
+    if(TickCount % 25 == 0 && Mainstore) {
         // update values
         Mainstore->SetTickCount(TickCount);
         Mainstore->SetTickTime(TickTime);
@@ -929,9 +975,11 @@ void Engine::Tick()
     if(_ResourceRefreshHandler)
         _ResourceRefreshHandler->CheckFileStatus();
 
-    // Send the tick event //
-    if(MainEvents)
-        MainEvents->CallEvent(new Event(EVENT_TYPE_TICK, new IntegerEventData(TickCount)));
+    // Send the tick event and the events queued since last tick //
+    if(MainEvents) {
+        MainEvents->FlushQueuedEvents();
+        MainEvents->CallIntegerEvent(EVENT_TYPE_TICK, TickCount);
+    }
 
     // Call the default app tick //
     Owner->Tick(TimePassed);
@@ -975,8 +1023,7 @@ void Engine::RenderFrame()
     // advanced statistic start monitoring //
     RenderTimer->RenderingStart();
 
-    MainEvents->CallEvent(
-        new Event(EVENT_TYPE_FRAME_BEGIN, new IntegerEventData(SinceLastFrame)));
+    MainEvents->CallIntegerEvent(EVENT_TYPE_FRAME_BEGIN, SinceLastFrame);
 
     // Calculate parameters for GameWorld frame rendering systems //
     int64_t timeintick = Time::GetTimeMs64() - LastTickTime;
@@ -1007,7 +1054,8 @@ void Engine::RenderFrame()
         Graph->Frame();
 
     guard.lock();
-    MainEvents->CallEvent(new Event(EVENT_TYPE_FRAME_END, new IntegerEventData(FrameCount)));
+    MainEvents->CallIntegerEvent(EVENT_TYPE_FRAME_END, FrameCount);
+    MainEvents->FlushQueuedEvents();
 
     // advanced statistics frame has ended //
     RenderTimer->RenderingEnd();
@@ -1159,32 +1207,46 @@ DLLEXPORT void Engine::MarkQuit()
         Owner->MarkAsClosing();
 }
 // ------------------------------------ //
-DLLEXPORT void Engine::Invoke(const std::function<void()>& function)
+DLLEXPORT void Engine::Invoke(InvokeFunction function, INVOKE_PRIORITY priority)
 {
-    RecursiveLock lock(InvokeLock);
-    InvokeQueue.push_back(function);
+    InvokeQueues[static_cast<size_t>(priority)].Push(std::move(function));
 }
 
 DLLEXPORT void Engine::ProcessInvokes()
 {
-    RecursiveLock lock(InvokeLock);
+    const auto start = WantedClockType::now();
+
+    InvokeFunction function;
+
+    for(size_t i = 0; i < InvokeQueues.size(); ++i) {
 
-    while(!InvokeQueue.empty()) {
+        const bool limited =
+            InvokeTimeBudget > 0 && i != static_cast<size_t>(INVOKE_PRIORITY::High);
 
-        const auto& func = InvokeQueue.front();
+        // Invokes queued by the invokes that are ran here are also ran in this loop //
+        while(InvokeQueues[i].Pop(function)) {
 
-        // Recursive mutex allows the invoke to call extra invokes
-        func();
+            function();
 
-        InvokeQueue.pop_front();
+            // Release what the invoke captured before running the next one
+            function.Reset();
+
+            if(limited && std::chrono::duration_cast<std::chrono::milliseconds>(
+                              WantedClockType::now() - start)
+                                  .count() >= InvokeTimeBudget) {
+
+                // The rest are ran on the next tick //
+                return;
+            }
+        }
     }
 }
 
-DLLEXPORT void Engine::RunOnMainThread(const std::function<void()>& function)
+DLLEXPORT void Engine::RunOnMainThread(InvokeFunction function, INVOKE_PRIORITY priority)
 {
     if(!IsOnMainThread()) {
 
-        Invoke(function);
+        Invoke(std::move(function), priority);
 
     } else {
 
@@ -1196,6 +1258,10 @@ DLLEXPORT std::shared_ptr<GameWorld> Engine::CreateWorld(Window* owningwindow, i
     const std::shared_ptr<PhysicsMaterialManager>& physicsMaterials,
     const WorldNetworkSettings& networking, int overrideid /*= -1*/)
 {
+    // The worlds are locked while they are ticked //
+    LEVIATHAN_ASSERT(!GameWorld::IsParallelTickOnThisThread(),
+        "Engine: CreateWorld: called from a world that is ticked in parallel");
+
     std::shared_ptr<GameWorld> world;
     if(worldtype >= 1024) {
         // Standard world types
@@ -1226,6 +1292,9 @@ DLLEXPORT std::shared_ptr<GameWorld> Engine::CreateWorld(Window* owningwindow, i
 
 DLLEXPORT void Engine::DestroyWorld(const shared_ptr<GameWorld>& world)
 {
+    LEVIATHAN_ASSERT(!GameWorld::IsParallelTickOnThisThread(),
+        "Engine: DestroyWorld: called from a world that is ticked in parallel");
+
     if(!world)
         return;
 
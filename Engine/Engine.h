@@ -6,7 +6,9 @@
 #include "Common/ThreadSafe.h"
 #include "Entities/WorldNetworkSettings.h"
 #include "Networking/CommonNetwork.h"
+#include "Threading/InvokeQueue.h"
 
+#include <array>
 #include <functional>
 #include <inttypes.h>
 #include <list>
@@ -70,6 +72,12 @@ public:
     DLLEXPORT void MessagePump();
 
 
+    //! \brief Runs the ticks that are due
+    //!
+    //! Ticks are ran every TICKSPEED milliseconds. If the engine has fallen behind at most
+    //! MaxTicksPerCall ticks are ran per call and if it is more than MaxTicksBehind ticks
+    //! behind the extra ticks are skipped. When ticking as fast as possible MaxTicksPerCall
+    //! ticks are ran each call without looking at the time
     DLLEXPORT void Tick();
     DLLEXPORT void RenderFrame();
     DLLEXPORT void PreFirstTick();
@@ -93,10 +101,63 @@ public:
     //! any Get functions called in the invoke
     //! \todo Write a wrapper file that can be used for invoking without having to include this
     //! huge file
-    DLLEXPORT void Invoke(const std::function<void()>& function);
+    //!
+    //! This doesn't block. Invokes run in priority order, within a priority in the order they
+    //! were queued. Normal and Low priority invokes are left for the next tick if the invoke
+    //! time budget runs out
+    DLLEXPORT void Invoke(
+        InvokeFunction function, INVOKE_PRIORITY priority = INVOKE_PRIORITY::Normal);
 
     //! \brief Runs the function now if on the main thread otherwise calls Invoke
-    DLLEXPORT void RunOnMainThread(const std::function<void()>& function);
+    DLLEXPORT void RunOnMainThread(
+        InvokeFunction function, INVOKE_PRIORITY priority = INVOKE_PRIORITY::Normal);
+
+    //! \brief Sets how long invokes can run per tick
+    //! \param milliseconds The time budget, 0 to always run all queued invokes
+    DLLEXPORT inline void SetInvokeTimeBudget(int milliseconds)
+    {
+        InvokeTimeBudget = milliseconds;
+    }
+
+    // ------------------------------------ //
+    // Tick scheduling
+
+    //! \brief Sets how many ticks a single call to Tick can run when catching up
+    DLLEXPORT inline void SetMaxTicksPerCall(int ticks)
+    {
+        MaxTicksPerCall = ticks > 0 ? ticks : 1;
+    }
+
+    //! \brief Sets how many ticks the engine can be behind before dropping ticks
+    //!
+    //! This keeps a server that can't run ticks fast enough from trying to catch up
+    //! forever. The simulation slows down instead of ticks being ran in bursts
+    //! \param ticks The limit, 0 to never skip ticks
+    DLLEXPORT inline void SetMaxTicksBehind(int ticks)
+    {
+        MaxTicksBehind = ticks;
+    }
+
+    //! \brief Makes ticks run without waiting for TICKSPEED to pass
+    //!
+    //! Meant for headless simulations, bots and fast forwarding replays and tests. Each
+    //! tick still simulates TICKSPEED milliseconds so the results are the same as when
+    //! running in real time
+    DLLEXPORT inline void SetTickAsFastAsPossible(bool fast)
+    {
+        TickAsFastAsPossible = fast;
+    }
+
+    DLLEXPORT inline bool GetTickAsFastAsPossible() const
+    {
+        return TickAsFastAsPossible;
+    }
+
+    //! \returns The total number of ticks dropped due to being too far behind
+    DLLEXPORT inline int GetSkippedTicks() const
+    {
+        return SkippedTicks;
+    }
 
     //! \brief Returns true if called on the main thread
     DLLEXPORT bool IsOnMainThread() const;
@@ -292,7 +353,12 @@ protected:
     //! \note Should only be called on the client as this may break some simulations
     void _AdjustTickNumber(int tickamount, bool absolute);
 
-    //! \brief Handles InvokeQueue
+    //! \brief Runs a single tick, called by Tick with the lock held
+    //! \param CurTime The time this tick was started at
+    void _RunTick(int64_t CurTime);
+
+    //! \brief Runs queued invokes until all have ran or the time budget is exceeded
+    //! \note Only the main thread may call this
     DLLEXPORT void ProcessInvokes();
 
     //! Console input comes through this
@@ -375,8 +441,19 @@ protected:
 
 
     // Invoke store //
-    RecursiveMutex InvokeLock;
-    std::list<std::function<void()>> InvokeQueue;
+    //! Queued invokes of each INVOKE_PRIORITY
+    std::array<InvokeQueue, INVOKE_PRIORITY_COUNT> InvokeQueues;
+
+    //! Milliseconds that invokes can run each tick, 0 is unlimited
+    int InvokeTimeBudget = 10;
+
+    // Tick scheduling //
+    int MaxTicksPerCall = 4;
+    int MaxTicksBehind = 20;
+    bool TickAsFastAsPossible = false;
+
+    //! Number of ticks that were dropped because the engine was too far behind
+    int SkippedTicks = 0;
 
     // Stores the command line before running it //
     //! \todo Remove this doesn't work now and needs redoing
@@ -8,7 +8,10 @@
 #include "Common/SFMLPackets.h"
 #include "EntityCommon.h"
 
+#include <atomic>
 #include <limits>
+#include <type_traits>
+#include <vector>
 
 // No clue where this is coming from...
 #ifdef _WIN32
@@ -48,15 +51,234 @@ enum class COMPONENT_TYPE : uint16_t {
 };
 
 
+class Component;
+class ComponentChangeBuffer;
+class ComponentChangeList;
+
+//! \brief A bool flag of a component that keeps a ComponentChangeList up to date
+//!
+//! Works like a bool, but once tracked by a ComponentHolder setting this adds the component to
+//! the list of changed components of its type and clearing removes it. This way systems
+//! only need to look at the components that have the flag set.
+//! \note The lists may only be modified by one thread at a time. Other threads that set
+//! flags at the same time need to use a ComponentChangeBuffer
+class ComponentChangeFlag {
+    friend ComponentChangeBuffer;
+    friend ComponentChangeList;
+
+    //! Index of flags that aren't in their list
+    static constexpr uint32_t NOT_LISTED = std::numeric_limits<uint32_t>::max();
+
+public:
+    inline ComponentChangeFlag(Component* owner, bool value) : Value(value), Owner(owner) {}
+
+    inline ~ComponentChangeFlag();
+
+    ComponentChangeFlag(const ComponentChangeFlag&) = delete;
+    ComponentChangeFlag& operator=(const ComponentChangeFlag&) = delete;
+
+    inline ComponentChangeFlag& operator=(bool value);
+
+    inline operator bool() const
+    {
+        return Value.load(std::memory_order_relaxed);
+    }
+
+    //! \brief Starts keeping list updated, adds the owner to it if this is set
+    inline void Track(ComponentChangeList* list, ObjectID id);
+
+private:
+    //! \brief Adds this to or removes this from List to match Value
+    inline void _UpdateList();
+
+private:
+    //! Atomic so that threads buffering their changes can set the same flags
+    std::atomic<bool> Value;
+
+    //! Position of this in List or NOT_LISTED
+    uint32_t Index = NOT_LISTED;
+
+    ObjectID ID = NULL_OBJECT;
+    Component* const Owner;
+    ComponentChangeList* List = nullptr;
+};
+
+//! \brief Components of one type that have a ComponentChangeFlag set
+class ComponentChangeList {
+    friend ComponentChangeFlag;
+
+public:
+    ComponentChangeList() = default;
+
+    ComponentChangeList(const ComponentChangeList&) = delete;
+    ComponentChangeList& operator=(const ComponentChangeList&) = delete;
+
+    //! \brief Calls callback(ComponentT&, ObjectID) for each component in this
+    //!
+    //! The callback may clear the flag of the component it is called with, components whose
+    //! flag is set during the loop might not be visited
+    template<class ComponentT, class CallbackT>
+    void ForEach(CallbackT&& callback)
+    {
+        // Going backwards keeps the unvisited items in place when the current one is removed
+        for(size_t i = Flags.size(); i-- > 0;) {
+
+            if(i >= Flags.size())
+                continue;
+
+            ComponentChangeFlag* flag = Flags[i];
+            callback(static_cast<ComponentT&>(*flag->Owner), flag->ID);
+        }
+    }
+
+    inline size_t GetCount() const
+    {
+        return Flags.size();
+    }
+
+private:
+    inline void _Add(ComponentChangeFlag* flag)
+    {
+        flag->Index = static_cast<uint32_t>(Flags.size());
+        Flags.push_back(flag);
+    }
+
+    inline void _Remove(ComponentChangeFlag* flag)
+    {
+        ComponentChangeFlag* last = Flags.back();
+        Flags[flag->Index] = last;
+        last->Index = flag->Index;
+        Flags.pop_back();
+
+        flag->Index = ComponentChangeFlag::NOT_LISTED;
+    }
+
+private:
+    std::vector<ComponentChangeFlag*> Flags;
+};
+
+//! \brief Collects the ComponentChangeFlags set on threads that may not modify the lists
+//!
+//! While a Scope is active on a thread, setting a flag there only changes its value and the
+//! flag is stored in the buffer. Apply then updates the lists on the thread that owns them
+//! once the buffering threads are done. Used for systems that run at the same time
+class ComponentChangeBuffer {
+public:
+    //! \brief Makes the flags set on the calling thread go to a buffer while this exists
+    class Scope {
+    public:
+        inline Scope(ComponentChangeBuffer& buffer) : Previous(_GetActive())
+        {
+            _GetActive() = &buffer;
+        }
+
+        inline ~Scope()
+        {
+            _GetActive() = Previous;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ComponentChangeBuffer* const Previous;
+    };
+
+    ComponentChangeBuffer() = default;
+
+    ComponentChangeBuffer(const ComponentChangeBuffer&) = delete;
+    ComponentChangeBuffer& operator=(const ComponentChangeBuffer&) = delete;
+
+    //! \brief Updates the lists of the buffered flags and clears this
+    //! \note No thread may be setting the buffered flags while this runs
+    inline void Apply()
+    {
+        for(ComponentChangeFlag* flag : Changed)
+            flag->_UpdateList();
+
+        Changed.clear();
+    }
+
+    //! \returns The buffer of the calling thread or null
+    static inline ComponentChangeBuffer* GetActive()
+    {
+        return _GetActive();
+    }
+
+private:
+    static inline ComponentChangeBuffer*& _GetActive()
+    {
+        thread_local ComponentChangeBuffer* active = nullptr;
+        return active;
+    }
+
+    friend ComponentChangeFlag;
+
+    //! The same flag may be here multiple times, the final value is used when applying
+    std::vector<ComponentChangeFlag*> Changed;
+};
+
+ComponentChangeFlag::~ComponentChangeFlag()
+{
+    if(Index != NOT_LISTED && List)
+        List->_Remove(this);
+}
+
+ComponentChangeFlag& ComponentChangeFlag::operator=(bool value)
+{
+    if(Value.load(std::memory_order_relaxed) == value)
+        return *this;
+
+    Value.store(value, std::memory_order_relaxed);
+
+    if(List) {
+
+        ComponentChangeBuffer* buffer = ComponentChangeBuffer::GetActive();
+
+        if(buffer) {
+            buffer->Changed.push_back(this);
+        } else {
+            _UpdateList();
+        }
+    }
+
+    return *this;
+}
+
+void ComponentChangeFlag::Track(ComponentChangeList* list, ObjectID id)
+{
+    if(Index != NOT_LISTED && List)
+        List->_Remove(this);
+
+    List = list;
+    ID = id;
+
+    if(List)
+        _UpdateList();
+}
+
+void ComponentChangeFlag::_UpdateList()
+{
+    const bool listed = Index != NOT_LISTED;
+
+    if(Value.load(std::memory_order_relaxed)) {
+        if(!listed)
+            List->_Add(this);
+    } else if(listed) {
+        List->_Remove(this);
+    }
+}
+
 //! \brief Base class for all components
 class Component {
 public:
-    inline Component(COMPONENT_TYPE type) : Marked(true), Type(type){};
+    inline Component(COMPONENT_TYPE type) : Marked(this, true), Type(type){};
 
     //! Set to true when this component has changed
-    //! Can be used by other systems to react to changing components
+    //! Can be used by other systems to react to changing components. Systems should loop
+    //! ComponentHolder::ForEachMarked instead of checking this for all components
     //! \note This is true when the component has just been created
-    bool Marked;
+    ComponentChangeFlag Marked;
 
     //! Type of this component, used for network serialization
     const COMPONENT_TYPE Type;
@@ -65,9 +287,90 @@ public:
     Component& operator=(const Component&) = delete;
 };
 
+template<class ComponentType, class = void>
+struct HasStateMarked : std::false_type {};
+
+template<class ComponentType>
+struct HasStateMarked<ComponentType, std::void_t<decltype(ComponentType::StateMarked)>> :
+    std::true_type {};
+
+//! \brief Holds all components of a type in a world
+//!
+//! Keeps lists of the components that are marked (and state marked for ComponentWithStates)
+//! so that systems don't need to check all components to find the changed ones
 template<class ComponentType>
 class ComponentHolder : public ObjectPoolTracked<ComponentType, ObjectID> {
+    using BaseT = ObjectPoolTracked<ComponentType, ObjectID>;
+
 public:
+    ComponentHolder() = default;
+
+    ~ComponentHolder()
+    {
+        // The components need to be destroyed while the change lists still exist
+        this->Clear();
+    }
+
+    //! \copydoc ObjectPoolTracked::ConstructNew
+    template<typename... Args>
+    ComponentType* ConstructNew(ObjectID forentity, Args&&... args)
+    {
+        ComponentType* created = BaseT::ConstructNew(forentity, std::forward<Args>(args)...);
+
+        created->Marked.Track(&MarkedComponents, forentity);
+
+        if constexpr(HasStateMarked<ComponentType>::value)
+            created->StateMarked.Track(&StateMarkedComponents, forentity);
+
+        return created;
+    }
+
+    //! \brief Calls callback(ComponentType&, ObjectID) for all components that are Marked
+    //! \see ComponentChangeList::ForEach
+    template<class CallbackT>
+    void ForEachMarked(CallbackT&& callback)
+    {
+        MarkedComponents.template ForEach<ComponentType>(std::forward<CallbackT>(callback));
+    }
+
+    //! \brief Calls callback(ComponentType&, ObjectID) for all components that are
+    //! StateMarked
+    template<class CallbackT>
+    void ForEachStateMarked(CallbackT&& callback)
+    {
+        static_assert(HasStateMarked<ComponentType>::value, "component type has no states");
+        StateMarkedComponents.template ForEach<ComponentType>(
+            std::forward<CallbackT>(callback));
+    }
+
+    inline size_t GetMarkedCount() const
+    {
+        return MarkedComponents.GetCount();
+    }
+
+    inline size_t GetStateMarkedCount() const
+    {
+        return StateMarkedComponents.GetCount();
+    }
+
+private:
+    ComponentChangeList MarkedComponents;
+
+    //! Only used if ComponentType has StateMarked
+    ComponentChangeList StateMarkedComponents;
+};
+
+//! \brief Compile time list of the component types that a world stores
+//!
+//! Generated worlds define this as ComponentTypes so that templates can check whether a type
+//! can be accessed directly without going through the COMPONENT_TYPE based virtual methods
+template<class... ComponentTypes>
+struct ComponentTypeList {
+
+    static constexpr size_t Count = sizeof...(ComponentTypes);
+
+    template<class ComponentType>
+    static constexpr bool Contains = (std::is_same_v<ComponentType, ComponentTypes> || ...);
 };
 } // namespace Leviathan
 
@@ -11,13 +11,14 @@ namespace Leviathan {
 template<class StateT>
 class ComponentWithStates : public Component {
 public:
-    inline ComponentWithStates(COMPONENT_TYPE type) : Component(type) {}
+    inline ComponentWithStates(COMPONENT_TYPE type) : Component(type), StateMarked(this, true)
+    {}
 
     //! True when there are states in a StateHolder for this entity, which haven't been
     //! shown yet.
     //! \note This is true by default to always apply the initial position even
     //! if there are no states
-    bool StateMarked = true;
+    ComponentChangeFlag StateMarked;
 
     // Data for currently interpolating state
     // Some child classes might not use this if interpolating is not done
@@ -0,0 +1,84 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "Component.h"
+#include "Script/ScriptTypeResolver.h"
+
+namespace Leviathan {
+
+class GameWorld;
+
+//! \brief Functions for accessing one C++ component type of a world when the type is only
+//! known at runtime
+//!
+//! Retrieved once with GameWorld::GetComponentTypeAccess after which the functions go
+//! directly to the ComponentHolder of the world. This avoids the switch of the virtual
+//! GetComponent(ObjectID, COMPONENT_TYPE) and the vector copies of GetAddedFor on each call.
+//! \note The world passed to the functions must be the one that returned this (or one of
+//! the same class)
+struct ComponentTypeAccess {
+
+    COMPONENT_TYPE Type;
+
+    //! \returns The component of an entity or null
+    void* (*Find)(GameWorld& world, ObjectID id);
+
+    size_t (*GetAddedCount)(GameWorld& world);
+    ObjectID (*GetAddedEntity)(GameWorld& world, size_t index);
+
+    size_t (*GetRemovedCount)(GameWorld& world);
+    ObjectID (*GetRemovedEntity)(GameWorld& world, size_t index);
+
+    //! \returns The AngelScript type id of the component type
+    int (*GetAngelScriptTypeID)(ScriptExecutor* exec);
+};
+
+//! \brief Implements ComponentTypeAccess for a component type of a generated world
+//!
+//! WorldT needs to have a GetComponentHolder<ComponentT>() method
+template<class WorldT, class ComponentT>
+struct ComponentTypeAccessFor {
+
+    static void* Find(GameWorld& world, ObjectID id)
+    {
+        return _Holder(world).Find(id);
+    }
+
+    static size_t GetAddedCount(GameWorld& world)
+    {
+        return _Holder(world).GetAdded().size();
+    }
+
+    static ObjectID GetAddedEntity(GameWorld& world, size_t index)
+    {
+        return std::get<1>(_Holder(world).GetAdded()[index]);
+    }
+
+    static size_t GetRemovedCount(GameWorld& world)
+    {
+        return _Holder(world).GetRemoved().size();
+    }
+
+    static ObjectID GetRemovedEntity(GameWorld& world, size_t index)
+    {
+        return std::get<1>(_Holder(world).GetRemoved()[index]);
+    }
+
+    static int GetAngelScriptTypeID(ScriptExecutor* exec)
+    {
+        return AngelScriptTypeIDResolver<ComponentT>::Get(exec);
+    }
+
+    static constexpr ComponentTypeAccess Table = {ComponentT::TYPE, &Find, &GetAddedCount,
+        &GetAddedEntity, &GetRemovedCount, &GetRemovedEntity, &GetAngelScriptTypeID};
+
+private:
+    static ComponentHolder<ComponentT>& _Holder(GameWorld& world)
+    {
+        return static_cast<WorldT&>(world).template GetComponentHolder<ComponentT>();
+    }
+};
+
+} // namespace Leviathan
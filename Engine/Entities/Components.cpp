@@ -15,6 +15,8 @@
 
 #include "bsfCore/Components/BsCAnimation.h"
 #include "bsfCore/Components/BsCRenderable.h"
+#include "bsfCore/Material/BsMaterial.h"
+#include "bsfCore/Resources/BsResources.h"
 // #include "bsfCore/Importer/BsImporter.h"
 #include "bsfCore/Renderer/BsRenderable.h"
 #include "bsfCore/Scene/BsSceneObject.h"
@@ -331,6 +333,23 @@ DLLEXPORT void Model::ApplyMeshName()
     GraphicalObject->setMesh(mesh);
 }
 
+DLLEXPORT std::string Model::GetMaterialUUID() const
+{
+    if(Material.getUUID().empty())
+        return "";
+
+    return Material.getUUID().toString().c_str();
+}
+
+DLLEXPORT bs::HMaterial Model::FindMaterial(const std::string& uuid)
+{
+    if(uuid.empty())
+        return bs::HMaterial();
+
+    return bs::static_resource_cast<bs::Material>(
+        bs::gResources().loadFromUUID(bs::UUID(bs::String(uuid.c_str()))));
+}
+
 // // ------------------ ManualObject ------------------ //
 // DLLEXPORT ManualObject::ManualObject(bs::Scene* scene) : Component(TYPE)
 // {
@@ -56,6 +56,10 @@ public:
 
     void SetPositionDataFromPhysics(const Float3& position, const Float4& orientation) override
     {
+        // Resting bodies that haven't fallen asleep yet don't need new states //
+        if(Members._Position == position && Members._Orientation == orientation)
+            return;
+
         Members._Position = position;
         Members._Orientation = orientation;
         Marked = true;
@@ -238,6 +242,13 @@ public:
 
     DLLEXPORT void ApplyMeshName();
 
+    //! \returns The resource UUID of Material or an empty string if there is no material
+    DLLEXPORT std::string GetMaterialUUID() const;
+
+    //! \brief Finds a material by a UUID returned by GetMaterialUUID
+    //! \note Only materials that are loaded or registered in a resource manifest can be found
+    DLLEXPORT static bs::HMaterial FindMaterial(const std::string& uuid);
+
     REFERENCE_HANDLE_UNCOUNTED_TYPE(Model);
 
     //! The entity that has this model's mesh loaded
@@ -13,9 +13,35 @@ using ObjectID = int32_t;
 // TODO: start using this everywhere
 constexpr ObjectID NULL_OBJECT = 0;
 
+//! \brief Entity IDs are made of an index, which is dense within a world, and a generation
+//! that is incremented each time the index is reused
+//! \see EntityIDAllocator
+constexpr uint32_t ENTITY_ID_INDEX_BITS = 22;
+constexpr uint32_t ENTITY_ID_GENERATION_BITS = 9;
+
+constexpr uint32_t ENTITY_ID_INDEX_MASK = (1u << ENTITY_ID_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_ID_GENERATION_MASK = ((1u << ENTITY_ID_GENERATION_BITS) - 1)
+                                               << ENTITY_ID_INDEX_BITS;
+
+//! Set on the entities that clients create, to keep them separate from the server's entities
+constexpr uint32_t ENTITY_ID_LOCAL_FLAG = 1u << 31;
+
+//! \returns The part of id that can be used to index per entity arrays
+constexpr uint32_t GetEntityIndex(ObjectID id)
+{
+    return static_cast<uint32_t>(id) & ENTITY_ID_INDEX_MASK;
+}
+
+constexpr uint32_t GetEntityGeneration(ObjectID id)
+{
+    return (static_cast<uint32_t>(id) & ENTITY_ID_GENERATION_MASK) >> ENTITY_ID_INDEX_BITS;
+}
+
 } // namespace Leviathan
 
 #ifdef LEAK_INTO_GLOBAL
+using Leviathan::GetEntityGeneration;
+using Leviathan::GetEntityIndex;
 using Leviathan::NULL_OBJECT;
 using Leviathan::ObjectID;
 #endif
@@ -0,0 +1,86 @@
+// ------------------------------------ //
+#include "EntityIDAllocator.h"
+
+#include "Exceptions.h"
+
+using namespace Leviathan;
+// ------------------------------------ //
+constexpr uint16_t INDEX_IN_USE = 0x8000;
+
+static_assert(ENTITY_ID_GENERATION_BITS < 16, "generation doesn't fit with the in use bit");
+// ------------------------------------ //
+DLLEXPORT EntityIDAllocator::EntityIDAllocator(size_t minimumfreeindexes) :
+    // Index 0 is never used so that no ID is NULL_OBJECT
+    Generations(1, 0), MinimumFreeIndexes(minimumfreeindexes)
+{}
+
+DLLEXPORT void EntityIDAllocator::SetFlags(uint32_t flags)
+{
+    Flags = flags & ~(ENTITY_ID_INDEX_MASK | ENTITY_ID_GENERATION_MASK);
+}
+// ------------------------------------ //
+DLLEXPORT ObjectID EntityIDAllocator::Allocate()
+{
+    uint32_t index;
+
+    if(FreeIndexes.size() > MinimumFreeIndexes) {
+
+        index = FreeIndexes.front();
+        FreeIndexes.pop_front();
+
+    } else {
+
+        if(Generations.size() > ENTITY_ID_INDEX_MASK)
+            throw InvalidState("EntityIDAllocator: all entity indexes are in use");
+
+        index = static_cast<uint32_t>(Generations.size());
+        Generations.push_back(0);
+    }
+
+    Generations[index] |= INDEX_IN_USE;
+    ++AliveCount;
+
+    const uint32_t generation = Generations[index] & ~INDEX_IN_USE;
+
+    return static_cast<ObjectID>(Flags | (generation << ENTITY_ID_INDEX_BITS) | index);
+}
+
+DLLEXPORT bool EntityIDAllocator::Release(ObjectID id)
+{
+    if(!IsAlive(id))
+        return false;
+
+    const auto index = GetEntityIndex(id);
+
+    // The generation wraps around once it has used all of its bits //
+    Generations[index] = static_cast<uint16_t>(
+        (GetEntityGeneration(id) + 1) & (ENTITY_ID_GENERATION_MASK >> ENTITY_ID_INDEX_BITS));
+
+    FreeIndexes.push_back(index);
+    --AliveCount;
+    return true;
+}
+
+DLLEXPORT bool EntityIDAllocator::IsAlive(ObjectID id) const
+{
+    const auto index = GetEntityIndex(id);
+
+    if((static_cast<uint32_t>(id) & ~(ENTITY_ID_INDEX_MASK | ENTITY_ID_GENERATION_MASK)) !=
+            Flags ||
+        index == 0 || index >= Generations.size())
+        return false;
+
+    return Generations[index] == (GetEntityGeneration(id) | INDEX_IN_USE);
+}
+// ------------------------------------ //
+DLLEXPORT void EntityIDAllocator::Clear()
+{
+    for(uint32_t index = 1; index < Generations.size(); ++index) {
+
+        if(!(Generations[index] & INDEX_IN_USE))
+            continue;
+
+        Release(static_cast<ObjectID>(
+            Flags | ((Generations[index] & ~INDEX_IN_USE) << ENTITY_ID_INDEX_BITS) | index));
+    }
+}
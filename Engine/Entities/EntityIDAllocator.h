@@ -0,0 +1,74 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "EntityCommon.h"
+
+#include <deque>
+#include <vector>
+
+namespace Leviathan {
+
+//! \brief Creates the entity IDs of a single GameWorld
+//!
+//! IDs are indexes starting from 1 combined with a generation (see EntityCommon.h). Released
+//! indexes are reused in the order they were released and their generation is incremented so
+//! that the old IDs don't match the new entity. Reuse only starts once enough indexes are
+//! free so that a generation doesn't wrap around quickly when a few entities are repeatedly
+//! created and destroyed.
+class EntityIDAllocator {
+public:
+    //! \param minimumfreeindexes How many released indexes are kept before reusing them
+    DLLEXPORT EntityIDAllocator(size_t minimumfreeindexes = 1024);
+
+    //! \brief Sets the bits (for example ENTITY_ID_LOCAL_FLAG) that are set in all created IDs
+    //!
+    //! Release and IsAlive ignore IDs that don't have the same flags, so IDs created
+    //! elsewhere can be passed to them
+    DLLEXPORT void SetFlags(uint32_t flags);
+
+    //! \brief Creates a new ID
+    //! \exception InvalidState if all indexes are in use
+    DLLEXPORT ObjectID Allocate();
+
+    //! \brief Allows the index of id to be reused
+    //! \returns False if id isn't currently allocated from this
+    DLLEXPORT bool Release(ObjectID id);
+
+    //! \returns True if id is allocated from this and hasn't been released
+    DLLEXPORT bool IsAlive(ObjectID id) const;
+
+    //! \brief Releases all IDs
+    DLLEXPORT void Clear();
+
+    //! \returns The number of IDs that haven't been released
+    inline size_t GetAliveCount() const
+    {
+        return AliveCount;
+    }
+
+    //! \returns One past the largest index that has been used. Arrays indexed with
+    //! GetEntityIndex need to be this large
+    inline size_t GetIndexCount() const
+    {
+        return Generations.size();
+    }
+
+private:
+    //! Generation of each index, the highest bit is set while the index is in use
+    std::vector<uint16_t> Generations;
+
+    std::deque<uint32_t> FreeIndexes;
+
+    size_t MinimumFreeIndexes;
+    size_t AliveCount = 0;
+
+    uint32_t Flags = 0;
+};
+
+} // namespace Leviathan
+
+#ifdef LEAK_INTO_GLOBAL
+using Leviathan::EntityIDAllocator;
+#endif
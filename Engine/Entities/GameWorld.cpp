@@ -12,14 +12,18 @@
 #include "Networking/NetworkServerInterface.h"
 #include "ObjectFiles/ObjectFileProcessor.h"
 #include "Physics/PhysicalWorld.h"
+#include "Physics/PhysicsHistory.h"
 #include "Physics/PhysicsMaterialManager.h"
 #include "Rendering/Graphics.h"
 #include "Script/ScriptConversionHelpers.h"
 #include "Script/ScriptExecutor.h"
 #include "ScriptComponentHolder.h"
 #include "ScriptSystemWrapper.h"
+#include "SpatialIndex.h"
+#include "WorldSnapshot.h"
 #include "Sound/SoundDevice.h"
 #include "Threading/ThreadingManager.h"
+#include "TimeIncludes.h"
 #include "Window.h"
 
 // Camera interpolation
@@ -33,6 +37,14 @@
 #include "bsfCore/Components/BsCSkybox.h"
 #include "bsfCore/Scene/BsSceneObject.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
 using namespace Leviathan;
 // ------------------------------------ //
 
@@ -42,6 +54,109 @@ using namespace Leviathan;
 //     const dFloat* const hitNormal, dLong collisionID, void* const userData,
 //     dFloat intersectParam);
 
+// ------------------------------------ //
+namespace {
+
+//! \brief Thread safe script systems that are ran during a single tick
+//!
+//! Both the ticking thread and the worker threads take systems from this until none are left
+//! so the ticking thread doesn't wait for workers that haven't started yet. Workers that start
+//! after all the systems are taken return immediately
+struct ParallelScriptSystemRuns {
+
+    explicit ParallelScriptSystemRuns(std::vector<ScriptSystemWrapper*>&& systems) :
+        Systems(std::move(systems)), ChangedComponents(Systems.size())
+    {}
+
+    //! \brief Counts a system as finished when destroyed, even if the system threw
+    class FinishedGuard {
+    public:
+        FinishedGuard(ParallelScriptSystemRuns& runs) : Runs(runs) {}
+
+        ~FinishedGuard()
+        {
+            if(++Runs.Finished == Runs.Systems.size()) {
+
+                std::lock_guard<std::mutex> lock(Runs.FinishedMutex);
+                Runs.AllFinished.notify_all();
+            }
+        }
+
+    private:
+        ParallelScriptSystemRuns& Runs;
+    };
+
+    void RunRemaining()
+    {
+        for(size_t i = NextToRun++; i < Systems.size(); i = NextToRun++) {
+
+            FinishedGuard finished(*this);
+
+            try {
+                // The systems running at the same time can't all modify the change lists //
+                ComponentChangeBuffer::Scope buffering(ChangedComponents[i]);
+                Systems[i]->Run();
+            } catch(...) {
+
+                // Thrown on the ticking thread by WaitForAll //
+                std::lock_guard<std::mutex> lock(FinishedMutex);
+
+                if(!Error)
+                    Error = std::current_exception();
+            }
+        }
+    }
+
+    //! \brief Waits for the systems that other threads are still running and then applies
+    //! the component changes they made
+    //! \exception Rethrows the first exception thrown by a system
+    void WaitForAll()
+    {
+        {
+            std::unique_lock<std::mutex> lock(FinishedMutex);
+            AllFinished.wait(lock, [this]() { return Finished == Systems.size(); });
+        }
+
+        for(auto& changes : ChangedComponents)
+            changes.Apply();
+
+        if(Error)
+            std::rethrow_exception(Error);
+    }
+
+    const std::vector<ScriptSystemWrapper*> Systems;
+
+    //! Marked flags set by each system
+    std::vector<ComponentChangeBuffer> ChangedComponents;
+    std::atomic<size_t> NextToRun{0};
+    std::atomic<size_t> Finished{0};
+
+    std::mutex FinishedMutex;
+    std::condition_variable AllFinished;
+
+    //! First exception thrown by a system, protected by FinishedMutex
+    std::exception_ptr Error;
+};
+
+//! True on threads that are ticking a world in GameWorld::TickWorlds at the same time as other
+//! worlds
+thread_local bool ParallelTickOnThisThread = false;
+
+//! \brief Sets ParallelTickOnThisThread for the duration of a parallel tick
+class ParallelTickSetter {
+public:
+    ParallelTickSetter()
+    {
+        ParallelTickOnThisThread = true;
+    }
+
+    ~ParallelTickSetter()
+    {
+        ParallelTickOnThisThread = false;
+    }
+};
+
+} // namespace
 // ------------------------------------ //
 class GameWorld::Implementation {
 public:
@@ -66,6 +181,13 @@ public:
     std::vector<std::tuple<WantedClockType::time_point, ResponseEntityUpdate>>
         QueuedEntityUpdates;
 
+    //! Physics states of the recent ticks on a client with local control. Used to resimulate
+    //! our entities when the server corrects them
+    PhysicsHistory LocalControlPhysicsHistory;
+
+    //! Positions of the entities, updated by SpatialIndexSystem
+    SpatialIndex EntityPositions;
+
     // BSF rendering resources
     bs::HSceneObject WorldCameraSO;
     bs::HCamera WorldCamera;
@@ -104,9 +226,20 @@ DLLEXPORT bool GameWorld::Init(const WorldNetworkSettings& network, Graphics* gr
 {
     NetworkSettings = network;
 
+    // Server created entities are received with their IDs so clients need to keep theirs
+    // separate //
+    EntityIDs.SetFlags(NetworkSettings.IsAuthoritative ? 0 : ENTITY_ID_LOCAL_FLAG);
+
     // Detecting non-GUI mode //
     if(graphics) {
 
+        if(TickInParallel) {
+
+            LOG_WARNING("GameWorld: Init: graphical worlds can't be ticked in parallel, "
+                        "disabling SetTickInParallel");
+            TickInParallel = false;
+        }
+
         GraphicalMode = true;
         // these are always required for worlds //
         _CreateRenderingResources(graphics);
@@ -120,7 +253,8 @@ DLLEXPORT bool GameWorld::Init(const WorldNetworkSettings& network, Graphics* gr
     // that physics is wanted
     if(PhysicsMaterials) {
 
-        _PhysicalWorld = std::make_shared<PhysicalWorld>(this, PhysicsMaterials.get());
+        _PhysicalWorld = std::make_shared<PhysicalWorld>(
+            this, PhysicsMaterials.get(), MultithreadedPhysics);
     }
 
     _DoSystemsInit();
@@ -497,9 +631,34 @@ DLLEXPORT bs::HSceneObject GameWorld::GetCameraSceneObject()
     return pimpl->WorldCameraSO;
 }
 // ------------------------------------ //
+DLLEXPORT SpatialIndex& GameWorld::GetSpatialIndex()
+{
+    return pimpl->EntityPositions;
+}
+// ------------------------------------ //
 DLLEXPORT bool GameWorld::ShouldPlayerReceiveEntity(
     Position& atposition, Connection& connection)
 {
+    const float radius = NetworkSettings.EntityRelevanceRadius;
+
+    if(radius <= 0)
+        return true;
+
+    for(const auto& player : ReceivingPlayers) {
+
+        if(player->GetConnection().get() != &connection)
+            continue;
+
+        const ObjectID playerEntity = player->GetPositionInWorld(this);
+        Float3 playerPosition;
+
+        if(!pimpl->EntityPositions.GetPosition(playerEntity, playerPosition))
+            return true;
+
+        return (atposition.Members._Position - playerPosition).LengthSquared() <=
+               radius * radius;
+    }
+
     return true;
 }
 
@@ -543,9 +702,11 @@ DLLEXPORT void GameWorld::SetPlayerReceiveWorld(std::shared_ptr<ConnectedPlayer>
 
     {
         // Start world receive information
-        ply->GetConnection()->SendPacketToConnection(
-            std::make_shared<ResponseStartWorldReceive>(0, ID, WorldType),
-            RECEIVE_GUARANTEE::Critical);
+        auto response = std::make_shared<ResponseStartWorldReceive>(0, ID, WorldType);
+
+        SendOrQueue([connection = ply->GetConnection(), response]() {
+            connection->SendPacketToConnection(response, RECEIVE_GUARANTEE::Critical);
+        });
     }
 
     // Update the position data //
@@ -617,7 +778,7 @@ DLLEXPORT void GameWorld::SetPlayerReceiveWorld(std::shared_ptr<ConnectedPlayer>
 }
 
 DLLEXPORT void GameWorld::SendToAllPlayers(
-    const std::shared_ptr<NetworkResponse>& response, RECEIVE_GUARANTEE guarantee) const
+    const std::shared_ptr<NetworkResponse>& response, RECEIVE_GUARANTEE guarantee)
 {
     // Notify everybody that an entity has been destroyed //
     for(auto iter = ReceivingPlayers.begin(); iter != ReceivingPlayers.end(); ++iter) {
@@ -629,9 +790,21 @@ DLLEXPORT void GameWorld::SendToAllPlayers(
             continue;
         }
 
-        safe->SendPacketToConnection(response, guarantee);
+        SendOrQueue([safe, response, guarantee]() {
+            safe->SendPacketToConnection(response, guarantee);
+        });
     }
 }
+
+DLLEXPORT void GameWorld::SendOrQueue(std::function<void()> send)
+{
+    if(TickingInParallel) {
+        QueuedSends.push_back(std::move(send));
+        return;
+    }
+
+    send();
+}
 // ------------------------------------ //
 DLLEXPORT void GameWorld::CaptureEntityState(ObjectID id, EntityState& curstate) const {}
 
@@ -640,6 +813,289 @@ DLLEXPORT uint32_t GameWorld::CaptureEntityStaticState(ObjectID id, sf::Packet&
     return 0;
 }
 
+DLLEXPORT uint32_t GameWorld::CaptureEntitySnapshotState(
+    ObjectID id, sf::Packet& receiver) const
+{
+    return 0;
+}
+// ------------------------------------ //
+DLLEXPORT bool GameWorld::SaveSnapshot(std::ostream& output)
+{
+    WorldSnapshotWriter writer(output);
+
+    // Reused for all entities as the component count needs to be written before the data
+    sf::Packet componentData;
+
+    for(ObjectID id : Entities) {
+
+        componentData.clear();
+        const uint32_t componentCount = CaptureEntitySnapshotState(id, componentData);
+
+        uint32_t scriptComponentCount = 0;
+
+        for(const auto& [name, holder] : pimpl->RegisteredScriptComponents) {
+            if(holder->FindDirect(id))
+                ++scriptComponentCount;
+        }
+
+        sf::Packet& item = writer.BeginItem(WORLD_SNAPSHOT_CHUNK::Entities);
+        item << id << componentCount;
+        item.append(componentData.getData(), componentData.getDataSize());
+        item << scriptComponentCount;
+
+        for(const auto& [name, holder] : pimpl->RegisteredScriptComponents) {
+
+            if(!holder->FindDirect(id))
+                continue;
+
+            item << name;
+            holder->Serialize(id, item);
+        }
+
+        writer.EndItem();
+    }
+
+    for(const auto& [parent, child] : Parents) {
+
+        writer.BeginItem(WORLD_SNAPSHOT_CHUNK::Parents) << parent << child;
+        writer.EndItem();
+    }
+
+    if(!_PhysicalWorld)
+        return writer.Finish();
+
+    // Bodies sharing a shape share it also after loading
+    std::unordered_map<const PhysicsShape*, uint32_t> shapeNumbers;
+
+    for(ObjectID id : Entities) {
+
+        Physics* physics = GetComponentPtr<Physics>(id);
+
+        if(!physics || !physics->GetBody() || !physics->GetBody()->GetShape())
+            continue;
+
+        const PhysicsShape* shape = physics->GetBody()->GetShape();
+
+        if(shapeNumbers.find(shape) != shapeNumbers.end())
+            continue;
+
+        sf::Packet& item = writer.BeginItem(WORLD_SNAPSHOT_CHUNK::PhysicsShapes);
+
+        if(!_PhysicalWorld->SerializeShape(*shape, item)) {
+            LOG_ERROR("GameWorld: SaveSnapshot: can't save the physics shape of entity: " +
+                      std::to_string(id));
+            return false;
+        }
+
+        writer.EndItem();
+
+        const uint32_t number = static_cast<uint32_t>(shapeNumbers.size());
+        shapeNumbers[shape] = number;
+    }
+
+    PhysicsBodyState state;
+    PhysicsBodyProperties properties;
+
+    for(ObjectID id : Entities) {
+
+        Physics* physics = GetComponentPtr<Physics>(id);
+
+        if(!physics || !physics->GetBody() || !physics->GetBody()->GetShape())
+            continue;
+
+        PhysicsBody& body = *physics->GetBody();
+
+        std::string material;
+
+        if(body.GetPhysicalMaterialID() != -1 && PhysicsMaterials) {
+
+            const auto* found = PhysicsMaterials->GetMaterial(body.GetPhysicalMaterialID());
+
+            if(found)
+                material = found->GetName();
+        }
+
+        body.GetProperties(properties);
+        body.GetState(state);
+
+        writer.BeginItem(WORLD_SNAPSHOT_CHUNK::PhysicsBodies)
+            << id << shapeNumbers[body.GetShape()] << body.GetMass() << material
+            << properties.LinearDamping << properties.AngularDamping << properties.Friction
+            << properties.LinearFactor << properties.AngularFactor << state.Position
+            << state.Orientation << state.LinearVelocity << state.AngularVelocity
+            << state.DeactivationTime << state.ActivationState;
+        writer.EndItem();
+    }
+
+    return writer.Finish();
+}
+
+DLLEXPORT bool GameWorld::LoadSnapshotChunk(WorldSnapshotReader& reader)
+{
+    if(!reader.ReadChunk())
+        return false;
+
+    sf::Packet& data = reader.GetChunkData();
+    const auto itemCount = reader.GetChunkItemCount();
+
+    switch(reader.GetChunkType()) {
+    case WORLD_SNAPSHOT_CHUNK::Entities: {
+
+        for(uint32_t i = 0; i < itemCount; ++i) {
+
+            ObjectID saved;
+            uint32_t componentCount;
+            data >> saved >> componentCount;
+
+            if(!data || componentCount > 1000)
+                return reader.SetFailed("invalid entity in chunk");
+
+            const auto id = CreateEntity();
+            reader.SetLoadedEntity(saved, id);
+
+            try {
+                _CreateComponentsFromSnapshot(id, data, componentCount, -1);
+            } catch(const InvalidArgument& e) {
+
+                e.PrintToLog();
+                DestroyEntity(id);
+                return reader.SetFailed("creating components of entity failed");
+            }
+
+            uint32_t scriptComponentCount;
+            data >> scriptComponentCount;
+
+            // The rest of the chunk can't be read if the components weren't fully read //
+            if(!data || scriptComponentCount > 1000)
+                return reader.SetFailed("component data ended too soon");
+
+            std::string name;
+
+            for(uint32_t component = 0; component < scriptComponentCount; ++component) {
+
+                data >> name;
+
+                const auto holder = pimpl->RegisteredScriptComponents.find(name);
+
+                if(!data || holder == pimpl->RegisteredScriptComponents.end())
+                    return reader.SetFailed("unknown script component type: " + name);
+
+                if(!holder->second->CreateFromSerialized(id, data))
+                    return reader.SetFailed("invalid script component: " + name);
+            }
+        }
+
+        break;
+    }
+    case WORLD_SNAPSHOT_CHUNK::Parents: {
+
+        for(uint32_t i = 0; i < itemCount; ++i) {
+
+            ObjectID parent;
+            ObjectID child;
+            data >> parent >> child;
+
+            if(!data)
+                return reader.SetFailed("parent chunk ended too soon");
+
+            parent = reader.GetLoadedEntity(parent);
+            child = reader.GetLoadedEntity(child);
+
+            if(parent != NULL_OBJECT && child != NULL_OBJECT)
+                SetEntitysParent(child, parent);
+        }
+
+        break;
+    }
+    case WORLD_SNAPSHOT_CHUNK::PhysicsShapes: {
+
+        if(!_PhysicalWorld)
+            return reader.SetFailed("world has no physics");
+
+        for(uint32_t i = 0; i < itemCount; ++i) {
+
+            auto shape = _PhysicalWorld->DeserializeShape(data);
+
+            if(!shape)
+                return reader.SetFailed("invalid physics shape");
+
+            reader.AddLoadedShape(shape);
+        }
+
+        break;
+    }
+    case WORLD_SNAPSHOT_CHUNK::PhysicsBodies: {
+
+        if(!_PhysicalWorld)
+            return reader.SetFailed("world has no physics");
+
+        uint32_t shapeNumber;
+        float mass;
+        std::string material;
+        PhysicsBodyState state;
+        PhysicsBodyProperties properties;
+
+        for(uint32_t i = 0; i < itemCount; ++i) {
+
+            ObjectID saved;
+            data >> saved >> shapeNumber >> mass >> material >> properties.LinearDamping >>
+                properties.AngularDamping >> properties.Friction >>
+                properties.LinearFactor >> properties.AngularFactor >> state.Position >>
+                state.Orientation >> state.LinearVelocity >> state.AngularVelocity >>
+                state.DeactivationTime >> state.ActivationState;
+
+            if(!data)
+                return reader.SetFailed("physics chunk ended too soon");
+
+            const auto shape = reader.GetLoadedShape(shapeNumber);
+
+            if(!shape)
+                return reader.SetFailed("physics body has an invalid shape");
+
+            const auto id = reader.GetLoadedEntity(saved);
+            Physics* physics = id != NULL_OBJECT ? GetComponentPtr<Physics>(id) : nullptr;
+
+            if(!physics)
+                continue;
+
+            if(!physics->GetBody()) {
+
+                const int materialID = material.empty() ? -1 : GetPhysicalMaterial(material);
+
+                if(!material.empty() && materialID == -1) {
+                    LOG_WARNING("GameWorld: LoadSnapshotChunk: physical material doesn't "
+                                "exist in this world: " +
+                                material);
+                }
+
+                if(!physics->CreatePhysicsBody(_PhysicalWorld.get(), shape, mass, materialID))
+                    return reader.SetFailed("creating physics body failed");
+            }
+
+            physics->GetBody()->ApplyProperties(properties);
+            physics->GetBody()->ApplyState(state);
+        }
+
+        break;
+    }
+    case WORLD_SNAPSHOT_CHUNK::End:
+        break;
+    }
+
+    return true;
+}
+
+DLLEXPORT bool GameWorld::LoadSnapshot(std::istream& input)
+{
+    WorldSnapshotReader reader(input);
+
+    while(LoadSnapshotChunk(reader)) {
+        // Each call loads one chunk //
+    }
+
+    return !reader.HasFailed();
+}
+
 DLLEXPORT void GameWorld::_CreateComponentsFromCreationMessage(
     ObjectID id, sf::Packet& data, int entriesleft, int decodedtype)
 {
@@ -650,6 +1106,16 @@ DLLEXPORT void GameWorld::_CreateComponentsFromCreationMessage(
               "GameWorld implementation. Received entity won't be fully constructed");
 }
 
+DLLEXPORT void GameWorld::_CreateComponentsFromSnapshot(
+    ObjectID id, sf::Packet& data, int entriesleft, int decodedtype)
+{
+    if(entriesleft < 1)
+        return;
+
+    throw InvalidArgument(
+        "unknown component type in snapshot: " + std::to_string(decodedtype));
+}
+
 DLLEXPORT void GameWorld::_CreateStatesFromUpdateMessage(
     ObjectID id, int32_t ticknumber, sf::Packet& data, int32_t referencetick, int decodedtype)
 {
@@ -672,10 +1138,25 @@ DLLEXPORT void GameWorld::Tick(int currenttick)
 
     TickNumber = currenttick;
 
+    // Only checked when profiling //
+    auto phaseStart = TickTimings ? WantedClockType::now() : WantedClockType::time_point();
+
+    const auto endPhase = [&](int64_t WorldTickTimings::*phase) {
+        if(!TickTimings)
+            return;
+
+        const auto now = WantedClockType::now();
+        TickTimings->*phase =
+            std::chrono::duration_cast<MicrosecondDuration>(now - phaseStart).count();
+        phaseStart = now;
+    };
+
     // Apply queued packets //
     ApplyQueuedPackets();
+    endPhase(&WorldTickTimings::Packets);
 
     _HandleDelayedDelete();
+    endPhase(&WorldTickTimings::Deletes);
 
     // All required nodes for entities are created //
     HandleAddedAndDeleted();
@@ -697,6 +1178,8 @@ DLLEXPORT void GameWorld::Tick(int currenttick)
         }
     }
 
+    endPhase(&WorldTickTimings::NodeCreation);
+
     // Set this to disallow deleting while running physics as well
     TickInProgress = true;
 
@@ -707,16 +1190,23 @@ DLLEXPORT void GameWorld::Tick(int currenttick)
         // if(IsOnServer) {
 
         // _ApplyEntityUpdatePackets();
-        if(_PhysicalWorld)
+        if(_PhysicalWorld) {
             _PhysicalWorld->SimulateWorld(TICKSPEED / 1000.f);
 
+            if(!NetworkSettings.IsAuthoritative && !OurActiveLocalControl.empty())
+                pimpl->LocalControlPhysicsHistory.Record(*_PhysicalWorld, TickNumber);
+        }
+
         // } else {
 
         // Simulate direct control //
         // }
     }
 
+    endPhase(&WorldTickTimings::Physics);
+
     _RunTickSystems();
+    endPhase(&WorldTickTimings::Systems);
 
     TickInProgress = false;
 
@@ -738,6 +1228,127 @@ DLLEXPORT void GameWorld::Tick(int currenttick)
         // TODO: direct control objects
         // _ReceivedSystem.Run(ComponentReceived.GetIndex(), *this);
     }
+
+    endPhase(&WorldTickTimings::Send);
+}
+
+DLLEXPORT void GameWorld::TickWorlds(
+    const std::vector<std::shared_ptr<GameWorld>>& worlds, int currenttick)
+{
+    ThreadingManager* threads = ThreadingManager::Get();
+
+    std::vector<GameWorld*> parallelWorlds;
+
+    if(threads) {
+        for(const auto& world : worlds) {
+            if(world->TickInParallel && world->_CanTickInParallel())
+                parallelWorlds.push_back(world.get());
+        }
+
+        // Nothing to run at the same time with //
+        if(parallelWorlds.size() < 2)
+            parallelWorlds.clear();
+    }
+
+    // Other worlds are ticked normally first to keep them from seeing the parallel worlds in
+    // the middle of a tick //
+    for(const auto& world : worlds) {
+
+        if(std::find(parallelWorlds.begin(), parallelWorlds.end(), world.get()) ==
+            parallelWorlds.end())
+            world->Tick(currenttick);
+    }
+
+    if(parallelWorlds.empty())
+        return;
+
+    std::vector<std::future<void>> parallelTicks;
+    parallelTicks.reserve(parallelWorlds.size() - 1);
+
+    for(GameWorld* world : parallelWorlds) {
+
+        // Rendering resources are shared by the whole engine //
+        LEVIATHAN_ASSERT(!world->GraphicalMode,
+            "GameWorld: TickWorlds: graphical world is ticked in parallel");
+
+        world->TickingInParallel = true;
+    }
+
+    // The first world is ticked on this thread while the workers handle the rest //
+    for(size_t i = 1; i < parallelWorlds.size(); ++i) {
+
+        GameWorld* world = parallelWorlds[i];
+        auto done = std::make_shared<std::promise<void>>();
+        parallelTicks.push_back(done->get_future());
+
+        threads->QueueTask(std::make_shared<QueuedTask>([world, currenttick, done]() {
+            ParallelTickSetter parallelTick;
+
+            try {
+                world->Tick(currenttick);
+                done->set_value();
+            } catch(...) {
+                done->set_exception(std::current_exception());
+            }
+        }));
+    }
+
+    std::exception_ptr exception;
+
+    {
+        ParallelTickSetter parallelTick;
+
+        try {
+            parallelWorlds.front()->Tick(currenttick);
+        } catch(...) {
+            exception = std::current_exception();
+        }
+    }
+
+    // All worlds must be done before continuing, even if one failed //
+    for(auto& tick : parallelTicks) {
+        try {
+            tick.get();
+        } catch(...) {
+            if(!exception)
+                exception = std::current_exception();
+        }
+    }
+
+    // Connection isn't thread safe so the packets from the parallel ticks are sent here //
+    for(GameWorld* world : parallelWorlds) {
+
+        world->TickingInParallel = false;
+
+        for(const auto& send : world->QueuedSends)
+            send();
+
+        world->QueuedSends.clear();
+    }
+
+    if(exception)
+        std::rethrow_exception(exception);
+}
+
+DLLEXPORT bool GameWorld::IsParallelTickOnThisThread()
+{
+    return ParallelTickOnThisThread;
+}
+
+bool GameWorld::_CanTickInParallel() const
+{
+    if(!pimpl)
+        return true;
+
+    // The script module and its globals are shared by all worlds //
+    for(auto iter = pimpl->RegisteredScriptSystems.begin();
+        iter != pimpl->RegisteredScriptSystems.end(); ++iter) {
+
+        if(!iter->second->IsThreadSafe())
+            return false;
+    }
+
+    return true;
 }
 // ------------------------------------ //
 DLLEXPORT void GameWorld::HandleAddedAndDeleted()
@@ -800,12 +1411,55 @@ DLLEXPORT void GameWorld::RunFrameRenderSystems(int tick, int timeintick)
 
 DLLEXPORT void GameWorld::_RunTickSystems()
 {
+    // Thread safe script systems are ran on the worker threads after the rest have ran here.
+    // Systems that aren't thread safe never run at the same time as any other system //
+    // When the world is ticked in parallel the other worlds are already using the worker
+    // threads and waiting on them here could stall them all. TickWorlds only does that when
+    // all of the script systems are thread safe //
+    ThreadingManager* threads = TickingInParallel ? nullptr : ThreadingManager::Get();
+    std::shared_ptr<ParallelScriptSystemRuns> parallelRuns;
+
+    if(threads) {
+
+        std::vector<ScriptSystemWrapper*> threadSafe;
+
+        for(auto iter = pimpl->RegisteredScriptSystems.begin();
+            iter != pimpl->RegisteredScriptSystems.end(); ++iter) {
+
+            if(iter->second->IsThreadSafe())
+                threadSafe.push_back(iter->second.get());
+        }
+
+        // A single system is just ran here with the others //
+        if(threadSafe.size() > 1)
+            parallelRuns = std::make_shared<ParallelScriptSystemRuns>(std::move(threadSafe));
+    }
+
     // We are responsible for script systems //
     for(auto iter = pimpl->RegisteredScriptSystems.begin();
         iter != pimpl->RegisteredScriptSystems.end(); ++iter) {
 
+        if(parallelRuns && iter->second->IsThreadSafe())
+            continue;
+
         iter->second->Run();
     }
+
+    if(parallelRuns) {
+
+        // This thread also runs them so one less worker is needed //
+        const auto workers = std::min(parallelRuns->Systems.size() - 1,
+            static_cast<size_t>(std::max(threads->GetThreadCount(), 0)));
+
+        for(size_t i = 0; i < workers; ++i) {
+            threads->QueueTask(std::make_shared<QueuedTask>(
+                [parallelRuns]() { parallelRuns->RunRemaining(); }));
+        }
+
+        // Anything that the workers haven't gotten to yet is ran here //
+        parallelRuns->RunRemaining();
+        parallelRuns->WaitForAll();
+    }
 }
 // ------------------------------------ //
 DLLEXPORT float GameWorld::GetTickProgress() const
@@ -835,41 +1489,34 @@ DLLEXPORT std::tuple<int, int> GameWorld::GetTickAndTime() const
 // ------------------ Object managing ------------------ //
 DLLEXPORT ObjectID GameWorld::CreateEntity()
 {
-    if(!GetNetworkSettings().IsAuthoritative) {
-        // Clients create high number entities. This is not optimal but good enough for now
-        auto id = (1 << 31) | static_cast<ObjectID>(IDFactory::GetID());
-
-        Entities.push_back(id);
-
-        return id;
+    // Clients have the local flag set in the IDs //
+    const auto id = EntityIDs.Allocate();
 
-    } else {
-        auto id = static_cast<ObjectID>(IDFactory::GetID());
-
-        Entities.push_back(id);
+    Entities.push_back(id);
 
-        if(NetworkSettings.IsAuthoritative) {
-            // NewlyCreatedEntities.push_back(id);
+    if(NetworkSettings.IsAuthoritative) {
+        // NewlyCreatedEntities.push_back(id);
 
-            if(NetworkSettings.AutoCreateNetworkComponents) {
-                _CreateSendableComponentForEntity(id);
-            }
+        if(NetworkSettings.AutoCreateNetworkComponents) {
+            _CreateSendableComponentForEntity(id);
         }
-
-        return id;
     }
+
+    return id;
 }
 // ------------------------------------ //
 DLLEXPORT void GameWorld::ClearEntities()
 {
     // Release objects //
     Entities.clear();
+    EntityIDs.Clear();
     Parents.clear();
     // This shouldn't be used all that much so release the memory
     Parents.shrink_to_fit();
 
     // Clear all nodes //
     _ResetSystems();
+    pimpl->EntityPositions.Clear();
 
     // Clears all components
     // Runs Release on components that need it
@@ -935,8 +1582,8 @@ DLLEXPORT void GameWorld::QueueDestroyEntity(ObjectID id)
     if(id == NULL_OBJECT)
         throw InvalidArgument("Cannot destroy NULL_OBJECT");
 
-    // This is a sanity check, can be disabled (or made cheaper when the world no longer uses
-    // IDFactory) when crashing stops
+    // This is a sanity check, can be disabled (or made cheaper with EntityIDs once the
+    // entities received from the server are also tracked there) when crashing stops
     bool exists = false;
 
     for(auto existingId : Entities) {
@@ -1028,6 +1675,9 @@ void GameWorld::_DoDestroy(ObjectID id)
     // TODO: find a better way to do this
     DestroyAllIn(id);
 
+    // Entities received from the server aren't from EntityIDs and are ignored by this //
+    EntityIDs.Release(id);
+
     // Parent destroy children //
     // We need to support recursively parented entities
     for(size_t i = 0; i < Parents.size();) {
@@ -1075,6 +1725,12 @@ DLLEXPORT std::tuple<void*, ComponentTypeInfo, bool> GameWorld::GetComponentWith
     return std::make_tuple(nullptr, ComponentTypeInfo(-1, -1), false);
 }
 
+DLLEXPORT const ComponentTypeAccess* GameWorld::GetComponentTypeAccess(
+    COMPONENT_TYPE type) const
+{
+    return nullptr;
+}
+
 DLLEXPORT std::tuple<void*, bool> GameWorld::GetStatesFor(COMPONENT_TYPE type)
 {
     return std::make_tuple(nullptr, false);
@@ -1345,7 +2001,18 @@ DLLEXPORT void GameWorld::HandleEntityPacket(
 
         if(entity == message.EntityID) {
 
-            // TODO: apply corrections if our simulation was incorrect / not allowed
+            // The server state is the correct one, our prediction is fixed to match it
+            try {
+                _ApplyLocalControlUpdateMessage(message.EntityID, message.TickNumber,
+                    message.UpdateData, message.ReferenceTick, -1);
+            } catch(const InvalidArgument& e) {
+                LOG_ERROR("GameWorld: HandleEntityPacket: trying to load local control "
+                          "correction data caused an exception: ");
+                e.PrintToLog();
+                return;
+            }
+
+            _OnLocalControlCorrected(message.EntityID, message.TickNumber);
             return;
         }
     }
@@ -1485,7 +2152,9 @@ DLLEXPORT void GameWorld::SetLocalControl(
     // Notify
     auto response = std::make_shared<ResponseEntityLocalControlStatus>(0, ID, id, enabled);
 
-    allowedconnection->SendPacketToConnection(response, RECEIVE_GUARANTEE::Critical);
+    SendOrQueue([allowedconnection, response]() {
+        allowedconnection->SendPacketToConnection(response, RECEIVE_GUARANTEE::Critical);
+    });
 }
 
 DLLEXPORT void GameWorld::_OnLocalControlUpdatedEntity(ObjectID id, int32_t ticknumber)
@@ -1501,6 +2170,52 @@ DLLEXPORT void GameWorld::_OnLocalControlUpdatedEntity(ObjectID id, int32_t tick
         }
     }
 }
+
+DLLEXPORT void GameWorld::_OnLocalControlCorrected(ObjectID id, int32_t ticknumber)
+{
+    Position* position = GetComponentPtr<Position>(id);
+    Physics* physics = GetComponentPtr<Physics>(id);
+
+    if(!position || !physics || !physics->GetBody() || !_PhysicalWorld)
+        return;
+
+    // Not applied if it wasn't the newest state //
+    if(!position->Marked)
+        return;
+
+    PhysicsBody& body = *physics->GetBody();
+    PhysicsHistory& history = pimpl->LocalControlPhysicsHistory;
+    PhysicsSnapshot* snapshot = history.Find(ticknumber);
+
+    if(!snapshot || ticknumber >= TickNumber) {
+
+        // Too old to resimulate (or not in the past), just snap to the received state
+        physics->JumpTo(*position);
+        return;
+    }
+
+    // Go back to the corrected tick keeping the received position. Restoring moves the
+    // position component so the received values are copied first
+    const Float3 receivedPosition = position->Members._Position;
+    const Float4 receivedOrientation = position->Members._Orientation;
+
+    snapshot->RestoreBody(body);
+
+    position->Members._Position = receivedPosition;
+    position->Members._Orientation = receivedOrientation;
+    physics->JumpTo(*position);
+    snapshot->UpdateBody(body);
+
+    // And simulate the ticks after it again. The later snapshots are fixed so that further
+    // corrections start from the corrected prediction
+    _PhysicalWorld->ResimulateBodies({&body}, *snapshot, TickNumber - ticknumber,
+        TICKSPEED / 1000.f, [&](int step) {
+            PhysicsSnapshot* later = history.Find(ticknumber + step + 1);
+
+            if(later)
+                later->UpdateBody(body);
+        });
+}
 // ------------------------------------ //
 DLLEXPORT void GameWorld::ApplyQueuedPackets()
 {
@@ -1718,6 +2433,12 @@ DLLEXPORT bool GameWorld::RegisterScriptSystem(
 
     // Might as well call Init now as other systems are almost certainly initialized as well //
     pimpl->RegisteredScriptSystems[name]->Init(this);
+
+    if(TickInParallel && !pimpl->RegisteredScriptSystems[name]->IsThreadSafe()) {
+        LOG_WARNING("GameWorld: RegisterScriptSystem: system \"" + name +
+                    "\" isn't thread safe, this world won't be ticked in parallel");
+    }
+
     return true;
 }
 
@@ -1824,6 +2545,18 @@ DLLEXPORT void GameWorld::SetRunInBackground(bool tickinbackground)
     TickWhileInBackground = tickinbackground;
 }
 
+DLLEXPORT void GameWorld::SetTickInParallel(bool parallel)
+{
+    if(parallel && GraphicalMode) {
+
+        LOG_ERROR("GameWorld: SetTickInParallel: graphical worlds can't be ticked in "
+                  "parallel");
+        return;
+    }
+
+    TickInParallel = parallel;
+}
+
 // // ------------------ RayCastHitEntity ------------------ //
 // DLLEXPORT Leviathan::RayCastHitEntity::RayCastHitEntity(
 //     const NewtonBody* ptr /*= nullptr*/, const float& tvar, RayCastData* ownerptr) :
@@ -6,12 +6,16 @@
 #include "Common/ReferenceCounted.h"
 #include "Common/ThreadSafe.h"
 #include "Component.h"
+#include "EntityIDAllocator.h"
 #include "Networking/CommonNetwork.h"
 #include "WorldNetworkSettings.h"
 
 // #include <type_traits>
 #include "bsfCore/BsCorePrerequisites.h"
 
+#include <functional>
+#include <iosfwd>
+
 class CScriptArray;
 class asIScriptObject;
 class asIScriptFunction;
@@ -21,7 +25,10 @@ namespace Leviathan {
 
 class Camera;
 class PhysicalWorld;
+struct ComponentTypeAccess;
 class ScriptComponentHolder;
+class SpatialIndex;
+class WorldSnapshotReader;
 class ResponseEntityCreation;
 class ResponseEntityDestruction;
 class ResponseEntityUpdate;
@@ -43,6 +50,18 @@ struct ComponentTypeInfo {
 };
 
 
+//! \brief Microseconds spent in each phase of GameWorld::Tick
+//! \see GameWorld::SetTickTimingsTarget
+struct WorldTickTimings {
+
+    int64_t Packets = 0;
+    int64_t Deletes = 0;
+    int64_t NodeCreation = 0;
+    int64_t Physics = 0;
+    int64_t Systems = 0;
+    int64_t Send = 0;
+};
+
 #define WORLD_CLOCK_SYNC_PACKETS 12
 #define WORLD_CLOCK_SYNC_ALLOW_FAILS 2
 #define WORLD_OBJECT_UPDATE_CLIENTS_INTERVAL 2
@@ -134,6 +153,61 @@ public:
     //! events that need to happen at certain game world times this is ideal
     DLLEXPORT void Tick(int currenttick);
 
+    //! \brief Ticks all worlds in worlds. The worlds that allow ticking in parallel are ticked
+    //! at the same time on the worker threads
+    //!
+    //! This returns only after all of the worlds have finished ticking, so anything that
+    //! parallel ticks deferred (queued events and invokes) can be handled after this
+    //! \see SetTickInParallel
+    DLLEXPORT static void TickWorlds(
+        const std::vector<std::shared_ptr<GameWorld>>& worlds, int currenttick);
+
+    //! \brief Makes Tick store how long each of its phases took in target
+    //!
+    //! Used for profiling and benchmarks. Pass nullptr to stop
+    DLLEXPORT inline void SetTickTimingsTarget(WorldTickTimings* target)
+    {
+        TickTimings = target;
+    }
+
+    //! \brief Allows ticking this world at the same time as other worlds
+    //!
+    //! Only set this on worlds that share no entities, physics or other mutable state with
+    //! other worlds. While ticking in parallel the world (and its systems and physics
+    //! callbacks) may only use these engine wide things: IDFactory, EventHandler::QueueEvent
+    //! and Engine::Invoke. Sending events directly, creating or destroying worlds and
+    //! anything else that locks the Engine are not allowed. Packets need to be sent with
+    //! SendOrQueue
+    //! \note Graphical worlds can't be ticked in parallel as rendering resources are engine
+    //! wide. Enabling this on one is ignored
+    //! \note Worlds with script systems that aren't thread safe are ticked normally as the
+    //! script module is shared by all worlds
+    DLLEXPORT void SetTickInParallel(bool parallel);
+
+    DLLEXPORT inline bool GetTickInParallel() const
+    {
+        return TickInParallel;
+    }
+
+    //! \returns True while Tick is running at the same time as other worlds are ticked
+    DLLEXPORT inline bool IsTickingInParallel() const
+    {
+        return TickingInParallel;
+    }
+
+    //! \returns True if the calling thread is ticking a world at the same time as other
+    //! worlds are ticked. Used to catch parallel ticks touching engine wide state
+    DLLEXPORT static bool IsParallelTickOnThisThread();
+
+    //! \brief Makes the physics of this world use the ThreadingManager worker threads
+    //!
+    //! Helps with worlds that have thousands of bodies. Must be called before Init
+    //! \see PhysicalWorld::PhysicalWorld
+    DLLEXPORT inline void SetMultithreadedPhysics(bool multithreaded)
+    {
+        MultithreadedPhysics = multithreaded;
+    }
+
     //! \brief Runs systems required for a rendering run. Also updates camera positions
     //! \todo Allow script systems to specify their type
     DLLEXPORT void Render(int mspassed, int tick, int timeintick);
@@ -165,7 +239,10 @@ public:
     // DLLEXPORT RayCastHitEntity* CastRayGetFirstHit(const Float3& from, const Float3& to);
 
     //! \brief Creates a new empty entity and returns its id
-    //! \todo Make this have a per world counter
+    //!
+    //! IDs are allocated per world and the IDs of destroyed entities are reused with a new
+    //! generation. On clients ENTITY_ID_LOCAL_FLAG is set in the created IDs
+    //! \see EntityIDAllocator
     DLLEXPORT ObjectID CreateEntity();
 
     //! \brief Destroys an entity and all of its components
@@ -245,6 +322,14 @@ public:
     DLLEXPORT virtual std::tuple<void*, ComponentTypeInfo, bool> GetComponentWithType(
         ObjectID id, COMPONENT_TYPE type);
 
+    //! \brief Returns functions for directly accessing the components of a type
+    //!
+    //! Meant for code that gets the type at runtime and does many lookups, like script
+    //! systems. The result should be cached instead of calling this for each lookup
+    //! \returns Null if the type isn't known
+    DLLEXPORT virtual const ComponentTypeAccess* GetComponentTypeAccess(
+        COMPONENT_TYPE type) const;
+
     //! Helper for getting component state holder for type. This is much slower than
     //! direct lookups with the actual implementation class' GetStatesFor_Position etc.
     //! methods
@@ -298,6 +383,38 @@ public:
     DLLEXPORT virtual uint32_t CaptureEntityStaticState(
         ObjectID id, sf::Packet& receiver) const;
 
+    //! \brief Captures the types and initial parameters of all components of an entity
+    //!
+    //! Unlike CaptureEntityStaticState this includes the component types that aren't sent
+    //! over the network
+    //! \returns The count of component data entries in receiver
+    DLLEXPORT virtual uint32_t CaptureEntitySnapshotState(
+        ObjectID id, sf::Packet& receiver) const;
+
+    //! \brief Writes all entities, their parents and physics bodies as a snapshot
+    //!
+    //! The components are stored with CaptureEntitySnapshotState and script components with
+    //! ScriptComponentHolder::Serialize. Physics bodies are stored with their shapes, mass,
+    //! material and state so that they can be recreated when loading.
+    //! \returns False if writing to output failed or a physics shape can't be saved
+    //! \see WorldSnapshotWriter
+    DLLEXPORT bool SaveSnapshot(std::ostream& output);
+
+    //! \brief Loads the next chunk of a snapshot into this world
+    //!
+    //! Can be called once per tick to spread out loading a large snapshot. The loaded
+    //! entities get new IDs, WorldSnapshotReader::GetLoadedEntity maps the saved IDs to them.
+    //! The script component types need to be registered before loading. Physics bodies are
+    //! created for the loaded Physics components that don't have one yet.
+    //! \returns False once the whole snapshot has been loaded or if it is invalid, check
+    //! WorldSnapshotReader::HasFailed
+    DLLEXPORT bool LoadSnapshotChunk(WorldSnapshotReader& reader);
+
+    //! \brief Loads all of a snapshot
+    //! \returns False if the snapshot is invalid. The entities loaded before the error was
+    //! found are kept
+    DLLEXPORT bool LoadSnapshot(std::istream& input);
+
     //! \brief Sets the entity that acts as a camera.
     //!
     //! The entity needs at least Position and Camera components
@@ -331,6 +448,12 @@ public:
         return _PhysicalWorld.get();
     }
 
+    //! \brief Returns the index of entity positions for finding entities near a point
+    //!
+    //! Standard worlds update this once per tick from the Position components that have been
+    //! marked as changed
+    DLLEXPORT SpatialIndex& GetSpatialIndex();
+
     //! \returns the unique ID of this world
     DLLEXPORT inline int GetID() const
     {
@@ -359,7 +482,9 @@ public:
 
     //! \brief Returns true when the player matching the connection should receive updates
     //! about an entity
-    //! \todo Implement this
+    //!
+    //! Entities further than WorldNetworkSettings::EntityRelevanceRadius from the entity the
+    //! player controls aren't received. Players without a position receive everything
     DLLEXPORT bool ShouldPlayerReceiveEntity(Position& atposition, Connection& connection);
 
     //! \brief Returns true if a player with the given connection is receiving updates for
@@ -378,7 +503,14 @@ public:
 
     //! \brief Sends a packet to all connected players
     DLLEXPORT void SendToAllPlayers(
-        const std::shared_ptr<NetworkResponse>& response, RECEIVE_GUARANTEE guarantee) const;
+        const std::shared_ptr<NetworkResponse>& response, RECEIVE_GUARANTEE guarantee);
+
+    //! \brief Runs send now or, while this world is ticked in parallel, on the main thread
+    //! after all the worlds have finished ticking
+    //!
+    //! Connection is not thread safe so everything that sends packets from a tick needs to
+    //! go through this
+    DLLEXPORT void SendOrQueue(std::function<void()> send);
 
     //! \brief Sets local control on a client over an entity or disables it
     //!
@@ -526,6 +658,8 @@ protected:
     //! Derived worls should run their systems that need to be ran before the basic systems
     //! and then call this and finally run systems that need to be ran after the base
     //! class' systems (if any)
+    //! \note Script systems that are thread safe are ran in parallel on the worker threads,
+    //! unless this world is ticked in parallel with other worlds
     DLLEXPORT virtual void _RunTickSystems();
 
     //! \brief Handles added entities and components
@@ -573,6 +707,15 @@ protected:
     DLLEXPORT virtual void _CreateComponentsFromCreationMessage(
         ObjectID id, sf::Packet& data, int entriesleft, int decodedtype);
 
+    //! \brief Called to create the components of an entity that is loaded from a snapshot
+    //!
+    //! This is the reverse operation for CaptureEntitySnapshotState
+    //! \param decodedtype This is used to move unrecognized types up to the base class. -1 if
+    //! not fetched yet
+    //! \exception InvalidArgument if not all components could be created
+    DLLEXPORT virtual void _CreateComponentsFromSnapshot(
+        ObjectID id, sf::Packet& data, int entriesleft, int decodedtype);
+
     //! \brief Called to deserialize entity component states from a packet
     //! \param decodedtype This is used to move unrecognized types up to the base class. -1 if
     //! not fetched yet
@@ -595,6 +738,13 @@ protected:
     //! implementation resets the physics position of a moved entity
     DLLEXPORT virtual void _OnLocalControlUpdatedEntity(ObjectID id, int32_t ticknumber);
 
+    //! \brief Called on a client when the server has sent the state of an entity we control
+    //!
+    //! The received state has already been applied. The base implementation rewinds the
+    //! physics body of the entity to ticknumber, moves it to the received position and
+    //! resimulates it up to the current tick. The other bodies aren't resimulated
+    DLLEXPORT virtual void _OnLocalControlCorrected(ObjectID id, int32_t ticknumber);
+
 private:
     //! \brief Updates a players position info in this world
     void UpdatePlayersPositionData(ConnectedPlayer& ply);
@@ -604,6 +754,9 @@ private:
 
     void _HandleDelayedDelete();
 
+    //! \returns False if a registered script system isn't thread safe
+    bool _CanTickInParallel() const;
+
     //! \brief Reports an entity deletion to clients
     void _ReportEntityDestruction(ObjectID id);
 
@@ -678,6 +831,9 @@ private:
     // Entities //
     std::vector<ObjectID> Entities;
 
+    //! Creates the IDs of the entities made with CreateEntity
+    EntityIDAllocator EntityIDs;
+
     // Parented entities, used to destroy children
     // First is the parent, second is child
     std::vector<std::tuple<ObjectID, ObjectID>> Parents;
@@ -711,6 +867,21 @@ private:
     //! If true this will keep running while not attached to a window
     bool TickWhileInBackground = false;
 
+    //! Set with SetTickInParallel
+    bool TickInParallel = false;
+
+    //! True while TickWorlds is ticking this at the same time as other worlds
+    bool TickingInParallel = false;
+
+    //! Sends from a parallel tick. TickWorlds runs these after the barrier
+    std::vector<std::function<void()>> QueuedSends;
+
+    //! Set with SetMultithreadedPhysics
+    bool MultithreadedPhysics = false;
+
+    //! If set the durations of the Tick phases are stored here
+    WorldTickTimings* TickTimings = nullptr;
+
     //! Set by OnLinkToWindow when this is added to a Window
     //! \note This must be added to the same one that Init was called with
     //! \todo Determine if worlds could be linked to a different Window than the
@@ -1,13 +1,110 @@
 // ------------------------------------ //
 #include "ScriptComponentHolder.h"
 
+#include "Common/SFMLPackets.h"
 #include "GameWorld.h"
-#include "Script/ScriptConversionHelpers.h"
 #include "Script/ScriptExecutor.h"
 
-#include <boost/range/adaptor/map.hpp>
+#include "add_on/scriptarray/scriptarray.h"
+
+#include <algorithm>
+#include <cstring>
 using namespace Leviathan;
 // ------------------------------------ //
+namespace {
+//! \brief Property types written by ScriptComponentHolder::Serialize
+enum class SERIALIZED_PROPERTY : uint8_t {
+    Bool = 0,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    Uint8,
+    Uint16,
+    Uint32,
+    Uint64,
+    Float,
+    Double,
+    String,
+    Float2,
+    Float3,
+    Float4
+};
+
+//! \brief Used to pass the types of a property to the callback of VisitPropertyType
+//! \param SerializedT The type used with sf::Packet, the 64 bit types have different names
+template<class T, class SerializedT = T>
+struct PropertyTypeTag {
+    using Type = T;
+    using Serialized = SerializedT;
+};
+
+template<class CallbackT>
+bool VisitPropertyType(SERIALIZED_PROPERTY type, CallbackT&& callback)
+{
+    switch(type) {
+    case SERIALIZED_PROPERTY::Bool: return callback(PropertyTypeTag<bool>());
+    case SERIALIZED_PROPERTY::Int8: return callback(PropertyTypeTag<int8_t>());
+    case SERIALIZED_PROPERTY::Int16: return callback(PropertyTypeTag<int16_t>());
+    case SERIALIZED_PROPERTY::Int32: return callback(PropertyTypeTag<int32_t>());
+    case SERIALIZED_PROPERTY::Int64: return callback(PropertyTypeTag<int64_t, sf::Int64>());
+    case SERIALIZED_PROPERTY::Uint8: return callback(PropertyTypeTag<uint8_t>());
+    case SERIALIZED_PROPERTY::Uint16: return callback(PropertyTypeTag<uint16_t>());
+    case SERIALIZED_PROPERTY::Uint32: return callback(PropertyTypeTag<uint32_t>());
+    case SERIALIZED_PROPERTY::Uint64: return callback(PropertyTypeTag<uint64_t, sf::Uint64>());
+    case SERIALIZED_PROPERTY::Float: return callback(PropertyTypeTag<float>());
+    case SERIALIZED_PROPERTY::Double: return callback(PropertyTypeTag<double>());
+    case SERIALIZED_PROPERTY::String: return callback(PropertyTypeTag<std::string>());
+    case SERIALIZED_PROPERTY::Float2: return callback(PropertyTypeTag<Float2>());
+    case SERIALIZED_PROPERTY::Float3: return callback(PropertyTypeTag<Float3>());
+    case SERIALIZED_PROPERTY::Float4: return callback(PropertyTypeTag<Float4>());
+    }
+
+    return false;
+}
+
+//! \returns False if properties of the type aren't saved
+bool GetSerializedPropertyType(asIScriptEngine* engine, int typeID, SERIALIZED_PROPERTY& type)
+{
+    switch(typeID) {
+    case asTYPEID_BOOL: type = SERIALIZED_PROPERTY::Bool; return true;
+    case asTYPEID_INT8: type = SERIALIZED_PROPERTY::Int8; return true;
+    case asTYPEID_INT16: type = SERIALIZED_PROPERTY::Int16; return true;
+    case asTYPEID_INT32: type = SERIALIZED_PROPERTY::Int32; return true;
+    case asTYPEID_INT64: type = SERIALIZED_PROPERTY::Int64; return true;
+    case asTYPEID_UINT8: type = SERIALIZED_PROPERTY::Uint8; return true;
+    case asTYPEID_UINT16: type = SERIALIZED_PROPERTY::Uint16; return true;
+    case asTYPEID_UINT32: type = SERIALIZED_PROPERTY::Uint32; return true;
+    case asTYPEID_UINT64: type = SERIALIZED_PROPERTY::Uint64; return true;
+    case asTYPEID_FLOAT: type = SERIALIZED_PROPERTY::Float; return true;
+    case asTYPEID_DOUBLE: type = SERIALIZED_PROPERTY::Double; return true;
+    }
+
+    auto* exec = static_cast<ScriptExecutor*>(engine->GetUserData());
+
+    if(typeID == AngelScriptTypeIDResolver<std::string>::Get(exec)) {
+        type = SERIALIZED_PROPERTY::String;
+    } else if(typeID == AngelScriptTypeIDResolver<Float2>::Get(exec)) {
+        type = SERIALIZED_PROPERTY::Float2;
+    } else if(typeID == AngelScriptTypeIDResolver<Float3>::Get(exec)) {
+        type = SERIALIZED_PROPERTY::Float3;
+    } else if(typeID == AngelScriptTypeIDResolver<Float4>::Get(exec)) {
+        type = SERIALIZED_PROPERTY::Float4;
+    } else {
+
+        // Enums are stored as their value
+        asITypeInfo* info = engine->GetTypeInfoById(typeID);
+
+        if(!info || !(info->GetFlags() & asOBJ_ENUM))
+            return false;
+
+        type = SERIALIZED_PROPERTY::Int32;
+    }
+
+    return true;
+}
+} // namespace
+// ------------------------------------ //
 
 DLLEXPORT ScriptComponentHolder::ScriptComponentHolder(
     const std::string& name, asIScriptFunction* factory, GameWorld* world) :
@@ -25,17 +122,20 @@ DLLEXPORT ScriptComponentHolder::~ScriptComponentHolder()
 
     Factory->Release();
 
-    LEVIATHAN_ASSERT(CreatedObjects.empty(), "ScriptComponentHolder didn't properly clear");
+    LEVIATHAN_ASSERT(Components.empty(), "ScriptComponentHolder didn't properly clear");
 }
 // ------------------------------------ //
 DLLEXPORT bool ScriptComponentHolder::ReleaseComponent(ObjectID entity)
 {
-    auto iter = CreatedObjects.find(entity);
+    const auto found = ComponentSlots.find(entity);
 
-    if(iter == CreatedObjects.end())
+    if(found == ComponentSlots.end())
         return false;
 
-    Removed.push_back(std::make_tuple(iter->second, entity));
+    const size_t slot = found->second;
+    asIScriptObject* object = Components[slot];
+
+    Removed.push_back(std::make_tuple(object, entity));
 
     // Remove from added if there //
     for(auto iter = Added.begin(); iter != Added.end(); ++iter) {
@@ -48,24 +148,37 @@ DLLEXPORT bool ScriptComponentHolder::ReleaseComponent(ObjectID entity)
         }
     }
 
+    ComponentSlots.erase(found);
+
+    // Move the last one to the freed slot //
+    if(slot + 1 != Components.size()) {
+
+        Components[slot] = Components.back();
+        ComponentEntities[slot] = ComponentEntities.back();
+        ComponentSlots[ComponentEntities[slot]] = slot;
+    }
+
+    Components.pop_back();
+    ComponentEntities.pop_back();
+
     // TODO: call release on the actual script object to let it do shutdown stuff
     // Release our reference to let the object be destroyed once all references are released
-    iter->second->Release();
-
-    CreatedObjects.erase(iter);
+    object->Release();
 
     return true;
 }
 
 DLLEXPORT void ScriptComponentHolder::ReleaseAllComponents()
 {
-    for(auto iter = CreatedObjects.begin(); iter != CreatedObjects.end(); ++iter) {
+    for(asIScriptObject* object : Components) {
 
         // TODO: also call release here
-        iter->second->Release();
+        object->Release();
     }
 
-    CreatedObjects.clear();
+    Components.clear();
+    ComponentEntities.clear();
+    ComponentSlots.clear();
     Added.clear();
     Removed.clear();
 }
@@ -73,14 +186,10 @@ DLLEXPORT void ScriptComponentHolder::ReleaseAllComponents()
 DLLEXPORT asIScriptObject* ScriptComponentHolder::Create(ObjectID entity)
 {
     // Fail if already exists //
-    asIScriptObject* found = Find(entity);
-    if(found != nullptr) {
+    if(FindDirect(entity) != nullptr) {
 
         LOG_WARNING("ScriptComponentHolder: Create: called for existing component, id: " +
                     std::to_string(entity));
-
-        // Must release reference
-        found->Release();
         return nullptr;
     }
 
@@ -113,7 +222,9 @@ DLLEXPORT asIScriptObject* ScriptComponentHolder::Create(ObjectID entity)
     // Remember that we take a reference to it
     result.Value->AddRef();
 
-    CreatedObjects[entity] = result.Value;
+    ComponentSlots[entity] = Components.size();
+    Components.push_back(result.Value);
+    ComponentEntities.push_back(entity);
 
     // And we return it so increase refcount for that too //
     result.Value->AddRef();
@@ -122,21 +233,147 @@ DLLEXPORT asIScriptObject* ScriptComponentHolder::Create(ObjectID entity)
 
 DLLEXPORT asIScriptObject* ScriptComponentHolder::Find(ObjectID entity)
 {
-    auto iter = CreatedObjects.find(entity);
+    asIScriptObject* object = FindDirect(entity);
 
-    if(iter == CreatedObjects.end())
+    if(!object)
         return nullptr;
 
-    iter->second->AddRef();
-    return iter->second;
+    object->AddRef();
+    return object;
+}
+// ------------------------------------ //
+DLLEXPORT bool ScriptComponentHolder::Serialize(ObjectID entity, sf::Packet& receiver) const
+{
+    asIScriptObject* object = FindDirect(entity);
+
+    if(!object)
+        return false;
+
+    asIScriptEngine* engine = object->GetEngine();
+    const asUINT count = object->GetPropertyCount();
+    SERIALIZED_PROPERTY type;
+
+    // The written properties are counted first as the count is needed before them //
+    uint32_t writtenCount = 0;
+
+    for(asUINT i = 0; i < count; ++i) {
+        if(GetSerializedPropertyType(engine, object->GetPropertyTypeId(i), type))
+            ++writtenCount;
+    }
+
+    receiver << writtenCount;
+
+    for(asUINT i = 0; i < count; ++i) {
+
+        if(!GetSerializedPropertyType(engine, object->GetPropertyTypeId(i), type))
+            continue;
+
+        receiver << object->GetPropertyName(i) << static_cast<uint8_t>(type);
+
+        const void* address = object->GetAddressOfProperty(i);
+
+        VisitPropertyType(type, [&](auto tag) {
+            using Tag = decltype(tag);
+
+            receiver << static_cast<typename Tag::Serialized>(
+                *static_cast<const typename Tag::Type*>(address));
+            return true;
+        });
+    }
+
+    return true;
+}
+
+DLLEXPORT bool ScriptComponentHolder::CreateFromSerialized(ObjectID entity, sf::Packet& data)
+{
+    uint32_t count;
+    data >> count;
+
+    if(!data)
+        return false;
+
+    asIScriptObject* object = Create(entity);
+
+    if(!object)
+        return false;
+
+    asIScriptEngine* engine = object->GetEngine();
+    bool valid = true;
+
+    for(uint32_t i = 0; i < count && valid; ++i) {
+
+        std::string name;
+        uint8_t type;
+        data >> name >> type;
+
+        if(!data || type > static_cast<uint8_t>(SERIALIZED_PROPERTY::Float4)) {
+            valid = false;
+            break;
+        }
+
+        const auto savedType = static_cast<SERIALIZED_PROPERTY>(type);
+
+        // The value is still read when there is no matching property to skip it //
+        void* address = nullptr;
+
+        for(asUINT j = 0; j < object->GetPropertyCount(); ++j) {
+
+            SERIALIZED_PROPERTY currentType;
+
+            if(name == object->GetPropertyName(j) &&
+                GetSerializedPropertyType(engine, object->GetPropertyTypeId(j), currentType) &&
+                currentType == savedType) {
+
+                address = object->GetAddressOfProperty(j);
+                break;
+            }
+        }
+
+        valid = VisitPropertyType(savedType, [&](auto tag) {
+            using Tag = decltype(tag);
+
+            typename Tag::Serialized value;
+            data >> value;
+
+            if(!data)
+                return false;
+
+            if(address)
+                *static_cast<typename Tag::Type*>(address) =
+                    static_cast<typename Tag::Type>(value);
+            return true;
+        });
+    }
+
+    // Create added a reference for us //
+    object->Release();
+    return valid;
 }
 // ------------------------------------ //
 DLLEXPORT CScriptArray* ScriptComponentHolder::GetIndex() const
 {
-    asIScriptContext* ctx = asGetActiveContext();
+    if(!IndexArrayType) {
+
+        IndexArrayType = Factory->GetEngine()->GetTypeInfoByDecl("array<ObjectID>");
+
+        if(!IndexArrayType)
+            throw InvalidState("ScriptComponentHolder: array<ObjectID> type is not registered");
+    }
 
-    asIScriptEngine* engine = ctx ? ctx->GetEngine() : ScriptExecutor::Get()->GetASEngine();
+    CScriptArray* array =
+        CScriptArray::Create(IndexArrayType, static_cast<asUINT>(ComponentEntities.size()));
+
+    if(!array)
+        return nullptr;
+
+    if(!ComponentEntities.empty()) {
+        auto* buffer = static_cast<ObjectID*>(array->GetBuffer());
+        std::memcpy(
+            buffer, ComponentEntities.data(), ComponentEntities.size() * sizeof(ObjectID));
+
+        // The components are stored unordered but scripts expect the index in entity order //
+        std::sort(buffer, buffer + ComponentEntities.size());
+    }
 
-    return ConvertIteratorToASArray((CreatedObjects | boost::adaptors::map_keys).begin(),
-        (CreatedObjects | boost::adaptors::map_keys).end(), engine, "array<ObjectID>");
+    return array;
 }
@@ -5,12 +5,18 @@
 // ------------------------------------ //
 #include "Common/ReferenceCounted.h"
 
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 class asIScriptFunction;
 class asIScriptObject;
+class asITypeInfo;
 class CScriptArray;
 
+namespace sf {
+class Packet;
+}
+
 namespace Leviathan {
 
 //! \brief
@@ -49,6 +55,37 @@ public:
     //! \note Increases refcount on returned object
     DLLEXPORT asIScriptObject* Find(ObjectID entity);
 
+    //! \brief Finds a component for entity without increasing refcount
+    //! \note The returned object is only guaranteed to stay valid until the component is
+    //! released
+    inline asIScriptObject* FindDirect(ObjectID entity) const
+    {
+        const auto iter = ComponentSlots.find(entity);
+        return iter != ComponentSlots.end() ? Components[iter->second] : nullptr;
+    }
+
+    //! \brief Writes the properties of the component of entity for saving it
+    //!
+    //! Only properties that have a primitive, enum, string or Float2-4 type are written. They
+    //! are written with their names so properties can be added and removed between saving and
+    //! loading
+    //! \returns False if entity doesn't have a component of this type
+    DLLEXPORT bool Serialize(ObjectID entity, sf::Packet& receiver) const;
+
+    //! \brief Creates a component for entity and sets its properties from data written by
+    //! Serialize
+    //!
+    //! Saved properties that the component no longer has or that have changed type are
+    //! skipped. Init is not called on the component.
+    //! \returns False if creating the component failed or data is invalid
+    DLLEXPORT bool CreateFromSerialized(ObjectID entity, sf::Packet& data);
+
+    //! \returns The number of created components
+    inline size_t GetComponentCount() const
+    {
+        return Components.size();
+    }
+
     //! \brief Destroys a component of held type for entity
     //! \note This is just a wrapper for ReleaseComponent to be more consistent with c++
     //! component types
@@ -62,7 +99,7 @@ public:
     //! Caller must release reference
     //! \todo Check can we somehow return all the keys and the objects to avoid having to call
     //! Find from scripts after this
-    //! \note This builds a new array object on each call.
+    //! \note This builds a new array object on each call. The entities are in ascending order
     DLLEXPORT CScriptArray* GetIndex() const;
 
 
@@ -99,7 +136,14 @@ private:
     asIScriptFunction* Factory;
     GameWorld* World;
 
-    std::map<ObjectID, asIScriptObject*> CreatedObjects;
+    //! The created objects are stored densely and removed by swapping with the last one.
+    //! ComponentSlots maps entities to the index in these
+    std::vector<ObjectID> ComponentEntities;
+    std::vector<asIScriptObject*> Components;
+    std::unordered_map<ObjectID, size_t> ComponentSlots;
+
+    //! Type of array<ObjectID>, cached for GetIndex
+    mutable asITypeInfo* IndexArrayType = nullptr;
 
     // Need to remember these for compatibility with caching
     std::vector<std::tuple<asIScriptObject*, ObjectID>> Added;
@@ -1,14 +1,422 @@
 // ------------------------------------ //
 #include "ScriptSystemWrapper.h"
 
+#include "ComponentTypeAccess.h"
 #include "GameWorld.h"
-#include "Script/CustomScriptRunHelpers.h"
+#include "Script/PreparedScriptCall.h"
 #include "Script/ScriptExecutor.h"
 #include "ScriptComponentHolder.h"
 
 #include "add_on/scriptarray/scriptarray.h"
+
+#include <unordered_map>
 using namespace Leviathan;
 // ------------------------------------ //
+namespace Leviathan {
+
+//! \brief State of ScriptSystemNodeHelper that is kept between the calls for a single system
+//!
+//! The component types are resolved only once and the nodes in the cached array are indexed
+//! by entity so that only the added and removed components need to be processed each tick
+struct ScriptSystemNodeCache {
+
+    struct UsedComponent {
+
+        //! Set for script components, null if the world doesn't (yet) have the type
+        ScriptComponentHolder* Holder = nullptr;
+
+        //! Set for C++ components, null if the world doesn't have the type
+        const ComponentTypeAccess* Access = nullptr;
+        ComponentTypeInfo CType{static_cast<uint16_t>(-1), -1};
+        bool IsScript = false;
+
+        //! Type of the script component objects that was last checked to match the factory
+        //! parameter. The type of the objects isn't known before they are created
+        int ValidatedScriptType = -1;
+    };
+
+    ScriptSystemNodeCache() = default;
+
+    ~ScriptSystemNodeCache()
+    {
+        ReleaseComponents();
+
+        if(CachedClass)
+            CachedClass->Release();
+    }
+
+    ScriptSystemNodeCache(const ScriptSystemNodeCache& other) = delete;
+    ScriptSystemNodeCache& operator=(const ScriptSystemNodeCache& other) = delete;
+
+    //! \brief Makes sure everything matches the parameters given to ScriptSystemNodeHelper
+    //! \returns False if a script exception was set
+    bool Update(GameWorld* world, CScriptArray& systemcomponents, CScriptArray* cached,
+        asITypeInfo* cacheclass, asIScriptContext* context, ScriptExecutor* exec)
+    {
+        if(World != world || SystemComponents != &systemcomponents ||
+            Components.size() != systemcomponents.GetSize() || HasUnresolved) {
+
+            if(!ResolveComponents(world, systemcomponents, context, exec))
+                return false;
+        }
+
+        if(CachedClass != cacheclass && !ValidateCachedClass(cacheclass, context, exec))
+            return false;
+
+        // Clearing or otherwise resizing the array from a script causes a rebuild //
+        if(Cached != cached || SlotEntities.size() != cached->GetSize())
+            return RebuildIndex(cached, context);
+
+        return true;
+    }
+
+    bool ResolveComponents(GameWorld* world, CScriptArray& systemcomponents,
+        asIScriptContext* context, ScriptExecutor* exec)
+    {
+        ReleaseComponents();
+
+        const auto elementID = systemcomponents.GetElementTypeId();
+        const auto wantedID = AngelScriptTypeIDResolver<ScriptSystemUses>::Get(exec);
+
+        if(elementID != wantedID) {
+
+            context->SetException(("expected systemcomponents array to hold objects of type " +
+                                   std::to_string(wantedID) + " but it contains type " +
+                                   std::to_string(elementID))
+                                      .c_str());
+            return false;
+        }
+
+        const auto size = systemcomponents.GetSize();
+        Components.resize(size);
+
+        for(asUINT i = 0; i < size; ++i) {
+
+            ScriptSystemUses* type = static_cast<ScriptSystemUses*>(systemcomponents.At(i));
+
+            auto& used = Components[i];
+            used.IsScript = type->UsesName;
+
+            if(type->UsesName) {
+
+                // Increases refcount, released in ReleaseComponents //
+                used.Holder = world->GetScriptComponentHolder(type->Name);
+
+                if(!used.Holder)
+                    HasUnresolved = true;
+
+            } else {
+
+                used.Access =
+                    world->GetComponentTypeAccess(static_cast<COMPONENT_TYPE>(type->Type));
+
+                if(used.Access) {
+                    used.CType = ComponentTypeInfo(
+                        type->Type, used.Access->GetAngelScriptTypeID(exec));
+                }
+            }
+        }
+
+        World = world;
+        SystemComponents = &systemcomponents;
+
+        // The factory is validated against the resolved types //
+        Factory = nullptr;
+        return true;
+    }
+
+    void ReleaseComponents()
+    {
+        for(auto& used : Components) {
+            if(used.Holder)
+                used.Holder->Release();
+        }
+
+        Components.clear();
+        HasUnresolved = false;
+        World = nullptr;
+        SystemComponents = nullptr;
+    }
+
+    //! \brief Checks that the first property of the class in the cached array is the ID
+    bool ValidateCachedClass(
+        asITypeInfo* cacheclass, asIScriptContext* context, ScriptExecutor* exec)
+    {
+        if(CachedClass) {
+            CachedClass->Release();
+            CachedClass = nullptr;
+        }
+
+        Factory = nullptr;
+
+        int propertyType = -1;
+
+        if(cacheclass->GetPropertyCount() < 1 ||
+            cacheclass->GetProperty(0, nullptr, &propertyType) < 0) {
+
+            context->SetException(("type inside cachedcomponents (" +
+                                   std::string(cacheclass->GetName()) +
+                                   ") doesn't have 'ObjectID id' as its first property")
+                                      .c_str());
+            return false;
+        }
+
+        const auto neededType = AngelScriptTypeIDResolver<ObjectID>::Get(exec);
+
+        if(propertyType != neededType) {
+
+            context->SetException(
+                ("type inside cachedcomponents (" + std::string(cacheclass->GetName()) +
+                    ") doesn't have 'ObjectID id' as its first property. Type " +
+                    std::to_string(propertyType) +
+                    " doesn't match ObjectID type: " + std::to_string(neededType))
+                    .c_str());
+            return false;
+        }
+
+        // Keeps the pointer from being reused by another type //
+        CachedClass = cacheclass;
+        CachedClass->AddRef();
+        return true;
+    }
+
+    //! \brief Finds the factory of CachedClass that takes the ID and all the components
+    //!
+    //! The parameter types are validated here so that CreateNode can pass the arguments
+    //! without checking them for each node. Script component parameters are only checked
+    //! to be objects as the type of the script components is known once they are found
+    bool FindFactory(asIScriptContext* context, ScriptExecutor* exec)
+    {
+        if(Factory)
+            return true;
+
+        const asUINT factoryCount = CachedClass->GetFactoryCount();
+        const auto expectedParamCount = Components.size() + 1;
+
+        std::string mismatch;
+
+        for(asUINT i = 0; i < factoryCount; ++i) {
+
+            asIScriptFunction* currentToCheck = CachedClass->GetFactoryByIndex(i);
+
+            if(currentToCheck->GetParamCount() != expectedParamCount)
+                continue;
+
+            if(!CheckFactoryParameters(currentToCheck, exec, mismatch))
+                continue;
+
+            Factory = currentToCheck;
+
+            for(auto& used : Components)
+                used.ValidatedScriptType = -1;
+
+            return true;
+        }
+
+        if(!mismatch.empty()) {
+
+            context->SetException(
+                ("type inside cachedcomponents has no suitable factory, " + mismatch).c_str());
+            return false;
+        }
+
+        context->SetException(
+            ("type inside cachedcomponents has no suitable factory, expected one with " +
+                std::to_string(expectedParamCount) +
+                " parameters, type: " + std::string(CachedClass->GetName()))
+                .c_str());
+        return false;
+    }
+
+    //! \brief Checks that factory takes the ID and then the components in order
+    //! \param mismatch Set to a description of the first mismatching parameter
+    bool CheckFactoryParameters(
+        asIScriptFunction* factory, ScriptExecutor* exec, std::string& mismatch) const
+    {
+        int paramType = -1;
+        factory->GetParam(0, &paramType);
+
+        if(paramType != AngelScriptTypeIDResolver<ObjectID>::Get(exec)) {
+
+            mismatch = "first parameter isn't 'ObjectID id', func: " +
+                       std::string(factory->GetDeclaration());
+            return false;
+        }
+
+        for(size_t i = 0; i < Components.size(); ++i) {
+
+            const auto& used = Components[i];
+            factory->GetParam(static_cast<asUINT>(i + 1), &paramType);
+
+            bool matches = true;
+
+            if(used.IsScript) {
+
+                matches = (paramType & asTYPEID_SCRIPTOBJECT) != 0;
+
+            } else if(used.Access) {
+
+                matches = paramType == used.CType.AngelScriptType;
+            }
+
+            // Unresolved C++ types are never passed as entities can't have them //
+            if(!matches) {
+
+                mismatch = "parameter number " + std::to_string(i + 1) +
+                           " doesn't match the component type, func: " +
+                           std::string(factory->GetDeclaration());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //! \brief Checks that the script component objects of type typeID can be passed as the
+    //! parameter of used
+    bool ValidateScriptParameter(
+        UsedComponent& used, size_t index, int typeID, asIScriptContext* context)
+    {
+        int paramType = -1;
+        Factory->GetParam(static_cast<asUINT>(index + 1), &paramType);
+
+        // The parameter can be a handle or a reference to the type //
+        if(paramType != typeID && (paramType ^ asTYPEID_OBJHANDLE) != typeID) {
+
+            asITypeInfo* type = context->GetEngine()->GetTypeInfoById(typeID);
+
+            context->SetException(
+                ("script component " + std::string(type->GetName()) +
+                    " doesn't match parameter number " + std::to_string(index + 1) +
+                    " of factory func: " + std::string(Factory->GetDeclaration()))
+                    .c_str());
+            return false;
+        }
+
+        used.ValidatedScriptType = typeID;
+        return true;
+    }
+
+    //! \brief Reads the ID of a node. The layout needs to be validated before this
+    static inline ObjectID GetNodeID(CScriptArray* cached, asUINT index)
+    {
+        asIScriptObject* obj = *static_cast<asIScriptObject**>(cached->At(index));
+        return obj ? *static_cast<ObjectID*>(obj->GetAddressOfProperty(0)) : NULL_OBJECT;
+    }
+
+    bool RebuildIndex(CScriptArray* cached, asIScriptContext* context)
+    {
+        Cached = cached;
+
+        const auto size = cached->GetSize();
+
+        SlotEntities.resize(size);
+        Slots.clear();
+        Slots.reserve(size);
+
+        for(asUINT i = 0; i < size; ++i) {
+
+            if(!*static_cast<asIScriptObject**>(cached->At(i))) {
+
+                context->SetException(
+                    ("cachedcomponents number " + std::to_string(i) + " is null").c_str());
+                Cached = nullptr;
+                return false;
+            }
+
+            SlotEntities[i] = GetNodeID(cached, i);
+            Slots[SlotEntities[i]] = i;
+        }
+
+        return true;
+    }
+
+    //! \returns False if a script exception was set
+    bool CreateNode(ObjectID newentity, CScriptArray* cached, asIScriptContext* context,
+        ScriptExecutor* exec);
+
+    //! \brief Removes the node of entity if there is one
+    void RemoveNode(ObjectID entity, CScriptArray* cached, asIScriptContext* context)
+    {
+        auto found = Slots.find(entity);
+
+        if(found == Slots.end())
+            return;
+
+        // The index is rebuilt if the array was reordered by something else //
+        if(GetNodeID(cached, found->second) != entity) {
+
+            if(!RebuildIndex(cached, context))
+                return;
+
+            found = Slots.find(entity);
+
+            if(found == Slots.end())
+                return;
+        }
+
+        const asUINT slot = found->second;
+        const asUINT last = cached->GetSize() - 1;
+
+        Slots.erase(found);
+
+        // We do a swap trick here //
+        if(slot != last) {
+
+            cached->SetValue(slot, cached->At(last));
+            SlotEntities[slot] = SlotEntities[last];
+            Slots[SlotEntities[slot]] = slot;
+        }
+
+        cached->RemoveLast();
+        SlotEntities.pop_back();
+    }
+
+    GameWorld* World = nullptr;
+
+    //! Used to detect when the components need to be resolved again, not referenced
+    CScriptArray* SystemComponents = nullptr;
+    std::vector<UsedComponent> Components;
+    bool HasUnresolved = false;
+
+    //! The validated class of the nodes and its factory
+    asITypeInfo* CachedClass = nullptr;
+    asIScriptFunction* Factory = nullptr;
+
+    //! The array the index is for, not referenced
+    CScriptArray* Cached = nullptr;
+
+    //! The entity of each node and the reverse mapping
+    std::vector<ObjectID> SlotEntities;
+    std::unordered_map<ObjectID, asUINT> Slots;
+};
+
+} // namespace Leviathan
+
+namespace {
+
+//! The cache of the system whose CreateAndDestroyNodes is running
+thread_local ScriptSystemNodeCache* ActiveNodeCache = nullptr;
+
+//! \brief Sets ActiveNodeCache for the duration of a CreateAndDestroyNodes call
+class ActiveNodeCacheSetter {
+public:
+    ActiveNodeCacheSetter(ScriptSystemNodeCache* cache) : Previous(ActiveNodeCache)
+    {
+        ActiveNodeCache = cache;
+    }
+
+    ~ActiveNodeCacheSetter()
+    {
+        ActiveNodeCache = Previous;
+    }
+
+private:
+    ScriptSystemNodeCache* const Previous;
+};
+
+} // namespace
+// ------------------------------------ //
 DLLEXPORT ScriptSystemWrapper::ScriptSystemWrapper(
     const std::string& name, asIScriptObject* impl) :
     Name(name),
@@ -21,6 +429,7 @@ DLLEXPORT ScriptSystemWrapper::ScriptSystemWrapper(
 DLLEXPORT ScriptSystemWrapper::~ScriptSystemWrapper()
 {
     _ReleaseCachedFunctions();
+    NodeCache.reset();
 
     if(ImplementationObject) {
         LOG_ERROR("ScriptSystemWrapper: Release has not been called before destructor");
@@ -55,6 +464,19 @@ DLLEXPORT void ScriptSystemWrapper::Init(GameWorld* world)
         LOG_ERROR("Script system(" + Name + "): failed to call Init");
         return;
     }
+
+    // This is optional
+    func = ImplementationObject->GetObjectType()->GetMethodByDecl("bool IsThreadSafe()");
+
+    if(func) {
+
+        auto threadSafe =
+            static_cast<ScriptExecutor*>(ImplementationObject->GetEngine()->GetUserData())
+                ->RunScriptMethod<bool>(setup, func, ImplementationObject);
+
+        ThreadSafe =
+            threadSafe.Result == SCRIPT_RUN_RESULT::Success && threadSafe.Value == true;
+    }
 }
 DLLEXPORT void ScriptSystemWrapper::Release()
 {
@@ -79,6 +501,7 @@ DLLEXPORT void ScriptSystemWrapper::Release()
     }
 
     _ReleaseCachedFunctions();
+    NodeCache.reset();
 
     ImplementationObject->Release();
     ImplementationObject = nullptr;
@@ -86,23 +509,13 @@ DLLEXPORT void ScriptSystemWrapper::Release()
 // ------------------------------------ //
 DLLEXPORT void ScriptSystemWrapper::Run()
 {
-    // For performance reasons this might be good to store
-    if(!RunMethod) {
-
-        RunMethod = ImplementationObject->GetObjectType()->GetMethodByName("Run");
-        RunMethod->AddRef();
-    }
-
-    if(!RunMethod) {
+    if(!_PrepareCachedCall(RunCall, "Run")) {
 
         LOG_ERROR("Script system(" + Name + "): failed to find Run method on as object");
         return;
     }
 
-    ScriptRunningSetup setup;
-    auto result =
-        static_cast<ScriptExecutor*>(ImplementationObject->GetEngine()->GetUserData())
-            ->RunScriptMethod<void>(setup, RunMethod, ImplementationObject);
+    auto result = RunCall->RunMethod(ImplementationObject);
 
     if(result.Result != SCRIPT_RUN_RESULT::Success) {
 
@@ -113,25 +526,20 @@ DLLEXPORT void ScriptSystemWrapper::Run()
 // ------------------------------------ //
 DLLEXPORT void ScriptSystemWrapper::CreateAndDestroyNodes()
 {
-    // For performance reasons this might be good to store
-    if(!CreateAndDestroyNodesMethod) {
-
-        CreateAndDestroyNodesMethod =
-            ImplementationObject->GetObjectType()->GetMethodByName("CreateAndDestroyNodes");
-        CreateAndDestroyNodesMethod->AddRef();
-    }
-
-    if(!CreateAndDestroyNodesMethod) {
+    if(!_PrepareCachedCall(CreateAndDestroyNodesCall, "CreateAndDestroyNodes")) {
 
         LOG_ERROR("Script system(" + Name +
                   "): failed to find CreateAndDestroyNodes method on as object");
         return;
     }
 
-    ScriptRunningSetup setup;
-    auto result =
-        static_cast<ScriptExecutor*>(ImplementationObject->GetEngine()->GetUserData())
-            ->RunScriptMethod<void>(setup, CreateAndDestroyNodesMethod, ImplementationObject);
+    if(!NodeCache)
+        NodeCache = std::make_unique<ScriptSystemNodeCache>();
+
+    // Lets ScriptSystemNodeHelper find the cache //
+    ActiveNodeCacheSetter activeCache(NodeCache.get());
+
+    auto result = CreateAndDestroyNodesCall->RunMethod(ImplementationObject);
 
     if(result.Result != SCRIPT_RUN_RESULT::Success) {
 
@@ -205,57 +613,26 @@ DLLEXPORT void ScriptSystemWrapper::Resume()
 // ------------------------------------ //
 DLLEXPORT void ScriptSystemWrapper::_ReleaseCachedFunctions()
 {
-
-    if(RunMethod) {
-        RunMethod->Release();
-        RunMethod = nullptr;
-    }
-
-    if(CreateAndDestroyNodesMethod) {
-        CreateAndDestroyNodesMethod->Release();
-        CreateAndDestroyNodesMethod = nullptr;
-    }
+    RunCall.reset();
+    CreateAndDestroyNodesCall.reset();
 }
-// ------------------------------------ //
-// ScriptSystemNodeHelper
-//! Helper for ScriptSystemNodeHelper
-//! \returns True on success. False if failed (will also set exception on context)
-inline bool GetCachedScriptObjectIDAtIndex(CScriptArray* cached, asUINT index,
-    asIScriptContext* context, ScriptExecutor* exec, ObjectID& id)
-{
-    asIScriptObject* obj = *static_cast<asIScriptObject**>(cached->At(index));
-
-    if(obj->GetPropertyCount() < 1) {
-
-        context->SetException(("cachedcomponents number " + std::to_string(index) +
-                               " doesn't have 'ObjectID id' as its first property")
-                                  .c_str());
-        return false;
-    }
-
-    // This check can be disabled once this is working (as reading 4 bytes will most
-    // often probably work, but for developing new systems this check is good)
-    const auto propertyType = obj->GetPropertyTypeId(0);
 
-    const auto neededType = AngelScriptTypeIDResolver<ObjectID>::Get(exec);
-
-    if(propertyType != neededType) {
+bool ScriptSystemWrapper::_PrepareCachedCall(
+    std::unique_ptr<PreparedScriptCall<void()>>& call, const char* methodname)
+{
+    if(call)
+        return call->IsValid();
 
-        context->SetException(("cachedcomponents number " + std::to_string(index) +
-                               " doesn't have 'ObjectID id' as its first property. Type " +
-                               std::to_string(propertyType) +
-                               " doesn't match ObjectID type: " + std::to_string(neededType))
-                                  .c_str());
-        return false;
-    }
+    asIScriptFunction* func =
+        ImplementationObject->GetObjectType()->GetMethodByName(methodname);
 
-    // Now that the property is (probably) validated we can read it
-    ObjectID* idProperty = static_cast<ObjectID*>(obj->GetAddressOfProperty(0));
+    call = std::make_unique<PreparedScriptCall<void()>>(
+        static_cast<ScriptExecutor*>(ImplementationObject->GetEngine()->GetUserData()), func);
 
-    id = *idProperty;
-    return true;
+    return call->IsValid();
 }
-
+// ------------------------------------ //
+// ScriptSystemNodeHelper
 struct ComponentFindStatusForCache {
 
     ComponentFindStatusForCache(asIScriptObject* as) :
@@ -276,163 +653,103 @@ struct ComponentFindStatusForCache {
     bool IsScript;
 };
 
-
-//! Helper for ScriptSystemNodeHelper
-//! \returns False if failed and a script exception was set
-inline bool TryToCreateNewCachedComponentsForEntity(ObjectID newentity, CScriptArray* cached,
-    asIScriptFunction* factoryfunc,
-    std::vector<std::tuple<void*, ObjectID, ComponentTypeInfo>>& addedcpp,
-    std::vector<std::tuple<asIScriptObject*, ObjectID, ScriptComponentHolder*>>& addedscript,
-    GameWorld* world, CScriptArray& systemcomponents, asIScriptContext* context,
-    ScriptExecutor* exec)
+bool ScriptSystemNodeCache::CreateNode(ObjectID newentity, CScriptArray* cached,
+    asIScriptContext* context, ScriptExecutor* exec)
 {
-    // Find the needed components //
-    std::vector<ComponentFindStatusForCache> foundComponents;
-
-    const auto sysSize = systemcomponents.GetSize();
-
-    foundComponents.reserve(sysSize);
-
-    for(asUINT i = 0; i < sysSize; ++i) {
-
-        ScriptSystemUses* type = static_cast<ScriptSystemUses*>(systemcomponents.At(i));
-
-        bool found = false;
-
-        if(type->UsesName) {
-
-            // First search added //
-            for(const auto& addedTuple : addedscript) {
-
-                if(std::get<1>(addedTuple) != newentity ||
-                    std::get<2>(addedTuple)->ComponentType != type->Name)
-                    continue;
-
-                // Found //
-                foundComponents.push_back(std::get<0>(addedTuple));
-                found = true;
-                break;
-            }
-
-            // And then do full search //
-            if(!found) {
-
-                auto* holder = world->GetScriptComponentHolder(type->Name);
+    // Skip if already exists //
+    const auto existing = Slots.find(newentity);
 
-                if(!holder) {
+    if(existing != Slots.end()) {
 
-                    context->SetException(
-                        ("systemcomponents has type that world doesn't have: " + type->Name)
-                            .c_str());
-                    return false;
-                }
+        // The script may have modified the array without changing its size so the slot is
+        // checked before trusting it
+        if(existing->second < cached->GetSize() &&
+            GetNodeID(cached, existing->second) == newentity)
+            return true;
 
-                asIScriptObject* fullSearchResult = holder->Find(newentity);
-                holder->Release();
+        if(!RebuildIndex(cached, context))
+            return false;
 
-                if(fullSearchResult) {
+        if(Slots.find(newentity) != Slots.end())
+            return true;
+    }
 
-                    // We don't need to keep a reference as the holder will do that for us //
-                    fullSearchResult->Release();
-                    foundComponents.push_back(fullSearchResult);
-                    found = true;
-                }
-            }
+    // Find the needed components //
+    std::vector<ComponentFindStatusForCache> foundComponents;
+    foundComponents.reserve(Components.size());
 
+    for(size_t i = 0; i < Components.size(); ++i) {
 
-        } else {
+        auto& used = Components[i];
 
-            // First search added //
-            for(const auto& addedTuple : addedcpp) {
+        if(used.IsScript) {
 
-                if(std::get<1>(addedTuple) != newentity ||
-                    std::get<2>(addedTuple).LeviathanType != type->Type)
-                    continue;
+            if(!used.Holder) {
 
-                // Found //
-                foundComponents.push_back({std::get<0>(addedTuple), std::get<2>(addedTuple)});
-                found = true;
-                break;
+                context->SetException(
+                    ("systemcomponents has type that world doesn't have: " +
+                        static_cast<ScriptSystemUses*>(SystemComponents->At(i))->Name)
+                        .c_str());
+                return false;
             }
 
-            // And then do full search //
-            if(!found) {
-
-                const auto existingComponent = world->GetComponentWithType(
-                    newentity, static_cast<COMPONENT_TYPE>(type->Type));
+            // We don't need to keep a reference as the holder will do that for us //
+            asIScriptObject* found = used.Holder->FindDirect(newentity);
 
-                if(std::get<0>(existingComponent)) {
+            if(!found)
+                return true;
 
-                    foundComponents.push_back(
-                        {std::get<0>(existingComponent), std::get<1>(existingComponent)});
-                    found = true;
-                }
-            }
-        }
+            // Usually all the components of a holder are the same type //
+            if(found->GetTypeId() != used.ValidatedScriptType &&
+                !ValidateScriptParameter(used, i, found->GetTypeId(), context))
+                return false;
 
-        if(!found) {
-            // Fail if not found //
-            return true;
-        }
-    }
+            foundComponents.push_back(found);
 
-    // Skip if already exists //
-    bool exists = false;
+        } else {
 
-    for(asUINT i = 0; i < cached->GetSize(); ++i) {
+            if(!used.Access)
+                return true;
 
-        ObjectID currentID;
-        if(!GetCachedScriptObjectIDAtIndex(cached, i, context, exec, currentID))
-            return false;
+            void* found = used.Access->Find(*World, newentity);
 
-        if(currentID == newentity) {
+            if(!found)
+                return true;
 
-            exists = true;
-            break;
+            foundComponents.push_back({found, used.CType});
         }
     }
 
-    if(exists)
-        return true;
-
     // Call factory to create it //
-    auto scriptRunInfo = exec->PrepareCustomScriptRun(factoryfunc);
+    auto scriptRunInfo = exec->PrepareCustomScriptRun(Factory);
 
     if(scriptRunInfo) {
 
-        // Pass parameters //
-        // TODO: the types here should be checked only once and then just assumed to be right
-        // for more performance
+        // Pass parameters. The types were validated by FindFactory and above //
+        asIScriptContext* factoryContext = scriptRunInfo->Context;
 
-        if(!PassParameterToCustomRun(scriptRunInfo, newentity)) {
+        if(factoryContext->SetArgDWord(0, static_cast<asDWORD>(newentity)) < 0) {
 
             context->SetException(("failed to pass ObjectID as first param to factory func: " +
-                                   std::string(factoryfunc->GetDeclaration()))
+                                   std::string(Factory->GetDeclaration()))
                                       .c_str());
             return false;
         }
 
         // Then the rest //
-        for(const auto& component : foundComponents) {
+        for(size_t i = 0; i < foundComponents.size(); ++i) {
 
-            bool success = false;
+            const auto& component = foundComponents[i];
 
-            if(component.IsScript) {
+            void* object = component.IsScript ? static_cast<void*>(component.ScriptComponent) :
+                                                component.CppComponent;
 
-                success = PassParameterToCustomRun(scriptRunInfo, component.ScriptComponent);
+            if(factoryContext->SetArgObject(static_cast<asUINT>(i + 1), object) < 0) {
 
-            } else {
-                success = PassParameterToCustomRun(
-                    scriptRunInfo, component.CppComponent, component.CType.AngelScriptType);
-            }
-
-            if(!success) {
-
-                context->SetException(
-                    ("failed to pass parameter number " +
-                        std::to_string(scriptRunInfo->PassedIndex) +
-                        "  to factory func: " + std::string(factoryfunc->GetDeclaration()))
-                        .c_str());
+                context->SetException(("failed to pass parameter number " +
+                                       std::to_string(i + 1) + " to factory func: " +
+                                       std::string(Factory->GetDeclaration()))
+                                          .c_str());
                 return false;
             }
         }
@@ -444,7 +761,7 @@ inline bool TryToCreateNewCachedComponentsForEntity(ObjectID newentity, CScriptA
 
         context->SetException(("failed to create new cachedcomponent, factory function failed "
                                "to run or returned null, func: " +
-                               std::string(factoryfunc->GetDeclaration()))
+                               std::string(Factory->GetDeclaration()))
                                   .c_str());
         return false;
     }
@@ -453,6 +770,9 @@ inline bool TryToCreateNewCachedComponentsForEntity(ObjectID newentity, CScriptA
     // The array increments reference count
     // handle type so we need to give this a pointer to a pointer
     cached->InsertLast(&result.Value);
+
+    Slots[newentity] = static_cast<asUINT>(SlotEntities.size());
+    SlotEntities.push_back(newentity);
     return true;
 }
 
@@ -474,19 +794,6 @@ DLLEXPORT void Leviathan::ScriptSystemNodeHelper(
     auto* engine = context->GetEngine();
     auto* exec = static_cast<ScriptExecutor*>(engine->GetUserData());
 
-    // Verify types //
-    const auto elementID = systemcomponents.GetElementTypeId();
-    const auto wantedID = AngelScriptTypeIDResolver<ScriptSystemUses>::Get(exec);
-
-    if(elementID != wantedID) {
-
-        context->SetException(("expected systemcomponents array to hold objects of type " +
-                               std::to_string(wantedID) + " but it contains type " +
-                               std::to_string(elementID))
-                                  .c_str());
-        return;
-    }
-
     // And then the harder to verify the one that can be anything //
     asITypeInfo* givenComponentsType = engine->GetTypeInfoById(cachedtypeid);
 
@@ -524,133 +831,82 @@ DLLEXPORT void Leviathan::ScriptSystemNodeHelper(
         return;
     }
 
-    std::vector<std::tuple<void*, ObjectID, ComponentTypeInfo>> addedCpp;
-    std::vector<std::tuple<asIScriptObject*, ObjectID, ScriptComponentHolder*>> addedScript;
-    std::vector<std::tuple<void*, ObjectID>> removedCpp;
-    std::vector<std::tuple<asIScriptObject*, ObjectID>> removedScript;
+    // When not called through ScriptSystemWrapper everything is resolved again //
+    ScriptSystemNodeCache temporaryCache;
+    ScriptSystemNodeCache& cache = ActiveNodeCache ? *ActiveNodeCache : temporaryCache;
 
-    // Get all the added and removed at once //
-    // TODO: Might be more cache efficient to first get all added c++ and then all added script
-    // and then move on to the removed ones
-    for(asUINT i = 0; i < systemcomponents.GetSize(); ++i) {
+    if(!cache.Update(world, systemcomponents, cached, cacheclass, context, exec))
+        return;
 
-        ScriptSystemUses* type = static_cast<ScriptSystemUses*>(systemcomponents.At(i));
+    bool added = false;
+    bool removed = false;
 
-        if(type->UsesName) {
+    for(const auto& used : cache.Components) {
 
-            world->GetAddedForScriptDefined(type->Name, addedScript);
-            world->GetRemovedForScriptDefined(type->Name, removedScript);
+        if(used.Holder) {
 
-        } else {
+            added = added || !used.Holder->GetAdded().empty();
+            removed = removed || !used.Holder->GetRemoved().empty();
 
-            world->GetAddedFor(static_cast<COMPONENT_TYPE>(type->Type), addedCpp);
-            world->GetRemovedFor(static_cast<COMPONENT_TYPE>(type->Type), removedCpp);
+        } else if(used.Access) {
+
+            added = added || used.Access->GetAddedCount(*world) > 0;
+            removed = removed || used.Access->GetRemovedCount(*world) > 0;
         }
     }
 
-    // Only do more checks if something has changed //
-    if(!addedCpp.empty() || !addedScript.empty()) {
+    // Only do more checks if something has changed. Removed are handled first so that a
+    // component that was replaced during the tick gets a new node instead of the old one
+    // being kept and then removed
+    if(removed) {
 
-        // Handle added like in TupleCachedComponentCollectionHelper //
+        for(const auto& used : cache.Components) {
 
-        // Find the first factory that has the right number of arguments //
-        asIScriptFunction* factoryFunc = nullptr;
+            if(used.Holder) {
 
-        const asUINT factoryCount = cacheclass->GetFactoryCount();
-        const auto expectedParamCount = systemcomponents.GetSize() + 1;
+                for(const auto& tuple : used.Holder->GetRemoved())
+                    cache.RemoveNode(std::get<1>(tuple), cached, context);
 
-        for(asUINT i = 0; i < factoryCount; ++i) {
+            } else if(used.Access) {
 
-            asIScriptFunction* currentToCheck = cacheclass->GetFactoryByIndex(i);
+                const auto count = used.Access->GetRemovedCount(*world);
 
-            if(currentToCheck->GetParamCount() == expectedParamCount) {
-                factoryFunc = currentToCheck;
-                break;
+                for(size_t i = 0; i < count; ++i) {
+                    cache.RemoveNode(
+                        used.Access->GetRemovedEntity(*world, i), cached, context);
+                }
             }
         }
+    }
 
-        if(!factoryFunc) {
+    // Then added like in TupleCachedComponentCollectionHelper //
+    if(added) {
 
-            context->SetException(
-                ("type inside cachedcomponents has no suitable factory, expected one with " +
-                    std::to_string(expectedParamCount) +
-                    " parameters, type: " + std::string(cacheclass->GetName()))
-                    .c_str());
+        if(!cache.FindFactory(context, exec))
             return;
-        }
-
 
-        // For sanity reasons this is split into a helper which goes through all of the added
-        // vectors again trying to build an enity of the ID
-        for(const auto& tuple : addedCpp) {
-
-            if(!TryToCreateNewCachedComponentsForEntity(std::get<1>(tuple), cached,
-                   factoryFunc, addedCpp, addedScript, world, systemcomponents, context, exec))
-                return;
-        }
+        for(const auto& used : cache.Components) {
 
-        for(const auto& tuple : addedScript) {
+            // Indexed as the factory may create more components //
+            if(used.Holder) {
 
-            // Skip if already checked //
-            bool inCpp = false;
-            for(const auto& alreadyDone : addedCpp) {
+                const auto& addedScript = used.Holder->GetAdded();
 
-                if(std::get<1>(tuple) == std::get<1>(alreadyDone)) {
+                for(size_t i = 0; i < addedScript.size(); ++i) {
 
-                    inCpp = true;
-                    break;
+                    if(!cache.CreateNode(std::get<1>(addedScript[i]), cached, context, exec))
+                        return;
                 }
-            }
-
-            if(inCpp)
-                continue;
-
-            if(!TryToCreateNewCachedComponentsForEntity(std::get<1>(tuple), cached,
-                   factoryFunc, addedCpp, addedScript, world, systemcomponents, context, exec))
-                return;
-        }
-    }
-
-    if(!removedCpp.empty() || !removedScript.empty()) {
-        // And deleted like in any system that does CachedComponents.RemoveBasedOnKeyTupleList
-
-        // Cheaper to query each object only once about their id //
-        for(asUINT i = 0; i < cached->GetSize();) {
 
-            ObjectID currentID;
-            if(!GetCachedScriptObjectIDAtIndex(cached, i, context, exec, currentID))
-                return;
-
-            bool remove = false;
-
-            for(const auto& tuple : removedCpp) {
-
-                if(std::get<1>(tuple) == currentID) {
-                    remove = true;
-                    break;
-                }
-            }
+            } else if(used.Access) {
 
-            if(!remove) {
-                for(const auto& tuple : removedScript) {
+                for(size_t i = 0; i < used.Access->GetAddedCount(*world); ++i) {
 
-                    if(std::get<1>(tuple) == currentID) {
-                        remove = true;
-                        break;
-                    }
+                    if(!cache.CreateNode(
+                           used.Access->GetAddedEntity(*world, i), cached, context, exec))
+                        return;
                 }
             }
-
-            if(!remove) {
-                ++i;
-                continue;
-            }
-
-            // Remove it //
-            // We do a swap trick here //
-            // This should work even for size == 1
-            cached->SetValue(i, cached->At(cached->GetSize() - 1));
-            cached->RemoveLast();
         }
     }
 }
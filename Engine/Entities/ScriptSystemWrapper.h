@@ -12,6 +12,10 @@ class CScriptArray;
 namespace Leviathan {
 
 class GameWorld;
+struct ScriptSystemNodeCache;
+
+template<class Signature>
+class PreparedScriptCall;
 
 //! \brief Holds a single component type from c++ or from script, which a ScriptSystem uses
 struct ScriptSystemUses {
@@ -37,10 +41,18 @@ struct ScriptSystemUses {
 };
 
 //! \brief Helper for script systems to call to properly handle added and removed nodes
+//!
+//! When called from CreateAndDestroyNodes the resolved component types and an index of the
+//! nodes are kept in the ScriptSystemWrapper so only changed components are processed.
+//! \note cachedcomponents may be cleared by the script but otherwise should only be modified
+//! by this
 DLLEXPORT void ScriptSystemNodeHelper(GameWorld* world, void* cachedcomponents,
     int cachedtypeid, CScriptArray& systemcomponents);
 
 //! \brief Wraps an AngelScript object that is an implementation of ScriptSystem
+//!
+//! A system can declare that its Run method may be called on a worker thread at the same time
+//! as other systems run by defining "bool IsThreadSafe()" that returns true
 class ScriptSystemWrapper {
 public:
     //! \note Doesn't increase reference on impl so caller needs to
@@ -71,6 +83,12 @@ public:
 
     DLLEXPORT void Resume();
 
+    //! \returns True if Run can be called from any thread in parallel with other systems
+    //! \note This is checked in Init
+    inline bool IsThreadSafe() const
+    {
+        return ThreadSafe;
+    }
 
     const std::string Name;
 
@@ -78,18 +96,28 @@ protected:
     //! Helper for reducing copy pasting between the functions that don't need extra parameters
     DLLEXPORT bool _CallMethodOnUs(const std::string& methodname);
 
-    //! Must be called to not leak the cached function pointers (RunMethod,
-    //! CreateAndDestroyNodesMethod)
+    //! Must be called to not leak the cached function pointers (RunCall,
+    //! CreateAndDestroyNodesCall)
     DLLEXPORT void _ReleaseCachedFunctions();
 
+    //! \brief Finds and verifies a method that is called without parameters
+    //! \returns False if the method doesn't exist
+    bool _PrepareCachedCall(
+        std::unique_ptr<PreparedScriptCall<void()>>& call, const char* methodname);
+
 private:
     //! This is the actual implementation of this system in angelscript
     //! This is reference counted so make sure to release the reference
     asIScriptObject* ImplementationObject;
 
     // Cached methods for performance reasons
-    asIScriptFunction* RunMethod = nullptr;
-    asIScriptFunction* CreateAndDestroyNodesMethod = nullptr;
+    std::unique_ptr<PreparedScriptCall<void()>> RunCall;
+    std::unique_ptr<PreparedScriptCall<void()>> CreateAndDestroyNodesCall;
+
+    bool ThreadSafe = false;
+
+    //! State kept for ScriptSystemNodeHelper
+    std::unique_ptr<ScriptSystemNodeCache> NodeCache;
 };
 
 } // namespace Leviathan
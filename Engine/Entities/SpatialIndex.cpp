@@ -0,0 +1,250 @@
+// ------------------------------------ //
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Leviathan;
+// ------------------------------------ //
+//! Cell coordinates are packed into 21 bits per axis
+constexpr int32_t SPATIAL_INDEX_MAX_CELL = (1 << 20) - 1;
+
+DLLEXPORT SpatialIndex::SpatialIndex(float cellsize /*= 16.f*/) :
+    CellSize(cellsize > 0 ? cellsize : 1.f)
+{}
+// ------------------------------------ //
+DLLEXPORT void SpatialIndex::Set(ObjectID id, const Float3& position)
+{
+    const auto cell = _GetCell(position);
+    const auto existing = Locations.find(id);
+
+    if(existing != Locations.end()) {
+
+        // Staying in the same cell only needs the position updated //
+        if(existing->second.Cell == cell) {
+            Cells[cell][existing->second.Index].Position = position;
+            return;
+        }
+
+        _RemoveFromCell(existing->second);
+    }
+
+    auto& items = Cells[cell];
+    Locations[id] = Location{cell, static_cast<uint32_t>(items.size())};
+    items.push_back(Item{id, position});
+}
+
+DLLEXPORT bool SpatialIndex::Remove(ObjectID id)
+{
+    const auto existing = Locations.find(id);
+
+    if(existing == Locations.end())
+        return false;
+
+    _RemoveFromCell(existing->second);
+    Locations.erase(existing);
+    return true;
+}
+
+DLLEXPORT void SpatialIndex::Clear()
+{
+    Cells.clear();
+    Locations.clear();
+}
+
+DLLEXPORT void SpatialIndex::SetCellSize(float cellsize)
+{
+    std::vector<Item> items;
+    items.reserve(Locations.size());
+
+    for(const auto& cell : Cells)
+        items.insert(items.end(), cell.second.begin(), cell.second.end());
+
+    Clear();
+    CellSize = cellsize > 0 ? cellsize : 1.f;
+
+    for(const auto& item : items)
+        Set(item.ID, item.Position);
+}
+
+DLLEXPORT bool SpatialIndex::GetPosition(ObjectID id, Float3& position) const
+{
+    const auto existing = Locations.find(id);
+
+    if(existing == Locations.end())
+        return false;
+
+    position = Cells.at(existing->second.Cell)[existing->second.Index].Position;
+    return true;
+}
+// ------------------------------------ //
+DLLEXPORT size_t SpatialIndex::QueryRadius(
+    const Float3& center, float radius, std::vector<ObjectID>& result) const
+{
+    const auto radiusSquared = radius * radius;
+    const auto oldSize = result.size();
+
+    _ForEachInCells(center - Float3(radius), center + Float3(radius), [&](const Item& item) {
+        if((item.Position - center).LengthSquared() <= radiusSquared)
+            result.push_back(item.ID);
+    });
+
+    return result.size() - oldSize;
+}
+
+DLLEXPORT size_t SpatialIndex::QueryBox(
+    const Float3& min, const Float3& max, std::vector<ObjectID>& result) const
+{
+    const auto oldSize = result.size();
+
+    _ForEachInCells(min, max, [&](const Item& item) {
+        const auto& position = item.Position;
+
+        if(position.X >= min.X && position.Y >= min.Y && position.Z >= min.Z &&
+            position.X <= max.X && position.Y <= max.Y && position.Z <= max.Z)
+            result.push_back(item.ID);
+    });
+
+    return result.size() - oldSize;
+}
+
+DLLEXPORT size_t SpatialIndex::QueryNearest(const Float3& point, size_t count,
+    std::vector<ObjectID>& result, float maxdistance /*= -1.f*/) const
+{
+    if(count == 0 || Locations.empty())
+        return 0;
+
+    const bool limited = maxdistance >= 0;
+
+    // Start from the nearby cells and grow the searched area until enough entities are found.
+    // Entities outside the searched sphere are further away than all the ones inside so the
+    // closest ones are found once the sphere contains count entities
+    float radius = limited ? std::min(CellSize, maxdistance) : CellSize;
+
+    while(true) {
+
+        NearestCandidates.clear();
+        const auto radiusSquared = radius * radius;
+
+        const bool searchedAll = _ForEachInCells(
+            point - Float3(radius), point + Float3(radius), [&](const Item& item) {
+                const auto distance = (item.Position - point).LengthSquared();
+
+                if(distance <= radiusSquared)
+                    NearestCandidates.emplace_back(distance, item.ID);
+            });
+
+        // Entities (or a point) with NaN coordinates are never within the radius so the
+        // search also stops once the radius can't grow anymore
+        if(NearestCandidates.size() >= count || NearestCandidates.size() == Locations.size() ||
+            (limited && radius >= maxdistance) || std::isinf(radius))
+            break;
+
+        // Once all cells are gone through growing the radius in steps doesn't find anything
+        // faster than taking everything at once
+        radius = searchedAll ? std::numeric_limits<float>::infinity() : radius * 2;
+
+        if(limited)
+            radius = std::min(radius, maxdistance);
+    }
+
+    const auto found = std::min(count, NearestCandidates.size());
+
+    std::partial_sort(NearestCandidates.begin(), NearestCandidates.begin() + found,
+        NearestCandidates.end());
+
+    for(size_t i = 0; i < found; ++i)
+        result.push_back(std::get<1>(NearestCandidates[i]));
+
+    return found;
+}
+// ------------------------------------ //
+template<class CallbackT>
+bool SpatialIndex::_ForEachInCells(
+    const Float3& min, const Float3& max, CallbackT&& callback) const
+{
+    const auto minX = _ToCellCoordinate(min.X);
+    const auto minY = _ToCellCoordinate(min.Y);
+    const auto minZ = _ToCellCoordinate(min.Z);
+    const auto maxX = _ToCellCoordinate(max.X);
+    const auto maxY = _ToCellCoordinate(max.Y);
+    const auto maxZ = _ToCellCoordinate(max.Z);
+
+    const double cellCount = (static_cast<double>(maxX) - minX + 1) *
+                             (static_cast<double>(maxY) - minY + 1) *
+                             (static_cast<double>(maxZ) - minZ + 1);
+
+    // Big areas are faster to check by going through the existing cells //
+    if(cellCount > Cells.size()) {
+
+        for(const auto& cell : Cells) {
+            for(const auto& item : cell.second)
+                callback(item);
+        }
+
+        return true;
+    }
+
+    for(int32_t x = minX; x <= maxX; ++x) {
+        for(int32_t y = minY; y <= maxY; ++y) {
+            for(int32_t z = minZ; z <= maxZ; ++z) {
+
+                const auto cell = Cells.find(_PackCell(x, y, z));
+
+                if(cell == Cells.end())
+                    continue;
+
+                for(const auto& item : cell->second)
+                    callback(item);
+            }
+        }
+    }
+
+    return false;
+}
+
+uint64_t SpatialIndex::_GetCell(const Float3& position) const
+{
+    return _PackCell(_ToCellCoordinate(position.X), _ToCellCoordinate(position.Y),
+        _ToCellCoordinate(position.Z));
+}
+
+int32_t SpatialIndex::_ToCellCoordinate(float value) const
+{
+    const float cell = std::floor(value / CellSize);
+
+    // Also handles NaNs by putting them in cell 0 //
+    if(!(cell > -SPATIAL_INDEX_MAX_CELL))
+        return cell <= 0 ? -SPATIAL_INDEX_MAX_CELL : 0;
+
+    if(cell > SPATIAL_INDEX_MAX_CELL)
+        return SPATIAL_INDEX_MAX_CELL;
+
+    return static_cast<int32_t>(cell);
+}
+
+uint64_t SpatialIndex::_PackCell(int32_t x, int32_t y, int32_t z)
+{
+    constexpr uint64_t mask = (1 << 21) - 1;
+
+    return (static_cast<uint64_t>(x) & mask) | ((static_cast<uint64_t>(y) & mask) << 21) |
+           ((static_cast<uint64_t>(z) & mask) << 42);
+}
+
+void SpatialIndex::_RemoveFromCell(const Location& location)
+{
+    auto cell = Cells.find(location.Cell);
+    auto& items = cell->second;
+
+    if(location.Index + 1 != items.size()) {
+
+        items[location.Index] = items.back();
+        Locations[items[location.Index].ID].Index = location.Index;
+    }
+
+    items.pop_back();
+
+    if(items.empty())
+        Cells.erase(cell);
+}
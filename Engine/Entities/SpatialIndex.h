@@ -0,0 +1,107 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "Common/Types.h"
+
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Leviathan {
+
+//! \brief Finds entities near a point
+//!
+//! This is a hash grid of entity positions. Each entity is stored in the cubic cell its
+//! position is in, and queries only look at the cells they overlap. GameWorld keeps one of
+//! these updated from the Position components once per tick (see SpatialIndexSystem) so
+//! within a tick queries see the same positions.
+//! \note Only the positions are indexed, the size of an entity isn't taken into account
+class SpatialIndex {
+    struct Item {
+
+        ObjectID ID;
+        Float3 Position;
+    };
+
+    struct Location {
+
+        uint64_t Cell;
+        //! Index of the entity in the item vector of Cell
+        uint32_t Index;
+    };
+
+public:
+    //! \param cellsize Length of the side of a cell. Works best when queries are about the
+    //! size of a cell
+    DLLEXPORT SpatialIndex(float cellsize = 16.f);
+
+    //! \brief Adds an entity or moves it if it is already in this
+    DLLEXPORT void Set(ObjectID id, const Float3& position);
+
+    //! \returns False if id wasn't in this
+    DLLEXPORT bool Remove(ObjectID id);
+
+    DLLEXPORT void Clear();
+
+    //! \brief Changes the cell size and rebuilds the grid
+    DLLEXPORT void SetCellSize(float cellsize);
+
+    //! \brief Gets the indexed position of an entity
+    //! \returns False if id isn't in this
+    DLLEXPORT bool GetPosition(ObjectID id, Float3& position) const;
+
+    //! \brief Finds entities within radius of center
+    //! \param result The found entities are added to this
+    //! \returns The number of found entities
+    DLLEXPORT size_t QueryRadius(
+        const Float3& center, float radius, std::vector<ObjectID>& result) const;
+
+    //! \brief Finds entities inside an axis aligned box
+    //! \copydetails QueryRadius
+    DLLEXPORT size_t QueryBox(
+        const Float3& min, const Float3& max, std::vector<ObjectID>& result) const;
+
+    //! \brief Finds the count entities closest to point, closest first
+    //! \param maxdistance Entities further than this aren't found. Negative for no limit
+    //! \copydetails QueryRadius
+    DLLEXPORT size_t QueryNearest(const Float3& point, size_t count,
+        std::vector<ObjectID>& result, float maxdistance = -1.f) const;
+
+    inline size_t GetEntityCount() const
+    {
+        return Locations.size();
+    }
+
+    inline float GetCellSize() const
+    {
+        return CellSize;
+    }
+
+private:
+    //! \brief Calls callback with each item in the cells overlapping min and max
+    //! \returns True if the area was so big that all items were passed to callback
+    template<class CallbackT>
+    bool _ForEachInCells(const Float3& min, const Float3& max, CallbackT&& callback) const;
+
+    uint64_t _GetCell(const Float3& position) const;
+    int32_t _ToCellCoordinate(float value) const;
+    static uint64_t _PackCell(int32_t x, int32_t y, int32_t z);
+
+    //! \brief Removes the item at location, moving the last item of the cell in its place
+    void _RemoveFromCell(const Location& location);
+
+private:
+    float CellSize;
+
+    std::unordered_map<uint64_t, std::vector<Item>> Cells;
+
+    //! Where each entity is stored
+    std::unordered_map<ObjectID, Location> Locations;
+
+    //! Reused by QueryNearest to not allocate on each call
+    mutable std::vector<std::tuple<float, ObjectID>> NearestCandidates;
+};
+
+} // namespace Leviathan
@@ -39,7 +39,15 @@ COMPONENT_MODEL = EntityComponent.new(
                              memberaccess: "Material")
               ]
             )], releaseparams: [#["GetComponent_RenderNode(id)" # "GetScene()"
-  ], nosynchronize: true # this is to get around not having implemented bsf serialization
+  ], nosynchronize: true, # this is to get around not having implemented bsf serialization
+  # World snapshots save the material by its resource UUID
+  customstaticserializer: "    receiver << model->MeshName << model->GetMaterialUUID();",
+  customstaticloader: <<-END
+std::string model;
+std::string materialuuid;
+data >> model >> materialuuid;
+const auto material = Model::FindMaterial(materialuuid);
+END
 )
 
 COMPONENT_PHYSICS = EntityComponent.new(
@@ -2,12 +2,13 @@
 SYSTEM_RENDERINGPOSITION = EntitySystem.new(
   "RenderingPositionSystem", ["RenderNode", "Position"],
   runrender: {group: 10, parameters: [
-                "PositionStates", "calculatedTick", "progressInTick"
+                "ComponentPosition", "PositionStates", "calculatedTick",
+                "progressInTick"
               ]})
 
 SYSTEM_RENDERNODEPROPERTIES = EntitySystem.new(
   "RenderNodePropertiesSystem", [],
-  runrender: {group: 11, parameters: ["ComponentRenderNode.GetIndex()"]})
+  runrender: {group: 11, parameters: ["ComponentRenderNode"]})
 
 SYSTEM_ANIMATION = EntitySystem.new(
   "AnimationSystem", [],
@@ -23,22 +24,27 @@ SYSTEM_RECEIVED = EntitySystem.new(
 SYSTEM_SENDABLEMARK_POSITION = EntitySystem.new(
   "SendableMarkFromSystem<Position>", ["Sendable", "Position"],
   runtick: {group: 20,
-            parameters: []})
+            parameters: ["ComponentPosition"]})
+
+# Positions are read before PositionStateSystem unmarks them
+SYSTEM_SPATIALINDEX = EntitySystem.new(
+  "SpatialIndexSystem", ["Position"],
+  runtick: {group: 45,
+            parameters: ["ComponentPosition"]})
 
 SYSTEM_SENDABLE = EntitySystem.new(
   "SendableSystem", [],
   runtick: {group: 70,
-            parameters: ["ComponentSendable.GetIndex()"]})
+            parameters: ["ComponentSendable"]})
 
 SYSTEM_POSITIONSTATE = EntitySystem.new(
   "PositionStateSystem", [], runtick: {
     group: 50,
-    parameters: ["ComponentPosition.GetIndex()", "PositionStates",
-                 "tick"]})
+    parameters: ["ComponentPosition", "PositionStates", "tick"]})
 
 SYSTEM_MODELPROPERTIES = EntitySystem.new(
   "ModelPropertiesSystem", [], runtick: {
     group: 56,
-    parameters: ["ComponentModel.GetIndex()"]})
+    parameters: ["ComponentModel"]})
 
 
@@ -21,6 +21,7 @@ STANDARD_WORLD = GameWorldClass.new(
     SYSTEM_RECEIVED,
     SYSTEM_SENDABLEMARK_POSITION,
     SYSTEM_SENDABLE,
+    SYSTEM_SPATIALINDEX,
     SYSTEM_POSITIONSTATE,
     SYSTEM_MODELPROPERTIES,
   ],
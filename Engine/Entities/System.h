@@ -191,36 +191,37 @@ public:
 template<class UsedComponent, class ComponentState>
 class StateCreationSystem {
 public:
-    void Run(GameWorld& world, std::unordered_map<ObjectID, UsedComponent*>& index,
+    void Run(GameWorld& world, ComponentHolder<UsedComponent>& components,
         StateHolder<ComponentState>& heldstates, int worldtick)
     {
         // TODO: find a better way (see the comment a few lines down why this is here)
-        if(!world.GetNetworkSettings().DoInterpolation)
+        if(!world.GetNetworkSettings().DoInterpolation) {
+
+            // Nothing else uses the marks after this so they are cleared to not need to look
+            // at these components again
+            components.ForEachMarked(
+                [](UsedComponent& component, ObjectID id) { component.Marked = false; });
             return;
+        }
 
         const bool authoritative = world.GetNetworkSettings().IsAuthoritative;
 
-        for(auto iter = index.begin(); iter != index.end(); ++iter) {
-            auto& component = *iter->second;
-
-            if(!component.Marked)
-                continue;
-
+        components.ForEachMarked([&](UsedComponent& component, ObjectID id) {
             // And only for locally controlled entities
-            if(!authoritative && !world.IsUnderOurLocalControl(iter->first))
-                continue;
+            if(!authoritative && !world.IsUnderOurLocalControl(id))
+                return;
 
             // Ignore creating states on the server when using local control as that causes
             // issues Actually this whole system is disabled when interpolating isn't needed
 
             // Needs a new state //
-            if(heldstates.CreateStateIfChanged(iter->first, component, worldtick)) {
+            if(heldstates.CreateStateIfChanged(id, component, worldtick)) {
 
                 component.StateMarked = true;
             }
 
             component.Marked = false;
-        }
+        });
     }
 };
 
@@ -2,6 +2,7 @@
 #include "Systems.h"
 
 #include "GameWorld.h"
+#include "SpatialIndex.h"
 #include "Networking/Connection.h"
 #include "Networking/NetworkHandler.h"
 #include "Networking/NetworkRequest.h"
@@ -16,16 +17,36 @@
 
 using namespace Leviathan;
 // ------------------------------------ //
-// ModelPropertiesSystem
-void ModelPropertiesSystem::Run(GameWorld& world, std::unordered_map<ObjectID, Model*>& index)
+// SpatialIndexSystem
+DLLEXPORT void SpatialIndexSystem::Run(
+    GameWorld& world, ComponentHolder<Position>& components)
 {
-    for(auto iter = index.begin(); iter != index.end(); ++iter) {
+    SpatialIndex& spatial = world.GetSpatialIndex();
 
-        auto& node = *iter->second;
+    // Removed first as a component can be removed and added again in the same tick
+    for(ObjectID id : Removed)
+        spatial.Remove(id);
 
-        if(!node.Marked)
-            continue;
+    for(ObjectID id : Added) {
+
+        const Position* position = components.Find(id);
+
+        if(position)
+            spatial.Set(id, position->Members._Position);
+    }
 
+    Removed.clear();
+    Added.clear();
+
+    components.ForEachMarked([&](Position& position, ObjectID id) {
+        spatial.Set(id, position.Members._Position);
+    });
+}
+// ------------------------------------ //
+// ModelPropertiesSystem
+void ModelPropertiesSystem::Run(GameWorld& world, ComponentHolder<Model>& components)
+{
+    components.ForEachMarked([](Model& node, ObjectID id) {
         // TODO: this check could be for graphics outside this loop
         if(node.GraphicalObject) {
             node.ApplyMeshName();
@@ -33,7 +54,7 @@ void ModelPropertiesSystem::Run(GameWorld& world, std::unordered_map<ObjectID, M
         }
 
         node.Marked = false;
-    }
+    });
 }
 
 // ------------------------------------ //
@@ -80,11 +101,22 @@ void SendableHandleHelper(ObjectID id, Sendable& obj, GameWorld& world,
             }
 
             // Send the update packet
-            auto sentThing = connection->SendPacketToConnectionWithTrackingWithoutGuarantee(
-                ResponseEntityUpdate(
-                    0, world.GetID(), ticknumber, referencetick, id, std::move(updateData)));
-
-            iter->AddSentPacket(ticknumber, curstate, sentThing);
+            auto update = std::make_shared<ResponseEntityUpdate>(
+                0, world.GetID(), ticknumber, referencetick, id, std::move(updateData));
+
+            // The receiver is looked up again as the sending may be delayed until the end of
+            // the tick //
+            world.SendOrQueue([&obj, connection, curstate, update, ticknumber]() {
+                auto sentThing =
+                    connection->SendPacketToConnectionWithTrackingWithoutGuarantee(*update);
+
+                for(auto& receiver : obj.UpdateReceivers) {
+                    if(receiver.CorrespondingConnection == connection) {
+                        receiver.AddSentPacket(ticknumber, curstate, sentThing);
+                        break;
+                    }
+                }
+            });
 
             break;
         }
@@ -92,6 +124,8 @@ void SendableHandleHelper(ObjectID id, Sendable& obj, GameWorld& world,
 
     if(initial) {
 
+        std::shared_ptr<ResponseEntityCreation> creation;
+
         // Only server sends the static state, as the server doesn't want to receive that data,
         // because it was the one who initially sent it to any client that has local control
         if(server) {
@@ -102,11 +136,8 @@ void SendableHandleHelper(ObjectID id, Sendable& obj, GameWorld& world,
             sf::Packet initialComponentData;
             uint32_t componentCount = world.CaptureEntityStaticState(id, initialComponentData);
 
-            // Send the initial response
-            connection->SendPacketToConnection(
-                std::make_shared<ResponseEntityCreation>(
-                    0, world.GetID(), id, componentCount, std::move(initialComponentData)),
-                RECEIVE_GUARANTEE::Critical);
+            creation = std::make_shared<ResponseEntityCreation>(
+                0, world.GetID(), id, componentCount, std::move(initialComponentData));
         }
 
         // And then send the initial state packet
@@ -114,12 +145,21 @@ void SendableHandleHelper(ObjectID id, Sendable& obj, GameWorld& world,
 
         curstate->AddDataToPacket(updateData);
 
-        auto sentThing = connection->SendPacketToConnectionWithTrackingWithoutGuarantee(
-            ResponseEntityUpdate(0, world.GetID(), ticknumber, -1, id, std::move(updateData)));
+        auto update = std::make_shared<ResponseEntityUpdate>(
+            0, world.GetID(), ticknumber, -1, id, std::move(updateData));
+
+        world.SendOrQueue([&obj, connection, curstate, creation, update, ticknumber]() {
+            // Send the initial response
+            if(creation)
+                connection->SendPacketToConnection(creation, RECEIVE_GUARANTEE::Critical);
+
+            auto sentThing =
+                connection->SendPacketToConnectionWithTrackingWithoutGuarantee(*update);
 
-        // And add the connection to the receivers
-        obj.UpdateReceivers.emplace_back(connection);
-        obj.UpdateReceivers.back().AddSentPacket(ticknumber, curstate, sentThing);
+            // And add the connection to the receivers
+            obj.UpdateReceivers.emplace_back(connection);
+            obj.UpdateReceivers.back().AddSentPacket(ticknumber, curstate, sentThing);
+        });
     }
 }
 
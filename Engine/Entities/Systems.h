@@ -55,14 +55,28 @@ class RenderingPositionSystem : public System<std::tuple<RenderNode&, Position&>
 
 public:
     template<class GameWorldT>
-    void Run(GameWorldT& world, const StateHolder<PositionState>& heldstates, int tick,
-        int timeintick)
+    void Run(GameWorldT& world, ComponentHolder<Position>& positions,
+        const StateHolder<PositionState>& heldstates, int tick, int timeintick)
     {
-        auto& index = CachedComponents.GetIndex();
-        for(auto iter = index.begin(); iter != index.end(); ++iter) {
+        // Usually only a few positions are being interpolated, but positions without a
+        // RenderNode are never unmarked so the nodes are looped if there are fewer of them
+        if(positions.GetStateMarkedCount() > CachedComponents.GetObjectCount()) {
+
+            auto& index = CachedComponents.GetIndex();
+            for(auto iter = index.begin(); iter != index.end(); ++iter) {
+
+                this->ProcessNode(*iter->second, iter->first, heldstates, tick, timeintick);
+            }
 
-            this->ProcessNode(*iter->second, iter->first, heldstates, tick, timeintick);
+            return;
         }
+
+        positions.ForEachStateMarked([&](Position& position, ObjectID id) {
+            auto* node = CachedComponents.Find(id);
+
+            if(node)
+                this->ProcessNode(*node, id, heldstates, tick, timeintick);
+        });
     }
 
     //! \brief Creates nodes if matching ids are found in all data vectors or
@@ -90,29 +104,57 @@ public:
 //! \brief Handles properties of scene objects that have a changed RenderNode
 class RenderNodePropertiesSystem {
 public:
-    void Run(GameWorld& world, std::unordered_map<ObjectID, RenderNode*>& index)
+    void Run(GameWorld& world, ComponentHolder<RenderNode>& components)
     {
-        for(auto iter = index.begin(); iter != index.end(); ++iter) {
-
-            auto& node = *iter->second;
-
-            if(!node.Marked)
-                continue;
-
+        components.ForEachMarked([](RenderNode& node, ObjectID id) {
             // This check being here, may or may not be faster than just always setting it
             if(node.Node->getActive() != !node.Hidden)
                 node.Node->setActive(!node.Hidden);
 
             node.Node->setScale(node.Scale);
             node.Marked = false;
-        }
+        });
+    }
+};
+
+//! \brief Updates GameWorld::GetSpatialIndex from the Position components
+//!
+//! Added and removed entities are collected as they happen and the index is updated once per
+//! tick along with the positions that have been marked as changed.
+//! \note This needs to run before the systems that unmark Position
+class SpatialIndexSystem {
+public:
+    DLLEXPORT void Run(GameWorld& world, ComponentHolder<Position>& components);
+
+    void CreateNodes(const std::vector<std::tuple<Position*, ObjectID>>& added,
+        const ComponentHolder<Position>& holder)
+    {
+        for(const auto& node : added)
+            Added.push_back(std::get<1>(node));
+    }
+
+    void DestroyNodes(const std::vector<std::tuple<Position*, ObjectID>>& removed)
+    {
+        for(const auto& node : removed)
+            Removed.push_back(std::get<1>(node));
+    }
+
+    //! \brief Forgets pending changes. GameWorld clears the index itself
+    void Clear()
+    {
+        Added.clear();
+        Removed.clear();
     }
+
+private:
+    std::vector<ObjectID> Added;
+    std::vector<ObjectID> Removed;
 };
 
 //! \brief Handles properties of Model
 class ModelPropertiesSystem {
 public:
-    DLLEXPORT void Run(GameWorld& world, std::unordered_map<ObjectID, Model*>& index);
+    DLLEXPORT void Run(GameWorld& world, ComponentHolder<Model>& components);
 };
 
 
@@ -131,19 +173,13 @@ public:
 class SendableSystem {
 public:
     //! \pre Final states for entities have been created for current tick
-    void Run(GameWorld& world, std::unordered_map<ObjectID, Sendable*>& index)
+    void Run(GameWorld& world, ComponentHolder<Sendable>& components)
     {
-        for(auto iter = index.begin(); iter != index.end(); ++iter) {
-
-            auto& node = *iter->second;
-
-            if(!node.Marked)
-                continue;
-
-            HandleNode(iter->first, node, world);
+        components.ForEachMarked([&](Sendable& node, ObjectID id) {
+            HandleNode(id, node, world);
 
             node.Marked = false;
-        }
+        });
     }
 
 protected:
@@ -155,15 +191,14 @@ protected:
 template<class T>
 class SendableMarkFromSystem : public System<std::tuple<Sendable&, T&>> {
 public:
-    void Run(GameWorld& world)
+    void Run(GameWorld& world, ComponentHolder<T>& components)
     {
-        auto& index = this->CachedComponents.GetIndex();
-        for(auto iter = index.begin(); iter != index.end(); ++iter) {
+        components.ForEachMarked([&](T& component, ObjectID id) {
+            auto* node = this->CachedComponents.Find(id);
 
-            if(std::get<1>(*iter->second).Marked) {
-                std::get<0>(*iter->second).Marked = true;
-            }
-        }
+            if(node)
+                std::get<0>(*node).Marked = true;
+        });
     }
 
     void CreateNodes(const std::vector<std::tuple<Sendable*, ObjectID>>& firstdata,
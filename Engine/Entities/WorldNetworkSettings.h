@@ -65,6 +65,10 @@ struct WorldNetworkSettings {
 
     //! Enables clientside interpolation functions
     bool DoInterpolation = true;
+
+    //! Players only receive entities within this distance from their own entity. 0 for no
+    //! limit
+    float EntityRelevanceRadius = 0.f;
 };
 
 
@@ -0,0 +1,255 @@
+// ------------------------------------ //
+#include "WorldSnapshot.h"
+
+#include "lz4/lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+using namespace Leviathan;
+// ------------------------------------ //
+//! "LVWS" at the start of all snapshots
+constexpr uint32_t WORLD_SNAPSHOT_MAGIC = 0x4C565753;
+
+// These are written with sf::Packet so the sizes are fixed
+constexpr size_t WORLD_SNAPSHOT_HEADER_SIZE = 4 + 2 + 2;
+constexpr size_t WORLD_SNAPSHOT_CHUNK_HEADER_SIZE = 1 + 4 + 4 + 4;
+
+//! How far back LZ4 can find matches, this much of the previous chunks is kept around
+constexpr size_t WORLD_SNAPSHOT_DICTIONARY_SIZE = 64 * 1024;
+// ------------------------------------ //
+DLLEXPORT WorldSnapshotWriter::WorldSnapshotWriter(std::ostream& output, uint32_t chunksize) :
+    Output(output), ChunkSize(std::min(chunksize, MAX_WORLD_SNAPSHOT_CHUNK_SIZE / 2)),
+    // LZ4 needs at least 192 KiB to be able to slide the buffer
+    InputBuffer(std::max(3 * WORLD_SNAPSHOT_DICTIONARY_SIZE,
+        WORLD_SNAPSHOT_DICTIONARY_SIZE + 2 * static_cast<size_t>(ChunkSize))),
+    StreamState(LZ4_sizeofStreamState())
+{
+    LZ4_resetStreamState(StreamState.data(), InputBuffer.data());
+
+    sf::Packet header;
+    header << WORLD_SNAPSHOT_MAGIC << WORLD_SNAPSHOT_VERSION << static_cast<uint16_t>(0);
+
+    Output.write(static_cast<const char*>(header.getData()), header.getDataSize());
+}
+
+DLLEXPORT sf::Packet& WorldSnapshotWriter::BeginItem(WORLD_SNAPSHOT_CHUNK type)
+{
+    if(type != CurrentType) {
+
+        _FlushChunk();
+        CurrentType = type;
+    }
+
+    return CurrentData;
+}
+
+DLLEXPORT void WorldSnapshotWriter::EndItem()
+{
+    ++CurrentItems;
+
+    if(CurrentData.getDataSize() >= ChunkSize)
+        _FlushChunk();
+}
+
+DLLEXPORT bool WorldSnapshotWriter::Finish()
+{
+    if(!Finished) {
+
+        _FlushChunk();
+        _WriteChunk(WORLD_SNAPSHOT_CHUNK::End, 0, nullptr, 0, 0);
+        Output.flush();
+        Finished = true;
+    }
+
+    return static_cast<bool>(Output);
+}
+// ------------------------------------ //
+void WorldSnapshotWriter::_FlushChunk()
+{
+    if(CurrentItems == 0 || !Output)
+        return;
+
+    const size_t rawSize = CurrentData.getDataSize();
+
+    // The chunk needs to be right after the previous one for LZ4 to continue the stream //
+    if(NextBlock + rawSize > InputBuffer.size()) {
+
+        if(NextBlock >= 2 * WORLD_SNAPSHOT_DICTIONARY_SIZE &&
+            WORLD_SNAPSHOT_DICTIONARY_SIZE + rawSize <= InputBuffer.size()) {
+
+            // Moves the last 64 KiB to the start
+            NextBlock = LZ4_slideInputBuffer(StreamState.data()) - InputBuffer.data();
+
+        } else {
+
+            // Only happens with single items larger than the chunk size. The stream is
+            // restarted so the chunk can't refer to the earlier ones
+            if(InputBuffer.size() < rawSize)
+                InputBuffer.resize(rawSize);
+
+            LZ4_resetStreamState(StreamState.data(), InputBuffer.data());
+            NextBlock = 0;
+        }
+    }
+
+    std::memcpy(InputBuffer.data() + NextBlock, CurrentData.getData(), rawSize);
+
+    CompressBuffer.resize(LZ4_compressBound(static_cast<int>(rawSize)));
+
+    const int compressedSize = LZ4_compress_continue(StreamState.data(),
+        InputBuffer.data() + NextBlock, CompressBuffer.data(), static_cast<int>(rawSize));
+
+    NextBlock += rawSize;
+
+    if(compressedSize <= 0) {
+
+        LOG_ERROR("WorldSnapshotWriter: compressing a chunk failed");
+        Output.setstate(std::ios::failbit);
+
+    } else {
+
+        _WriteChunk(CurrentType, CurrentItems, CompressBuffer.data(), compressedSize,
+            static_cast<uint32_t>(rawSize));
+    }
+
+    CurrentData.clear();
+    CurrentItems = 0;
+}
+
+void WorldSnapshotWriter::_WriteChunk(WORLD_SNAPSHOT_CHUNK type, uint32_t itemcount,
+    const char* data, uint32_t size, uint32_t rawsize)
+{
+    sf::Packet header;
+    header << static_cast<uint8_t>(type) << itemcount << rawsize << size;
+
+    Output.write(static_cast<const char*>(header.getData()), header.getDataSize());
+
+    if(size > 0)
+        Output.write(data, size);
+
+    ++WrittenChunks;
+}
+// ------------------------------------ //
+// WorldSnapshotReader
+DLLEXPORT WorldSnapshotReader::WorldSnapshotReader(std::istream& input) :
+    Input(input),
+    // Chunks start after 64 KiB of zeros so that invalid data can't make LZ4 read outside the
+    // buffer when it refers to the previous data
+    DecompressedBuffer(3 * WORLD_SNAPSHOT_DICTIONARY_SIZE),
+    NextBlock(WORLD_SNAPSHOT_DICTIONARY_SIZE)
+{
+    char buffer[WORLD_SNAPSHOT_HEADER_SIZE];
+
+    if(!Input.read(buffer, sizeof(buffer))) {
+        SetFailed("input ended before the header");
+        return;
+    }
+
+    sf::Packet header;
+    header.append(buffer, sizeof(buffer));
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    header >> magic >> version >> flags;
+
+    if(!header || magic != WORLD_SNAPSHOT_MAGIC) {
+        SetFailed("input is not a world snapshot");
+        return;
+    }
+
+    if(version != WORLD_SNAPSHOT_VERSION) {
+        SetFailed("unsupported snapshot version: " + std::to_string(version));
+        return;
+    }
+}
+
+DLLEXPORT bool WorldSnapshotReader::ReadChunk()
+{
+    ChunkData.clear();
+    ChunkItems = 0;
+
+    if(Ended || Failed)
+        return false;
+
+    char buffer[WORLD_SNAPSHOT_CHUNK_HEADER_SIZE];
+
+    if(!Input.read(buffer, sizeof(buffer)))
+        return SetFailed("input ended before the end marker");
+
+    sf::Packet header;
+    header.append(buffer, sizeof(buffer));
+
+    uint8_t type;
+    uint32_t items;
+    uint32_t rawSize;
+    uint32_t compressedSize;
+    header >> type >> items >> rawSize >> compressedSize;
+
+    if(type > static_cast<uint8_t>(WORLD_SNAPSHOT_CHUNK::PhysicsBodies))
+        return SetFailed("unknown chunk type: " + std::to_string(type));
+
+    ChunkType = static_cast<WORLD_SNAPSHOT_CHUNK>(type);
+
+    if(ChunkType == WORLD_SNAPSHOT_CHUNK::End) {
+
+        Ended = true;
+        return false;
+    }
+
+    if(rawSize > MAX_WORLD_SNAPSHOT_CHUNK_SIZE ||
+        compressedSize > static_cast<uint32_t>(LZ4_compressBound(rawSize)))
+        return SetFailed("chunk is too large, the data is likely corrupted");
+
+    CompressedBuffer.resize(compressedSize);
+
+    if(!Input.read(CompressedBuffer.data(), compressedSize))
+        return SetFailed("input ended in the middle of a chunk");
+
+    if(NextBlock + rawSize > DecompressedBuffer.size()) {
+
+        // Only the last 64 KiB is needed for the next chunks //
+        std::memmove(DecompressedBuffer.data(),
+            DecompressedBuffer.data() + NextBlock - WORLD_SNAPSHOT_DICTIONARY_SIZE,
+            WORLD_SNAPSHOT_DICTIONARY_SIZE);
+        NextBlock = WORLD_SNAPSHOT_DICTIONARY_SIZE;
+
+        if(NextBlock + rawSize > DecompressedBuffer.size())
+            DecompressedBuffer.resize(NextBlock + rawSize);
+    }
+
+    char* const decompressed = DecompressedBuffer.data() + NextBlock;
+
+    const int decompressedSize = LZ4_decompress_safe_withPrefix64k(CompressedBuffer.data(),
+        decompressed, static_cast<int>(compressedSize), static_cast<int>(rawSize));
+
+    if(decompressedSize != static_cast<int>(rawSize))
+        return SetFailed("chunk failed to decompress");
+
+    NextBlock += rawSize;
+
+    ChunkData.append(decompressed, rawSize);
+    ChunkItems = items;
+    return true;
+}
+// ------------------------------------ //
+DLLEXPORT ObjectID WorldSnapshotReader::GetLoadedEntity(ObjectID saved) const
+{
+    const auto found = LoadedEntities.find(saved);
+
+    if(found == LoadedEntities.end())
+        return NULL_OBJECT;
+
+    return found->second;
+}
+// ------------------------------------ //
+DLLEXPORT bool WorldSnapshotReader::SetFailed(const std::string& message)
+{
+    LOG_ERROR("WorldSnapshotReader: " + message);
+    ChunkData.clear();
+    ChunkItems = 0;
+    Failed = true;
+    return false;
+}
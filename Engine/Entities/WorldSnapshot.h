@@ -0,0 +1,204 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "Common/SFMLPackets.h"
+#include "Physics/PhysicsShape.h"
+
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+namespace Leviathan {
+
+//! Increment when the layout of the snapshot data changes
+constexpr uint16_t WORLD_SNAPSHOT_VERSION = 2;
+
+//! Chunks are compressed once they have at least this many bytes of data
+constexpr uint32_t DEFAULT_WORLD_SNAPSHOT_CHUNK_SIZE = 64 * 1024;
+
+//! Larger chunks are treated as corrupted data when reading
+constexpr uint32_t MAX_WORLD_SNAPSHOT_CHUNK_SIZE = 64 * 1024 * 1024;
+
+//! \brief What the items in a chunk of a world snapshot are
+enum class WORLD_SNAPSHOT_CHUNK : uint8_t {
+
+    //! Marks the end of the snapshot, has no data
+    End = 0,
+
+    //! ObjectID, uint32_t component count, the component data from
+    //! GameWorld::CaptureEntitySnapshotState, uint32_t script component count and then for
+    //! each script component its type name and the data from ScriptComponentHolder::Serialize
+    Entities,
+
+    //! ObjectID parent, ObjectID child
+    Parents,
+
+    //! The shapes of the bodies from PhysicalWorld::SerializeShape. They are numbered in the
+    //! order they are in the snapshot
+    PhysicsShapes,
+
+    //! ObjectID, uint32_t shape number, mass, physical material name, PhysicsBodyProperties
+    //! and then the PhysicsBodyState of the body in its Physics component
+    PhysicsBodies
+};
+
+//! \brief Writes a world snapshot
+//!
+//! The snapshot is a header followed by chunks. Items are added to the current chunk and once
+//! it is large enough it is compressed with LZ4 and written to the output. The chunks are
+//! compressed as one LZ4 stream so later chunks can refer to the data of the previous ones,
+//! but memory use still doesn't depend on the size of the world and a reader can load the
+//! chunks one at a time.
+//! \see GameWorld::SaveSnapshot
+class WorldSnapshotWriter {
+public:
+    //! \brief Writes the header to output
+    DLLEXPORT WorldSnapshotWriter(
+        std::ostream& output, uint32_t chunksize = DEFAULT_WORLD_SNAPSHOT_CHUNK_SIZE);
+
+    //! \brief Returns the packet the data of an item of type should be written to
+    //!
+    //! If the current chunk has a different type it is written first. EndItem needs to be
+    //! called after writing the data
+    DLLEXPORT sf::Packet& BeginItem(WORLD_SNAPSHOT_CHUNK type);
+
+    //! \brief Counts the item and writes the chunk if it is now large enough
+    DLLEXPORT void EndItem();
+
+    //! \brief Writes the remaining data and the end marker
+    //! \returns False if writing to the output failed at any point
+    DLLEXPORT bool Finish();
+
+    inline size_t GetWrittenChunkCount() const
+    {
+        return WrittenChunks;
+    }
+
+private:
+    void _WriteChunk(WORLD_SNAPSHOT_CHUNK type, uint32_t itemcount, const char* data,
+        uint32_t size, uint32_t rawsize);
+
+    void _FlushChunk();
+
+private:
+    std::ostream& Output;
+    const uint32_t ChunkSize;
+
+    WORLD_SNAPSHOT_CHUNK CurrentType = WORLD_SNAPSHOT_CHUNK::End;
+    uint32_t CurrentItems = 0;
+    sf::Packet CurrentData;
+
+    //! Chunks are copied one after another to this for the LZ4 stream, which needs to see the
+    //! previous data
+    std::vector<char> InputBuffer;
+    size_t NextBlock = 0;
+
+    //! Reused between chunks
+    std::vector<char> CompressBuffer;
+    std::vector<char> StreamState;
+
+    size_t WrittenChunks = 0;
+    bool Finished = false;
+};
+
+//! \brief Reads a world snapshot one chunk at a time
+//! \see GameWorld::LoadSnapshotChunk
+class WorldSnapshotReader {
+public:
+    //! \brief Reads the header from input
+    //!
+    //! HasFailed returns true if the header isn't valid
+    DLLEXPORT WorldSnapshotReader(std::istream& input);
+
+    //! \brief Reads and decompresses the next chunk
+    //!
+    //! The chunks depend on the previous ones so they need to be read in order
+    //! \returns False once the end was reached or if reading failed
+    DLLEXPORT bool ReadChunk();
+
+    //! \brief Remembers what ID an entity from the snapshot got when it was loaded
+    inline void SetLoadedEntity(ObjectID saved, ObjectID loaded)
+    {
+        LoadedEntities[saved] = loaded;
+    }
+
+    //! \returns The ID of an entity after loading or NULL_OBJECT if it wasn't loaded (yet)
+    DLLEXPORT ObjectID GetLoadedEntity(ObjectID saved) const;
+
+    //! \brief Remembers a loaded shape, the shapes are numbered in the order they are added
+    inline void AddLoadedShape(const PhysicsShape::pointer& shape)
+    {
+        LoadedShapes.push_back(shape);
+    }
+
+    //! \returns The shape with number or null if there isn't one
+    inline PhysicsShape::pointer GetLoadedShape(uint32_t number) const
+    {
+        if(number >= LoadedShapes.size())
+            return nullptr;
+
+        return LoadedShapes[number];
+    }
+
+    inline WORLD_SNAPSHOT_CHUNK GetChunkType() const
+    {
+        return ChunkType;
+    }
+
+    inline uint32_t GetChunkItemCount() const
+    {
+        return ChunkItems;
+    }
+
+    //! \brief The items of the last read chunk
+    inline sf::Packet& GetChunkData()
+    {
+        return ChunkData;
+    }
+
+    //! \returns True if the end marker has been read
+    inline bool HasEnded() const
+    {
+        return Ended;
+    }
+
+    //! \returns True if the data was invalid or the input ended before the end marker
+    inline bool HasFailed() const
+    {
+        return Failed;
+    }
+
+    //! \brief Stops reading, used when the data of a chunk is invalid
+    //! \returns False
+    DLLEXPORT bool SetFailed(const std::string& message);
+
+private:
+    std::istream& Input;
+
+    WORLD_SNAPSHOT_CHUNK ChunkType = WORLD_SNAPSHOT_CHUNK::End;
+    uint32_t ChunkItems = 0;
+    sf::Packet ChunkData;
+
+    //! Reused between chunks
+    std::vector<char> CompressedBuffer;
+
+    //! The chunks are decompressed one after another to this as LZ4 may refer to the previous
+    //! 64 KiB of data
+    std::vector<char> DecompressedBuffer;
+    size_t NextBlock;
+
+    std::unordered_map<ObjectID, ObjectID> LoadedEntities;
+    std::vector<PhysicsShape::pointer> LoadedShapes;
+
+    bool Ended = false;
+    bool Failed = false;
+};
+
+} // namespace Leviathan
+
+#ifdef LEAK_INTO_GLOBAL
+using Leviathan::WorldSnapshotReader;
+using Leviathan::WorldSnapshotWriter;
+#endif
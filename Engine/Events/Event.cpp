@@ -102,7 +102,7 @@ DLLEXPORT Leviathan::GenericEvent::GenericEvent(
 {}
 
 DLLEXPORT Leviathan::GenericEvent::GenericEvent(const std::string& type) :
-    TypeStr(new std::string(type)), Variables(new NamedVars())
+    TypeStr(new std::string(type)), Variables(nullptr)
 {}
 
 DLLEXPORT Leviathan::GenericEvent::~GenericEvent()
@@ -137,7 +137,11 @@ DLLEXPORT void Leviathan::GenericEvent::AddDataToPacket(sf::Packet& packet) cons
     // Add data to the packet //
     packet << *TypeStr;
 
-    Variables->AddDataToPacket(packet);
+    if(Variables) {
+        Variables->AddDataToPacket(packet);
+    } else {
+        NamedVars().AddDataToPacket(packet);
+    }
 }
 #endif // LEVIATHAN_USING_SFML
 // ------------------------------------ //
@@ -153,18 +157,25 @@ DLLEXPORT std::string Leviathan::GenericEvent::GetType() const
 
 DLLEXPORT const NamedVars Leviathan::GenericEvent::GetVariablesConst() const
 {
+    if(!Variables)
+        return NamedVars();
+
     return *Variables;
 }
 
 DLLEXPORT NamedVars* Leviathan::GenericEvent::GetVariables()
 {
+    if(!Variables)
+        Variables = new NamedVars();
+
     return Variables;
 }
 // ------------------------------------ //
 DLLEXPORT NamedVars* Leviathan::GenericEvent::GetNamedVarsRefCounted()
 {
-    Variables->AddRef();
-    return Variables;
+    NamedVars* variables = GetVariables();
+    variables->AddRef();
+    return variables;
 }
 // ------------------ ClientInterpolationEventData ------------------ //
 void ClientInterpolationEventData::CalculatePercentage()
@@ -181,6 +181,7 @@ public:
     DLLEXPORT GenericEvent(const std::string& type, const NamedVars& copyvals);
 
     //! \brief Constructs a generic event without any values
+    //! \note The variables are only allocated if GetVariables is called
     DLLEXPORT GenericEvent(const std::string& type);
 
     //! \brief Constructor that takes the pointers as it's own
@@ -214,7 +215,8 @@ protected:
     //! String that defines this event's type
     std::string* TypeStr;
 
-    //! Pointer to this event's variables
+    //! Pointer to this event's variables, null until needed if this was created without
+    //! values
     NamedVars* Variables;
 };
 
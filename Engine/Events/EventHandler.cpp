@@ -1,138 +1,315 @@
 // ------------------------------------ //
 #include "EventHandler.h"
+
+#include <algorithm>
 using namespace Leviathan;
 using namespace std;
 // ------------------------------------ //
-EventHandler::EventHandler(){
-
-}
-
-EventHandler::~EventHandler(){
+EventHandler::EventHandler() :
+    EventListeners(EVENT_TYPE_ALL + 1), IntegerEventPool(EVENT_TYPE_ALL + 1)
+{}
 
+EventHandler::~EventHandler()
+{
+    _DiscardQueuedEvents();
 }
 // ------------------------------------ //
-bool EventHandler::Init(){
-	return true;
+bool EventHandler::Init()
+{
+    return true;
 }
 
-void EventHandler::Release(){
-	GUARD_LOCK();
+void EventHandler::Release()
+{
+    GUARD_LOCK();
+
+    _DiscardQueuedEvents();
+
+    // Release listeners //
+    for(auto& listeners : EventListeners)
+        listeners.clear();
 
-    
-    
-	// Release listeners //
-	EventListeners.clear();
-	GenericEventListeners.clear();
+    GenericEventListeners.clear();
+    GenericEventIDs.clear();
+
+    for(auto& event : IntegerEventPool)
+        event.reset();
 }
 // ------------------------------------ //
-void EventHandler::CallEvent(Event* event){
-
+void EventHandler::CallEvent(Event* event)
+{
     const auto type = event->GetType();
 
     GUARD_LOCK();
 
-	for(auto iter = EventListeners.begin(); iter != EventListeners.end(); ){
+    if(!_IsValidType(type)) {
 
-		if(std::get<1>(*iter) == type){
+        event->Release();
+        return;
+    }
 
-			const auto result = std::get<0>(*iter)->OnEvent(event);
+    auto& listeners = EventListeners[type];
 
-            if(result == -1){
+    ++SendingEvents;
 
-                // Unregister requested //
-                iter = EventListeners.erase(iter);
-                continue;
-            }
-		}
+    // Listeners added while sending aren't called and removed ones are set to null so looping
+    // by index up to the current size is safe //
+    for(size_t i = 0, count = listeners.size(); i < count; ++i) {
+
+        CallableObject* listener = listeners[i];
+
+        if(!listener)
+            continue;
+
+        if(listener->OnEvent(event) == -1) {
 
-        ++iter;
-	}
+            // Unregister requested //
+            _RemoveListener(listeners, i);
+        }
+    }
+
+    if(--SendingEvents == 0 && ListenersRemoved)
+        _CompactListeners();
 
     event->Release();
 }
 
-DLLEXPORT void Leviathan::EventHandler::CallEvent(GenericEvent* event){
+DLLEXPORT void Leviathan::EventHandler::CallEvent(GenericEvent* event)
+{
+    GUARD_LOCK();
 
-    const auto type = event->GetType();
-    
-	GUARD_LOCK();
-    
-	// Loop generic listeners //
-	for(auto iter = GenericEventListeners.begin(); iter != GenericEventListeners.end(); ){
+    const auto id = _GetGenericEventID(*event->GetTypePtr());
 
-		if(std::get<1>(*iter) == type){
+    if(id < 0) {
 
-			const auto result = std::get<0>(*iter)->OnGenericEvent(event);
+        event->Release();
+        return;
+    }
 
-            if(result == -1){
+    ++SendingEvents;
 
-                // Unregister requested //
-                iter = GenericEventListeners.erase(iter);
-                continue;
-            }
-		}
+    // The listeners are accessed through GenericEventListeners each time as registering for a
+    // new name while sending can reallocate it //
+    for(size_t i = 0, count = GenericEventListeners[id].size(); i < count; ++i) {
+
+        CallableObject* listener = GenericEventListeners[id][i];
+
+        if(!listener)
+            continue;
+
+        if(listener->OnGenericEvent(event) == -1) {
+
+            // Unregister requested //
+            _RemoveListener(GenericEventListeners[id], i);
+        }
+    }
 
-        ++iter;
-	}
+    if(--SendingEvents == 0 && ListenersRemoved)
+        _CompactListeners();
 
     event->Release();
 }
 // ------------------------------------ //
-bool EventHandler::RegisterForEvent(CallableObject* toregister, EVENT_TYPE totype){
-	GUARD_LOCK();
-	EventListeners.push_back(std::make_tuple(toregister, totype));
-	return true;
+DLLEXPORT void EventHandler::CallIntegerEvent(EVENT_TYPE type, int value)
+{
+    GUARD_LOCK();
+
+    if(!_IsValidType(type) || EventListeners[type].empty())
+        return;
+
+    Event::pointer& pooled = IntegerEventPool[type];
+
+    // Only reusable if the last receivers didn't keep it //
+    if(pooled && pooled->GetRefCount() == 1) {
+
+        pooled->GetIntegerDataForEvent()->IntegerDataValue = value;
+
+    } else {
+
+        pooled = Event::MakeShared<Event>(type, new IntegerEventData(value));
+    }
+
+    CallEvent(pooled);
+}
+// ------------------------------------ //
+DLLEXPORT void EventHandler::QueueEvent(Event* event)
+{
+    GUARD_LOCK();
+    EventQueue.push_back({event, nullptr});
+}
+
+DLLEXPORT void EventHandler::QueueEvent(GenericEvent* event)
+{
+    GUARD_LOCK();
+    EventQueue.push_back({nullptr, event});
+}
+
+DLLEXPORT void EventHandler::FlushQueuedEvents()
+{
+    std::vector<QueuedEvent> events;
+
+    {
+        GUARD_LOCK();
+
+        if(EventQueue.empty())
+            return;
+
+        events.swap(EventQueue);
+    }
+
+    for(const auto& queued : events) {
+
+        if(queued.Static) {
+            CallEvent(queued.Static);
+        } else {
+            CallEvent(queued.Generic);
+        }
+    }
+}
+// ------------------------------------ //
+DLLEXPORT bool EventHandler::HasListeners(EVENT_TYPE type)
+{
+    GUARD_LOCK();
+    return _IsValidType(type) && !EventListeners[type].empty();
+}
+// ------------------------------------ //
+bool EventHandler::RegisterForEvent(CallableObject* toregister, EVENT_TYPE totype)
+{
+    GUARD_LOCK();
+
+    if(!_IsValidType(totype))
+        return false;
+
+    EventListeners[totype].push_back(toregister);
+    return true;
 }
 
 DLLEXPORT bool Leviathan::EventHandler::RegisterForEvent(CallableObject* toregister,
     const std::string &genericname)
 {
-	GUARD_LOCK();
-	GenericEventListeners.push_back(std::make_tuple(toregister, genericname));
-	return true;
+    GUARD_LOCK();
+
+    int id = _GetGenericEventID(genericname);
+
+    if(id < 0) {
+
+        id = static_cast<int>(GenericEventListeners.size());
+        GenericEventListeners.emplace_back();
+        GenericEventIDs[genericname] = id;
+    }
+
+    GenericEventListeners[id].push_back(toregister);
+    return true;
 }
 
-void EventHandler::Unregister(CallableObject* caller, EVENT_TYPE type, bool all){
-	GUARD_LOCK();
-    
-	// Loop and remove wanted objects //
-	for(auto iter = EventListeners.begin(); iter != EventListeners.end(); ){
+void EventHandler::Unregister(CallableObject* caller, EVENT_TYPE type, bool all)
+{
+    GUARD_LOCK();
+
+    for(size_t currentType = 0; currentType < EventListeners.size(); ++currentType) {
+
+        // check type or if all is specified delete //
+        if(!all && currentType != static_cast<size_t>(type))
+            continue;
+
+        auto& listeners = EventListeners[currentType];
+
+        for(size_t i = 0; i < listeners.size();) {
 
-		if(std::get<0>(*iter) == caller){
-    
-			// check type or if all is specified delete //
-			if(all || type == std::get<1>(*iter)){
-                
-				iter = EventListeners.erase(iter);
-                continue;
-			}
-		}
+            if(listeners[i] == caller) {
 
-        ++iter;
-	}
+                const auto oldSize = listeners.size();
+                _RemoveListener(listeners, i);
+
+                if(listeners.size() != oldSize)
+                    continue;
+            }
+
+            ++i;
+        }
+    }
 }
 
 DLLEXPORT void Leviathan::EventHandler::Unregister(CallableObject* caller,
     const std::string &genericname,
     bool all /*= false*/)
 {
-	GUARD_LOCK();
-    
-	// Loop and remove wanted objects //
-	for(auto iter = GenericEventListeners.begin(); iter != GenericEventListeners.end(); ){
+    GUARD_LOCK();
+
+    for(const auto& [name, id] : GenericEventIDs) {
+
+        // check type or if all is specified delete //
+        if(!all && name != genericname)
+            continue;
 
-		if(std::get<0>(*iter) == caller){
-    
-			// check type or if all is specified delete //
-			if(all || genericname == std::get<1>(*iter)){
-                
-				iter = GenericEventListeners.erase(iter);
-                continue;
-			}
-		}
+        auto& listeners = GenericEventListeners[id];
 
-        ++iter;
-	}
+        for(size_t i = 0; i < listeners.size();) {
+
+            if(listeners[i] == caller) {
+
+                const auto oldSize = listeners.size();
+                _RemoveListener(listeners, i);
+
+                if(listeners.size() != oldSize)
+                    continue;
+            }
+
+            ++i;
+        }
+    }
 }
 // ------------------------------------ //
+int EventHandler::_GetGenericEventID(const std::string& genericname) const
+{
+    const auto iter = GenericEventIDs.find(genericname);
+
+    if(iter == GenericEventIDs.end())
+        return -1;
 
+    return iter->second;
+}
+
+void EventHandler::_RemoveListener(std::vector<CallableObject*>& listeners, size_t index)
+{
+    if(SendingEvents > 0) {
+
+        // Erasing would move the listeners that are being looped over //
+        listeners[index] = nullptr;
+        ListenersRemoved = true;
+        return;
+    }
+
+    listeners.erase(listeners.begin() + index);
+}
+
+void EventHandler::_DiscardQueuedEvents()
+{
+    for(const auto& queued : EventQueue) {
+
+        if(queued.Static) {
+            queued.Static->Release();
+        } else {
+            queued.Generic->Release();
+        }
+    }
+
+    EventQueue.clear();
+}
+
+void EventHandler::_CompactListeners()
+{
+    ListenersRemoved = false;
+
+    const auto compact = [](std::vector<CallableObject*>& listeners) {
+        listeners.erase(
+            std::remove(listeners.begin(), listeners.end(), nullptr), listeners.end());
+    };
+
+    for(auto& listeners : EventListeners)
+        compact(listeners);
+
+    for(auto& listeners : GenericEventListeners)
+        compact(listeners);
+}
+// ------------------------------------ //
@@ -6,13 +6,26 @@
 #include "CallableObject.h"
 #include "Event.h"
 
+#include <unordered_map>
+
 namespace Leviathan {
 
 //! \brief Allows object to register for events that can be fired from anywhere
 //!
 //! This is recursive to allow EventCallbacks to also fire events. This makes it possible to
 //! cause a stackoverflow but makes it easier to make events that fire a different event
+//!
+//! Listeners are stored per event type (generic event names are mapped to ids) so sending an
+//! event only looks at the listeners of that type. Listeners can register and unregister
+//! while an event is being sent, listeners added during sending get only the next events.
 class EventHandler : public ThreadSafeRecursive {
+    //! \brief A queued event, only one of the pointers is set
+    struct QueuedEvent {
+
+        Event* Static;
+        GenericEvent* Generic;
+    };
+
 public:
     DLLEXPORT EventHandler();
     DLLEXPORT ~EventHandler();
@@ -38,6 +51,31 @@ public:
         CallEvent(event.get());
     }
 
+    //! \brief Sends an event that has IntegerEventData (tick and frame events)
+    //!
+    //! Does nothing if there are no listeners for type. The sent event objects are reused if
+    //! no listener kept a reference to the previous one
+    DLLEXPORT void CallIntegerEvent(EVENT_TYPE type, int value);
+
+    //! \brief Queues an event to be sent when FlushQueuedEvents is called
+    //! \param event The event to send. Reference count will be decremented once sent
+    //! \note The engine flushes the queue at the start of each tick and at the end of each
+    //! frame
+    DLLEXPORT void QueueEvent(Event* event);
+
+    //! \copydoc QueueEvent(Event*)
+    DLLEXPORT void QueueEvent(GenericEvent* event);
+
+    //! \brief Sends all queued events in the order they were queued
+    //!
+    //! Events that are queued while flushing are sent on the next flush
+    DLLEXPORT void FlushQueuedEvents();
+
+    //! \returns True if something is registered for type
+    //!
+    //! Can be used to skip creating events that nobody would receive
+    DLLEXPORT bool HasListeners(EVENT_TYPE type);
+
     DLLEXPORT bool RegisterForEvent(CallableObject* toregister, EVENT_TYPE totype);
     DLLEXPORT bool RegisterForEvent(
         CallableObject* toregister, const std::string& genericname);
@@ -47,8 +85,45 @@ public:
         CallableObject* caller, const std::string& genericname, bool all = false);
 
 private:
-    std::vector<std::tuple<CallableObject*, EVENT_TYPE>> EventListeners;
-    std::vector<std::tuple<CallableObject*, std::string>> GenericEventListeners;
+    //! \returns True if type can be used to index EventListeners
+    inline bool _IsValidType(EVENT_TYPE type) const
+    {
+        return type >= 0 && static_cast<size_t>(type) < EventListeners.size();
+    }
+
+    //! \returns The id of a generic event name, or -1 if nothing has registered for it
+    int _GetGenericEventID(const std::string& genericname) const;
+
+    //! \brief Removes a listener or marks it as removed if events are being sent
+    void _RemoveListener(std::vector<CallableObject*>& listeners, size_t index);
+
+    //! \brief Erases listeners that were removed while events were being sent
+    void _CompactListeners();
+
+    //! \brief Releases queued events without sending them
+    void _DiscardQueuedEvents();
+
+private:
+    //! Listeners of each EVENT_TYPE
+    std::vector<std::vector<CallableObject*>> EventListeners;
+
+    //! Listeners of each generic event id
+    std::vector<std::vector<CallableObject*>> GenericEventListeners;
+
+    //! Maps generic event names to indexes in GenericEventListeners
+    std::unordered_map<std::string, int> GenericEventIDs;
+
+    //! Number of CallEvent calls in progress. While not 0 removed listeners are set to null
+    //! instead of erasing them
+    int SendingEvents = 0;
+
+    //! True when there are null listeners that need erasing
+    bool ListenersRemoved = false;
+
+    std::vector<QueuedEvent> EventQueue;
+
+    //! Reused events for CallIntegerEvent
+    std::vector<Event::pointer> IntegerEventPool;
 };
 
 } // namespace Leviathan
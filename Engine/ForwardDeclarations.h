@@ -124,6 +124,7 @@ class ResourceFolderListener;
 class ResourceRefreshHandler;
 
 class UTF8DataIterator;
+class UTF8ViewDataIterator;
 template<class DTypeName>
 class SyncedPrimitive;
 class SyncedResource;
@@ -220,6 +221,7 @@ using Leviathan::SyncedResource;
 using Leviathan::SyncedValue;
 using Leviathan::TimingMonitor;
 using Leviathan::UTF8DataIterator;
+using Leviathan::UTF8ViewDataIterator;
 using Leviathan::VariableBlock;
 using Leviathan::GUI::GuiManager;
 
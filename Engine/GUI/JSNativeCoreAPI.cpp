@@ -4,6 +4,9 @@
 #include "CEFConversionHelpers.h"
 #include "GuiCEFApplication.h"
 #include "JavaScriptHelper.h"
+
+#include <utility>
+
 using namespace Leviathan;
 using namespace Leviathan::GUI;
 // ------------------------------------ //
@@ -571,7 +574,7 @@ bool JSNamedVarsInterceptor::Get(const CefString& name, const CefRefPtr<CefV8Val
                             return true;
                         }
 
-                        auto vecval = casted->Values->GetVec();
+                        auto vecval = std::as_const(*casted->Values).GetVec();
 
                         const int size = static_cast<int>(vecval->size());
 
@@ -624,7 +627,7 @@ bool JSNamedVarsInterceptor::Set(const CefString& name, const CefRefPtr<CefV8Val
 
 void JSNamedVarsInterceptor::BindValues(CefRefPtr<CefV8Value> object)
 {
-    auto vecval = Values->GetVec();
+    auto vecval = std::as_const(*Values).GetVec();
 
     for(size_t i = 0; i < vecval->size(); i++) {
 
@@ -70,6 +70,8 @@ DLLEXPORT bool VideoPlayer::Play(const std::string& videofile)
         return false;
     }
 
+    StartDecodeThread();
+
     // Make tick run
     IsPlaying = true;
     RegisterForEvent(EVENT_TYPE_FRAME_BEGIN);
@@ -81,6 +83,10 @@ DLLEXPORT void VideoPlayer::Stop()
     // Close all ffmpeg resources //
     StreamValid = false;
 
+    // The decode thread uses the ffmpeg objects so it needs to quit first. This also wakes up
+    // the audio thread if it is waiting for packets
+    StopDecodeThread();
+
     // Stop audio playing first //
     if(IsPlayingAudio) {
         IsPlayingAudio = false;
@@ -137,8 +143,14 @@ DLLEXPORT void VideoPlayer::Stop()
         av_frame_free(&DecodedFrame);
     if(DecodedAudio)
         av_frame_free(&DecodedAudio);
-    if(ConvertedFrameBuffer)
-        av_freep(&ConvertedFrameBuffer);
+    for(auto& frame : DecodedFrames) {
+        if(frame.Data)
+            av_freep(&frame.Data);
+    }
+
+    FirstDecodedFrame = 0;
+    DecodedFrameCount = 0;
+
     if(ConvertedFrame)
         av_frame_free(&ConvertedFrame);
 
@@ -182,6 +194,167 @@ DLLEXPORT void VideoPlayer::Stop()
 
     IsPlaying = false;
 }
+
+DLLEXPORT int VideoPlayer::DecodeAllFrames(const std::string& videofile)
+{
+    Stop();
+
+    LoadFFMPEG();
+
+    if(!std::filesystem::exists(videofile)) {
+
+        LOG_ERROR("VideoPlayer: DecodeAllFrames: file doesn't exist: " + videofile);
+        return -1;
+    }
+
+    VideoFile = videofile;
+
+    if(!FFMPEGLoadFile()) {
+
+        LOG_ERROR("VideoPlayer: DecodeAllFrames: ffmpeg failed to parse the file");
+        Stop();
+        return -1;
+    }
+
+    // Nothing would read the audio so the decode thread can skip it //
+    if(AudioCodec)
+        avcodec_free_context(&AudioCodec);
+
+    StartDecodeThread();
+
+    int decodedFrames = 0;
+
+    {
+        Lock lock(ReadPacketMutex);
+
+        while(true) {
+
+            DecodedDataNotify.wait(
+                lock, [this]() { return DecodedFrameCount > 0 || VideoDecodeEnded; });
+
+            if(DecodedFrameCount == 0)
+                break;
+
+            FirstDecodedFrame = (FirstDecodedFrame + 1) % DECODE_AHEAD_FRAMES;
+            --DecodedFrameCount;
+            ++decodedFrames;
+
+            DecodeThreadNotify.notify_all();
+        }
+    }
+
+    const bool succeeded = StreamValid;
+
+    Stop();
+    return succeeded ? decodedFrames : -1;
+}
+// ------------------------------------ //
+void VideoPlayer::StartDecodeThread()
+{
+    {
+        Lock lock(ReadPacketMutex);
+
+        StopDecoding = false;
+        DemuxEnded = false;
+        VideoDecodeEnded = false;
+        FirstDecodedFrame = 0;
+        DecodedFrameCount = 0;
+    }
+
+    DecodeThread = std::thread(&VideoPlayer::RunDecodeThread, this);
+}
+
+void VideoPlayer::StopDecodeThread()
+{
+    {
+        Lock lock(ReadPacketMutex);
+        StopDecoding = true;
+    }
+
+    DecodeThreadNotify.notify_all();
+    DecodedDataNotify.notify_all();
+
+    if(DecodeThread.joinable())
+        DecodeThread.join();
+}
+
+void VideoPlayer::RunDecodeThread()
+{
+    Lock lock(ReadPacketMutex);
+
+    while(!StopDecoding) {
+
+        if(!StreamValid) {
+
+            // Let the main thread notice the error. Waiting audio reads are woken up so that
+            // they can also quit
+            VideoDecodeEnded = true;
+            DemuxEnded = true;
+            break;
+        }
+
+        const bool frameSlotFree =
+            !VideoDecodeEnded && DecodedFrameCount < DECODE_AHEAD_FRAMES;
+
+        const bool audioWanted = AudioCodec && !DemuxEnded &&
+                                 WaitingAudioPackets.size() < MIN_QUEUED_AUDIO_PACKETS;
+
+        if(!frameSlotFree && !audioWanted) {
+
+            DecodeThreadNotify.wait(lock);
+            continue;
+        }
+
+        if(!frameSlotFree) {
+
+            // Demux until there is enough audio queued //
+            lock.unlock();
+            ReadOnePacket();
+            lock.lock();
+            continue;
+        }
+
+        // The main thread doesn't touch the slot after the last frame so it can be written
+        // without the lock
+        DecodedVideoFrame& target =
+            DecodedFrames[(FirstDecodedFrame + DecodedFrameCount) % DECODE_AHEAD_FRAMES];
+
+        lock.unlock();
+
+        FrameDecodeResult result;
+
+        while((result = DecodeVideoFrame(target)) == FrameDecodeResult::NeedsData) {
+
+            if(SendVideoPacket())
+                continue;
+
+            if(ReadOnePacket() == PacketReadResult::Ended) {
+
+                if(!StreamValid) {
+                    result = FrameDecodeResult::Ended;
+                    break;
+                }
+
+                // Flush out the frames the decoder still has. After these
+                // avcodec_receive_frame reports the end
+                avcodec_send_packet(VideoCodec, nullptr);
+            }
+        }
+
+        lock.lock();
+
+        if(result == FrameDecodeResult::Decoded) {
+            ++DecodedFrameCount;
+        } else {
+            VideoDecodeEnded = true;
+        }
+
+        DecodedDataNotify.notify_all();
+    }
+
+    lock.unlock();
+    DecodedDataNotify.notify_all();
+}
 // ------------------------------------ //
 DLLEXPORT float VideoPlayer::GetDuration() const
 {
@@ -289,12 +462,15 @@ bool VideoPlayer::FFMPEGLoadFile()
     ConvertedBufferSize =
         av_image_get_buffer_size(FFMPEG_DECODE_TARGET, FrameWidth, FrameHeight, 1);
 
-    ConvertedFrameBuffer =
-        reinterpret_cast<uint8_t*>(av_malloc(ConvertedBufferSize * sizeof(uint8_t)));
+    for(auto& frame : DecodedFrames) {
 
-    if(!ConvertedFrameBuffer) {
-        LOG_ERROR("VideoPlayer: FFMPEG: av_malloc failed for ConvertedFrameBuffer");
-        return false;
+        frame.Data =
+            reinterpret_cast<uint8_t*>(av_malloc(ConvertedBufferSize * sizeof(uint8_t)));
+
+        if(!frame.Data) {
+            LOG_ERROR("VideoPlayer: FFMPEG: av_malloc failed for a decoded frame buffer");
+            return false;
+        }
     }
 
     if(ConvertedBufferSize != static_cast<size_t>(FrameWidth * FrameHeight * 4)) {
@@ -304,12 +480,6 @@ bool VideoPlayer::FFMPEGLoadFile()
         return false;
     }
 
-    if(av_image_fill_arrays(ConvertedFrame->data, ConvertedFrame->linesize,
-           ConvertedFrameBuffer, FFMPEG_DECODE_TARGET, FrameWidth, FrameHeight, 1) < 0) {
-        LOG_ERROR("VideoPlayer: FFMPEG: av_image_fill_arrays failed");
-        return false;
-    }
-
     // Converting images to be ogre compatible is done by this
     // TODO: allow controlling how good conversion is done
     // SWS_FAST_BILINEAR is the fastest
@@ -410,9 +580,7 @@ bool VideoPlayer::FFMPEGLoadFile()
     FirstCallbackAfterPlay = true;
 
     PassedTimeSeconds = 0.f;
-    NextFrameReady = false;
-    // This is -1 to make this smaller than 0
-    CurrentlyDecodedTimeStamp = -1.f;
+    CurrentlyShownTimeStamp = 0.f;
 
     StreamValid = true;
 
@@ -487,7 +655,7 @@ bool VideoPlayer::OpenStream(unsigned int index, bool video)
     return true;
 }
 // ------------------------------------ //
-bool VideoPlayer::DecodeVideoFrame()
+VideoPlayer::FrameDecodeResult VideoPlayer::DecodeVideoFrame(DecodedVideoFrame& target)
 {
     const auto result = avcodec_receive_frame(VideoCodec, DecodedFrame);
 
@@ -495,12 +663,20 @@ bool VideoPlayer::DecodeVideoFrame()
 
         // Worked //
 
+        if(av_image_fill_arrays(ConvertedFrame->data, ConvertedFrame->linesize, target.Data,
+               FFMPEG_DECODE_TARGET, FrameWidth, FrameHeight, 1) < 0) {
+            LOG_ERROR("VideoPlayer: FFMPEG: av_image_fill_arrays failed");
+            StreamValid = false;
+            return FrameDecodeResult::Ended;
+        }
+
         // Convert the image from its native format to RGB
         if(sws_scale(ImageConverter, DecodedFrame->data, DecodedFrame->linesize, 0,
                FrameHeight, ConvertedFrame->data, ConvertedFrame->linesize) < 0) {
             // Failed to convert frame //
             LOG_ERROR("Converting video frame failed");
-            return false;
+            StreamValid = false;
+            return FrameDecodeResult::Ended;
         }
 
         // Seems like DecodedFrame->pts contains garbage
@@ -513,172 +689,134 @@ bool VideoPlayer::DecodeVideoFrame()
         // Seems that the latest FFMPEG version has fixed this.
         // I would put this in a #IF macro bLock if ffmpeg provided a way to check the
         // version at compile time
-        CurrentlyDecodedTimeStamp = DecodedFrame->pts * VideoTimeBase;
-        return true;
+        target.TimeStamp = DecodedFrame->pts * VideoTimeBase;
+        return FrameDecodeResult::Decoded;
     }
 
     if(result == AVERROR(EAGAIN)) {
 
         // Waiting for data //
-        return false;
+        return FrameDecodeResult::NeedsData;
+    }
+
+    if(result == AVERROR_EOF) {
+
+        // Decoder has been flushed //
+        return FrameDecodeResult::Ended;
     }
 
     LOG_ERROR("VideoPlayer: DecodeVideoFrame: frame receive failed, error: " +
               std::to_string(result));
-    return false;
+    StreamValid = false;
+    return FrameDecodeResult::Ended;
 }
 
-VideoPlayer::PacketReadResult VideoPlayer::ReadOnePacket(
-    Lock& packetmutex, DecodePriority priority)
+VideoPlayer::PacketReadResult VideoPlayer::ReadOnePacket()
 {
     if(!FormatContext || !StreamValid)
         return PacketReadResult::Ended;
 
-    // Decode queued packets first
-    if(priority == DecodePriority::Video && !WaitingVideoPackets.empty()) {
-
-        // Try to send it //
-        const auto Result =
-            avcodec_send_packet(VideoCodec, &WaitingVideoPackets.front()->packet);
-
-        if(Result == AVERROR(EAGAIN)) {
-
-            // Still wailing to send //
-            return PacketReadResult::QueueFull;
-        }
-
-        if(Result < 0) {
-
-            // An error occured //
-            LOG_ERROR("Video stream send error from queue, stopping playback");
-            StreamValid = false;
-            return PacketReadResult::Ended;
-        }
-
-        // Successfully sent the first in the queue //
-        WaitingVideoPackets.pop_front();
-        return PacketReadResult::Ok;
-    }
-
-    if(priority == DecodePriority::Audio && !WaitingAudioPackets.empty()) {
-
-        // Try to send it //
-        const auto Result =
-            avcodec_send_packet(AudioCodec, &WaitingAudioPackets.front()->packet);
-
-        if(Result == AVERROR(EAGAIN)) {
-
-            // Still wailing to send //
-            return PacketReadResult::QueueFull;
-        }
-
-        if(Result < 0) {
-
-            // An error occured //
-            LOG_ERROR("VideoPlayer: Audio stream send error from queue, stopping playback");
-            StreamValid = false;
-            return PacketReadResult::Ended;
-        }
-
-        // Successfully sent the first in the queue //
-        WaitingAudioPackets.pop_front();
-        return PacketReadResult::Ok;
-    }
-
-    // If we had nothing in the right queue try to read more frames //
-
     AVPacket Packet;
     // av_init_packet(&packet);
 
     if(av_read_frame(FormatContext, &Packet) < 0) {
 
         // Stream ended //
-        // av_packet_unref(&packet);
-        return PacketReadResult::Ended;
-    }
-
-    if(!StreamValid) {
+        {
+            Lock lock(ReadPacketMutex);
+            DemuxEnded = true;
+        }
 
-        av_packet_unref(&Packet);
+        // The audio thread may be waiting for more packets
+        DecodedDataNotify.notify_all();
         return PacketReadResult::Ended;
     }
 
     // Is this a packet from the video stream?
     if(Packet.stream_index == VideoIndex) {
 
-        // If not wanting this stream don't send it //
-        if(priority != DecodePriority::Video) {
+        WaitingVideoPackets.push_back(std::unique_ptr<ReadPacket>(new ReadPacket(&Packet)));
+        return PacketReadResult::Ok;
 
-            WaitingVideoPackets.push_back(
-                std::unique_ptr<ReadPacket>(new ReadPacket(&Packet)));
+    } else if(Packet.stream_index == AudioIndex && AudioCodec) {
 
-            return PacketReadResult::Ok;
+        // If audio codec is null audio playback is disabled //
+        {
+            Lock lock(ReadPacketMutex);
+            WaitingAudioPackets.push_back(
+                std::unique_ptr<ReadPacket>(new ReadPacket(&Packet)));
         }
 
-        // Send it to the decoder //
-        const auto Result = avcodec_send_packet(VideoCodec, &Packet);
+        DecodedDataNotify.notify_all();
+        return PacketReadResult::Ok;
+    }
 
-        if(Result == AVERROR(EAGAIN)) {
+    // Unknown stream, ignore
+    av_packet_unref(&Packet);
+    return PacketReadResult::Ok;
+}
 
-            // Add to queue //
-            WaitingVideoPackets.push_back(
-                std::unique_ptr<ReadPacket>(new ReadPacket(&Packet)));
-            return PacketReadResult::QueueFull;
-        }
+bool VideoPlayer::SendVideoPacket()
+{
+    if(WaitingVideoPackets.empty() || !StreamValid)
+        return false;
 
-        av_packet_unref(&Packet);
+    const auto result = avcodec_send_packet(VideoCodec, &WaitingVideoPackets.front()->packet);
 
-        if(Result < 0) {
+    if(result == AVERROR(EAGAIN)) {
 
-            LOG_ERROR("VideoPlayer:Video stream send error, stopping playback");
-            StreamValid = false;
-            return PacketReadResult::Ended;
-        }
+        // Frames need to be received first, the packet stays queued //
+        return true;
+    }
 
-        return PacketReadResult::Ok;
+    WaitingVideoPackets.pop_front();
 
-    } else if(Packet.stream_index == AudioIndex && AudioCodec) {
+    if(result < 0) {
 
-        // If audio codec is null audio playback is disabled //
+        LOG_ERROR("VideoPlayer: Video stream send error, stopping playback");
+        StreamValid = false;
+        return false;
+    }
 
-        // If not wanting this stream don't send it //
-        if(priority != DecodePriority::Audio) {
+    return true;
+}
 
-            WaitingAudioPackets.push_back(
-                std::unique_ptr<ReadPacket>(new ReadPacket(&Packet)));
-            return PacketReadResult::Ok;
-        }
+bool VideoPlayer::SendAudioPacket()
+{
+    std::unique_ptr<ReadPacket> packet;
+
+    {
+        Lock lock(ReadPacketMutex);
 
-        const auto Result = avcodec_send_packet(AudioCodec, &Packet);
+        while(WaitingAudioPackets.empty()) {
 
-        if(Result == AVERROR(EAGAIN)) {
+            if(DemuxEnded || StopDecoding || !StreamValid)
+                return false;
 
-            // Add to queue //
-            WaitingAudioPackets.push_back(
-                std::unique_ptr<ReadPacket>(new ReadPacket(&Packet)));
-            return PacketReadResult::QueueFull;
+            DecodeThreadNotify.notify_all();
+            DecodedDataNotify.wait(lock);
         }
 
-        av_packet_unref(&Packet);
+        packet = std::move(WaitingAudioPackets.front());
+        WaitingAudioPackets.pop_front();
 
-        if(Result < 0) {
+        if(WaitingAudioPackets.size() < MIN_QUEUED_AUDIO_PACKETS)
+            DecodeThreadNotify.notify_all();
+    }
 
-            LOG_ERROR("Audio stream send error, stopping audio playback");
-            StreamValid = false;
-            return PacketReadResult::Ended;
-        }
+    // This is only called after the decoder has run out of frames so this doesn't return
+    // EAGAIN
+    if(avcodec_send_packet(AudioCodec, &packet->packet) < 0) {
 
-        // This is probably not needed? and was an error before
-        // av_packet_unref(&Packet);
-        return PacketReadResult::Ok;
+        LOG_ERROR("VideoPlayer: Audio stream send error, stopping playback");
+        StreamValid = false;
+        return false;
     }
 
-    // Unknown stream, ignore
-    av_packet_unref(&Packet);
-    return PacketReadResult::Ok;
+    return true;
 }
 // ------------------------------------ //
-void VideoPlayer::UpdateTexture()
+void VideoPlayer::UpdateTexture(const DecodedVideoFrame& frame)
 {
     auto buffer = GetNextDataBuffer();
     if(!buffer) {
@@ -686,7 +824,7 @@ void VideoPlayer::UpdateTexture()
         return;
     }
 
-    std::memcpy((*buffer)->getData(), ConvertedFrameBuffer, ConvertedBufferSize);
+    std::memcpy((*buffer)->getData(), frame.Data, ConvertedBufferSize);
     VideoOutputTexture->writeData(*buffer, 0, 0, true);
 }
 
@@ -698,7 +836,6 @@ bs::SPtr<bs::PixelData> VideoPlayer::_OnNewBufferNeeded()
 size_t VideoPlayer::ReadAudioData(uint8_t* output, size_t amount)
 {
     Lock lock(AudioMutex);
-    Lock lock2(ReadPacketMutex);
 
     if(!AudioCodec || !StreamValid) {
         return 0;
@@ -739,7 +876,7 @@ size_t VideoPlayer::ReadAudioData(uint8_t* output, size_t amount)
 
         if(result == AVERROR(EAGAIN)) {
 
-            if(this->ReadOnePacket(lock2, DecodePriority::Audio) == PacketReadResult::Ended) {
+            if(!SendAudioPacket()) {
 
                 // Stream ended //
                 return readAmount / bytesPerSample / ChannelCount;
@@ -883,10 +1020,15 @@ void VideoPlayer::OnStreamEndReached()
 
 void VideoPlayer::SeekVideo(float time)
 {
+    if(!FormatContext || !VideoCodec)
+        return;
 
     if(time < 0)
         time = 0;
 
+    // The decode thread uses the demuxer and the decoders so it is stopped for the seek //
+    StopDecodeThread();
+
     const auto seekPos = static_cast<uint64_t>(time * AV_TIME_BASE);
 
     const auto timeStamp = av_rescale_q(seekPos,
@@ -901,6 +1043,29 @@ void VideoPlayer::SeekVideo(float time)
 
     av_seek_frame(FormatContext, VideoIndex, timeStamp, AVSEEK_FLAG_BACKWARD);
 
+    // Nothing decoded from before the seek may be shown //
+    avcodec_flush_buffers(VideoCodec);
+
+    {
+        Lock lock(ReadPacketMutex);
+
+        WaitingVideoPackets.clear();
+        WaitingAudioPackets.clear();
+    }
+
+    if(AudioCodec) {
+
+        Lock lock(AudioMutex);
+
+        avcodec_flush_buffers(AudioCodec);
+        ReadAudioDataBuffer.clear();
+    }
+
+    PassedTimeSeconds = time;
+
+    // This also empties the decoded frame queue //
+    StartDecodeThread();
+
     LOG_WARNING("VideoPlayer: SeekVideo: audio seeking not implemented!");
 }
 // ------------------------------------ //
@@ -964,34 +1129,57 @@ DLLEXPORT int VideoPlayer::OnEvent(Event* event)
             IsPlayingAudio = true;
         }
 
-        // This loops until we are displaying a frame we should be showing at this time //
-        while(CurrentlyDecodedTimeStamp <= PassedTimeSeconds) {
+        // Find the newest decoded frame that should be showing by now. Frames that are
+        // already late are skipped
+        DecodedVideoFrame* frameToShow = nullptr;
+        bool ended = false;
 
-            // Make sure the next frame is ready
-            if(!NextFrameReady) {
-                Lock lock(ReadPacketMutex);
+        {
+            Lock lock(ReadPacketMutex);
+
+            size_t readyFrames = 0;
 
-                while(!NextFrameReady) {
+            while(readyFrames < DecodedFrameCount &&
+                  DecodedFrames[(FirstDecodedFrame + readyFrames) % DECODE_AHEAD_FRAMES]
+                          .TimeStamp <= PassedTimeSeconds) {
+                ++readyFrames;
+            }
 
-                    // Decode a packet if none are in queue
-                    if(ReadOnePacket(lock, DecodePriority::Video) == PacketReadResult::Ended) {
+            if(readyFrames > 1) {
 
-                        // There are no more frames, end the playback
-                        lock.unlock();
-                        OnStreamEndReached();
-                        return -1;
-                    }
+                FirstDecodedFrame =
+                    (FirstDecodedFrame + readyFrames - 1) % DECODE_AHEAD_FRAMES;
+                DecodedFrameCount -= readyFrames - 1;
+                DecodeThreadNotify.notify_all();
+            }
 
-                    NextFrameReady = DecodeVideoFrame();
-                }
+            if(readyFrames > 0) {
+                frameToShow = &DecodedFrames[FirstDecodedFrame];
+            } else {
+                ended = DecodedFrameCount == 0 && VideoDecodeEnded;
             }
+        }
 
-            // Don't show a frame yet if it is too soon
-            if(PassedTimeSeconds < CurrentlyDecodedTimeStamp)
-                break;
+        if(ended) {
+
+            // There are no more frames, end the playback
+            OnStreamEndReached();
+            return -1;
+        }
+
+        if(frameToShow) {
+
+            // The decode thread doesn't write to the first frame until it is released below
+            UpdateTexture(*frameToShow);
+            CurrentlyShownTimeStamp = frameToShow->TimeStamp;
+
+            {
+                Lock lock(ReadPacketMutex);
+                FirstDecodedFrame = (FirstDecodedFrame + 1) % DECODE_AHEAD_FRAMES;
+                --DecodedFrameCount;
+            }
 
-            UpdateTexture();
-            NextFrameReady = false;
+            DecodeThreadNotify.notify_all();
         }
 
         return 0;
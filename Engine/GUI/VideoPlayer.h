@@ -11,7 +11,10 @@
 
 #include "bsfCore/BsCorePrerequisites.h"
 
+#include <array>
 #include <chrono>
+#include <condition_variable>
+#include <thread>
 #include <vector>
 
 extern "C" {
@@ -31,6 +34,10 @@ namespace Leviathan { namespace GUI {
 //! written by Henri Hyyryläinen which in turn was based on
 //! ogre-ffmpeg-videoplayer, but all original ogre-ffmpeg-videoplayer
 //! code has been removed in course of all the rewrites.
+//!
+//! Demuxing and video decoding happen on a background thread that converts frames ahead of
+//! time into a small queue. The main thread only uploads the frame that should be showing
+//! and the audio thread only decodes the audio packets the decode thread has queued for it.
 //! \todo Implement pausing and seeking
 //! \todo When Stop is called the OnPlaybackEnded should still be fired. If something was
 //! playing
@@ -38,17 +45,35 @@ class VideoPlayer : public CallableObject, RotatingBufferHelper<bs::SPtr<bs::Pix
 protected:
     using ClockType = std::chrono::steady_clock;
 
+    //! How many converted frames the decode thread can have waiting for the main thread.
+    //! This matches the number of texture upload buffers
+    static constexpr size_t DECODE_AHEAD_FRAMES = 4;
+
+    //! The decode thread keeps at least this many audio packets ready for the audio thread
+    static constexpr size_t MIN_QUEUED_AUDIO_PACKETS = 8;
+
     enum class PacketReadResult {
 
         Ended,
-        Ok,
-        QueueFull
+        Ok
+    };
+
+    enum class FrameDecodeResult {
+
+        Decoded,
+        NeedsData,
+        //! All frames have been decoded or an error occurred
+        Ended
     };
 
-    enum class DecodePriority {
+    //! A frame converted by the decode thread
+    struct DecodedVideoFrame {
 
-        Video,
-        Audio
+        //! Allocated with av_malloc, ConvertedBufferSize bytes
+        uint8_t* Data = nullptr;
+
+        //! Presentation time in seconds
+        float TimeStamp = 0.f;
     };
 
     //! Holds converted audio data that could not be immediately returned by ReadAudioData
@@ -96,6 +121,13 @@ public:
     //! \brief Stops playing and unloads the current playback objects
     DLLEXPORT void Stop();
 
+    //! \brief Decodes all the frames of a video as fast as possible
+    //!
+    //! Doesn't need a renderer or a sound device, only the decode thread is ran and the
+    //! converted frames are discarded. Meant for measuring decode throughput
+    //! \returns The number of decoded frames or -1 if the file couldn't be decoded
+    DLLEXPORT int DecodeAllFrames(const std::string& videofile);
+
     // ------------------------------------ //
     // Stream info
 
@@ -106,10 +138,10 @@ public:
     }
 
     //! \returns Current playback position, in seconds
-    //! The return value is directly read from the last decoded frame timestamp
+    //! The return value is the timestamp of the frame that is currently shown
     DLLEXPORT float GetCurrentTime() const
     {
-        return CurrentlyDecodedTimeStamp;
+        return CurrentlyShownTimeStamp;
     }
 
     //! \returns The total length of the video is seconds
@@ -144,7 +176,7 @@ public:
     //! \returns true if all the ffmpeg stream objects are valid for playback
     DLLEXPORT bool IsStreamValid() const
     {
-        return StreamValid && VideoCodec && ConvertedFrameBuffer;
+        return StreamValid && VideoCodec && DecodedFrames[0].Data;
     }
 
     DLLEXPORT auto GetTexture() const
@@ -180,15 +212,34 @@ protected:
     //! \returns true on success
     bool OpenStream(unsigned int index, bool video);
 
-    //! \brief Decodes one video frame. Returns false if more data is required
-    //! by the decoder
-    bool DecodeVideoFrame();
+    //! \brief Decodes and converts one video frame into target
+    //! \note Only called on the decode thread
+    FrameDecodeResult DecodeVideoFrame(DecodedVideoFrame& target);
+
+    //! \brief Reads a single packet from the stream and queues it for the right decoder
+    //! \note Only called on the decode thread
+    PacketReadResult ReadOnePacket();
+
+    //! \brief Sends the next queued video packet to the decoder
+    //! \returns False if there are no queued packets or the stream is invalid
+    bool SendVideoPacket();
+
+    //! \brief Sends the next queued audio packet to the decoder. Waits for the decode thread
+    //! if none are queued
+    //! \returns False if the stream has ended
+    bool SendAudioPacket();
 
-    //! \brief Reads a single packet from the stream that matches Priority
-    PacketReadResult ReadOnePacket(Lock& packetmutex, DecodePriority priority);
+    //! \brief Main loop of the decode thread
+    void RunDecodeThread();
 
-    //! \brief Updates the texture
-    void UpdateTexture();
+    //! \brief Starts the decode thread after the file has been loaded
+    void StartDecodeThread();
+
+    //! \brief Stops the decode thread and waits for it to quit
+    void StopDecodeThread();
+
+    //! \brief Updates the texture with frame
+    void UpdateTexture(const DecodedVideoFrame& frame);
 
     bs::SPtr<bs::PixelData> _OnNewBufferNeeded() override;
 
@@ -205,6 +256,9 @@ protected:
     void OnStreamEndReached();
 
     //! Video streem seaking. Don't use as the audio will get out of sync
+    //!
+    //! Stops the decode thread for the seek and throws away all the queued packets and
+    //! decoded frames before starting it again
     DLLEXPORT void SeekVideo(float time);
 
 public:
@@ -241,13 +295,21 @@ protected:
     AVFrame* DecodedFrame = nullptr;
     AVFrame* DecodedAudio = nullptr;
 
-    //! Once a frame has been loaded to DecodedFrame it is converted
-    //! to a format that Ogre texture can accept
+    //! Once a frame has been loaded to DecodedFrame it is converted to a format that the
+    //! texture can accept. This points to the data of the frame in DecodedFrames that is
+    //! being written
     AVFrame* ConvertedFrame = nullptr;
 
-    //! This is the backing buffer for ConvertedFrame
-    //! \note This is not a smart pointer because this needs to be released with av_freep
-    uint8_t* ConvertedFrameBuffer = nullptr;
+    //! Converted frames waiting to be shown. This is a ring buffer starting from
+    //! FirstDecodedFrame with DecodedFrameCount frames. The decode thread writes only to the
+    //! slot after the last frame and the main thread reads only the first frame so the data
+    //! is accessed without holding ReadPacketMutex.
+    //! RotatingBufferHelper isn't used for this as it hands out any buffer that the GPU
+    //! isn't reading, without keeping the frames in order between two threads. It is still
+    //! used for the texture upload buffers
+    std::array<DecodedVideoFrame, DECODE_AHEAD_FRAMES> DecodedFrames;
+    size_t FirstDecodedFrame = 0;
+    size_t DecodedFrameCount = 0;
 
     //! Required size for a single converted frame
     size_t ConvertedBufferSize = 0;
@@ -275,9 +337,9 @@ protected:
 
     // Timing control
     float PassedTimeSeconds = 0.f;
-    float CurrentlyDecodedTimeStamp = 0.f;
 
-    bool NextFrameReady = false;
+    //! Time stamp of the frame that is in the texture
+    float CurrentlyShownTimeStamp = 0.f;
 
     //! Set to false if an error occurs and playback should stop
     std::atomic<bool> StreamValid{false};
@@ -288,8 +350,32 @@ protected:
     //! Also if paused this will need to be set true when resuming
     bool FirstCallbackAfterPlay = true;
 
+    //! Runs RunDecodeThread
+    std::thread DecodeThread;
+
+    //! Protects WaitingAudioPackets, the DecodedFrames counts and the decode state flags
     Mutex ReadPacketMutex;
+
+    //! Notified when the decode thread has more work to do
+    std::condition_variable DecodeThreadNotify;
+
+    //! Notified by the decode thread when it has queued audio packets or a frame or has
+    //! stopped
+    std::condition_variable DecodedDataNotify;
+
+    //! Set to make the decode thread quit
+    bool StopDecoding = false;
+
+    //! True once all packets have been read from the file
+    bool DemuxEnded = false;
+
+    //! True once the decode thread has converted the last frame
+    bool VideoDecodeEnded = false;
+
+    //! Only accessed by the decode thread
     std::list<std::unique_ptr<ReadPacket>> WaitingVideoPackets;
+
+    //! Filled by the decode thread and consumed by the audio thread
     std::list<std::unique_ptr<ReadPacket>> WaitingAudioPackets;
 
 public:
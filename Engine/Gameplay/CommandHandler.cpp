@@ -3,6 +3,7 @@
 
 #include "Iterators/StringIterator.h"
 #include "Threading/ThreadingManager.h"
+#include "utf8/checked.h"
 using namespace Leviathan;
 // ------------------------------------ //
 
@@ -63,15 +64,25 @@ DLLEXPORT void Leviathan::CommandHandler::QueueCommand(const std::string &comman
     CommandSender* issuer)
 {
 	// Get the first word //
-	StringIterator itr(std::make_unique<UTF8DataIterator>(command));
+	StringIterator itr(std::make_unique<UTF8ViewDataIterator>(command));
 
-	// Only skip a single / if there is one //
-	if(itr.GetCharacter() == '/')
-		itr.MoveToNext();
+	std::unique_ptr<std::string> firstword;
 
-	// Get the first word //
-	auto firstword = itr.GetNextCharacterSequence<std::string>(
-        UNNORMALCHARACTER_TYPE_LOWCODES);
+	// The iterator throws on invalid utf8 //
+	try{
+		// Only skip a single / if there is one //
+		if(itr.GetCharacter() == '/')
+			itr.MoveToNext();
+
+		// Get the first word //
+		firstword = itr.GetNextCharacterSequence<std::string>(
+			UNNORMALCHARACTER_TYPE_LOWCODES);
+
+	} catch(const utf8::exception&){
+
+		issuer->SendPrivateMessage("Invalid command, the command is not valid utf8");
+		return;
+	}
 
 	if(!firstword || firstword->empty())
 		return;
@@ -38,6 +38,15 @@ DLLEXPORT bool Leviathan::StringDataIterator::ReturnSubString(size_t startpos, s
         "sure your provided data source string type is the same as the request template type");
     return false;
 }
+
+DLLEXPORT bool Leviathan::StringDataIterator::ReturnSubString(size_t startpos, size_t endpos,
+    std::string_view &receiver)
+{
+    DEBUG_BREAK;
+    LEVIATHAN_ASSERT(0, "StringDataIterator doesn't support getting with type: string_view, "
+        "only contiguous utf8 data sources can return views");
+    return false;
+}
 // ------------------------------------ //
 DLLEXPORT size_t Leviathan::StringDataIterator::GetCurrentCharacterNumber() const{
     return CurrentCharacterNumber;
@@ -209,6 +218,19 @@ DLLEXPORT bool UTF8PointerDataIterator::ReturnSubString(size_t startpos, size_t
     return true;
 }
 
+DLLEXPORT bool UTF8PointerDataIterator::ReturnSubString(size_t startpos, size_t endpos,
+    std::string_view &receiver)
+{
+    if(startpos >= static_cast<size_t>(End - BeginPos) ||
+        endpos >= static_cast<size_t>(End - BeginPos) || startpos > endpos)
+    {
+        return false;
+    }
+
+    receiver = std::string_view(BeginPos + startpos, (endpos - startpos) + 1);
+    return true;
+}
+
     
 
 // ------------------------------------ //
@@ -226,3 +248,39 @@ DLLEXPORT UTF8DataIterator::UTF8DataIterator(const std::string &str) :
     // incremented immediately
     CheckLineChange();
 }
+// ------------------------------------ //
+// UTF8ViewDataIterator
+DLLEXPORT UTF8ViewDataIterator::UTF8ViewDataIterator(std::string_view data) :
+    UTF8PointerDataIterator(data.data(), data.data() + data.size())
+{
+
+}
+
+DLLEXPORT void UTF8ViewDataIterator::SkipBytes(size_t count){
+
+    LEVIATHAN_ASSERT(count <= static_cast<size_t>(End - Current),
+        "UTF8ViewDataIterator: SkipBytes past the end");
+
+    const char* target = Current + count;
+
+    // The current character was already counted when moving to it //
+    for(const char* position = Current + 1; position <= target; ++position){
+
+        // Moving to the end also counts as a character like in MoveToNextCharacter //
+        if(position == End){
+            ++CurrentCharacterNumber;
+            break;
+        }
+
+        // Continuation bytes are part of the previous character //
+        if((static_cast<unsigned char>(*position) & 0xC0) == 0x80)
+            continue;
+
+        ++CurrentCharacterNumber;
+
+        if(IsLineChange(position))
+            ++CurrentLineNumber;
+    }
+
+    Current = target;
+}
@@ -2,6 +2,9 @@
 // ------------------------------------ //
 #include "Define.h"
 // ------------------------------------ //
+#include "StringScanning.h"
+
+#include <string_view>
 
 
 namespace Leviathan{
@@ -44,6 +47,11 @@ public:
     DLLEXPORT virtual bool ReturnSubString(size_t startpos, size_t endpos, 
         std::wstring &receiver);
 
+    //! \brief Returns a view into the underlying data instead of a copy
+    //! \note Only supported by iterators that have contiguous utf8 data
+    DLLEXPORT virtual bool ReturnSubString(size_t startpos, size_t endpos,
+        std::string_view &receiver);
+
 
     //! \brief Gets the position of the iterator, for use with ReturnSubString and others
     virtual size_t CurrentIteratorPosition() const = 0;
@@ -269,6 +277,10 @@ public:
     DLLEXPORT virtual bool ReturnSubString(size_t startpos, size_t endpos, 
         std::string &receiver);
 
+    //! \note The view is valid as long as the wrapped data is
+    DLLEXPORT virtual bool ReturnSubString(size_t startpos, size_t endpos,
+        std::string_view &receiver);
+
 protected:
 
     //! The current position of the iterator
@@ -295,10 +307,100 @@ protected:
     std::string OurString;
 };
 
+//! \brief Utf8 iterator over a buffer owned by someone else
+//!
+//! This is final so that StringIterator can call it without going through the vtable. ASCII
+//! characters are handled inline and only multibyte sequences use the utf8 library. Use
+//! this with std::string_view or memory mapped files for parsing without copying the input.
+//! \note The data must stay alive while this is used
+class UTF8ViewDataIterator final : public UTF8PointerDataIterator{
+public:
+
+    DLLEXPORT UTF8ViewDataIterator(std::string_view data);
+
+    inline bool GetNextCharCode(int &codepointreceiver, size_t forward) override{
+
+        if(Current + forward >= End)
+            return false;
+
+        // Everything up to the wanted character needs to be single byte //
+        if(forward <= 1 && IsSingleByte(Current[0]) && IsSingleByte(Current[forward])){
+
+            codepointreceiver = Current[forward];
+            return true;
+        }
+
+        return UTF8PointerDataIterator::GetNextCharCode(codepointreceiver, forward);
+    }
+
+    inline void MoveToNextCharacter() override{
+
+        if(Current == End)
+            return;
+
+        if(!IsSingleByte(*Current)){
+
+            UTF8PointerDataIterator::MoveToNextCharacter();
+            return;
+        }
+
+        ++Current;
+        ++CurrentCharacterNumber;
+
+        if(Current == End)
+            return;
+
+        if(!IsSingleByte(*Current)){
+            CheckLineChange();
+            return;
+        }
+
+        if(IsLineChange(Current))
+            ++CurrentLineNumber;
+    }
+
+    inline size_t CurrentIteratorPosition() const override{
+        return Current - BeginPos;
+    }
+
+    inline bool IsPositionValid() const override{
+        return Current != End;
+    }
+
+    //! \brief Moves forward count bytes at once
+    //!
+    //! Used by StringIterator after it has scanned for characters it doesn't need to look at
+    //! one by one.
+    //! \note The skipped range may not contain non-ASCII line terminators and needs to end at
+    //! a character boundary
+    DLLEXPORT void SkipBytes(size_t count);
+
+    //! \returns The data from the current position to the end
+    inline std::string_view GetRemainingData() const{
+        return std::string_view(Current, End - Current);
+    }
+
+private:
+
+    static inline bool IsSingleByte(char character){
+        return (static_cast<unsigned char>(character) & 0x80) == 0;
+    }
+
+    //! \returns True if position (which must be valid) starts a new line
+    //! \see StringDataIterator::CheckLineChange
+    inline bool IsLineChange(const char* position) const{
+
+        if(!StringScanning::IsASCIILineTerminator(static_cast<unsigned char>(*position)))
+            return false;
+
+        return *position != '\r' || position + 1 == End || position[1] != '\n';
+    }
+};
 
 }
 
 #ifdef LEAK_INTO_GLOBAL
 using Leviathan::UTF8DataIterator;
+using Leviathan::UTF8ViewDataIterator;
 #endif
 
@@ -13,6 +13,12 @@ DLLEXPORT Leviathan::StringIterator::StringIterator(
     DataIterator(iterator.release())
 {}
 
+DLLEXPORT Leviathan::StringIterator::StringIterator(
+    std::unique_ptr<UTF8ViewDataIterator>&& iterator) :
+    HandlesDelete(true),
+    DataIterator(iterator.get()), ViewIterator(iterator.release())
+{}
+
 DLLEXPORT Leviathan::StringIterator::StringIterator(const string& text) :
     HandlesDelete(true), DataIterator(new StringClassDataIterator<string>(text))
 {}
@@ -49,6 +55,7 @@ DLLEXPORT void StringIterator::ReInit(std::unique_ptr<StringDataIterator>&& iter
 
     HandlesDelete = true;
     DataIterator = iterator.release();
+    ViewIterator = nullptr;
 
     // Reset everything //
     CurrentCharacter = -1;
@@ -59,6 +66,15 @@ DLLEXPORT void StringIterator::ReInit(std::unique_ptr<StringDataIterator>&& iter
     CurrentFlags = 0;
 }
 
+DLLEXPORT void StringIterator::ReInit(std::unique_ptr<UTF8ViewDataIterator>&& iterator)
+{
+    UTF8ViewDataIterator* view = iterator.get();
+
+    ReInit(std::unique_ptr<StringDataIterator>(std::move(iterator)));
+
+    ViewIterator = view;
+}
+
 DLLEXPORT void Leviathan::StringIterator::ReInit(const wstring& text)
 {
     ReInit(std::make_unique<StringClassDataIterator<wstring>>(text));
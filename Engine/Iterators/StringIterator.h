@@ -137,6 +137,13 @@ public:
     //! \brief Creates a iterator from the iterating object
     DLLEXPORT StringIterator(std::unique_ptr<StringDataIterator>&& iterator);
 
+    //! \brief Creates an iterator that reads utf8 data without copying it
+    //!
+    //! This skips the virtual calls for each character and can return std::string_view
+    //! results that point to the original data.
+    //! \see UTF8ViewDataIterator
+    DLLEXPORT StringIterator(std::unique_ptr<UTF8ViewDataIterator>&& iterator);
+
     //! \brief Helper constructor for common string type
     DLLEXPORT StringIterator(const std::wstring& text);
     //! \brief Helper constructor for common string type
@@ -158,6 +165,8 @@ public:
 
     //! \brief Changes the current iterator to the new iterator and goes to the beginning
     DLLEXPORT void ReInit(std::unique_ptr<StringDataIterator>&& iterator);
+    //! \brief Changes to a new view iterator
+    DLLEXPORT void ReInit(std::unique_ptr<UTF8ViewDataIterator>&& iterator);
     //! \brief Helper function for ReInit for common string type
     DLLEXPORT void ReInit(const std::wstring& text);
     //! \brief Helper function for ReInit for common string type
@@ -464,6 +473,10 @@ public:
     {
         IteratorCharacterData stufftoskip(chartoskip);
 
+        if(ViewIterator && (additionalflag & UNNORMALCHARACTER_TYPE_LOWCODES) &&
+            chartoskip <= 32)
+            SkipWhiteSpaceInBulk(specialflags);
+
         // Iterate over the string skipping until hit something that doesn't need to be
         // skipped
         StartIterating(specialflags, &StringIterator::SkipSomething, stufftoskip,
@@ -486,6 +499,8 @@ public:
     //! class (mostly expensive for UTF8 strings)
     inline size_t GetPosition()
     {
+        if(ViewIterator)
+            return ViewIterator->CurrentIteratorPosition();
 
         return DataIterator->CurrentIteratorPosition();
     }
@@ -506,7 +521,7 @@ public:
 
             if(!CurrentStored) {
 
-                if(!DataIterator->GetNextCharCode(CurrentCharacter, 0)) {
+                if(!GetDataCharCode(CurrentCharacter, 0)) {
 
                     // Invalid position //
                     return -1;
@@ -524,7 +539,7 @@ public:
         // Get the character from our iterator and store it to a temporary value
         // and then return it
         int tmpval = -1;
-        DataIterator->GetNextCharCode(tmpval, forward);
+        GetDataCharCode(tmpval, forward);
 
         ITR_COREDEBUG("Peek forward char: (" + Convert::CodePointToUtf8(tmpval) + ")");
 
@@ -558,13 +573,13 @@ public:
     inline bool MoveToNext()
     {
 
-        DataIterator->MoveToNextCharacter();
-        bool valid = DataIterator->IsPositionValid();
+        MoveDataToNextCharacter();
+        bool valid = IsDataPositionValid();
         // It's important to reset this //
         CurrentStored = false;
 
         // We need to handle the flags on this position if we aren't on the first character //
-        if(valid && DataIterator->CurrentIteratorPosition() != 0) {
+        if(valid && GetPosition() != 0) {
 
             ITR_COREDEBUG("Move to next");
 
@@ -584,7 +599,7 @@ public:
     inline bool IsOutOfBounds()
     {
 
-        return !DataIterator->IsPositionValid();
+        return !IsDataPositionValid();
     }
 
     // Flag checking methods for outside callers //
@@ -628,6 +643,9 @@ public:
         // Setup the result object //
         IteratorFindUntilData data;
 
+        if(ViewIterator)
+            FindUntilCharacterInBulk(data, character);
+
         // Iterate with our getting function //
         StartIterating(specialflags, &StringIterator::FindUntilSpecificCharacter, &data,
             character, specialflags);
@@ -646,6 +664,87 @@ public:
 private:
     StringIterator(const StringIterator& other) = delete;
 
+    // These skip the virtual calls when the data is known to be an UTF8ViewDataIterator //
+    inline bool IsDataPositionValid() const
+    {
+        if(ViewIterator)
+            return ViewIterator->IsPositionValid();
+
+        return DataIterator->IsPositionValid();
+    }
+
+    inline void MoveDataToNextCharacter()
+    {
+        if(ViewIterator) {
+            ViewIterator->MoveToNextCharacter();
+        } else {
+            DataIterator->MoveToNextCharacter();
+        }
+    }
+
+    inline bool GetDataCharCode(int& receiver, size_t forward)
+    {
+        if(ViewIterator)
+            return ViewIterator->GetNextCharCode(receiver, forward);
+
+        return DataIterator->GetNextCharCode(receiver, forward);
+    }
+
+    //! \brief Moves over whitespace without checking each character for special meaning
+    //!
+    //! Stops on the last whitespace character so that StartIterating handles the end
+    //! normally. Whitespace can't change the flags so this is skipped if any are set.
+    inline void SkipWhiteSpaceInBulk(int specialflags)
+    {
+        if(CurrentFlags != 0)
+            return;
+
+        const auto remaining = ViewIterator->GetRemainingData();
+
+        const auto count = StringScanning::CountLeadingWhitespace(remaining.data(),
+            remaining.size(), (specialflags & SPECIAL_ITERATOR_ONNEWLINE_STOP) != 0);
+
+        if(count < 2)
+            return;
+
+        ITR_COREDEBUG("Bulk skipping whitespace: " + std::to_string(count - 1));
+
+        ViewIterator->SkipBytes(count - 1);
+        CurrentStored = false;
+    }
+
+    //! \brief Moves over characters that FindUntilSpecificCharacter would just accept
+    //!
+    //! Stops on the last such character so that StartIterating handles the end normally.
+    inline void FindUntilCharacterInBulk(IteratorFindUntilData& data, int character)
+    {
+        if(CurrentFlags != 0 || character <= 0 || character >= 0x80)
+            return;
+
+        const auto remaining = ViewIterator->GetRemainingData();
+
+        // The current character also needs to be a normal one //
+        const auto count = StringScanning::FindSpecialCharacter(
+            remaining.data(), remaining.size(), static_cast<char>(character));
+
+        if(count < 2)
+            return;
+
+        data.Positions.Start = GetPosition();
+        data.Positions.End = data.Positions.Start;
+
+        // Stop at the beginning of the last character before the special one //
+        size_t last = count - 1;
+
+        while(last > 0 && (static_cast<unsigned char>(remaining[last]) & 0xC0) == 0x80)
+            --last;
+
+        ITR_COREDEBUG("Bulk skipping until character: " + std::to_string(last));
+
+        ViewIterator->SkipBytes(last);
+        CurrentStored = false;
+    }
+
     //! Checks if current character causes the flags to change
     inline ITERATORCALLBACK_RETURNTYPE HandleSpecialCharacters()
     {
@@ -968,7 +1067,7 @@ private:
         if(IsStartUpLoop)
             firstiter = false;
 
-        for(; DataIterator->IsPositionValid(); DataIterator->MoveToNextCharacter()) {
+        for(; IsDataPositionValid(); MoveDataToNextCharacter()) {
 
             // The GetCharacter call will cache the result
             // but there might be iterators that don't want to get the current character
@@ -1033,6 +1132,9 @@ private:
     //! Wraps the underlying string
     StringDataIterator* DataIterator = nullptr;
 
+    //! Same as DataIterator if it is an UTF8ViewDataIterator, used for the fast paths
+    UTF8ViewDataIterator* ViewIterator = nullptr;
+
     //! Currently active flags
     //! Bit field of ITERATORFLAG_SET enum values
     int CurrentFlags = 0;
@@ -0,0 +1,159 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+// ------------------------------------ //
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEVIATHAN_STRING_SCAN_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+#endif
+
+namespace Leviathan {
+
+//! \brief Bulk scanning of contiguous utf8 buffers
+//!
+//! These look at 16 bytes at a time when SSE2 is available. Only ASCII characters are ever
+//! matched so a result is never in the middle of a multibyte sequence, except when the
+//! scanned range itself ends in one.
+class StringScanning {
+public:
+    //! \returns The number of bytes from the start of data that are whitespace (code point
+    //! <= 32)
+    //! \param stopatlineend When true line terminators don't count as whitespace
+    static size_t CountLeadingWhitespace(const char* data, size_t length, bool stopatlineend)
+    {
+        size_t i = 0;
+
+#ifdef LEVIATHAN_STRING_SCAN_SSE2
+        const __m128i space = _mm_set1_epi8(32);
+        const __m128i lineEndFirst = _mm_set1_epi8('\n');
+        const __m128i lineEndRange = _mm_set1_epi8('\r' - '\n');
+
+        for(; i + 16 <= length; i += 16) {
+
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            // Unsigned compare so that non-ASCII bytes aren't whitespace //
+            __m128i whitespace = _mm_cmpeq_epi8(_mm_max_epu8(chunk, space), space);
+
+            if(stopatlineend) {
+                // '\n', '\v', '\f' and '\r' are next to each other //
+                const __m128i offset = _mm_sub_epi8(chunk, lineEndFirst);
+                const __m128i lineEnd =
+                    _mm_cmpeq_epi8(_mm_min_epu8(offset, lineEndRange), offset);
+
+                whitespace = _mm_andnot_si128(lineEnd, whitespace);
+            }
+
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(whitespace));
+
+            if(mask != 0xffff)
+                return i + FirstSetBit(~mask & 0xffff);
+        }
+#endif // LEVIATHAN_STRING_SCAN_SSE2
+
+        for(; i < length; ++i) {
+
+            const auto character = static_cast<unsigned char>(data[i]);
+
+            if(character > 32 || (stopatlineend && IsASCIILineTerminator(character)))
+                return i;
+        }
+
+        return length;
+    }
+
+    //! \brief Finds the first character that StringIterator needs to look at individually
+    //!
+    //! These are quotes, comment and escape characters, line terminators and extra. Lead
+    //! bytes of multibyte sequences that may encode a line terminator also stop the scan.
+    //! \param extra Additional ASCII character to find
+    //! \returns The offset of the found character or length
+    static size_t FindSpecialCharacter(const char* data, size_t length, char extra)
+    {
+        size_t i = 0;
+
+#ifdef LEVIATHAN_STRING_SCAN_SSE2
+        const __m128i doubleQuote = _mm_set1_epi8('"');
+        const __m128i singleQuote = _mm_set1_epi8('\'');
+        const __m128i slash = _mm_set1_epi8('/');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i extraCharacter = _mm_set1_epi8(extra);
+        const __m128i nextLineLead = _mm_set1_epi8(static_cast<char>(0xC2));
+        const __m128i separatorLead = _mm_set1_epi8(static_cast<char>(0xE2));
+        const __m128i lineEndFirst = _mm_set1_epi8('\n');
+        const __m128i lineEndRange = _mm_set1_epi8('\r' - '\n');
+
+        for(; i + 16 <= length; i += 16) {
+
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            __m128i found = _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, doubleQuote), _mm_cmpeq_epi8(chunk, singleQuote));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, slash));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, backslash));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, extraCharacter));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, nextLineLead));
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chunk, separatorLead));
+
+            const __m128i offset = _mm_sub_epi8(chunk, lineEndFirst);
+            found = _mm_or_si128(
+                found, _mm_cmpeq_epi8(_mm_min_epu8(offset, lineEndRange), offset));
+
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(found));
+
+            if(mask != 0)
+                return i + FirstSetBit(mask);
+        }
+#endif // LEVIATHAN_STRING_SCAN_SSE2
+
+        for(; i < length; ++i) {
+
+            const auto character = static_cast<unsigned char>(data[i]);
+
+            if(IsSpecialCharacter(character) || data[i] == extra)
+                return i;
+        }
+
+        return length;
+    }
+
+    //! \returns True if FindSpecialCharacter would stop at character
+    static bool IsSpecialCharacter(unsigned char character)
+    {
+        return character == '"' || character == '\'' || character == '/' ||
+               character == '\\' || character == 0xC2 || character == 0xE2 ||
+               IsASCIILineTerminator(character);
+    }
+
+    //! \returns True for the single byte line terminators
+    //! \see StringOperations::IsLineTerminator
+    static bool IsASCIILineTerminator(unsigned char character)
+    {
+        return character >= '\n' && character <= '\r';
+    }
+
+private:
+#ifdef LEVIATHAN_STRING_SCAN_SSE2
+    static size_t FirstSetBit(unsigned mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctz(mask));
+#endif // _MSC_VER
+    }
+#endif // LEVIATHAN_STRING_SCAN_SSE2
+
+    StringScanning() = delete;
+    ~StringScanning() = delete;
+};
+
+} // namespace Leviathan
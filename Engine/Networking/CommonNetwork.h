@@ -17,6 +17,13 @@ constexpr uint8_t NORMAL_RESPONSE_TYPE = 0x12;
 
 constexpr uint8_t NORMAL_REQUEST_TYPE = 0x28;
 
+//! \brief Sent in the Connect request and response, connections with a different value are
+//! refused
+//!
+//! Must be incremented whenever the format of the packets changes. Was 42 before entity IDs
+//! were sent as CompactObjectID
+constexpr int32_t LEVIATHAN_NETWORK_PROTOCOL_VERSION = 43;
+
 
 //! Type of networked application
 enum class NETWORKED_TYPE {
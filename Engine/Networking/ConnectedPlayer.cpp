@@ -111,6 +111,31 @@ DLLEXPORT bool ConnectedPlayer::_OnSendPrivateMessage(const std::string& message
 // ------------------------------------ //
 DLLEXPORT ObjectID ConnectedPlayer::GetPositionInWorld(GameWorld* world) const
 {
+    for(const auto& [positionWorld, entity] : PositionsInWorlds) {
+        if(positionWorld == world)
+            return entity;
+    }
+
     // Not found for that world //
     return 0;
 }
+
+DLLEXPORT void ConnectedPlayer::SetPositionInWorld(GameWorld* world, ObjectID entity)
+{
+    for(auto iter = PositionsInWorlds.begin(); iter != PositionsInWorlds.end(); ++iter) {
+
+        if(std::get<0>(*iter) != world)
+            continue;
+
+        if(entity == NULL_OBJECT) {
+            PositionsInWorlds.erase(iter);
+        } else {
+            std::get<1>(*iter) = entity;
+        }
+
+        return;
+    }
+
+    if(entity != NULL_OBJECT)
+        PositionsInWorlds.emplace_back(world, entity);
+}
@@ -9,6 +9,8 @@
 #include "TimeIncludes.h"
 
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace Leviathan {
 
@@ -60,6 +62,12 @@ public:
     //! 0
     DLLEXPORT ObjectID GetPositionInWorld(GameWorld* world) const;
 
+    //! \brief Sets the entity that is this player's position in world
+    //!
+    //! GameWorld::ShouldPlayerReceiveEntity uses this to only send the entities near the
+    //! player. NULL_OBJECT clears the position
+    DLLEXPORT void SetPositionInWorld(GameWorld* world, ObjectID entity);
+
 
     const std::string& GetUniqueName() override
     {
@@ -104,6 +112,9 @@ protected:
 
     //! The unique identifier for this player, lasts only this session
     int ID;
+
+    //! The entity of this player in each world that has one
+    std::vector<std::tuple<GameWorld*, ObjectID>> PositionsInWorlds;
 };
 
 } // namespace Leviathan
@@ -825,6 +825,16 @@ DLLEXPORT bool Leviathan::Connection::_HandleInternalRequest(
     switch(request->GetType()) {
     case NETWORK_REQUEST_TYPE::Connect: {
 
+        const auto version = static_cast<RequestConnect*>(request.get())->CheckValue;
+
+        if(version != LEVIATHAN_NETWORK_PROTOCOL_VERSION) {
+
+            LOG_ERROR("Connection: received RequestConnect with a different protocol "
+                      "version (" +
+                      std::to_string(version) + "), ignoring it");
+            return true;
+        }
+
         SendPacketToConnection(std::make_shared<ResponseConnect>(request->GetIDForResponse()),
             RECEIVE_GUARANTEE::ResendOnce);
 
@@ -939,10 +949,13 @@ DLLEXPORT bool Leviathan::Connection::_HandleInternalResponse(
     }
     case NETWORK_RESPONSE_TYPE::Connect: {
 
-        if(static_cast<ResponseConnect*>(response.get())->CheckValue != 42) {
+        const auto version = static_cast<ResponseConnect*>(response.get())->CheckValue;
+
+        if(version != LEVIATHAN_NETWORK_PROTOCOL_VERSION) {
 
-            LOG_ERROR(
-                "Connection: received ResponseConnect with invalid check value, ignoring it");
+            LOG_ERROR("Connection: received ResponseConnect with a different protocol "
+                      "version (" +
+                      std::to_string(version) + "), ignoring it");
             return true;
         }
 
@@ -12,7 +12,7 @@ thingsToGenerate = [
 
   ["Connect",
    [
-     Variable.new("CheckValue", "int32_t", default: "42"),
+     Variable.new("CheckValue", "int32_t", default: "LEVIATHAN_NETWORK_PROTOCOL_VERSION"),
    ]],
 
   ["Security",
@@ -12,7 +12,7 @@ thingsToGenerate = [
 
   ["Connect",
    [
-     Variable.new("CheckValue", "int32_t", default: "42"),
+     Variable.new("CheckValue", "int32_t", default: "LEVIATHAN_NETWORK_PROTOCOL_VERSION"),
    ]],
   
   ["Security",
@@ -109,7 +109,7 @@ thingsToGenerate = [
   ["EntityCreation",
    [
      Variable.new("WorldID", "int32_t"),
-     Variable.new("EntityID", "int32_t"),
+     Variable.new("EntityID", "ObjectID", serializeas: "CompactObjectID"),
      Variable.new("ComponentCount", "uint32_t"),
      Variable.new("InitialComponentData", "sf::Packet", move: true),
    ]],
@@ -117,13 +117,13 @@ thingsToGenerate = [
   ["EntityDestruction",
    [
      Variable.new("WorldID", "int32_t"),
-     Variable.new("EntityID", "ObjectID"),
+     Variable.new("EntityID", "ObjectID", serializeas: "CompactObjectID"),
    ]],
 
   ["EntityLocalControlStatus",
    [
      Variable.new("WorldID", "int32_t"),
-     Variable.new("EntityID", "ObjectID"),
+     Variable.new("EntityID", "ObjectID", serializeas: "CompactObjectID"),
      Variable.new("Enabled", "bool"),
    ]],
 
@@ -150,8 +150,9 @@ thingsToGenerate = [
      Variable.new("WorldID", "int32_t"),
      Variable.new("TickNumber", "int32_t"),
      Variable.new("ReferenceTick", "int32_t"),
-     Variable.new("EntityID", "ObjectID"),
-     Variable.new("UpdateData", "sf::Packet", move: true),
+     Variable.new("EntityID", "ObjectID", serializeas: "CompactObjectID"),
+     # Reuses the buffers of earlier updates as these are received constantly
+     Variable.new("UpdateData", "PooledPacket", move: true),
    ]],
   
   ["CacheUpdated",
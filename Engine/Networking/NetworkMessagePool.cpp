@@ -0,0 +1,101 @@
+// ------------------------------------ //
+#include "NetworkMessagePool.h"
+
+using namespace Leviathan;
+// ------------------------------------ //
+namespace {
+struct FreePackets {
+
+    ~FreePackets();
+
+    std::vector<std::unique_ptr<sf::Packet>> Packets;
+};
+
+//! Set once the cache of the current thread has been destroyed on thread exit
+bool& PacketCacheDestroyed()
+{
+    thread_local bool destroyed = false;
+    return destroyed;
+}
+
+FreePackets::~FreePackets()
+{
+    PacketCacheDestroyed() = true;
+}
+
+std::vector<std::unique_ptr<sf::Packet>>& GetFreePackets()
+{
+    thread_local FreePackets packets;
+    return packets.Packets;
+}
+
+std::unique_ptr<sf::Packet> TakeCachedPacket()
+{
+    if(!PacketCacheDestroyed()) {
+
+        auto& packets = GetFreePackets();
+
+        if(!packets.empty()) {
+
+            auto packet = std::move(packets.back());
+            packets.pop_back();
+            return packet;
+        }
+    }
+
+    return std::make_unique<sf::Packet>();
+}
+
+void ReleaseCachedPacket(std::unique_ptr<sf::Packet> packet)
+{
+    if(!packet || PacketCacheDestroyed() ||
+        packet->getDataSize() > NETWORK_PACKET_POOL_MAX_KEPT_SIZE)
+        return;
+
+    auto& packets = GetFreePackets();
+
+    if(packets.size() >= NETWORK_MESSAGE_POOL_MAX_CACHED)
+        return;
+
+    packet->clear();
+    packets.push_back(std::move(packet));
+}
+} // namespace
+// ------------------------------------ //
+DLLEXPORT PooledPacket::PooledPacket() : Packet(TakeCachedPacket()) {}
+
+DLLEXPORT PooledPacket::PooledPacket(const sf::Packet& data) : Packet(TakeCachedPacket())
+{
+    Packet->append(data.getData(), data.getDataSize());
+}
+
+DLLEXPORT PooledPacket::PooledPacket(const PooledPacket& other) : PooledPacket(*other) {}
+
+DLLEXPORT PooledPacket::PooledPacket(PooledPacket&& other) noexcept :
+    Packet(std::move(other.Packet))
+{
+    // Other needs to stay usable so it gets an empty packet //
+    other.Packet = TakeCachedPacket();
+}
+
+DLLEXPORT PooledPacket::~PooledPacket()
+{
+    ReleaseCachedPacket(std::move(Packet));
+}
+
+DLLEXPORT PooledPacket& PooledPacket::operator=(const PooledPacket& other)
+{
+    if(this == &other)
+        return *this;
+
+    Packet->clear();
+    Packet->append(other->getData(), other->getDataSize());
+    return *this;
+}
+
+DLLEXPORT PooledPacket& PooledPacket::operator=(PooledPacket&& other) noexcept
+{
+    // The packet of this is released when other is destroyed
+    std::swap(Packet, other.Packet);
+    return *this;
+}
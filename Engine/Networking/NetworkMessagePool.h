@@ -0,0 +1,216 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "Common/SFMLPackets.h"
+
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace Leviathan {
+
+//! Maximum number of free blocks of one size that each thread keeps for reuse
+constexpr size_t NETWORK_MESSAGE_POOL_MAX_CACHED = 1024;
+
+//! \brief Per thread cache of freed memory blocks of one size
+//!
+//! Blocks freed on a different thread than where they were allocated go to the cache of the
+//! freeing thread, which is fine as all blocks of the same size are interchangeable
+template<size_t Size, size_t Alignment>
+class NetworkMessageBlockCache {
+    struct FreeBlocks {
+
+        ~FreeBlocks()
+        {
+            Destroyed() = true;
+
+            for(void* block : Blocks)
+                ::operator delete(block, std::align_val_t(Alignment));
+        }
+
+        std::vector<void*> Blocks;
+    };
+
+    //! Set once the cache of the current thread has been destroyed on thread exit. This is
+    //! trivially destructible so it can be checked after that
+    static bool& Destroyed()
+    {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static FreeBlocks& _GetFreeBlocks()
+    {
+        thread_local FreeBlocks blocks;
+        return blocks;
+    }
+
+public:
+    static void* Allocate()
+    {
+        if(!Destroyed()) {
+
+            auto& blocks = _GetFreeBlocks().Blocks;
+
+            if(!blocks.empty()) {
+
+                void* block = blocks.back();
+                blocks.pop_back();
+                return block;
+            }
+        }
+
+        return ::operator new(Size, std::align_val_t(Alignment));
+    }
+
+    static void Release(void* block)
+    {
+        if(!Destroyed()) {
+
+            auto& blocks = _GetFreeBlocks().Blocks;
+
+            if(blocks.size() < NETWORK_MESSAGE_POOL_MAX_CACHED) {
+
+                blocks.push_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block, std::align_val_t(Alignment));
+    }
+};
+
+//! \brief Allocator for decoded network messages
+//!
+//! Used with std::allocate_shared so that the message and the shared_ptr control block are
+//! in one block that is reused once the last reference is released
+template<class T>
+class NetworkMessageAllocator {
+public:
+    using value_type = T;
+
+    NetworkMessageAllocator() = default;
+
+    template<class OtherT>
+    NetworkMessageAllocator(const NetworkMessageAllocator<OtherT>&)
+    {}
+
+    T* allocate(size_t count)
+    {
+        if(count != 1)
+            return std::allocator<T>().allocate(count);
+
+        return static_cast<T*>(NetworkMessageBlockCache<sizeof(T), alignof(T)>::Allocate());
+    }
+
+    void deallocate(T* pointer, size_t count)
+    {
+        if(count != 1) {
+            std::allocator<T>().deallocate(pointer, count);
+            return;
+        }
+
+        NetworkMessageBlockCache<sizeof(T), alignof(T)>::Release(pointer);
+    }
+
+    template<class OtherT>
+    bool operator==(const NetworkMessageAllocator<OtherT>&) const
+    {
+        return true;
+    }
+
+    template<class OtherT>
+    bool operator!=(const NetworkMessageAllocator<OtherT>&) const
+    {
+        return false;
+    }
+};
+
+//! \brief Creates a decoded message that is freed to a per thread cache
+//!
+//! Messages that no handler keeps a reference to are released after handling, so after the
+//! first few packets decoding doesn't need to allocate memory for the messages. Handlers
+//! that keep a message keep its block out of the cache until they release it.
+//! \note Members of the message that allocate memory (like strings) still allocate
+template<class MessageT, class... Args>
+inline std::shared_ptr<MessageT> MakePooledNetworkMessage(Args&&... args)
+{
+    return std::allocate_shared<MessageT>(
+        NetworkMessageAllocator<MessageT>(), std::forward<Args>(args)...);
+}
+
+//! Packets with more data than this aren't kept for reuse so that a few large messages don't
+//! keep their memory reserved
+constexpr size_t NETWORK_PACKET_POOL_MAX_KEPT_SIZE = 16 * 1024;
+
+//! \brief sf::Packet that reuses the packets of destroyed PooledPackets on the same thread
+//!
+//! sf::Packet can't be moved so the only way to keep the memory of its buffer is to keep the
+//! packet object. Destroyed PooledPackets put their cleared packet in a per thread cache that
+//! new PooledPackets take from, so decoding data into one doesn't allocate once the cache has
+//! packets with large enough buffers. Moving a PooledPacket moves the packet object and
+//! leaves the moved from PooledPacket with an empty packet from the cache
+class PooledPacket {
+public:
+    DLLEXPORT PooledPacket();
+
+    //! \brief Copies data to a packet from the cache
+    DLLEXPORT PooledPacket(const sf::Packet& data);
+
+    DLLEXPORT PooledPacket(const PooledPacket& other);
+
+    DLLEXPORT PooledPacket(PooledPacket&& other) noexcept;
+
+    DLLEXPORT ~PooledPacket();
+
+    DLLEXPORT PooledPacket& operator=(const PooledPacket& other);
+    DLLEXPORT PooledPacket& operator=(PooledPacket&& other) noexcept;
+
+    inline sf::Packet& operator*()
+    {
+        return *Packet;
+    }
+
+    inline const sf::Packet& operator*() const
+    {
+        return *Packet;
+    }
+
+    inline sf::Packet* operator->()
+    {
+        return Packet.get();
+    }
+
+    inline const sf::Packet* operator->() const
+    {
+        return Packet.get();
+    }
+
+    //! Allows passing this to the methods that read a sf::Packet
+    inline operator sf::Packet&()
+    {
+        return *Packet;
+    }
+
+    inline operator const sf::Packet&() const
+    {
+        return *Packet;
+    }
+
+private:
+    std::unique_ptr<sf::Packet> Packet;
+};
+
+inline sf::Packet& operator<<(sf::Packet& packet, const PooledPacket& packetinner)
+{
+    return packet << *packetinner;
+}
+
+inline sf::Packet& operator>>(sf::Packet& packet, PooledPacket& packetinner)
+{
+    return packet >> *packetinner;
+}
+
+} // namespace Leviathan
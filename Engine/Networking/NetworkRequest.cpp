@@ -6,6 +6,7 @@
 #include "../Utility/Convert.h"
 #include "Exceptions.h"
 #include "GameSpecificPacketHandler.h"
+#include "NetworkMessagePool.h"
 using namespace Leviathan;
 using namespace std;
 // ------------------------------------ //
@@ -24,17 +25,17 @@ DLLEXPORT std::shared_ptr<NetworkRequest> NetworkRequest::LoadFromPacket(
     // Try to create the additional data if required for this type //
     switch(requesttype) {
     case NETWORK_REQUEST_TYPE::Echo:
-        return std::make_shared<RequestNone>(requesttype, messagenumber, packet);
+        return MakePooledNetworkMessage<RequestNone>(requesttype, messagenumber, packet);
     case NETWORK_REQUEST_TYPE::Connect:
-        return std::make_shared<RequestConnect>(messagenumber, packet);
+        return MakePooledNetworkMessage<RequestConnect>(messagenumber, packet);
     case NETWORK_REQUEST_TYPE::Security:
-        return std::make_shared<RequestSecurity>(messagenumber, packet);
+        return MakePooledNetworkMessage<RequestSecurity>(messagenumber, packet);
     case NETWORK_REQUEST_TYPE::Authenticate:
-        return std::make_shared<RequestAuthenticate>(messagenumber, packet);
+        return MakePooledNetworkMessage<RequestAuthenticate>(messagenumber, packet);
     case NETWORK_REQUEST_TYPE::JoinServer:
-        return std::make_shared<RequestJoinServer>(messagenumber, packet);
+        return MakePooledNetworkMessage<RequestJoinServer>(messagenumber, packet);
     case NETWORK_REQUEST_TYPE::JoinGame:
-        return std::make_shared<RequestJoinGame>(messagenumber, packet);
+        return MakePooledNetworkMessage<RequestJoinGame>(messagenumber, packet);
     default: {
         Logger::Get()->Warning("NetworkRequest: unused type: " +
                                Convert::ToString(static_cast<int>(requesttype)));
@@ -3,6 +3,7 @@
 
 #include "Common/DataStoring/NamedVars.h"
 #include "GameSpecificPacketHandler.h"
+#include "NetworkMessagePool.h"
 using namespace Leviathan;
 // ------------------------------------ //
 DLLEXPORT std::shared_ptr<NetworkResponse> NetworkResponse::LoadFromPacket(sf::Packet& packet)
@@ -24,30 +25,30 @@ DLLEXPORT std::shared_ptr<NetworkResponse> NetworkResponse::LoadFromPacket(sf::P
     // Process based on the type //
     switch(responsetype) {
     case NETWORK_RESPONSE_TYPE::Connect:
-        return std::make_shared<ResponseConnect>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseConnect>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::Authenticate:
-        return std::make_shared<ResponseAuthenticate>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseAuthenticate>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::Security:
-        return std::make_shared<ResponseSecurity>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseSecurity>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::ServerAllow:
-        return std::make_shared<ResponseServerAllow>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseServerAllow>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::ServerDisallow:
-        return std::make_shared<ResponseServerDisallow>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseServerDisallow>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::StartWorldReceive:
-        return std::make_shared<ResponseStartWorldReceive>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseStartWorldReceive>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::EntityCreation:
-        return std::make_shared<ResponseEntityCreation>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseEntityCreation>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::EntityDestruction:
-        return std::make_shared<ResponseEntityDestruction>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseEntityDestruction>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::EntityUpdate:
-        return std::make_shared<ResponseEntityUpdate>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseEntityUpdate>(responseid, packet);
     case NETWORK_RESPONSE_TYPE::EntityLocalControlStatus:
-        return std::make_shared<ResponseEntityLocalControlStatus>(responseid, packet);
+        return MakePooledNetworkMessage<ResponseEntityLocalControlStatus>(responseid, packet);
     // None based types
     case NETWORK_RESPONSE_TYPE::CloseConnection:
     case NETWORK_RESPONSE_TYPE::Keepalive:
     case NETWORK_RESPONSE_TYPE::None:
-        return std::make_shared<ResponseNone>(responsetype, responseid, packet);
+        return MakePooledNetworkMessage<ResponseNone>(responsetype, responseid, packet);
 
     default: {
         Logger::Get()->Warning("NetworkResponse: unused type: " +
@@ -9,6 +9,7 @@
 #include "Exceptions.h"
 
 #include "GameSpecificPacketHandler.h"
+#include "NetworkMessagePool.h"
 
 #include <memory>
 
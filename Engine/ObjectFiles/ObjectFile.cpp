@@ -13,6 +13,8 @@
 #include "../Script/ScriptScript.h"
 #endif // LEVIATHAN_USING_ANGELSCRIPT
 
+#include <utility>
+
 using namespace Leviathan;
 using namespace std;
 // ------------------------------------ //
@@ -602,7 +604,7 @@ DLLEXPORT std::unique_ptr<Leviathan::ObjectFileTemplateObject> ObjectFileTemplat
         unique_ptr<ObjectFileList> listobj(new ObjectFileListProper(actlistname));
 
         const std::vector<shared_ptr<NamedVariableList>>& vallist =
-            *curlist->GetVariables().GetVec();
+            *std::as_const(curlist->GetVariables()).GetVec();
 
         // Add the values replacing template arguments //
         for (size_t a = 0; a < vallist.size(); a++) {
@@ -291,6 +291,12 @@ public:
         return TemplatesName;
     }
 
+    //! \returns The template arguments of this instance
+    inline const std::vector<std::unique_ptr<std::string>>& GetArguments() const {
+
+        return Arguments;
+    }
+
     DLLEXPORT std::string Serialize(size_t indentspaces = 0) const;
 
 protected:
@@ -320,6 +326,18 @@ public:
     //! \brief Gets the name of this template
     DLLEXPORT const std::string& GetName() const;
 
+    //! \returns The template parameter names
+    inline const std::vector<std::unique_ptr<std::string>>& GetParameters() const {
+
+        return Parameters;
+    }
+
+    //! \returns The object that instances are created from
+    inline const std::shared_ptr<ObjectFileObject>& GetRepresentingObject() const {
+
+        return RepresentingObject;
+    }
+
 
     //! \brief Creates a ObjectFileTemplateDefinition from an ObjectFileObject and a parameter list
     //! \param obj The object from which to construct the template, the pointer will be deleted by this
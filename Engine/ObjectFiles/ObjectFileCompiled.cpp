@@ -0,0 +1,765 @@
+// ------------------------------------ //
+#include "ObjectFileCompiled.h"
+
+#include "Utility/Convert.h"
+
+#if !defined(ALTERNATIVE_EXCEPTIONS_FATAL) || defined(ALLOW_INTERNAL_EXCEPTIONS)
+#include "Exceptions.h"
+#endif
+
+#ifdef LEVIATHAN_USING_ANGELSCRIPT
+#include "Script/ScriptExecutor.h"
+#include "Script/ScriptModule.h"
+#include "Script/ScriptScript.h"
+#endif // LEVIATHAN_USING_ANGELSCRIPT
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace Leviathan;
+using namespace Leviathan::ObjectFileCompiledFormat;
+// ------------------------------------ //
+constexpr auto TABLE_ALIGNMENT = 8;
+
+template<class T>
+T ReadPayload(const Value& value)
+{
+    static_assert(sizeof(T) <= sizeof(value.Payload), "type doesn't fit in payload");
+
+    T result;
+    std::memcpy(&result, &value.Payload, sizeof(T));
+    return result;
+}
+
+template<class T>
+uint64_t MakePayload(const T& value)
+{
+    static_assert(sizeof(T) <= sizeof(uint64_t), "type doesn't fit in payload");
+
+    uint64_t result = 0;
+    std::memcpy(&result, &value, sizeof(T));
+    return result;
+}
+
+//! \returns True if the range [first, first + count) fits inside total
+inline bool IsRangeValid(uint32_t first, uint32_t count, uint32_t total)
+{
+    return static_cast<uint64_t>(first) + count <= total;
+}
+// ------------------ CompiledObjectFileData ------------------ //
+CompiledObjectFileData::CompiledObjectFileData(const std::string& file) : File(file) {}
+
+DLLEXPORT std::shared_ptr<CompiledObjectFileData> CompiledObjectFileData::Open(
+    const std::string& file, LErrorReporter* reporterror)
+{
+    std::shared_ptr<CompiledObjectFileData> data(new CompiledObjectFileData(file));
+
+    if(!data->File.IsValid())
+        return nullptr;
+
+    if(!data->Validate(reporterror))
+        return nullptr;
+
+    return data;
+}
+
+template<class T>
+bool GetTable(const MemoryMappedFile& file, uint32_t offset, uint32_t count, const T*& table)
+{
+    if(offset % alignof(T) != 0 || offset > file.GetSize())
+        return false;
+
+    if(count > (file.GetSize() - offset) / sizeof(T))
+        return false;
+
+    table = reinterpret_cast<const T*>(file.GetData() + offset);
+    return true;
+}
+
+bool CompiledObjectFileData::Validate(LErrorReporter* reporterror)
+{
+    const auto fail = [&](const std::string& reason) {
+        reporterror->Warning(
+            "CompiledObjectFile: file " + File.GetFile() + " is not valid: " + reason);
+        return false;
+    };
+
+    if(File.GetSize() < sizeof(ObjectFileCompiledFormat::Header))
+        return fail("too small");
+
+    Header = reinterpret_cast<const ObjectFileCompiledFormat::Header*>(File.GetData());
+
+    if(std::memcmp(Header->Magic, MAGIC, sizeof(MAGIC)) != 0)
+        return fail("wrong magic");
+
+    if(Header->ByteOrder != BYTE_ORDER_MARK)
+        return fail("wrong byte order");
+
+    if(Header->Version != FORMAT_VERSION)
+        return fail("unsupported version: " + std::to_string(Header->Version));
+
+    if(Header->FileSize != File.GetSize())
+        return fail("truncated");
+
+    if(!GetTable(File, Header->StringOffset, Header->StringCount, Strings) ||
+        !GetTable(File, Header->StringDataOffset, Header->StringDataSize, StringData) ||
+        !GetTable(File, Header->ValueOffset, Header->ValueCount, Values) ||
+        !GetTable(File, Header->IndexOffset, Header->IndexCount, Indexes) ||
+        !GetTable(File, Header->VariableOffset, Header->VariableCount, Variables) ||
+        !GetTable(File, Header->ListOffset, Header->ListCount, Lists) ||
+        !GetTable(File, Header->TextBlockOffset, Header->TextBlockCount, TextBlocks) ||
+        !GetTable(File, Header->ObjectOffset, Header->ObjectCount, Objects) ||
+        !GetTable(File, Header->TemplateOffset, Header->TemplateCount, Templates) ||
+        !GetTable(File, Header->InstanceOffset, Header->InstanceCount, Instances))
+        return fail("table is out of bounds");
+
+    // Then all the references between the tables //
+    const auto stringCount = Header->StringCount;
+
+    for(uint32_t i = 0; i < stringCount; ++i) {
+        if(!IsRangeValid(Strings[i].Offset, Strings[i].Length, Header->StringDataSize))
+            return fail("string is out of bounds");
+    }
+
+    for(uint32_t i = 0; i < Header->ValueCount; ++i) {
+
+        switch(Values[i].Type) {
+        case DATABLOCK_TYPE_INT:
+        case DATABLOCK_TYPE_FLOAT:
+        case DATABLOCK_TYPE_BOOL:
+        case DATABLOCK_TYPE_CHAR:
+        case DATABLOCK_TYPE_DOUBLE: break;
+        case DATABLOCK_TYPE_STRING:
+        case DATABLOCK_TYPE_WSTRING:
+            if(Values[i].Payload >= stringCount)
+                return fail("value has invalid string");
+            break;
+        default: return fail("value has unknown type");
+        }
+    }
+
+    for(uint32_t i = 0; i < Header->IndexCount; ++i) {
+        if(Indexes[i] >= stringCount)
+            return fail("index table has invalid string");
+    }
+
+    for(uint32_t i = 0; i < Header->VariableCount; ++i) {
+        const auto& variable = Variables[i];
+        if(variable.Name >= stringCount ||
+            !IsRangeValid(variable.FirstValue, variable.ValueCount, Header->ValueCount))
+            return fail("invalid variable");
+    }
+
+    for(uint32_t i = 0; i < Header->ListCount; ++i) {
+        const auto& list = Lists[i];
+        if(list.Name >= stringCount ||
+            !IsRangeValid(list.FirstVariable, list.VariableCount, Header->VariableCount))
+            return fail("invalid list");
+    }
+
+    for(uint32_t i = 0; i < Header->TextBlockCount; ++i) {
+        const auto& block = TextBlocks[i];
+        if(block.Name >= stringCount ||
+            !IsRangeValid(block.FirstLine, block.LineCount, Header->IndexCount))
+            return fail("invalid text block");
+    }
+
+    if(Header->DefinedObjectCount > Header->ObjectCount)
+        return fail("invalid object count");
+
+    for(uint32_t i = 0; i < Header->ObjectCount; ++i) {
+        const auto& object = Objects[i];
+        if(object.Name >= stringCount || object.TypeName >= stringCount ||
+            !IsRangeValid(object.FirstPrefix, object.PrefixCount, Header->IndexCount) ||
+            !IsRangeValid(object.FirstList, object.ListCount, Header->ListCount) ||
+            !IsRangeValid(
+                object.FirstTextBlock, object.TextBlockCount, Header->TextBlockCount))
+            return fail("invalid object");
+
+        if(object.ScriptSource != NO_INDEX &&
+            (object.ScriptSource >= stringCount || object.ScriptName >= stringCount ||
+                object.ScriptModuleSource >= stringCount || object.ScriptFile >= stringCount))
+            return fail("invalid object script");
+    }
+
+    for(uint32_t i = 0; i < Header->TemplateCount; ++i) {
+        const auto& tmpl = Templates[i];
+        if(tmpl.Name >= stringCount || tmpl.Object >= Header->ObjectCount ||
+            !IsRangeValid(tmpl.FirstParameter, tmpl.ParameterCount, Header->IndexCount))
+            return fail("invalid template");
+    }
+
+    for(uint32_t i = 0; i < Header->InstanceCount; ++i) {
+        const auto& instance = Instances[i];
+        if(instance.Name >= stringCount ||
+            !IsRangeValid(instance.FirstArgument, instance.ArgumentCount, Header->IndexCount))
+            return fail("invalid template instance");
+    }
+
+    if(!IsRangeValid(
+           Header->FirstHeaderVariable, Header->HeaderVariableCount, Header->VariableCount))
+        return fail("invalid header variables");
+
+    return true;
+}
+// ------------------------------------ //
+DLLEXPORT std::string CompiledObjectFileData::GetSourceHash() const
+{
+    return std::string(Header->SourceHash, sizeof(Header->SourceHash));
+}
+
+DLLEXPORT std::string CompiledObjectFileData::GetString(uint32_t index) const
+{
+    const auto& entry = Strings[index];
+    return std::string(StringData + entry.Offset, entry.Length);
+}
+
+std::vector<std::unique_ptr<std::string>> CompiledObjectFileData::LoadStringList(
+    uint32_t first, uint32_t count) const
+{
+    std::vector<std::unique_ptr<std::string>> result;
+    result.reserve(count);
+
+    for(uint32_t i = first; i < first + count; ++i)
+        result.push_back(std::make_unique<std::string>(GetString(Indexes[i])));
+
+    return result;
+}
+// ------------------------------------ //
+VariableBlock* CompiledObjectFileData::LoadValue(const Value& value) const
+{
+    switch(value.Type) {
+    case DATABLOCK_TYPE_INT: return new VariableBlock(new IntBlock(ReadPayload<int32_t>(value)));
+    case DATABLOCK_TYPE_FLOAT: return new VariableBlock(new FloatBlock(ReadPayload<float>(value)));
+    case DATABLOCK_TYPE_BOOL: return new VariableBlock(new BoolBlock(ReadPayload<bool>(value)));
+    case DATABLOCK_TYPE_CHAR: return new VariableBlock(new CharBlock(ReadPayload<char>(value)));
+    case DATABLOCK_TYPE_DOUBLE:
+        return new VariableBlock(new DoubleBlock(ReadPayload<double>(value)));
+    case DATABLOCK_TYPE_STRING:
+        return new VariableBlock(
+            new StringBlock(GetString(static_cast<uint32_t>(value.Payload))));
+    case DATABLOCK_TYPE_WSTRING:
+        return new VariableBlock(new WstringBlock(
+            Convert::Utf8ToUtf16(GetString(static_cast<uint32_t>(value.Payload)))));
+    }
+
+    // Validate has made sure this isn't reached
+    LEVIATHAN_ASSERT(false, "CompiledObjectFileData: unknown value type");
+    return nullptr;
+}
+
+std::shared_ptr<NamedVariableList> CompiledObjectFileData::LoadVariable(uint32_t index) const
+{
+    const auto& variable = Variables[index];
+
+    std::vector<VariableBlock*> values;
+    values.reserve(variable.ValueCount);
+
+    for(uint32_t i = variable.FirstValue; i < variable.FirstValue + variable.ValueCount; ++i)
+        values.push_back(LoadValue(Values[i]));
+
+    return std::make_shared<NamedVariableList>(GetString(variable.Name), values);
+}
+// ------------------------------------ //
+DLLEXPORT std::unique_ptr<ObjectFileObjectProper> CompiledObjectFileData::LoadObject(
+    uint32_t index) const
+{
+    const auto& record = Objects[index];
+
+    std::unique_ptr<ObjectFileObjectProper> object;
+
+    if(record.Flags & OBJECT_FLAG_TEMPLATED) {
+        object = std::make_unique<ObjectFileTemplateObject>(GetString(record.Name),
+            GetString(record.TypeName), LoadStringList(record.FirstPrefix, record.PrefixCount));
+    } else {
+        object = std::make_unique<ObjectFileObjectProper>(GetString(record.Name),
+            GetString(record.TypeName), LoadStringList(record.FirstPrefix, record.PrefixCount));
+    }
+
+    for(uint32_t i = record.FirstList; i < record.FirstList + record.ListCount; ++i) {
+
+        const auto& listRecord = Lists[i];
+        auto list = std::make_unique<ObjectFileListProper>(GetString(listRecord.Name));
+
+        // The names were unique when this was compiled so AddVariable isn't needed
+        NamedVars& variables = list->GetVariables();
+
+        for(uint32_t var = listRecord.FirstVariable;
+            var < listRecord.FirstVariable + listRecord.VariableCount; ++var)
+            variables.AddVar(LoadVariable(var));
+
+        object->AddVariableList(std::move(list));
+    }
+
+    for(uint32_t i = record.FirstTextBlock; i < record.FirstTextBlock + record.TextBlockCount;
+        ++i) {
+
+        const auto& blockRecord = TextBlocks[i];
+        auto block = std::make_unique<ObjectFileTextBlockProper>(GetString(blockRecord.Name));
+
+        for(uint32_t line = blockRecord.FirstLine;
+            line < blockRecord.FirstLine + blockRecord.LineCount; ++line)
+            block->AddTextLine(GetString(Indexes[line]));
+
+        object->AddTextBlock(std::move(block));
+    }
+
+    if(record.ScriptSource != NO_INDEX) {
+#ifdef LEVIATHAN_USING_ANGELSCRIPT
+        auto script = std::make_shared<ScriptScript>(ScriptExecutor::Get()->CreateNewModule(
+            GetString(record.ScriptName), GetString(record.ScriptModuleSource)));
+
+        auto module = script->GetModule();
+
+        module->AddScriptSegment(GetString(record.ScriptFile), record.ScriptStartLine,
+            GetString(record.ScriptSource));
+        module->SetBuildState(SCRIPTBUILDSTATE_READYTOBUILD);
+
+        object->AddScriptScript(script);
+#else
+        LOG_WARNING("CompiledObjectFileData: object " + object->GetName() +
+                    " has a script but there is no script support compiled in");
+#endif // LEVIATHAN_USING_ANGELSCRIPT
+    }
+
+    return object;
+}
+// ------------------------------------ //
+DLLEXPORT std::unique_ptr<ObjectFile> CompiledObjectFileData::CreateObjectFile(
+    LErrorReporter* reporterror)
+{
+    auto ofile = std::make_unique<ObjectFile>();
+
+    NamedVars& headerVars = *ofile->GetVariables();
+
+    for(uint32_t i = Header->FirstHeaderVariable;
+        i < Header->FirstHeaderVariable + Header->HeaderVariableCount; ++i)
+        headerVars.AddVar(LoadVariable(i));
+
+    for(uint32_t i = 0; i < Header->DefinedObjectCount; ++i) {
+
+        if(!ofile->AddObject(std::make_shared<ObjectFileObjectCompiled>(shared_from_this(), i))) {
+
+            reporterror->Error("CompiledObjectFile: " + File.GetFile() +
+                               " has conflicting object name: " + GetString(Objects[i].Name));
+            return nullptr;
+        }
+    }
+
+    for(uint32_t i = 0; i < Header->TemplateCount; ++i) {
+
+        const auto& tmpl = Templates[i];
+        auto parameters = LoadStringList(tmpl.FirstParameter, tmpl.ParameterCount);
+
+        auto definition = std::make_shared<ObjectFileTemplateDefinition>(GetString(tmpl.Name),
+            parameters, std::make_shared<ObjectFileObjectCompiled>(shared_from_this(), tmpl.Object));
+
+        if(!ofile->AddTemplate(definition)) {
+
+            reporterror->Error("CompiledObjectFile: " + File.GetFile() +
+                               " has conflicting template name: " + definition->GetName());
+            return nullptr;
+        }
+    }
+
+    // The instances have already been generated into the objects so these are only kept for
+    // saving the file again
+    for(uint32_t i = 0; i < Header->InstanceCount; ++i) {
+
+        const auto& instance = Instances[i];
+        auto arguments = LoadStringList(instance.FirstArgument, instance.ArgumentCount);
+
+        ofile->AddTemplateInstance(
+            std::make_shared<ObjectFileTemplateInstance>(GetString(instance.Name), arguments));
+    }
+
+    return ofile;
+}
+// ------------------ ObjectFileObjectCompiled ------------------ //
+DLLEXPORT ObjectFileObjectCompiled::ObjectFileObjectCompiled(
+    std::shared_ptr<const CompiledObjectFileData> data, uint32_t index) :
+    Data(std::move(data)),
+    Index(index), Name(Data->GetString(Data->GetObjectRecord(index).Name)),
+    TName(Data->GetString(Data->GetObjectRecord(index).TypeName))
+{}
+
+ObjectFileObjectProper& ObjectFileObjectCompiled::GetLoaded() const
+{
+    if(!Loaded)
+        Loaded = Data->LoadObject(Index);
+
+    return *Loaded;
+}
+// ------------------------------------ //
+DLLEXPORT const std::string& ObjectFileObjectCompiled::GetName() const
+{
+    return Name;
+}
+
+DLLEXPORT const std::string& ObjectFileObjectCompiled::GetTypeName() const
+{
+    return TName;
+}
+
+DLLEXPORT bool ObjectFileObjectCompiled::IsThisTemplated() const
+{
+    return (Data->GetObjectRecord(Index).Flags & OBJECT_FLAG_TEMPLATED) != 0;
+}
+
+DLLEXPORT size_t ObjectFileObjectCompiled::GetPrefixesCount() const
+{
+    return Data->GetObjectRecord(Index).PrefixCount;
+}
+
+DLLEXPORT const std::string& ObjectFileObjectCompiled::GetPrefix(size_t index) const
+{
+    return GetLoaded().GetPrefix(index);
+}
+// ------------------------------------ //
+DLLEXPORT bool ObjectFileObjectCompiled::AddVariableList(std::unique_ptr<ObjectFileList>&& list)
+{
+    return GetLoaded().AddVariableList(std::move(list));
+}
+
+DLLEXPORT bool ObjectFileObjectCompiled::AddTextBlock(
+    std::unique_ptr<ObjectFileTextBlock>&& tblock)
+{
+    return GetLoaded().AddTextBlock(std::move(tblock));
+}
+
+DLLEXPORT void ObjectFileObjectCompiled::AddScriptScript(std::shared_ptr<ScriptScript> script)
+{
+    GetLoaded().AddScriptScript(script);
+}
+// ------------------------------------ //
+DLLEXPORT ObjectFileList* ObjectFileObjectCompiled::GetListWithName(
+    const std::string& name) const
+{
+    return GetLoaded().GetListWithName(name);
+}
+
+DLLEXPORT size_t ObjectFileObjectCompiled::GetListCount() const
+{
+    if(Loaded)
+        return Loaded->GetListCount();
+
+    return Data->GetObjectRecord(Index).ListCount;
+}
+
+DLLEXPORT ObjectFileList* ObjectFileObjectCompiled::GetList(size_t index) const
+{
+    return GetLoaded().GetList(index);
+}
+
+DLLEXPORT ObjectFileTextBlock* ObjectFileObjectCompiled::GetTextBlockWithName(
+    const std::string& name) const
+{
+    return GetLoaded().GetTextBlockWithName(name);
+}
+
+DLLEXPORT size_t ObjectFileObjectCompiled::GetTextBlockCount() const
+{
+    if(Loaded)
+        return Loaded->GetTextBlockCount();
+
+    return Data->GetObjectRecord(Index).TextBlockCount;
+}
+
+DLLEXPORT ObjectFileTextBlock* ObjectFileObjectCompiled::GetTextBlock(size_t index) const
+{
+    return GetLoaded().GetTextBlock(index);
+}
+
+DLLEXPORT std::shared_ptr<ScriptScript> ObjectFileObjectCompiled::GetScript() const
+{
+    return GetLoaded().GetScript();
+}
+
+DLLEXPORT std::string ObjectFileObjectCompiled::Serialize(size_t indentspaces /*= 0*/) const
+{
+    return GetLoaded().Serialize(indentspaces);
+}
+// ------------------ CompiledObjectFileWriter ------------------ //
+uint32_t CompiledObjectFileWriter::AddString(const std::string& str)
+{
+    const auto found = StringIndexes.find(str);
+
+    if(found != StringIndexes.end())
+        return found->second;
+
+    const auto index = static_cast<uint32_t>(Strings.size());
+
+    Strings.push_back(
+        {static_cast<uint32_t>(StringData.size()), static_cast<uint32_t>(str.size())});
+    StringData.append(str);
+
+    StringIndexes[str] = index;
+    return index;
+}
+
+uint32_t CompiledObjectFileWriter::AddStringList(const std::vector<std::string>& strings)
+{
+    const auto first = static_cast<uint32_t>(Indexes.size());
+
+    for(const auto& str : strings)
+        Indexes.push_back(AddString(str));
+
+    return first;
+}
+
+bool CompiledObjectFileWriter::AddVariable(
+    const NamedVariableList& variable, LErrorReporter* reporterror)
+{
+    // GetValues isn't const
+    auto& values = const_cast<NamedVariableList&>(variable).GetValues();
+
+    Variables.push_back({AddString(variable.GetName()), static_cast<uint32_t>(Values.size()),
+        static_cast<uint32_t>(values.size())});
+
+    for(const VariableBlock* value : values) {
+
+        const DataBlockAll* block = value ? value->GetBlockConst() : nullptr;
+
+        if(!block) {
+            reporterror->Error("CompiledObjectFileWriter: variable " + variable.GetName() +
+                               " has an empty value");
+            return false;
+        }
+
+        ObjectFileCompiledFormat::Value compiled{};
+        compiled.Type = block->Type;
+
+        switch(block->Type) {
+        case DATABLOCK_TYPE_INT:
+            compiled.Payload = MakePayload<int32_t>(
+                *TvalToTypeResolver<DATABLOCK_TYPE_INT>::Conversion(block)->Value);
+            break;
+        case DATABLOCK_TYPE_FLOAT:
+            compiled.Payload = MakePayload<float>(
+                *TvalToTypeResolver<DATABLOCK_TYPE_FLOAT>::Conversion(block)->Value);
+            break;
+        case DATABLOCK_TYPE_BOOL:
+            compiled.Payload = MakePayload<bool>(
+                *TvalToTypeResolver<DATABLOCK_TYPE_BOOL>::Conversion(block)->Value);
+            break;
+        case DATABLOCK_TYPE_CHAR:
+            compiled.Payload = MakePayload<char>(
+                *TvalToTypeResolver<DATABLOCK_TYPE_CHAR>::Conversion(block)->Value);
+            break;
+        case DATABLOCK_TYPE_DOUBLE:
+            compiled.Payload = MakePayload<double>(
+                *TvalToTypeResolver<DATABLOCK_TYPE_DOUBLE>::Conversion(block)->Value);
+            break;
+        case DATABLOCK_TYPE_STRING:
+            compiled.Payload =
+                AddString(*TvalToTypeResolver<DATABLOCK_TYPE_STRING>::Conversion(block)->Value);
+            break;
+        case DATABLOCK_TYPE_WSTRING:
+            compiled.Payload = AddString(Convert::Utf16ToUtf8(
+                *TvalToTypeResolver<DATABLOCK_TYPE_WSTRING>::Conversion(block)->Value));
+            break;
+        default:
+            reporterror->Error("CompiledObjectFileWriter: variable " + variable.GetName() +
+                               " has a value of type that can't be compiled: " +
+                               std::to_string(block->Type));
+            return false;
+        }
+
+        Values.push_back(compiled);
+    }
+
+    return true;
+}
+
+bool CompiledObjectFileWriter::AddObject(ObjectFileObject& object, LErrorReporter* reporterror)
+{
+    ObjectFileCompiledFormat::Object record{};
+
+    record.Name = AddString(object.GetName());
+    record.TypeName = AddString(object.GetTypeName());
+    record.Flags = object.IsThisTemplated() ? OBJECT_FLAG_TEMPLATED : 0;
+
+    std::vector<std::string> prefixes;
+    for(size_t i = 0; i < object.GetPrefixesCount(); ++i)
+        prefixes.push_back(object.GetPrefix(i));
+
+    record.FirstPrefix = AddStringList(prefixes);
+    record.PrefixCount = static_cast<uint32_t>(prefixes.size());
+
+    // The lists are added first so that they are next to each other in the table
+    record.FirstList = static_cast<uint32_t>(Lists.size());
+    record.ListCount = static_cast<uint32_t>(object.GetListCount());
+
+    for(size_t i = 0; i < object.GetListCount(); ++i) {
+
+        ObjectFileList* list = object.GetList(i);
+        NamedVars& variables = list->GetVariables();
+
+        Lists.push_back({AddString(list->GetName()), static_cast<uint32_t>(Variables.size()),
+            static_cast<uint32_t>(variables.GetVariableCount())});
+
+        for(size_t var = 0; var < variables.GetVariableCount(); ++var) {
+            if(!AddVariable(*variables.GetValueDirectRaw(var), reporterror))
+                return false;
+        }
+    }
+
+    record.FirstTextBlock = static_cast<uint32_t>(TextBlocks.size());
+    record.TextBlockCount = static_cast<uint32_t>(object.GetTextBlockCount());
+
+    for(size_t i = 0; i < object.GetTextBlockCount(); ++i) {
+
+        ObjectFileTextBlock* block = object.GetTextBlock(i);
+
+        std::vector<std::string> lines;
+        for(size_t line = 0; line < block->GetLineCount(); ++line)
+            lines.push_back(block->GetLine(line));
+
+        TextBlocks.push_back({AddString(block->GetName()), AddStringList(lines),
+            static_cast<uint32_t>(lines.size())});
+    }
+
+    record.ScriptName = NO_INDEX;
+    record.ScriptModuleSource = NO_INDEX;
+    record.ScriptFile = NO_INDEX;
+    record.ScriptSource = NO_INDEX;
+
+#ifdef LEVIATHAN_USING_ANGELSCRIPT
+    auto script = object.GetScript();
+    auto module = script ? script->GetModuleSafe() : nullptr;
+
+    // Same as with templates only the first segment is used
+    if(module && module->GetScriptSegmentCount() > 0) {
+
+        auto segment = module->GetScriptSegment(0);
+
+        record.ScriptName = AddString(module->GetName());
+        record.ScriptModuleSource = AddString(module->GetSource());
+        record.ScriptFile = AddString(segment->SourceFile);
+        record.ScriptSource = AddString(*segment->SourceCode);
+        record.ScriptStartLine = segment->StartLine;
+    }
+#endif // LEVIATHAN_USING_ANGELSCRIPT
+
+    Objects.push_back(record);
+    return true;
+}
+// ------------------------------------ //
+template<class T>
+void AppendTable(std::string& receiver, const std::vector<T>& table, uint32_t& offset)
+{
+    // Pad to alignment
+    while(receiver.size() % TABLE_ALIGNMENT != 0)
+        receiver.push_back('\0');
+
+    offset = static_cast<uint32_t>(receiver.size());
+
+    if(!table.empty())
+        receiver.append(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+}
+
+DLLEXPORT bool CompiledObjectFileWriter::Write(ObjectFile& data, const std::string& sourcehash,
+    std::string& receiver, LErrorReporter* reporterror)
+{
+    static_assert(sizeof(ObjectFileCompiledFormat::Header) % TABLE_ALIGNMENT == 0,
+        "header breaks table alignment");
+
+    ObjectFileCompiledFormat::Header header{};
+
+    std::memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+    header.Version = FORMAT_VERSION;
+    header.ByteOrder = BYTE_ORDER_MARK;
+    std::memcpy(header.SourceHash, sourcehash.data(),
+        std::min(sourcehash.size(), sizeof(header.SourceHash)));
+
+    NamedVars& headerVars = *data.GetVariables();
+
+    header.FirstHeaderVariable = static_cast<uint32_t>(Variables.size());
+    header.HeaderVariableCount = static_cast<uint32_t>(headerVars.GetVariableCount());
+
+    for(size_t i = 0; i < headerVars.GetVariableCount(); ++i) {
+        if(!AddVariable(*headerVars.GetValueDirectRaw(i), reporterror))
+            return false;
+    }
+
+    // Objects from template instances are included here so loading doesn't need to
+    // generate them again
+    for(size_t i = 0; i < data.GetTotalObjectCount(); ++i) {
+        if(!AddObject(*data.GetObject(i), reporterror))
+            return false;
+    }
+
+    header.DefinedObjectCount = static_cast<uint32_t>(Objects.size());
+
+    for(size_t i = 0; i < data.GetTemplateDefinitionCount(); ++i) {
+
+        auto definition = data.GetTemplateDefinition(i);
+
+        std::vector<std::string> parameters;
+        for(const auto& parameter : definition->GetParameters())
+            parameters.push_back(*parameter);
+
+        const auto name = AddString(definition->GetName());
+        const auto firstParameter = AddStringList(parameters);
+        const auto object = static_cast<uint32_t>(Objects.size());
+
+        if(!AddObject(*definition->GetRepresentingObject(), reporterror))
+            return false;
+
+        Templates.push_back(
+            {name, firstParameter, static_cast<uint32_t>(parameters.size()), object});
+    }
+
+    for(size_t i = 0; i < data.GetTemplateInstanceCount(); ++i) {
+
+        auto instance = data.GetTemplateInstance(i);
+
+        std::vector<std::string> arguments;
+        for(const auto& argument : instance->GetArguments())
+            arguments.push_back(*argument);
+
+        const auto name = AddString(instance->GetNameOfParentTemplate());
+
+        Instances.push_back(
+            {name, AddStringList(arguments), static_cast<uint32_t>(arguments.size())});
+    }
+
+    header.StringCount = static_cast<uint32_t>(Strings.size());
+    header.StringDataSize = static_cast<uint32_t>(StringData.size());
+    header.ValueCount = static_cast<uint32_t>(Values.size());
+    header.IndexCount = static_cast<uint32_t>(Indexes.size());
+    header.VariableCount = static_cast<uint32_t>(Variables.size());
+    header.ListCount = static_cast<uint32_t>(Lists.size());
+    header.TextBlockCount = static_cast<uint32_t>(TextBlocks.size());
+    header.ObjectCount = static_cast<uint32_t>(Objects.size());
+    header.TemplateCount = static_cast<uint32_t>(Templates.size());
+    header.InstanceCount = static_cast<uint32_t>(Instances.size());
+
+    // The header is filled in last once the offsets are known
+    std::string buffer(sizeof(header), '\0');
+
+    AppendTable(buffer, Strings, header.StringOffset);
+    AppendTable(buffer, Values, header.ValueOffset);
+    AppendTable(buffer, Indexes, header.IndexOffset);
+    AppendTable(buffer, Variables, header.VariableOffset);
+    AppendTable(buffer, Lists, header.ListOffset);
+    AppendTable(buffer, TextBlocks, header.TextBlockOffset);
+    AppendTable(buffer, Objects, header.ObjectOffset);
+    AppendTable(buffer, Templates, header.TemplateOffset);
+    AppendTable(buffer, Instances, header.InstanceOffset);
+
+    header.StringDataOffset = static_cast<uint32_t>(buffer.size());
+    buffer.append(StringData);
+
+    if(buffer.size() > std::numeric_limits<uint32_t>::max()) {
+        reporterror->Error("CompiledObjectFileWriter: data is too large to be compiled");
+        return false;
+    }
+
+    header.FileSize = static_cast<uint32_t>(buffer.size());
+    std::memcpy(&buffer[0], &header, sizeof(header));
+
+    receiver = std::move(buffer);
+    return true;
+}
@@ -0,0 +1,315 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "ObjectFile.h"
+#include "ErrorReporter.h"
+#include "Utility/MemoryMappedFile.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Leviathan {
+
+//! \brief Layout of compiled (binary) ObjectFiles
+//!
+//! The file starts with a Header which points to the tables. Every table is an array of the
+//! structs defined here and is aligned to 8 bytes. Strings are stored only once and
+//! everything else refers to them by their index in the string table. Multi value things
+//! (variable values, prefixes, text lines, template arguments) are ranges of the value and
+//! index tables.
+namespace ObjectFileCompiledFormat {
+
+constexpr char MAGIC[4] = {'L', 'O', 'F', 'C'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+//! Used to detect files written on a machine with different byte order
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+//! Marks an unset string or object reference
+constexpr uint32_t NO_INDEX = 0xffffffff;
+
+//! Set on objects that were created from a template instance
+constexpr uint32_t OBJECT_FLAG_TEMPLATED = 0x1;
+
+struct Header {
+    char Magic[4];
+    uint32_t Version;
+    uint32_t ByteOrder;
+
+    //! Total size of the file, used to detect truncated files
+    uint32_t FileSize;
+
+    //! MD5 hex digest of the text source this was compiled from
+    char SourceHash[32];
+
+    uint32_t StringCount;
+    uint32_t StringOffset;
+    uint32_t StringDataSize;
+    uint32_t StringDataOffset;
+
+    uint32_t ValueCount;
+    uint32_t ValueOffset;
+
+    uint32_t IndexCount;
+    uint32_t IndexOffset;
+
+    uint32_t VariableCount;
+    uint32_t VariableOffset;
+
+    uint32_t ListCount;
+    uint32_t ListOffset;
+
+    uint32_t TextBlockCount;
+    uint32_t TextBlockOffset;
+
+    //! The first DefinedObjectCount objects are the ones in the ObjectFile, the rest are
+    //! template definition objects
+    uint32_t ObjectCount;
+    uint32_t DefinedObjectCount;
+    uint32_t ObjectOffset;
+
+    uint32_t TemplateCount;
+    uint32_t TemplateOffset;
+
+    uint32_t InstanceCount;
+    uint32_t InstanceOffset;
+
+    //! Range of the variable table that is the header variables
+    uint32_t FirstHeaderVariable;
+    uint32_t HeaderVariableCount;
+
+    uint32_t Unused;
+};
+
+struct StringEntry {
+    uint32_t Offset;
+    uint32_t Length;
+};
+
+//! \brief A single VariableBlock
+//!
+//! Type is one of the DATABLOCK_TYPE_* defines. Strings are stored as a string table index
+//! in the payload
+struct Value {
+    uint16_t Type;
+    uint16_t Unused1;
+    uint32_t Unused2;
+    uint64_t Payload;
+};
+
+//! \brief A NamedVariableList
+struct Variable {
+    uint32_t Name;
+    uint32_t FirstValue;
+    uint32_t ValueCount;
+};
+
+//! \brief An ObjectFileList
+struct List {
+    uint32_t Name;
+    uint32_t FirstVariable;
+    uint32_t VariableCount;
+};
+
+//! \brief An ObjectFileTextBlock, the lines are indexes to strings
+struct TextBlock {
+    uint32_t Name;
+    uint32_t FirstLine;
+    uint32_t LineCount;
+};
+
+struct Object {
+    uint32_t Name;
+    uint32_t TypeName;
+    uint32_t Flags;
+
+    uint32_t FirstPrefix;
+    uint32_t PrefixCount;
+
+    uint32_t FirstList;
+    uint32_t ListCount;
+
+    uint32_t FirstTextBlock;
+    uint32_t TextBlockCount;
+
+    //! Script block, only valid if ScriptSource isn't NO_INDEX
+    uint32_t ScriptName;
+    uint32_t ScriptModuleSource;
+    uint32_t ScriptFile;
+    uint32_t ScriptSource;
+    int32_t ScriptStartLine;
+};
+
+struct Template {
+    uint32_t Name;
+    uint32_t FirstParameter;
+    uint32_t ParameterCount;
+
+    //! Index in the object table
+    uint32_t Object;
+};
+
+struct TemplateInstance {
+    uint32_t Name;
+    uint32_t FirstArgument;
+    uint32_t ArgumentCount;
+};
+
+} // namespace ObjectFileCompiledFormat
+
+//! \brief Read only view of a compiled ObjectFile that stays mapped into memory
+//!
+//! Every reference in the file is validated when it is opened so the accessors don't need
+//! to do any checking.
+class CompiledObjectFileData
+    : public std::enable_shared_from_this<CompiledObjectFileData> {
+public:
+    //! \brief Maps and validates a compiled file
+    //! \returns Null if the file doesn't exist or isn't a valid compiled file
+    DLLEXPORT static std::shared_ptr<CompiledObjectFileData> Open(
+        const std::string& file, LErrorReporter* reporterror);
+
+    //! \brief Creates an ObjectFile which loads its objects on demand from this
+    DLLEXPORT std::unique_ptr<ObjectFile> CreateObjectFile(LErrorReporter* reporterror);
+
+    //! \brief Fully loads an object from the object table
+    DLLEXPORT std::unique_ptr<ObjectFileObjectProper> LoadObject(uint32_t index) const;
+
+    //! \returns The hash of the text source this was compiled from
+    DLLEXPORT std::string GetSourceHash() const;
+
+    DLLEXPORT std::string GetString(uint32_t index) const;
+
+    inline const ObjectFileCompiledFormat::Object& GetObjectRecord(uint32_t index) const
+    {
+        return Objects[index];
+    }
+
+protected:
+    CompiledObjectFileData(const std::string& file);
+
+    bool Validate(LErrorReporter* reporterror);
+
+    std::shared_ptr<NamedVariableList> LoadVariable(uint32_t index) const;
+
+    VariableBlock* LoadValue(const ObjectFileCompiledFormat::Value& value) const;
+
+    std::vector<std::unique_ptr<std::string>> LoadStringList(
+        uint32_t first, uint32_t count) const;
+
+protected:
+    MemoryMappedFile File;
+
+    const ObjectFileCompiledFormat::Header* Header = nullptr;
+    const ObjectFileCompiledFormat::StringEntry* Strings = nullptr;
+    const char* StringData = nullptr;
+    const ObjectFileCompiledFormat::Value* Values = nullptr;
+    const uint32_t* Indexes = nullptr;
+    const ObjectFileCompiledFormat::Variable* Variables = nullptr;
+    const ObjectFileCompiledFormat::List* Lists = nullptr;
+    const ObjectFileCompiledFormat::TextBlock* TextBlocks = nullptr;
+    const ObjectFileCompiledFormat::Object* Objects = nullptr;
+    const ObjectFileCompiledFormat::Template* Templates = nullptr;
+    const ObjectFileCompiledFormat::TemplateInstance* Instances = nullptr;
+};
+
+//! \brief ObjectFileObject that loads its contents from a compiled file on first use
+//!
+//! The name and type are available without loading anything so that finding objects doesn't
+//! load all of them
+class ObjectFileObjectCompiled : public ObjectFileObject {
+public:
+    DLLEXPORT ObjectFileObjectCompiled(
+        std::shared_ptr<const CompiledObjectFileData> data, uint32_t index);
+
+    DLLEXPORT const std::string& GetName() const override;
+
+    DLLEXPORT bool AddVariableList(std::unique_ptr<ObjectFileList>&& list) override;
+
+    DLLEXPORT bool AddTextBlock(std::unique_ptr<ObjectFileTextBlock>&& tblock) override;
+
+    DLLEXPORT void AddScriptScript(std::shared_ptr<ScriptScript> script) override;
+
+    DLLEXPORT const std::string& GetTypeName() const override;
+
+    DLLEXPORT ObjectFileList* GetListWithName(const std::string& name) const override;
+
+    DLLEXPORT size_t GetListCount() const override;
+
+    DLLEXPORT ObjectFileList* GetList(size_t index) const override;
+
+    DLLEXPORT ObjectFileTextBlock* GetTextBlockWithName(const std::string& name) const override;
+
+    DLLEXPORT size_t GetTextBlockCount() const override;
+
+    DLLEXPORT ObjectFileTextBlock* GetTextBlock(size_t index) const override;
+
+    DLLEXPORT std::shared_ptr<ScriptScript> GetScript() const override;
+
+    DLLEXPORT size_t GetPrefixesCount() const override;
+
+    DLLEXPORT const std::string& GetPrefix(size_t index) const override;
+
+    DLLEXPORT bool IsThisTemplated() const override;
+
+    DLLEXPORT std::string Serialize(size_t indentspaces = 0) const override;
+
+    //! \returns True once the contents have been loaded
+    inline bool IsLoaded() const
+    {
+        return Loaded.operator bool();
+    }
+
+protected:
+    //! \brief Loads the object data if not already loaded
+    ObjectFileObjectProper& GetLoaded() const;
+
+protected:
+    std::shared_ptr<const CompiledObjectFileData> Data;
+    const uint32_t Index;
+
+    const std::string Name;
+    const std::string TName;
+
+    //! The real object once something has been accessed
+    mutable std::unique_ptr<ObjectFileObjectProper> Loaded;
+};
+
+//! \brief Builds the compiled form of an ObjectFile
+class CompiledObjectFileWriter {
+public:
+    //! \brief Writes data in the compiled format to receiver
+    //! \param sourcehash Hash of the text source, used to detect stale compiled files
+    //! \returns False if data contains something that can't be compiled
+    DLLEXPORT bool Write(ObjectFile& data, const std::string& sourcehash,
+        std::string& receiver, LErrorReporter* reporterror);
+
+protected:
+    uint32_t AddString(const std::string& str);
+
+    uint32_t AddStringList(const std::vector<std::string>& strings);
+
+    bool AddVariable(const NamedVariableList& variable, LErrorReporter* reporterror);
+
+    bool AddObject(ObjectFileObject& object, LErrorReporter* reporterror);
+
+protected:
+    std::unordered_map<std::string, uint32_t> StringIndexes;
+    std::vector<ObjectFileCompiledFormat::StringEntry> Strings;
+    std::string StringData;
+
+    std::vector<ObjectFileCompiledFormat::Value> Values;
+    std::vector<uint32_t> Indexes;
+    std::vector<ObjectFileCompiledFormat::Variable> Variables;
+    std::vector<ObjectFileCompiledFormat::List> Lists;
+    std::vector<ObjectFileCompiledFormat::TextBlock> TextBlocks;
+    std::vector<ObjectFileCompiledFormat::Object> Objects;
+    std::vector<ObjectFileCompiledFormat::Template> Templates;
+    std::vector<ObjectFileCompiledFormat::TemplateInstance> Instances;
+};
+
+} // namespace Leviathan
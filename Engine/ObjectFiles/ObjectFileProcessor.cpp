@@ -13,6 +13,8 @@
 #include "utf8/checked.h"
 
 #include "ObjectFile.h"
+#include "ObjectFileCompiled.h"
+#include "Utility/MD5Generator.h"
 
 #ifdef ALLOW_INTERNAL_EXCEPTIONS
 #include "Exceptions.h"
@@ -23,6 +25,8 @@
 #include "Script/ScriptExecutor.h"
 #include "Script/ScriptScript.h"
 #endif // LEVIATHAN_USING_ANGELSCRIPT
+
+#include <filesystem>
 using namespace Leviathan;
 // ------------------------------------ //
 #ifndef NO_DEFAULT_DATAINDEX
@@ -87,38 +91,162 @@ template<class TStr, class TLineType>
     reporterror->Error(sstream.str());
 }
 // ------------------ Processing function ------------------ //
-DLLEXPORT std::unique_ptr<ObjectFile> Leviathan::ObjectFileProcessor::ProcessObjectFile(
-    const std::string &file, LErrorReporter* reporterror)
+bool Leviathan::ObjectFileProcessor::GetObjectFileText(const MemoryMappedFile &file,
+    std::string_view &receiver, LErrorReporter* reporterror)
 {
-	// First read the file entirely //
-	std::string filecontents;
-
-    if (!FileSystem::ReadFileEntirely(file, filecontents)) {
+    if (!file.IsValid()) {
 
         reporterror->Error("ObjectFileProcessor: ProcessObjectFile: file could not be read: " +
-            file);
-        return nullptr;
+            file.GetFile());
+        return false;
     }
-	
-	// Skip empty files //
-	if(filecontents.size() == 0){
 
-		return nullptr;
-	}
+    receiver = std::string_view(file.GetData(), file.GetSize());
 
 	// Skip the BOM if there is one //
-	if(utf8::starts_with_bom(filecontents.begin(), filecontents.end())){
+	if(utf8::starts_with_bom(receiver.begin(), receiver.end())){
 
-		// Pop the first 3 bytes //
-		filecontents = filecontents.substr(3, filecontents.size()-3);
+		receiver.remove_prefix(3);
 	}
 
+    return true;
+}
+
+DLLEXPORT std::unique_ptr<ObjectFile> Leviathan::ObjectFileProcessor::ProcessObjectFile(
+    const std::string &file, LErrorReporter* reporterror)
+{
+	// The file is parsed directly from the mapped memory //
+    MemoryMappedFile mapped(file);
+	std::string_view filecontents;
+
+    if(!GetObjectFileText(mapped, filecontents, reporterror))
+        return nullptr;
+
+    // Skip empty files //
+    if(filecontents.size() == 0){
+
+        return nullptr;
+    }
+
     return ProcessObjectFileFromString(filecontents, file, reporterror);
 }
+// ------------------------------------ //
+DLLEXPORT std::string Leviathan::ObjectFileProcessor::GetCompiledObjectFilePath(
+    const std::string &file)
+{
+    return file + COMPILED_EXTENSION;
+}
+
+DLLEXPORT std::unique_ptr<ObjectFile> Leviathan::ObjectFileProcessor::LoadCompiledObjectFile(
+    const std::string &compiledfile, LErrorReporter* reporterror)
+{
+    auto data = CompiledObjectFileData::Open(compiledfile, reporterror);
+
+    if(!data)
+        return nullptr;
+
+    return data->CreateObjectFile(reporterror);
+}
+
+DLLEXPORT std::unique_ptr<ObjectFile> Leviathan::ObjectFileProcessor::ProcessObjectFileCompiled(
+    const std::string &file, LErrorReporter* reporterror)
+{
+    const auto compiledfile = GetCompiledObjectFilePath(file);
+
+    std::error_code error;
+
+    const bool sourceExists = std::filesystem::exists(file, error);
+    const bool compiledExists = std::filesystem::exists(compiledfile, error);
+
+    // Allow shipping just the compiled files //
+    if(!sourceExists){
+
+        if(compiledExists)
+            return LoadCompiledObjectFile(compiledfile, reporterror);
+
+        reporterror->Error("ObjectFileProcessor: ProcessObjectFileCompiled: file doesn't "
+            "exist: " + file);
+        return nullptr;
+    }
+
+    std::shared_ptr<CompiledObjectFileData> compiled;
+
+    if(compiledExists){
+
+        compiled = CompiledObjectFileData::Open(compiledfile, reporterror);
+
+        // Fast path with no need to read the text //
+        if(compiled && std::filesystem::last_write_time(compiledfile, error) >=
+            std::filesystem::last_write_time(file, error) && !error)
+        {
+            return compiled->CreateObjectFile(reporterror);
+        }
+    }
+
+    MemoryMappedFile mapped(file);
+    std::string_view filecontents;
+
+    if(!GetObjectFileText(mapped, filecontents, reporterror))
+        return nullptr;
+
+    if(filecontents.size() == 0)
+        return nullptr;
+
+    MD5 hasher;
+    hasher.update(filecontents.data(), static_cast<MD5::size_type>(filecontents.size()));
+    hasher.finalize();
+
+    const auto hash = hasher.hexdigest();
+
+    if(compiled && compiled->GetSourceHash() == hash){
+
+        // Only the timestamp changed, touch the compiled file to skip hashing next time //
+        std::filesystem::last_write_time(compiledfile,
+            std::filesystem::last_write_time(file, error), error);
+
+        return compiled->CreateObjectFile(reporterror);
+    }
+
+    compiled.reset();
+
+    auto ofile = ProcessObjectFileFromString(filecontents, file, reporterror);
+
+    if(!ofile)
+        return nullptr;
+
+    std::string binary;
+
+    // Previously loaded ObjectFiles may still have the old compiled file mapped so it can't be
+    // truncated. A new file is written and renamed over the old one, which keeps the old
+    // mappings valid //
+    const auto temporary = compiledfile + ".tmp";
+
+    if(SerializeObjectFileBinary(*ofile, binary, reporterror, hash) &&
+        FileSystem::WriteToFile(binary, temporary))
+    {
+        error.clear();
+        std::filesystem::rename(temporary, compiledfile, error);
+
+    } else {
+
+        error = std::make_error_code(std::errc::io_error);
+    }
+
+    if(error){
+
+        // The text version was still loaded fine //
+        reporterror->Warning("ObjectFileProcessor: failed to write compiled version of: " +
+            file);
+
+        std::filesystem::remove(temporary, error);
+    }
+
+    return ofile;
+}
 
 DLLEXPORT std::unique_ptr<Leviathan::ObjectFile>
     ObjectFileProcessor::ProcessObjectFileFromString(
-    const std::string &filecontents, const std::string &filenameforerrors,
+    std::string_view filecontents, const std::string &filenameforerrors,
     LErrorReporter* reporterror) 
 {
     // Create the target object //
@@ -126,8 +254,8 @@ DLLEXPORT std::unique_ptr<Leviathan::ObjectFile>
 
     bool succeeded = true;
 
-    // Create an UTF8 supporting iterator //
-    StringIterator itr(std::make_unique<UTF8PointerDataIterator>(filecontents));
+    // Create an UTF8 supporting iterator that doesn't copy the contents //
+    StringIterator itr(std::make_unique<UTF8ViewDataIterator>(filecontents));
 
     while(!itr.IsOutOfBounds()){
         
@@ -1032,10 +1160,18 @@ bool Leviathan::ObjectFileProcessor::TryToLoadScriptBlock(const std::string &fil
 }
 // ------------------------------------ //
 DLLEXPORT bool Leviathan::ObjectFileProcessor::WriteObjectFile(ObjectFile &data,
-    const std::string &file, LErrorReporter* reporterror)
+    const std::string &file, LErrorReporter* reporterror, bool binary /*= false*/)
 {
     std::string datatowrite;
 
+    if(binary){
+
+        if(!SerializeObjectFileBinary(data, datatowrite, reporterror))
+            return false;
+
+        return FileSystem::WriteToFile(datatowrite, file);
+    }
+
     if(!SerializeObjectFile(data, datatowrite)){
 
         reporterror->Error("WriteObjectFile: failed to serialize data into a std::string");
@@ -1047,6 +1183,13 @@ DLLEXPORT bool Leviathan::ObjectFileProcessor::WriteObjectFile(ObjectFile &data,
 	return true;
 }
 
+DLLEXPORT bool Leviathan::ObjectFileProcessor::SerializeObjectFileBinary(ObjectFile &data,
+    std::string &receiver, LErrorReporter* reporterror, const std::string &sourcehash /*= ""*/)
+{
+    CompiledObjectFileWriter writer;
+    return writer.Write(data, sourcehash, receiver, reporterror);
+}
+
 DLLEXPORT bool Leviathan::ObjectFileProcessor::SerializeObjectFile(ObjectFile &data,
     std::string &receiver)
 {
@@ -6,10 +6,13 @@
 #include "ObjectFile.h"
 #include "ErrorReporter.h"
 #include <string>
+#include <string_view>
 #include <memory>
 
 namespace Leviathan{
 
+class MemoryMappedFile;
+
 //! \brief Static class for handling ObjectFiles
 class ObjectFileProcessor{
 public:
@@ -24,18 +27,37 @@ public:
     DLLEXPORT static std::unique_ptr<ObjectFile> ProcessObjectFile(const std::string &file, 
         LErrorReporter* reporterror);
 
+    //! \note filecontents only needs to stay valid during this call
     static DLLEXPORT std::unique_ptr<ObjectFile> ProcessObjectFileFromString(
-        const std::string &filecontents, const std::string &filenameforerrors,
+        std::string_view filecontents, const std::string &filenameforerrors,
         LErrorReporter* reporterror);
 
 
+    //! \brief Reads an ObjectFile using a compiled binary version of it when possible
+    //!
+    //! The compiled file is next to the text file (see GetCompiledObjectFilePath). If the
+    //! text file has been modified after the compiled one and its hash doesn't match the
+    //! compiled file, the text is parsed again and the compiled file rewritten
+    //! \note The objects are loaded from the compiled file only when they are used
+    DLLEXPORT static std::unique_ptr<ObjectFile> ProcessObjectFileCompiled(
+        const std::string &file, LErrorReporter* reporterror);
+
+    //! \brief Loads a compiled ObjectFile without checking its source file
+    //! \returns Null if the file is missing or isn't a valid compiled file
+    DLLEXPORT static std::unique_ptr<ObjectFile> LoadCompiledObjectFile(
+        const std::string &compiledfile, LErrorReporter* reporterror);
+
+    //! \returns The path where ProcessObjectFileCompiled stores the compiled version of file
+    DLLEXPORT static std::string GetCompiledObjectFilePath(const std::string &file);
+
     //! \brief Writes an ObjectFile's data structure to a file
     //! \warning Using the process and this function will erase ALL comments,
     //! which is not optimal for config files. It is recommended to only append
     //! to an existing file to keep comments intact
+    //! \param binary If true the compiled binary format is written instead of text
     //! \return True when the file has been written, false if something failed
     DLLEXPORT static bool WriteObjectFile(ObjectFile &data, const std::string &file,
-        LErrorReporter* reporterror);
+        LErrorReporter* reporterror, bool binary = false);
 
     //! \brief Serializes an ObjectFile object into a string
     //!
@@ -44,8 +66,15 @@ public:
     //! \returns True if succeeds, false if the object failed to be serialized for some reason
     DLLEXPORT static bool SerializeObjectFile(ObjectFile &data, std::string &receiver);
 
+    //! \brief Serializes an ObjectFile object into the compiled binary format
+    //! \param sourcehash Hash of the text this was parsed from, empty if there is none
+    //! \param receiver The previous contents are replaced with the compiled data
+    DLLEXPORT static bool SerializeObjectFileBinary(ObjectFile &data, std::string &receiver,
+        LErrorReporter* reporterror, const std::string &sourcehash = "");
+
     //! \brief Registers a new value alias for the processor
     //! \warning Calling this while files are being parsed will cause undefined behavior
+    //! \note Compiled ObjectFiles contain the values the aliases had when they were compiled
     DLLEXPORT static void RegisterValue(const std::string &name, VariableBlock* valuetokeep);
 
     // Utility functions //
@@ -190,8 +219,15 @@ public:
         return false;
     }
 
+    //! Extension appended to text files to get their compiled version's path
+    static constexpr auto COMPILED_EXTENSION = ".compiled";
+
 private:
 
+    //! \brief Gets the text of a mapped file without the BOM
+    static bool GetObjectFileText(const MemoryMappedFile &file, std::string_view &receiver,
+        LErrorReporter* reporterror);
+
     //! \brief Handling function for NamedVariables
     static std::shared_ptr<NamedVariableList> TryToLoadNamedVariables(const std::string &file,
         StringIterator &itr, const std::string &preceeding, LErrorReporter* reporterror);
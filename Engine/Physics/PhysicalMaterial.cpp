@@ -1,6 +1,8 @@
 // ------------------------------------ //
 #include "PhysicalMaterial.h"
 
+#include "PhysicsMaterialManager.h"
+
 using namespace Leviathan;
 // ------------------------------------ //
 DLLEXPORT Leviathan::PhysicalMaterial::PhysicalMaterial(const std::string& name, int id) :
@@ -12,6 +14,13 @@ DLLEXPORT Leviathan::PhysicalMaterial::~PhysicalMaterial() {}
 DLLEXPORT PhysMaterialDataPair& Leviathan::PhysicalMaterial::FormPairWith(
     const PhysicalMaterial& other)
 {
-    return InterractionsWith[other.ID] = PhysMaterialDataPair();
+    const bool existing = InterractionsWith.find(other.ID) != InterractionsWith.end();
+
+    PhysMaterialDataPair& pair = InterractionsWith[other.ID] = PhysMaterialDataPair();
+
+    if(Owner && !existing)
+        Owner->_RebuildPairTable();
+
+    return pair;
 }
 // ------------------------------------ //
@@ -121,7 +121,7 @@ public:
     DLLEXPORT ~PhysicalMaterial();
 
     //! \brief Data pairing
-    //! \note The returned reference is valid only until the next call to FormPairWith
+    //! \note The returned pair stays valid as long as this material does
     DLLEXPORT PhysMaterialDataPair& FormPairWith(const PhysicalMaterial& other);
 
     //! \brief Returns data for this material to interact with another
@@ -152,6 +152,9 @@ private:
     const std::string Name;
     const int ID;
 
+    //! Set when added to a manager, which is told about new pairs
+    PhysicsMaterialManager* Owner = nullptr;
+
     //! The key is the ID of the other material
     std::unordered_map<int, PhysMaterialDataPair> InterractionsWith;
 };
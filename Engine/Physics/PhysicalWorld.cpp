@@ -2,15 +2,118 @@
 #include "PhysicalWorld.h"
 
 #include "../TimeIncludes.h"
+#include "Common/SFMLPackets.h"
 #include "Engine.h"
 #include "Events/EventHandler.h"
+#include "PhysicsHistory.h"
 #include "PhysicsMaterialManager.h"
+#include "PhysicsTaskScheduler.h"
+#include "Script/NonOwningScriptCallback.h"
 
+#include <bullet/BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include <bullet/BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
 #include <bullet/btBulletDynamicsCommon.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef LEVIATHAN_USING_BULLET_MULTITHREADING
+#include <bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#endif // LEVIATHAN_USING_BULLET_MULTITHREADING
 using namespace Leviathan;
 // ------------------------------------ //
+namespace {
+//! \brief Accesses the time Bullet has accumulated towards the next fixed step
+struct StepTimeAccess : btDiscreteDynamicsWorld {
+
+    static btScalar& Get(btDiscreteDynamicsWorld& world)
+    {
+        return world.*(&StepTimeAccess::m_localTime);
+    }
+};
+
+//! \brief Types of shapes in the data of PhysicalWorld::SerializeShape
+enum class SERIALIZED_SHAPE : uint8_t { Sphere = 0, Box, Compound };
+
+//! Deeper compound shapes are treated as invalid data
+constexpr int MAX_SERIALIZED_SHAPE_DEPTH = 16;
+
+constexpr uint32_t MAX_SERIALIZED_SHAPE_CHILDREN = 10000;
+
+bool IsValidShapeSize(float value)
+{
+    return std::isfinite(value) && value > 0;
+}
+
+PhysicsShape::pointer DeserializeShapeImpl(PhysicalWorld& world, sf::Packet& data, int depth)
+{
+    uint8_t type;
+    data >> type;
+
+    if(!data)
+        return nullptr;
+
+    switch(static_cast<SERIALIZED_SHAPE>(type)) {
+    case SERIALIZED_SHAPE::Sphere: {
+        float radius;
+        data >> radius;
+
+        if(!data || !IsValidShapeSize(radius))
+            return nullptr;
+
+        return world.CreateSphere(radius);
+    }
+    case SERIALIZED_SHAPE::Box: {
+        Float3 halfExtents;
+        data >> halfExtents;
+
+        if(!data || !IsValidShapeSize(halfExtents.X) || !IsValidShapeSize(halfExtents.Y) ||
+            !IsValidShapeSize(halfExtents.Z))
+            return nullptr;
+
+        return world.CreateBox(halfExtents.X, halfExtents.Y, halfExtents.Z);
+    }
+    case SERIALIZED_SHAPE::Compound: {
+        uint32_t count;
+        data >> count;
+
+        if(!data || count > MAX_SERIALIZED_SHAPE_CHILDREN ||
+            depth >= MAX_SERIALIZED_SHAPE_DEPTH)
+            return nullptr;
+
+        auto compound = world.CreateCompound();
+
+        for(uint32_t i = 0; i < count; ++i) {
+
+            Float3 offset;
+            Float4 orientation;
+            data >> offset >> orientation;
+
+            if(!data || offset.HasInvalidValues() || orientation.HasInvalidValues())
+                return nullptr;
+
+            const auto child = DeserializeShapeImpl(world, data, depth + 1);
+
+            if(!child || !compound->AddChildShape(child, offset, orientation))
+                return nullptr;
+        }
+
+        return compound;
+    }
+    }
+
+    return nullptr;
+}
+} // namespace
+// ------------------------------------ //
 namespace Leviathan {
 //! \brief Handles AABB material callbacks
+//!
+//! Bullet calls this only while updating the broadphase, which is single threaded also in
+//! multithreaded worlds
 class LeviathanPhysicsOverlapFilter : public btOverlapFilterCallback {
 public:
     LeviathanPhysicsOverlapFilter(PhysicalWorld* world) : World(world) {}
@@ -70,9 +173,195 @@ private:
 };
 } // namespace Leviathan
 
+namespace {
+//! Bulk body creation and destruction optimizes the broadphase when at least this many bodies
+//! were changed
+constexpr size_t BULK_BROADPHASE_OPTIMIZE_COUNT = 64;
+
+//! \brief Stores the hits of a ray or sweep query
+//!
+//! Keeps only the closest hit or, when collecting all hits, the closest hit of each body
+class QueryHitCollector {
+public:
+    QueryHitCollector(const PhysicsQuery& query, PhysicsQueryHit* hits) :
+        Hits(hits), MaxHits(query.GetMaxHits()), All(query.Type == PHYSICS_QUERY_TYPE::RayAll),
+        From(query.From), To(query.To)
+    {}
+
+    //! \returns The fraction the rest of the cast can be cut to
+    btScalar Add(const btCollisionObject& object, float fraction, const btVector3& point,
+        const btVector3& normal)
+    {
+        PhysicsQueryHit hit;
+        hit.Body = static_cast<PhysicsBody*>(object.getUserPointer());
+        hit.Entity = hit.Body->GetOwningEntity();
+        hit.Point = point;
+        hit.Normal = normal.fuzzyZero() ? normal : normal.normalized();
+        hit.Fraction = fraction;
+
+        if(!All) {
+
+            if(Count == 0 || fraction < Hits[0].Fraction) {
+                Hits[0] = hit;
+                Count = 1;
+            }
+
+            return Hits[0].Fraction;
+        }
+
+        for(int i = 0; i < Count; ++i) {
+
+            if(Hits[i].Body == hit.Body) {
+
+                if(fraction < Hits[i].Fraction)
+                    Hits[i] = hit;
+
+                return 1;
+            }
+        }
+
+        if(Count < MaxHits) {
+
+            Hits[Count++] = hit;
+            return 1;
+        }
+
+        // When full the farthest hit is replaced //
+        auto farthest = std::max_element(Hits, Hits + Count, &IsCloser);
+
+        if(fraction < farthest->Fraction)
+            *farthest = hit;
+
+        return 1;
+    }
+
+    //! \returns The number of hits
+    int Finish()
+    {
+        if(All)
+            std::sort(Hits, Hits + Count, &IsCloser);
+
+        return Count;
+    }
+
+    Float3 GetPointAt(float fraction) const
+    {
+        return From + (To - From) * fraction;
+    }
+
+private:
+    static bool IsCloser(const PhysicsQueryHit& first, const PhysicsQueryHit& second)
+    {
+        return first.Fraction < second.Fraction;
+    }
+
+private:
+    PhysicsQueryHit* Hits;
+    const int MaxHits;
+    const bool All;
+    const Float3 From;
+    const Float3 To;
+
+    int Count = 0;
+};
+
+class QueryRayCallback : public btCollisionWorld::RayResultCallback {
+public:
+    QueryRayCallback(QueryHitCollector& collector) : Collector(collector) {}
+
+    btScalar addSingleResult(
+        btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+    {
+        const btCollisionObject& object = *rayResult.m_collisionObject;
+
+        const btVector3 normal =
+            normalInWorldSpace ?
+                rayResult.m_hitNormalLocal :
+                object.getWorldTransform().getBasis() * rayResult.m_hitNormalLocal;
+
+        m_closestHitFraction = Collector.Add(object, rayResult.m_hitFraction,
+            Collector.GetPointAt(rayResult.m_hitFraction), normal);
+        return m_closestHitFraction;
+    }
+
+private:
+    QueryHitCollector& Collector;
+};
+
+class QuerySweepCallback : public btCollisionWorld::ConvexResultCallback {
+public:
+    QuerySweepCallback(QueryHitCollector& collector) : Collector(collector) {}
+
+    btScalar addSingleResult(
+        btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+    {
+        const btCollisionObject& object = *convexResult.m_hitCollisionObject;
+
+        const btVector3 normal =
+            normalInWorldSpace ?
+                convexResult.m_hitNormalLocal :
+                object.getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+
+        // The hit point is in world space despite the name
+        m_closestHitFraction = Collector.Add(
+            object, convexResult.m_hitFraction, convexResult.m_hitPointLocal, normal);
+        return m_closestHitFraction;
+    }
+
+private:
+    QueryHitCollector& Collector;
+};
+
+//! \brief Calls a callback with the collision object of each found broadphase leaf
+template<class CallbackT>
+class QueryLeafCallback : public btDbvt::ICollide {
+public:
+    QueryLeafCallback(CallbackT&& callback) : Callback(std::move(callback)) {}
+
+    void Process(const btDbvtNode* leaf) override
+    {
+        Callback(static_cast<btCollisionObject*>(
+            static_cast<btBroadphaseProxy*>(leaf->data)->m_clientObject));
+    }
+
+private:
+    CallbackT Callback;
+};
+
+template<class CallbackT>
+QueryLeafCallback<CallbackT> MakeLeafCallback(CallbackT&& callback)
+{
+    return QueryLeafCallback<CallbackT>(std::move(callback));
+}
+
+//! \brief Runs the queries of a PhysicsQueryBatch
+class QueryBatchBody : public btIParallelForBody {
+public:
+    QueryBatchBody(const PhysicalWorld& world, const std::vector<PhysicsQuery>& queries,
+        const std::vector<size_t>& offsets, std::vector<int>& counts,
+        std::vector<PhysicsQueryHit>& hits) :
+        World(world),
+        Queries(queries), Offsets(offsets), Counts(counts), Hits(hits)
+    {}
+
+    void forLoop(int begin, int end) const override
+    {
+        for(int i = begin; i < end; ++i)
+            Counts[i] = World.RunQuery(Queries[i], Hits.data() + Offsets[i]);
+    }
+
+private:
+    const PhysicalWorld& World;
+    const std::vector<PhysicsQuery>& Queries;
+    const std::vector<size_t>& Offsets;
+    std::vector<int>& Counts;
+    std::vector<PhysicsQueryHit>& Hits;
+};
+} // namespace
+
 
 DLLEXPORT PhysicalWorld::PhysicalWorld(
-    GameWorld* owner, PhysicsMaterialManager* physicscallbacks) :
+    GameWorld* owner, PhysicsMaterialManager* physicscallbacks, bool multithreaded) :
     OwningWorld(owner),
     PhysicsMaterials(physicscallbacks),
     OverlapFilter(std::make_unique<LeviathanPhysicsOverlapFilter>(this))
@@ -80,17 +369,53 @@ DLLEXPORT PhysicalWorld::PhysicalWorld(
     // Setup physics world //
     CollisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
 
-    // Non-parallel dispatcher
-    Dispatcher = std::make_unique<btCollisionDispatcher>(CollisionConfiguration.get());
-
     // According to docs this is a good general broadphase
     OverlappingPairCache = std::make_unique<btDbvtBroadphase>();
 
-    // Non-parallel solver
-    Solver = std::make_unique<btSequentialImpulseConstraintSolver>();
+#ifdef LEVIATHAN_USING_BULLET_MULTITHREADING
+    Multithreaded = multithreaded;
+#else
+    if(multithreaded)
+        LOG_WARNING("PhysicalWorld: multithreaded physics requested but Leviathan is built "
+                    "without USE_BULLET_MULTITHREADING, using a single thread");
+#endif // LEVIATHAN_USING_BULLET_MULTITHREADING
+
+    if(!Multithreaded) {
+
+        // Non-parallel dispatcher
+        Dispatcher = std::make_unique<btCollisionDispatcher>(CollisionConfiguration.get());
+
+        // Non-parallel solver
+        Solver = std::make_unique<btSequentialImpulseConstraintSolver>();
 
-    DynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(Dispatcher.get(),
-        OverlappingPairCache.get(), Solver.get(), CollisionConfiguration.get());
+        DynamicsWorld = std::make_unique<btDiscreteDynamicsWorld>(Dispatcher.get(),
+            OverlappingPairCache.get(), Solver.get(), CollisionConfiguration.get());
+    }
+
+#ifdef LEVIATHAN_USING_BULLET_MULTITHREADING
+    if(Multithreaded) {
+
+        // Bullet runs its parallel loops with the global task scheduler
+        PhysicsTaskScheduler::Install();
+
+        Dispatcher = std::make_unique<btCollisionDispatcherMt>(CollisionConfiguration.get());
+
+        // Each thread solving islands takes its own solver from the pool
+        auto solverPool =
+            std::make_unique<btConstraintSolverPoolMt>(btGetTaskScheduler()->getNumThreads());
+
+#if BT_BULLET_VERSION >= 288
+        DynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(Dispatcher.get(),
+            OverlappingPairCache.get(), solverPool.get(), nullptr,
+            CollisionConfiguration.get());
+#else
+        DynamicsWorld = std::make_unique<btDiscreteDynamicsWorldMt>(Dispatcher.get(),
+            OverlappingPairCache.get(), solverPool.get(), CollisionConfiguration.get());
+#endif // BT_BULLET_VERSION >= 288
+
+        Solver = std::move(solverPool);
+    }
+#endif // LEVIATHAN_USING_BULLET_MULTITHREADING
 
     // Register required callbacks
     DynamicsWorld->setInternalTickCallback(&PhysicalWorld::OnPhysicsSubStep);
@@ -126,13 +451,20 @@ DLLEXPORT PhysicalWorld::~PhysicalWorld()
 // ------------------------------------ //
 DLLEXPORT void PhysicalWorld::SimulateWorld(float secondspassed, int maxsubsteps /*= 4*/)
 {
+    if(PhysicsMaterials && ScriptCallbacksVersion != PhysicsMaterials->GetPairTableVersion())
+        _UpdateScriptCallbackTable();
+
     PhysicsUpdateInProgress = true;
 
-    DynamicsWorld->stepSimulation(secondspassed, maxsubsteps);
+    DynamicsWorld->stepSimulation(secondspassed, maxsubsteps, PHYSICS_FIXED_STEP);
 
     PhysicsUpdateInProgress = false;
+
+    _DispatchContacts();
 }
 
+// Bullet calls this on the thread that is stepping the world after the parallel parts of the
+// substep are done, so queuing the contacts doesn't need locking
 void PhysicalWorld::OnPhysicsSubStep(btDynamicsWorld* world, btScalar timeStep)
 {
     auto leviathanWorld = static_cast<PhysicalWorld*>(world->getWorldUserInfo());
@@ -186,55 +518,134 @@ void PhysicalWorld::OnManifoldWithContact(btPersistentManifold* contactManifold,
     // const btVector3& contactPointB = contactPoint.getPositionWorldOnB();
     // const btVector3& normalOnB = contactPoint.m_normalWorldOnB;
 
+    // The callbacks for resimulated steps were already called //
+    if(Resimulating)
+        return;
+
     // Find matching materials
     PhysicsBody* body1 = static_cast<PhysicsBody*>(objA->getUserPointer());
     PhysicsBody* body2 = static_cast<PhysicsBody*>(objB->getUserPointer());
 
-    if(body1 && body2) {
+    if(!body1 || !body2)
+        return;
 
-        const auto materialID1 = body1->GetPhysicalMaterialID();
-        const auto materialID2 = body2->GetPhysicalMaterialID();
+    const int pairIndex = PhysicsMaterials->GetPairIndex(
+        body1->GetPhysicalMaterialID(), body2->GetPhysicalMaterialID());
 
-        // Find contact callbacks
-        if(materialID1 >= 0 && materialID2 >= 0) {
+    if(pairIndex < 0)
+        return;
 
-            auto pair = GetMaterialPair(materialID1, materialID2);
+    const auto pair = PhysicsMaterials->GetPairByIndex(pairIndex);
+    const auto callback = pair ? pair->ContactCallback : nullptr;
 
-            if(pair && pair->ContactCallback) {
+    const bool hasScriptCallback =
+        static_cast<size_t>(pairIndex) < ScriptCallbacksByPair.size() &&
+        ScriptCallbacksByPair[pairIndex];
 
-                pair->ContactCallback(*this, *body1, *body2);
+    // The callbacks are called once the simulation is done //
+    if(callback || hasScriptCallback)
+        PendingContacts.push_back({body1, body2, callback, pairIndex});
+}
+
+void PhysicalWorld::_DispatchContacts()
+{
+    // Contacts from simulating in a callback are left for the outer call to dispatch //
+    if(PendingContacts.empty() || DispatchingContacts)
+        return;
+
+    DispatchingContacts = true;
+
+    while(!PendingContacts.empty()) {
+
+        std::swap(PendingContacts, DispatchedContacts);
+
+        for(const auto& contact : DispatchedContacts) {
+
+            // Skip bodies destroyed by earlier callbacks //
+            if(!contact.Body1->GetBody() || !contact.Body2->GetBody())
+                continue;
+
+            if(contact.Callback)
+                contact.Callback(*this, *contact.Body1, *contact.Body2);
+
+            if(static_cast<size_t>(contact.PairIndex) < ScriptCallbacksByPair.size() &&
+                ScriptCallbacksByPair[contact.PairIndex]) {
+
+                ScriptRunningSetup setup;
+                ScriptCallbacksByPair[contact.PairIndex]->Run<void>(
+                    setup, this, contact.Body1.get(), contact.Body2.get());
             }
         }
+
+        DispatchedContacts.clear();
     }
+
+    DispatchingContacts = false;
+    RemovedScriptCallbacks.clear();
 }
 
 const PhysMaterialDataPair* PhysicalWorld::GetMaterialPair(int id1, int id2) const
 {
-    const auto material1 = PhysicsMaterials->GetMaterial(id1);
+    if(!PhysicsMaterials)
+        return nullptr;
 
-    const PhysMaterialDataPair* pair = nullptr;
+    return PhysicsMaterials->GetMaterialPair(id1, id2);
+}
+// ------------------------------------ //
+DLLEXPORT bool PhysicalWorld::SetScriptContactCallback(
+    int material1, int material2, asIScriptFunction* callback)
+{
+    if(!PhysicsMaterials || PhysicsMaterials->GetPairIndex(material1, material2) < 0) {
 
-    // The logs in this method will absolutely trash performance if they get hit as there will
-    // be tons of calls with the same parameters
+        LOG_ERROR("PhysicalWorld: SetScriptContactCallback: invalid material ids: " +
+                  std::to_string(material1) + ", " + std::to_string(material2));
 
-    if(material1) {
-        pair = material1->GetPairWith(id2);
-    } else {
-        LOG_ERROR("PhysicsBody has invalid material ID: " + std::to_string(id1));
+        if(callback)
+            callback->Release();
+        return false;
     }
 
-    if(!pair) {
+    // Pairs are the same in either order //
+    if(material1 > material2)
+        std::swap(material1, material2);
 
-        const auto material2 = PhysicsMaterials->GetMaterial(id2);
+    const auto existing = std::find_if(ScriptContactCallbacks.begin(),
+        ScriptContactCallbacks.end(), [&](const ScriptContactCallback& entry) {
+            return entry.Material1 == material1 && entry.Material2 == material2;
+        });
 
-        if(material2) {
-            pair = material2->GetPairWith(id1);
-        } else {
-            LOG_ERROR("PhysicsBody has invalid material ID: " + std::to_string(id2));
-        }
+    if(existing != ScriptContactCallbacks.end()) {
+
+        // A callback that is being ran can't be destroyed //
+        if(DispatchingContacts)
+            RemovedScriptCallbacks.push_back(std::move(existing->Callback));
+
+        ScriptContactCallbacks.erase(existing);
+    }
+
+    if(callback) {
+        ScriptContactCallbacks.push_back(
+            {material1, material2, std::make_unique<NonOwningScriptCallback>(callback)});
     }
 
-    return pair;
+    _UpdateScriptCallbackTable();
+    return true;
+}
+
+void PhysicalWorld::_UpdateScriptCallbackTable()
+{
+    ScriptCallbacksVersion = PhysicsMaterials->GetPairTableVersion();
+
+    ScriptCallbacksByPair.assign(
+        ScriptContactCallbacks.empty() ? 0 : PhysicsMaterials->GetPairIndexCount(), nullptr);
+
+    for(const auto& entry : ScriptContactCallbacks) {
+
+        const int index = PhysicsMaterials->GetPairIndex(entry.Material1, entry.Material2);
+
+        if(index >= 0)
+            ScriptCallbacksByPair[index] = entry.Callback.get();
+    }
 }
 // ------------------------------------ //
 // int Leviathan::SingleBodyUpdate(
@@ -281,6 +692,102 @@ DLLEXPORT PhysicsShape::pointer PhysicalWorld::CreateBox(
         std::make_unique<btBoxShape>(btVector3(xdimension, ydimension, zdimension)));
 }
 // ------------------------------------ //
+DLLEXPORT PhysicsShape::pointer PhysicalWorld::GetSharedSphere(float radius)
+{
+    auto& shape = SharedSpheres[radius];
+
+    if(!shape)
+        shape = CreateSphere(radius);
+
+    return shape;
+}
+
+DLLEXPORT PhysicsShape::pointer PhysicalWorld::GetSharedBox(
+    float xdimension, float ydimension, float zdimension)
+{
+    auto& shape = SharedBoxes[{xdimension, ydimension, zdimension}];
+
+    if(!shape)
+        shape = CreateBox(xdimension, ydimension, zdimension);
+
+    return shape;
+}
+
+DLLEXPORT void PhysicalWorld::ReleaseUnusedSharedShapes()
+{
+    // Only referenced by the map if the count is 1 //
+    const auto releaseUnused = [](auto& shapes) {
+        for(auto iter = shapes.begin(); iter != shapes.end();) {
+
+            if(iter->second->GetRefCount() == 1) {
+                iter = shapes.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    };
+
+    releaseUnused(SharedSpheres);
+    releaseUnused(SharedBoxes);
+}
+// ------------------------------------ //
+DLLEXPORT bool PhysicalWorld::SerializeShape(
+    const PhysicsShape& shape, sf::Packet& receiver) const
+{
+    const btCollisionShape* bulletShape = shape.Shape1.get();
+
+    switch(bulletShape->getShapeType()) {
+    case SPHERE_SHAPE_PROXYTYPE:
+        receiver << static_cast<uint8_t>(SERIALIZED_SHAPE::Sphere)
+                 << static_cast<float>(
+                        static_cast<const btSphereShape*>(bulletShape)->getRadius());
+        return true;
+    case BOX_SHAPE_PROXYTYPE:
+        receiver << static_cast<uint8_t>(SERIALIZED_SHAPE::Box)
+                 << Float3(static_cast<const btBoxShape*>(bulletShape)
+                               ->getHalfExtentsWithMargin());
+        return true;
+    case COMPOUND_SHAPE_PROXYTYPE: {
+        const auto* compound = static_cast<const btCompoundShape*>(bulletShape);
+        const int count = compound->getNumChildShapes();
+
+        receiver << static_cast<uint8_t>(SERIALIZED_SHAPE::Compound)
+                 << static_cast<uint32_t>(count);
+
+        // The order of the Bullet children changes when children are removed so the
+        // transforms are taken from there
+        for(int i = 0; i < count; ++i) {
+
+            const auto found = std::find_if(shape.ChildShapes.begin(), shape.ChildShapes.end(),
+                [&](const PhysicsShape::pointer& child) {
+                    return child->GetShape() == compound->getChildShape(i);
+                });
+
+            if(found == shape.ChildShapes.end())
+                return false;
+
+            const btTransform& transform = compound->getChildTransform(i);
+
+            receiver << Float3(transform.getOrigin()) << Float4(transform.getRotation());
+
+            if(!SerializeShape(**found, receiver))
+                return false;
+        }
+
+        return true;
+    }
+    default:
+        LOG_ERROR("PhysicalWorld: SerializeShape: unsupported shape type: " +
+                  std::to_string(bulletShape->getShapeType()));
+        return false;
+    }
+}
+
+DLLEXPORT PhysicsShape::pointer PhysicalWorld::DeserializeShape(sf::Packet& data)
+{
+    return DeserializeShapeImpl(*this, data, 0);
+}
+// ------------------------------------ //
 DLLEXPORT PhysicsBody::pointer PhysicalWorld::CreateBodyFromCollision(
     const PhysicsShape::pointer& shape, float mass,
     PhysicsPositionProvider* positionsynchronization, int physicsmaterialid /*= -1*/)
@@ -288,25 +795,91 @@ DLLEXPORT PhysicsBody::pointer PhysicalWorld::CreateBodyFromCollision(
     if(!shape)
         return nullptr;
 
-    btTransform transform;
-    transform.setIdentity();
+    // rigidbody is dynamic if and only if mass is non zero, otherwise static
+    btVector3 localInertia(0, 0, 0);
+    if(mass > 0)
+        shape->GetShape()->calculateLocalInertia(mass, localInertia);
 
-    if(positionsynchronization) {
-        const Float3* position;
-        const Float4* orientation;
-        positionsynchronization->GetPositionDataForPhysics(position, orientation);
+    PhysicalMaterial* material = nullptr;
 
-        transform.setRotation(*orientation);
-        transform.setOrigin(*position);
+    if(physicsmaterialid != -1 && PhysicsMaterials) {
+        material = PhysicsMaterials->GetMaterial(physicsmaterialid);
+
+        if(!material) {
+            LOG_ERROR(
+                "PhysicalWorld: CreateBodyFromCollision: can't find physics material id: " +
+                std::to_string(physicsmaterialid));
+            physicsmaterialid = -1;
+        }
     }
 
-    // rigidbody is dynamic if and only if mass is non zero, otherwise static
-    const bool isDynamic = mass > 0;
+    auto body = _CreateBody(
+        shape, mass, localInertia, positionsynchronization, physicsmaterialid, material);
+
+    if(!body)
+        return nullptr;
+
+    _AddBody(body);
+    return body;
+}
+
+DLLEXPORT std::vector<PhysicsBody::pointer> PhysicalWorld::CreateBodiesFromCollision(
+    const PhysicsShape::pointer& shape, float mass,
+    const std::vector<PhysicsPositionProvider*>& positionsynchronization,
+    int physicsmaterialid /*= -1*/)
+{
+    std::vector<PhysicsBody::pointer> bodies;
+
+    if(!shape)
+        return bodies;
 
+    // The inertia and the material are the same for all the bodies
     btVector3 localInertia(0, 0, 0);
-    if(isDynamic)
+    if(mass > 0)
         shape->GetShape()->calculateLocalInertia(mass, localInertia);
 
+    PhysicalMaterial* material = nullptr;
+
+    if(physicsmaterialid != -1 && PhysicsMaterials) {
+        material = PhysicsMaterials->GetMaterial(physicsmaterialid);
+
+        if(!material) {
+            LOG_ERROR(
+                "PhysicalWorld: CreateBodiesFromCollision: can't find physics material id: " +
+                std::to_string(physicsmaterialid));
+            physicsmaterialid = -1;
+        }
+    }
+
+    bodies.reserve(positionsynchronization.size());
+
+    for(auto* provider : positionsynchronization) {
+
+        auto body =
+            _CreateBody(shape, mass, localInertia, provider, physicsmaterialid, material);
+
+        if(!body)
+            return {};
+
+        bodies.push_back(std::move(body));
+    }
+
+    PhysicsBodies.reserve(PhysicsBodies.size() + bodies.size());
+
+    for(const auto& body : bodies)
+        _AddBody(body);
+
+    if(bodies.size() >= BULK_BROADPHASE_OPTIMIZE_COUNT)
+        _OptimizeBroadphase();
+
+    return bodies;
+}
+
+PhysicsBody::pointer PhysicalWorld::_CreateBody(const PhysicsShape::pointer& shape,
+    float mass, const btVector3& localinertia,
+    PhysicsPositionProvider* positionsynchronization, int physicsmaterialid,
+    PhysicalMaterial* material)
+{
     // To not have to lookup all positions all the time we use the position synchronization
     // object
     std::unique_ptr<PhysicsDataBridge> positionBridge;
@@ -315,35 +888,24 @@ DLLEXPORT PhysicsBody::pointer PhysicalWorld::CreateBodyFromCollision(
         positionBridge = std::make_unique<PhysicsDataBridge>(positionsynchronization);
 
     btRigidBody::btRigidBodyConstructionInfo info(
-        mass, positionBridge.get(), shape->GetShape(), localInertia);
+        mass, positionBridge.get(), shape->GetShape(), localinertia);
 
     auto body = PhysicsBody::MakeShared<PhysicsBody>(std::make_unique<btRigidBody>(info), mass,
         shape, std::move(positionBridge), physicsmaterialid);
 
     if(!body->GetBody()) {
-        LOG_ERROR("PhysicalWorld: CreateBodyFromCollision: failed to create bullet body");
+        LOG_ERROR("PhysicalWorld: failed to create bullet body");
         return nullptr;
     }
 
-    // Apply material
-    if(physicsmaterialid != -1 && PhysicsMaterials) {
-        auto material = PhysicsMaterials->GetMaterial(physicsmaterialid);
-
-        if(!material) {
-            LOG_ERROR(
-                "PhysicalWorld: CreateBodyFromCollision: can't find physics material id: " +
-                std::to_string(physicsmaterialid));
-            body->SetPhysicalMaterialID(-1);
-        } else {
+    if(material)
+        body->ApplyMaterial(*material);
 
-            body->ApplyMaterial(*material);
-        }
-    }
-
-    // Dirty hack to make bodies not sleep. This makes apply force work (another approach would
-    // be to wake any body that has force applied to it)
-    body->GetBody()->setActivationState(DISABLE_DEACTIVATION);
+    return body;
+}
 
+void PhysicalWorld::_AddBody(const PhysicsBody::pointer& body)
+{
     if(PhysicsUpdateInProgress) {
         // This might be okay...
         // DEBUG_BREAK;
@@ -352,8 +914,8 @@ DLLEXPORT PhysicsBody::pointer PhysicalWorld::CreateBodyFromCollision(
     DynamicsWorld->addRigidBody(body->GetBody());
 
     // Make sure it is alive as long as it is in the world
+    body->WorldIndex = static_cast<int>(PhysicsBodies.size());
     PhysicsBodies.push_back(body);
-    return body;
 }
 
 DLLEXPORT bool PhysicalWorld::ChangeBodyShape(
@@ -362,37 +924,30 @@ DLLEXPORT bool PhysicalWorld::ChangeBodyShape(
     if(!body || !shape || !body->GetBody())
         return false;
 
-    // Debug safety code
-    bool found = false;
-    for(auto iter = PhysicsBodies.begin(); iter != PhysicsBodies.end(); ++iter) {
-        if(iter->get() == body.get()) {
-
-            found = true;
-            break;
-        }
-    }
-
-    if(!found) {
+    if(!_IsBodyInWorld(body.get())) {
         LOG_ERROR("PhysicalWorld: ChangeBodyShape: passed body not part of this world");
         DEBUG_BREAK;
         return false;
     }
 
-    // This might be fine as it will be added back in
-    if(body->GetBody()->getNumConstraintRefs() > 0) {
-        // "undestroyed constraints on entity";
-    }
-
     if(PhysicsUpdateInProgress) {
         // This might be okay...
         // DEBUG_BREAK;
     }
 
-    DynamicsWorld->removeRigidBody(body->GetBody());
-
     body->ApplyShapeChange(shape);
 
-    DynamicsWorld->addRigidBody(body->GetBody());
+    // The body doesn't need to be removed from the world. The collision algorithms cached for
+    // its pairs were made for the old shape so those are cleared and the bounding box is
+    // updated in the broadphase
+    btRigidBody* bulletBody = body->GetBody();
+
+    if(bulletBody->getBroadphaseHandle()) {
+        OverlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(
+            bulletBody->getBroadphaseHandle(), Dispatcher.get());
+    }
+
+    DynamicsWorld->updateSingleAabb(bulletBody);
 
     return true;
 }
@@ -405,28 +960,448 @@ DLLEXPORT bool PhysicalWorld::DestroyBody(PhysicsBody* body)
         return false;
     }
 
-    // Remove from alive bodies. This also checks that the body is in this world
-    for(auto iter = PhysicsBodies.begin(); iter != PhysicsBodies.end(); ++iter) {
+    return _RemoveBody(body);
+}
+
+DLLEXPORT int PhysicalWorld::DestroyBodies(const std::vector<PhysicsBody*>& bodies)
+{
+    if(PhysicsUpdateInProgress) {
+        DEBUG_BREAK;
+        LOG_FATAL("PhysicalWorld: DestroyBodies: called while physics update is in progress");
+        return 0;
+    }
 
-        if(iter->get() == body) {
+    int destroyed = 0;
 
-            if(body->GetBody()->getNumConstraintRefs() > 0) {
+    for(auto* body : bodies) {
+        if(_RemoveBody(body))
+            ++destroyed;
+    }
 
-                LOG_ERROR("PhysicalWorld: DestroyBody: body has undestroyed constraints, "
-                          "can't safely destroy");
-                return false;
-            }
+    if(static_cast<size_t>(destroyed) >= BULK_BROADPHASE_OPTIMIZE_COUNT)
+        _OptimizeBroadphase();
 
-            DynamicsWorld->removeRigidBody(body->GetBody());
+    return destroyed;
+}
+
+bool PhysicalWorld::_RemoveBody(PhysicsBody* body)
+{
+    // This also checks that the body is in this world
+    if(!_IsBodyInWorld(body)) {
+        LOG_ERROR("PhysicalWorld: DestroyBody: called with body that wasn't in this world");
+        return false;
+    }
+
+    if(body->GetBody()->getNumConstraintRefs() > 0) {
+
+        LOG_ERROR("PhysicalWorld: DestroyBody: body has undestroyed constraints, "
+                  "can't safely destroy");
+        return false;
+    }
+
+    DynamicsWorld->removeRigidBody(body->GetBody());
+
+    body->DetachResources();
+
+    // Remove from alive bodies by moving the last body to this slot
+    const auto index = body->WorldIndex;
+    body->WorldIndex = -1;
+
+    if(static_cast<size_t>(index) + 1 != PhysicsBodies.size()) {
 
-            body->DetachResources();
-            PhysicsBodies.erase(iter);
-            return true;
+        PhysicsBodies[index] = std::move(PhysicsBodies.back());
+        PhysicsBodies[index]->WorldIndex = index;
+    }
+
+    PhysicsBodies.pop_back();
+    return true;
+}
+
+// ------------------------------------ //
+DLLEXPORT void PhysicalWorld::CaptureSnapshot(PhysicsSnapshot& snapshot, int ticknumber) const
+{
+    snapshot.Reset(ticknumber, StepTimeAccess::Get(*DynamicsWorld));
+
+    for(const auto& body : PhysicsBodies)
+        snapshot.Add(*body);
+}
+
+DLLEXPORT bool PhysicalWorld::ResimulateBodies(const std::vector<PhysicsBody*>& bodies,
+    const PhysicsSnapshot& from, int steps, float secondsperstep,
+    const std::function<void(int)>& afterstep /*= nullptr*/, int maxsubsteps /*= 4*/)
+{
+    if(PhysicsUpdateInProgress) {
+        LOG_ERROR(
+            "PhysicalWorld: ResimulateBodies: called while physics update is in progress");
+        return false;
+    }
+
+    ResimulatedFlags.assign(PhysicsBodies.size(), false);
+
+    for(auto* body : bodies) {
+        if(!_IsBodyInWorld(body)) {
+            LOG_ERROR("PhysicalWorld: ResimulateBodies: passed body not part of this world");
+            continue;
         }
+
+        ResimulatedFlags[body->WorldIndex] = true;
+    }
+
+    // Freeze everything else. Sleeping bodies aren't integrated and collisions between two
+    // sleeping bodies aren't processed so only the resimulated bodies cost anything
+    ResimulationFrozenBodies.clear();
+
+    for(const auto& body : PhysicsBodies) {
+
+        if(ResimulatedFlags[body->WorldIndex] || body->GetMass() <= 0)
+            continue;
+
+        ResimulationFrozenBodies.emplace_back();
+        ResimulationFrozenBodies.back().first = body.get();
+        body->GetState(ResimulationFrozenBodies.back().second);
+
+        if(body->GetBody()->isActive())
+            body->GetBody()->forceActivationState(ISLAND_SLEEPING);
+    }
+
+    for(size_t i = 0; i < PhysicsBodies.size(); ++i) {
+        if(ResimulatedFlags[i])
+            PhysicsBodies[i]->GetBody()->activate(true);
+    }
+
+    Resimulating = true;
+
+    // Start from the leftover time of the snapshot so that each step is split into the same
+    // substeps as originally
+    btScalar& stepTime = StepTimeAccess::Get(*DynamicsWorld);
+    const btScalar currentStepTime = stepTime;
+    stepTime = from.GetLeftoverStepTime();
+
+    for(int i = 0; i < steps; ++i) {
+
+        PhysicsUpdateInProgress = true;
+
+        DynamicsWorld->stepSimulation(secondsperstep, maxsubsteps, PHYSICS_FIXED_STEP);
+
+        PhysicsUpdateInProgress = false;
+
+        if(afterstep)
+            afterstep(i);
+    }
+
+    stepTime = currentStepTime;
+    Resimulating = false;
+
+    // Undo anything that happened to the frozen bodies //
+    for(const auto& [body, state] : ResimulationFrozenBodies) {
+
+        if(body->GetBody()->isActive() || state.ActivationState != ISLAND_SLEEPING)
+            body->ApplyState(state);
     }
 
-    LOG_ERROR("PhysicalWorld: DestroyBody: called with body that wasn't in this world");
-    return false;
+    ResimulationFrozenBodies.clear();
+    return true;
+}
+
+void PhysicalWorld::_OptimizeBroadphase()
+{
+    // Bodies are inserted to and removed from the tree one by one which can leave it badly
+    // balanced after big changes
+    static_cast<btDbvtBroadphase*>(OverlappingPairCache.get())->optimize();
+}
+// ------------------------------------ //
+DLLEXPORT int PhysicalWorld::RunQuery(const PhysicsQuery& query, PhysicsQueryHit* hits) const
+{
+    if(PhysicsUpdateInProgress) {
+        LOG_ERROR("PhysicalWorld: RunQuery: called while physics update is in progress");
+        return 0;
+    }
+
+    if(query.GetMaxHits() < 1)
+        return 0;
+
+    switch(query.Type) {
+    case PHYSICS_QUERY_TYPE::RayClosest:
+    case PHYSICS_QUERY_TYPE::RayAll: return _RunCastQuery(query, nullptr, hits);
+    case PHYSICS_QUERY_TYPE::SphereSweep: {
+        btSphereShape sphere(query.Extents.X);
+        return _RunCastQuery(query, &sphere, hits);
+    }
+    case PHYSICS_QUERY_TYPE::BoxSweep: {
+        btBoxShape box(query.Extents);
+        return _RunCastQuery(query, &box, hits);
+    }
+    case PHYSICS_QUERY_TYPE::AABBOverlap: return _RunOverlapQuery(query, nullptr, hits);
+    case PHYSICS_QUERY_TYPE::SphereOverlap: {
+        btSphereShape sphere(query.Extents.X);
+        return _RunOverlapQuery(query, &sphere, hits);
+    }
+    case PHYSICS_QUERY_TYPE::BoxOverlap: {
+        btBoxShape box(query.Extents);
+        return _RunOverlapQuery(query, &box, hits);
+    }
+    }
+
+    LOG_ERROR("PhysicalWorld: RunQuery: unknown query type");
+    return 0;
+}
+
+DLLEXPORT void PhysicalWorld::RunQueries(PhysicsQueryBatch& batch) const
+{
+    const auto count = batch.Queries.size();
+
+    // Each query gets space for its maximum number of hits so the queries can be ran in any
+    // order without sharing anything //
+    batch.HitOffsets.resize(count);
+    batch.HitCounts.assign(count, 0);
+
+    size_t totalHits = 0;
+
+    for(size_t i = 0; i < count; ++i) {
+
+        batch.HitOffsets[i] = totalHits;
+        totalHits += std::max(batch.Queries[i].GetMaxHits(), 0);
+    }
+
+    batch.Hits.resize(totalHits);
+
+    if(PhysicsUpdateInProgress) {
+        LOG_ERROR("PhysicalWorld: RunQueries: called while physics update is in progress");
+        return;
+    }
+
+    QueryBatchBody body(*this, batch.Queries, batch.HitOffsets, batch.HitCounts, batch.Hits);
+
+    // Small parts would spend more time waking up the workers than running queries
+    constexpr int QUERIES_PER_PART = 16;
+
+    PhysicsTaskScheduler::RunParallelFor(0, static_cast<int>(count), QUERIES_PER_PART, body,
+        PhysicsTaskScheduler::GetDefaultThreadCount());
+}
+// ------------------------------------ //
+DLLEXPORT PhysicsQueryHit PhysicalWorld::CastRay(const Float3& from, const Float3& to,
+    const PhysicsQueryFilter& filter /*= {}*/) const
+{
+    PhysicsQueryHit hit;
+    RunQuery(PhysicsQuery::Ray(from, to, filter), &hit);
+    return hit;
+}
+
+DLLEXPORT std::vector<PhysicsQueryHit> PhysicalWorld::CastRayAll(const Float3& from,
+    const Float3& to, const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/) const
+{
+    return _RunQueryToVector(PhysicsQuery::RayAll(from, to, filter, maxhits));
+}
+
+DLLEXPORT PhysicsQueryHit PhysicalWorld::SweepSphere(const Float3& from, const Float3& to,
+    float radius, const PhysicsQueryFilter& filter /*= {}*/) const
+{
+    PhysicsQueryHit hit;
+    RunQuery(PhysicsQuery::SphereSweep(from, to, radius, filter), &hit);
+    return hit;
+}
+
+DLLEXPORT PhysicsQueryHit PhysicalWorld::SweepBox(const Float3& from, const Float3& to,
+    const Float3& halfextents, const Float4& orientation,
+    const PhysicsQueryFilter& filter /*= {}*/) const
+{
+    PhysicsQueryHit hit;
+    RunQuery(PhysicsQuery::BoxSweep(from, to, halfextents, orientation, filter), &hit);
+    return hit;
+}
+
+DLLEXPORT std::vector<PhysicsQueryHit> PhysicalWorld::OverlapAABB(const Float3& min,
+    const Float3& max, const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/) const
+{
+    return _RunQueryToVector(PhysicsQuery::AABBOverlap(min, max, filter, maxhits));
+}
+
+DLLEXPORT std::vector<PhysicsQueryHit> PhysicalWorld::OverlapSphere(const Float3& center,
+    float radius, const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/) const
+{
+    return _RunQueryToVector(PhysicsQuery::SphereOverlap(center, radius, filter, maxhits));
+}
+
+DLLEXPORT std::vector<PhysicsQueryHit> PhysicalWorld::OverlapBox(const Float3& center,
+    const Float3& halfextents, const Float4& orientation,
+    const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/) const
+{
+    return _RunQueryToVector(
+        PhysicsQuery::BoxOverlap(center, halfextents, orientation, filter, maxhits));
+}
+
+std::vector<PhysicsQueryHit> PhysicalWorld::_RunQueryToVector(const PhysicsQuery& query) const
+{
+    std::vector<PhysicsQueryHit> hits(std::max(query.GetMaxHits(), 0));
+    hits.resize(RunQuery(query, hits.data()));
+    return hits;
+}
+// ------------------------------------ //
+// The queries walk the broadphase trees directly instead of using btCollisionWorld::rayTest
+// as that shares a traversal stack in the broadphase and so can't run on multiple threads
+int PhysicalWorld::_RunCastQuery(
+    const PhysicsQuery& query, const btConvexShape* castshape, PhysicsQueryHit* hits) const
+{
+    const btVector3 from = query.From;
+    const btVector3 to = query.To;
+
+    btVector3 direction = to - from;
+
+    if(direction.fuzzyZero())
+        return 0;
+
+    // Same setup as btCollisionWorld::rayTest does for the broadphase //
+    const btScalar length = direction.length();
+    direction /= length;
+
+    btVector3 directionInverse;
+    unsigned int signs[3];
+
+    for(int i = 0; i < 3; ++i) {
+        directionInverse[i] = direction[i] == 0 ? BT_LARGE_FLOAT : 1 / direction[i];
+        signs[i] = directionInverse[i] < 0;
+    }
+
+    const btQuaternion rotation = query.Orientation;
+    const btTransform fromTransform(rotation, from);
+    const btTransform toTransform(rotation, to);
+
+    // The tree nodes are grown by the size of the swept shape
+    btVector3 shapeMin(0, 0, 0);
+    btVector3 shapeMax(0, 0, 0);
+
+    if(castshape)
+        castshape->getAabb(btTransform(rotation), shapeMin, shapeMax);
+
+    QueryHitCollector collector(query, hits);
+    QueryRayCallback rayCallback(collector);
+    QuerySweepCallback sweepCallback(collector);
+
+    const btScalar allowedPenetration =
+        DynamicsWorld->getDispatchInfo().m_allowedCcdPenetration;
+
+    auto leafCallback = MakeLeafCallback([&](btCollisionObject* object) {
+        const auto body = static_cast<PhysicsBody*>(object->getUserPointer());
+
+        if(!body || !query.Filter.Accepts(*body))
+            return;
+
+        if(castshape) {
+            btCollisionWorld::objectQuerySingle(castshape, fromTransform, toTransform, object,
+                object->getCollisionShape(), object->getWorldTransform(), sweepCallback,
+                allowedPenetration);
+        } else {
+            btCollisionWorld::rayTestSingle(fromTransform, toTransform, object,
+                object->getCollisionShape(), object->getWorldTransform(), rayCallback);
+        }
+    });
+
+    const auto broadphase = static_cast<btDbvtBroadphase*>(OverlappingPairCache.get());
+
+    btAlignedObjectArray<const btDbvtNode*> stack;
+
+    // The dynamic and the static tree //
+    for(btDbvt& tree : broadphase->m_sets) {
+
+        if(!tree.m_root)
+            continue;
+
+        tree.rayTestInternal(tree.m_root, from, to, directionInverse, signs, length, shapeMin,
+            shapeMax, stack, leafCallback);
+    }
+
+    return collector.Finish();
+}
+
+int PhysicalWorld::_RunOverlapQuery(
+    const PhysicsQuery& query, const btConvexShape* shape, PhysicsQueryHit* hits) const
+{
+    const btTransform transform(query.Orientation, query.From);
+
+    btVector3 min = query.From;
+    btVector3 max = query.To;
+
+    if(shape)
+        shape->getAabb(transform, min, max);
+
+    const int maxHits = query.GetMaxHits();
+    int count = 0;
+
+    auto leafCallback = MakeLeafCallback([&](btCollisionObject* object) {
+        if(count >= maxHits)
+            return;
+
+        const auto body = static_cast<PhysicsBody*>(object->getUserPointer());
+
+        if(!body || !query.Filter.Accepts(*body))
+            return;
+
+        if(shape && !_ShapesOverlap(*shape, transform, *object->getCollisionShape(),
+                        object->getWorldTransform()))
+            return;
+
+        PhysicsQueryHit& hit = hits[count++];
+        hit = PhysicsQueryHit();
+        hit.Body = body;
+        hit.Entity = body->GetOwningEntity();
+        hit.Point = object->getWorldTransform().getOrigin();
+        hit.Fraction = 0;
+    });
+
+    const auto broadphase = static_cast<btDbvtBroadphase*>(OverlappingPairCache.get());
+    const auto volume = btDbvtVolume::FromMM(min, max);
+
+    for(btDbvt& tree : broadphase->m_sets) {
+
+        if(tree.m_root)
+            tree.collideTV(tree.m_root, volume, leafCallback);
+    }
+
+    return count;
+}
+
+bool PhysicalWorld::_ShapesOverlap(const btConvexShape& shape, const btTransform& transform,
+    const btCollisionShape& bodyshape, const btTransform& bodytransform)
+{
+    if(bodyshape.isCompound()) {
+
+        const auto& compound = static_cast<const btCompoundShape&>(bodyshape);
+
+        for(int i = 0; i < compound.getNumChildShapes(); ++i) {
+
+            if(_ShapesOverlap(shape, transform, *compound.getChildShape(i),
+                   bodytransform * compound.getChildTransform(i)))
+                return true;
+        }
+
+        return false;
+    }
+
+    // Concave shapes are only tested with their bounding boxes //
+    if(!bodyshape.isConvex()) {
+
+        btVector3 min, max, bodyMin, bodyMax;
+        shape.getAabb(transform, min, max);
+        bodyshape.getAabb(bodytransform, bodyMin, bodyMax);
+
+        return TestAabbAgainstAabb2(min, max, bodyMin, bodyMax);
+    }
+
+    btVoronoiSimplexSolver simplexSolver;
+    btGjkEpaPenetrationDepthSolver penetrationSolver;
+
+    btGjkPairDetector detector(&shape, static_cast<const btConvexShape*>(&bodyshape),
+        &simplexSolver, &penetrationSolver);
+
+    btGjkPairDetector::ClosestPointInput input;
+    input.m_transformA = transform;
+    input.m_transformB = bodytransform;
+
+    // The distance is negative when the shapes penetrate //
+    btPointCollector result;
+    detector.getClosestPoints(input, result, nullptr);
+
+    return result.m_hasResult && result.m_distance <= 0;
 }
 
 // ------------------------------------ //
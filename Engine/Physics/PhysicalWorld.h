@@ -6,9 +6,12 @@
 #include "Common/ThreadSafe.h"
 #include "Common/Types.h"
 #include "PhysicsBody.h"
+#include "PhysicsQuery.h"
 #include "PhysicsShape.h"
 
+#include <array>
 #include <functional>
+#include <map>
 
 // Bullet forward declarations
 class btCollisionShape;
@@ -16,12 +19,20 @@ class btRigidBody;
 class btDefaultCollisionConfiguration;
 class btCollisionDispatcher;
 class btBroadphaseInterface;
-class btSequentialImpulseConstraintSolver;
+class btConstraintSolver;
 class btDiscreteDynamicsWorld;
 class btDynamicsWorld;
 class btPersistentManifold;
 class btManifoldPoint;
 class btCollisionObject;
+class btConvexShape;
+class btTransform;
+
+class asIScriptFunction;
+
+namespace sf {
+class Packet;
+}
 
 #ifdef BT_USE_DOUBLE_PRECISION
 using btScalar = double;
@@ -33,10 +44,17 @@ using btScalar = float;
 namespace Leviathan {
 
 class LeviathanPhysicsOverlapFilter;
+class NonOwningScriptCallback;
+class PhysicalMaterial;
+class PhysicsSnapshot;
 struct PhysMaterialDataPair;
 
 constexpr auto PHYSICS_BASE_GRAVITY = -9.81f;
 
+//! Length of one simulation substep in seconds. SimulateWorld runs as many of these as fit in
+//! the passed time and the time left over is added to the next call
+constexpr float PHYSICS_FIXED_STEP = 1.f / 60.f;
+
 // //! \brief Base class for custom joint types defined for use by this class
 // //! \note If these should be able to be accessed from elsewhere, move this to a new file
 // class BaseCustomJoint {
@@ -55,10 +73,18 @@ class PhysicalWorld {
     // friend int SingleBodyUpdate(
     //     const NewtonWorld* const newtonWorld, const void* islandHandle, int bodyCount);
 public:
-    DLLEXPORT PhysicalWorld(GameWorld* owner, PhysicsMaterialManager* physicscallbacks);
+    //! \param multithreaded If true the collision detection and the solver are ran on the
+    //! ThreadingManager worker threads. Requires LEVIATHAN_USING_BULLET_MULTITHREADING,
+    //! without it this is ignored
+    //! \note Multithreaded worlds must be created on the main thread
+    DLLEXPORT PhysicalWorld(GameWorld* owner, PhysicsMaterialManager* physicscallbacks,
+        bool multithreaded = false);
     DLLEXPORT ~PhysicalWorld();
 
     //! \brief Advances the simulation the specified amount of time
+    //!
+    //! Material contact callbacks are called after the simulation is done, so they can
+    //! modify and destroy bodies
     DLLEXPORT void SimulateWorld(float secondspassed, int maxsubsteps = 4);
 
     // ------------------------------------ //
@@ -73,6 +99,30 @@ public:
     DLLEXPORT PhysicsShape::pointer CreateBox(
         float xdimension, float ydimension, float zdimension);
 
+    //! \brief Returns a sphere shape that is shared by everyone asking for the same radius
+    //!
+    //! Use these when spawning many bodies of the same shape instead of creating a shape for
+    //! each of them. Shared shapes must not be modified
+    DLLEXPORT PhysicsShape::pointer GetSharedSphere(float radius);
+
+    //! \copydoc GetSharedSphere
+    DLLEXPORT PhysicsShape::pointer GetSharedBox(
+        float xdimension, float ydimension, float zdimension);
+
+    //! \brief Forgets the shared shapes that no body or other object is using
+    DLLEXPORT void ReleaseUnusedSharedShapes();
+
+    //! \brief Writes shape so that it can be recreated with DeserializeShape
+    //!
+    //! The children of compound shapes are written as part of the compound shape
+    //! \returns False if the shape or one of its children isn't a type created by this class,
+    //! receiver then has only part of the shape
+    DLLEXPORT bool SerializeShape(const PhysicsShape& shape, sf::Packet& receiver) const;
+
+    //! \brief Creates a new shape from data written by SerializeShape
+    //! \returns Null if the data is invalid
+    DLLEXPORT PhysicsShape::pointer DeserializeShape(sf::Packet& data);
+
 
     // ------------------------------------ //
     // Physics constraint creation
@@ -87,9 +137,22 @@ public:
         float mass, PhysicsPositionProvider* positionsynchronization,
         int physicsmaterialid = -1);
 
+    //! \brief Creates a body for each of positionsynchronization with the same shape, mass
+    //! and material
+    //!
+    //! This is faster than calling CreateBodyFromCollision in a loop as the shared data is
+    //! calculated once and the broadphase is optimized once after adding all the bodies
+    //! \param positionsynchronization The position providers of the bodies, may contain
+    //! nulls
+    //! \returns The created bodies in the same order, or an empty vector on failure
+    DLLEXPORT std::vector<PhysicsBody::pointer> CreateBodiesFromCollision(
+        const PhysicsShape::pointer& shape, float mass,
+        const std::vector<PhysicsPositionProvider*>& positionsynchronization,
+        int physicsmaterialid = -1);
+
     //! \brief Applies a changed shape to a body
-    //! \todo Find out if it is required to remove and add the body back to the world (and if
-    //! that can be done in a physics callback)
+    //!
+    //! The body stays in the world, only its cached collision data is updated
     DLLEXPORT bool ChangeBodyShape(
         const PhysicsBody::pointer& body, const PhysicsShape::pointer& shape);
 
@@ -98,15 +161,113 @@ public:
     //! May not be called while a physics update is in progress
     DLLEXPORT bool DestroyBody(PhysicsBody* body);
 
+    //! \brief Destroys many bodies at once
+    //!
+    //! Bodies that can't be destroyed are skipped with an error like in DestroyBody
+    //! \returns The number of destroyed bodies
+    DLLEXPORT int DestroyBodies(const std::vector<PhysicsBody*>& bodies);
+
+    //! \returns The number of bodies in this world
+    DLLEXPORT inline size_t GetBodyCount() const
+    {
+        return PhysicsBodies.size();
+    }
+
+
+    // ------------------------------------ //
+    // Rewinding for client side prediction
+
+    //! \brief Stores the current state of all bodies in snapshot
+    DLLEXPORT void CaptureSnapshot(PhysicsSnapshot& snapshot, int ticknumber) const;
+
+    //! \brief Simulates only some bodies for a number of steps
+    //!
+    //! Used to resimulate bodies after they have been put back to an earlier state with
+    //! PhysicsSnapshot::RestoreBody. The other bodies are kept asleep so they don't move and
+    //! aren't simulated, but the resimulated bodies still collide with them. Other bodies that
+    //! got woken up by the resimulated bodies are put back to their states afterwards.
+    //! Material contact callbacks aren't called while resimulating as they were already
+    //! called for these steps.
+    //!
+    //! Each step is simulated like SimulateWorld(secondsperstep, maxsubsteps) starting from
+    //! the leftover time stored in from, so the same substeps are taken as when from was
+    //! captured. The leftover time of the world is not changed.
+    //! \param from The snapshot the bodies were restored from
+    //! \param afterstep If set called after each step with the index of the step
+    //! \returns False if called while the world is being simulated
+    DLLEXPORT bool ResimulateBodies(const std::vector<PhysicsBody*>& bodies,
+        const PhysicsSnapshot& from, int steps, float secondsperstep,
+        const std::function<void(int)>& afterstep = nullptr, int maxsubsteps = 4);
+
+    // ------------------------------------ //
+    // Scene queries
+    // These don't modify the world and see bodies where the last simulation step left them.
+    // They may not be called while the world is being simulated
+
+    //! \brief Runs a single query on the calling thread
+    //! \param hits Receives the hits, needs space for query.GetMaxHits() hits
+    //! \returns The number of hits
+    DLLEXPORT int RunQuery(const PhysicsQuery& query, PhysicsQueryHit* hits) const;
+
+    //! \brief Runs all queries in batch on the worker threads and this thread
+    //!
+    //! Each query writes only its own results, so the results are the same as when running
+    //! the queries one by one with RunQuery
+    DLLEXPORT void RunQueries(PhysicsQueryBatch& batch) const;
+
+    //! \returns The first body between from and to
+    DLLEXPORT PhysicsQueryHit CastRay(
+        const Float3& from, const Float3& to, const PhysicsQueryFilter& filter = {}) const;
+
+    //! \returns The bodies between from and to, sorted by distance from from
+    DLLEXPORT std::vector<PhysicsQueryHit> CastRayAll(const Float3& from, const Float3& to,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32) const;
+
+    //! \returns The first body a sphere moved from from to to hits
+    DLLEXPORT PhysicsQueryHit SweepSphere(const Float3& from, const Float3& to, float radius,
+        const PhysicsQueryFilter& filter = {}) const;
+
+    //! \returns The first body a box moved from from to to hits
+    DLLEXPORT PhysicsQueryHit SweepBox(const Float3& from, const Float3& to,
+        const Float3& halfextents, const Float4& orientation,
+        const PhysicsQueryFilter& filter = {}) const;
+
+    //! \returns The bodies whose bounding boxes overlap the box from min to max
+    DLLEXPORT std::vector<PhysicsQueryHit> OverlapAABB(const Float3& min, const Float3& max,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32) const;
+
+    //! \returns The bodies touching a sphere
+    DLLEXPORT std::vector<PhysicsQueryHit> OverlapSphere(const Float3& center, float radius,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32) const;
+
+    //! \returns The bodies touching a box
+    DLLEXPORT std::vector<PhysicsQueryHit> OverlapBox(const Float3& center,
+        const Float3& halfextents, const Float4& orientation,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32) const;
 
     //! \brief Finds the information for contact between objects with two materials
     const PhysMaterialDataPair* GetMaterialPair(int id1, int id2) const;
 
+    //! \brief Sets a script function to be called when bodies with two materials touch
+    //!
+    //! This is called with the same rules as PhysMaterialDataPair::ContactCallback but the
+    //! materials don't need to be paired
+    //! \param callback The function to call or null to remove. This takes the reference
+    //! \returns False if either material doesn't exist
+    DLLEXPORT bool SetScriptContactCallback(
+        int material1, int material2, asIScriptFunction* callback);
+
     DLLEXPORT inline GameWorld* GetGameWorld()
     {
         return OwningWorld;
     }
 
+    //! \returns True if this uses the multithreaded Bullet world
+    DLLEXPORT inline bool IsMultithreaded() const
+    {
+        return Multithreaded;
+    }
+
     //
     // Script wrappers
     //
@@ -130,15 +291,104 @@ public:
         return obj.get();
     }
 
+    inline PhysicsShape* GetSharedSphereWrapper(float radius)
+    {
+        auto obj = GetSharedSphere(radius);
+
+        if(obj)
+            obj->AddRef();
+
+        return obj.get();
+    }
+
+    inline PhysicsShape* GetSharedBoxWrapper(
+        float xdimension, float ydimension, float zdimension)
+    {
+        auto obj = GetSharedBox(xdimension, ydimension, zdimension);
+
+        if(obj)
+            obj->AddRef();
+
+        return obj.get();
+    }
+
+    REFERENCE_HANDLE_UNCOUNTED_TYPE(PhysicalWorld);
+
 protected:
+    //! \brief A contact waiting for its callbacks to be called
+    struct PendingContact {
+
+        PhysicsBody::pointer Body1;
+        PhysicsBody::pointer Body2;
+
+        //! The PhysicsMaterialContactCallback of the material pair
+        void (*Callback)(PhysicalWorld& world, PhysicsBody&, PhysicsBody&);
+
+        //! Index in the material pair table, used to find the script callback
+        int PairIndex;
+    };
+
+    //! \brief A script contact callback and the materials it is for
+    struct ScriptContactCallback {
+
+        int Material1;
+        int Material2;
+        std::unique_ptr<NonOwningScriptCallback> Callback;
+    };
+
     static void OnPhysicsSubStep(btDynamicsWorld* world, btScalar timeStep);
 
-    //! \brief Calls appropriate material callbacks. This is called once per contact manifold
-    //! that has penetrating points
+    //! \brief Queues the material callbacks to be called. This is called once per contact
+    //! manifold that has penetrating points
     void OnManifoldWithContact(btPersistentManifold* contactManifold,
         const btManifoldPoint& contactPoint, const btCollisionObject* objA,
         const btCollisionObject* objB);
 
+    //! \brief Runs a ray or sweep query, castshape is null for rays
+    int _RunCastQuery(const PhysicsQuery& query, const btConvexShape* castshape,
+        PhysicsQueryHit* hits) const;
+
+    //! \brief Runs an overlap query, shape is null for AABB overlaps
+    int _RunOverlapQuery(
+        const PhysicsQuery& query, const btConvexShape* shape, PhysicsQueryHit* hits) const;
+
+    //! \returns True if shape placed at transform touches bodyshape
+    static bool _ShapesOverlap(const btConvexShape& shape, const btTransform& transform,
+        const btCollisionShape& bodyshape, const btTransform& bodytransform);
+
+    //! \returns The hits of query
+    std::vector<PhysicsQueryHit> _RunQueryToVector(const PhysicsQuery& query) const;
+
+    //! \brief Creates a body without adding it to the world
+    //! \param material The material to apply or null
+    PhysicsBody::pointer _CreateBody(const PhysicsShape::pointer& shape, float mass,
+        const btVector3& localinertia, PhysicsPositionProvider* positionsynchronization,
+        int physicsmaterialid, PhysicalMaterial* material);
+
+    //! \brief Adds a body to the simulation and PhysicsBodies
+    void _AddBody(const PhysicsBody::pointer& body);
+
+    //! \brief Removes a body from the simulation and PhysicsBodies
+    //! \returns False if body isn't in this world or can't be removed
+    bool _RemoveBody(PhysicsBody* body);
+
+    //! \returns True if body is in PhysicsBodies
+    inline bool _IsBodyInWorld(const PhysicsBody* body) const
+    {
+        return body && body->WorldIndex >= 0 &&
+               static_cast<size_t>(body->WorldIndex) < PhysicsBodies.size() &&
+               PhysicsBodies[body->WorldIndex].get() == body;
+    }
+
+    //! \brief Rebuilds the broadphase tree after many bodies have been added or removed
+    void _OptimizeBroadphase();
+
+    //! \brief Calls the callbacks of the contacts found in the last simulation
+    void _DispatchContacts();
+
+    //! \brief Places the script callbacks at the current pair indexes
+    void _UpdateScriptCallbackTable();
+
 protected:
     //! Total amount of seconds required to be simulated
     float PassedTimeTotal = 0;
@@ -149,6 +399,8 @@ protected:
     //! This is a small sanity check for preventing destroying physics bodies during a tick
     bool PhysicsUpdateInProgress = false;
 
+    bool Multithreaded = false;
+
     // Bullet resources
     std::unique_ptr<btDefaultCollisionConfiguration> CollisionConfiguration;
 
@@ -156,15 +408,51 @@ protected:
 
     std::unique_ptr<btBroadphaseInterface> OverlappingPairCache;
 
-    std::unique_ptr<btSequentialImpulseConstraintSolver> Solver;
+    //! A btConstraintSolverPoolMt when multithreaded
+    std::unique_ptr<btConstraintSolver> Solver;
 
     std::unique_ptr<btDiscreteDynamicsWorld> DynamicsWorld;
 
     std::unique_ptr<LeviathanPhysicsOverlapFilter> OverlapFilter;
 
-    //! We need to keep the physic bodies alive (guaranteed) until they are destroyed
+    //! We need to keep the physic bodies alive (guaranteed) until they are destroyed.
+    //! PhysicsBody::WorldIndex is the index of a body here, removing swaps the last body
+    //! into the removed slot
     std::vector<PhysicsBody::pointer> PhysicsBodies;
 
+    //! Shapes returned by GetSharedSphere and GetSharedBox
+    std::map<float, PhysicsShape::pointer> SharedSpheres;
+    std::map<std::array<float, 3>, PhysicsShape::pointer> SharedBoxes;
+
+    //! Contacts found during the current simulation. Swapped with DispatchedContacts for
+    //! calling the callbacks so that both keep their memory
+    std::vector<PendingContact> PendingContacts;
+    std::vector<PendingContact> DispatchedContacts;
+
+    std::vector<ScriptContactCallback> ScriptContactCallbacks;
+
+    //! ScriptContactCallbacks by material pair index
+    std::vector<NonOwningScriptCallback*> ScriptCallbacksByPair;
+
+    //! The pair table version ScriptCallbacksByPair was made for
+    int ScriptCallbacksVersion = -1;
+
+    //! Script callbacks removed while contacts are dispatched, destroyed after dispatching
+    std::vector<std::unique_ptr<NonOwningScriptCallback>> RemovedScriptCallbacks;
+
+    //! True while _DispatchContacts is calling the callbacks
+    bool DispatchingContacts = false;
+
+    //! True while ResimulateBodies is running, contacts aren't queued then
+    bool Resimulating = false;
+
+    //! Bodies not being resimulated and their states before resimulating. Kept to reuse the
+    //! memory
+    std::vector<std::pair<PhysicsBody*, PhysicsBodyState>> ResimulationFrozenBodies;
+
+    //! Flags for the resimulated bodies by their index in PhysicsBodies
+    std::vector<bool> ResimulatedFlags;
+
     // //! Used for resimulation
     // //! \todo Potentially allow this to be a vector
     // NewtonBody* ResimulatedBody = nullptr;
@@ -59,6 +59,7 @@ DLLEXPORT void PhysicsBody::ApplyShapeChange(const PhysicsShape::pointer& shape)
         Shape->GetShape()->calculateLocalInertia(Mass, localInertia);
 
     Body->setMassProps(Mass, localInertia);
+    Body->activate();
 
     // TODO: is Body->updateInertiaTensor() needed here? or is the removing and adding this
     // back to the world good enough?
@@ -87,6 +88,7 @@ DLLEXPORT bool PhysicsBody::SetPosition(const Float3& pos, const Float4& orienta
     transform.setOrigin(pos);
 
     Body->setCenterOfMassTransform(transform);
+    Body->activate();
     return true;
 }
 
@@ -119,6 +121,7 @@ DLLEXPORT bool PhysicsBody::SetOnlyOrientation(const Float4& orientation)
     pos.setRotation(orientation);
 
     Body->setCenterOfMassTransform(pos);
+    Body->activate();
     return true;
 }
 // ------------------------------------ //
@@ -139,7 +142,7 @@ DLLEXPORT void PhysicsBody::GiveImpulse(const Float3& deltaspeed, const Float3&
     }
 
     Body->applyImpulse(deltaspeed, point);
-    // Maybe this needs to call activate() for the force to move it?
+    Body->activate();
 }
 
 DLLEXPORT void PhysicsBody::SetVelocity(const Float3& velocities)
@@ -159,6 +162,7 @@ DLLEXPORT void PhysicsBody::SetVelocity(const Float3& velocities)
     }
 
     Body->setLinearVelocity(velocities);
+    Body->activate();
 }
 
 DLLEXPORT void PhysicsBody::ClearVelocity()
@@ -206,6 +210,7 @@ DLLEXPORT void PhysicsBody::SetAngularVelocity(const Float3& velocities)
     }
 
     Body->setAngularVelocity(velocities);
+    Body->activate();
 }
 // ------------------------------------ //
 DLLEXPORT Float3 PhysicsBody::GetTorque() const
@@ -234,6 +239,96 @@ DLLEXPORT void PhysicsBody::ApplyTorque(const Float3& torque)
     }
 
     Body->applyTorque(torque);
+    Body->activate();
+}
+// ------------------------------------ //
+DLLEXPORT void PhysicsBody::WakeUp()
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    Body->activate();
+}
+
+DLLEXPORT bool PhysicsBody::IsSleeping() const
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    return !Body->isActive();
+}
+
+DLLEXPORT void PhysicsBody::SetAllowSleeping(bool allow)
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    Body->forceActivationState(allow ? ACTIVE_TAG : DISABLE_DEACTIVATION);
+    Body->activate();
+}
+// ------------------------------------ //
+DLLEXPORT void PhysicsBody::GetState(PhysicsBodyState& state) const
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    const btTransform& transform = Body->getCenterOfMassTransform();
+
+    state.Position = transform.getOrigin();
+    state.Orientation = transform.getRotation();
+    state.LinearVelocity = Body->getLinearVelocity();
+    state.AngularVelocity = Body->getAngularVelocity();
+    state.DeactivationTime = Body->getDeactivationTime();
+    state.ActivationState = Body->getActivationState();
+}
+
+DLLEXPORT void PhysicsBody::ApplyState(const PhysicsBodyState& state)
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    btTransform transform;
+    transform.setIdentity();
+    transform.setRotation(state.Orientation);
+    transform.setOrigin(state.Position);
+
+    // Interpolation transform is also set to not have the body blend from its current spot
+    Body->setCenterOfMassTransform(transform);
+    Body->setInterpolationWorldTransform(transform);
+    Body->setLinearVelocity(state.LinearVelocity);
+    Body->setAngularVelocity(state.AngularVelocity);
+    Body->setInterpolationLinearVelocity(state.LinearVelocity);
+    Body->setInterpolationAngularVelocity(state.AngularVelocity);
+    Body->clearForces();
+
+    Body->forceActivationState(state.ActivationState);
+    Body->setDeactivationTime(state.DeactivationTime);
+
+    if(Body->getMotionState())
+        Body->getMotionState()->setWorldTransform(transform);
+}
+
+DLLEXPORT void PhysicsBody::GetProperties(PhysicsBodyProperties& properties) const
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    properties.LinearDamping = Body->getLinearDamping();
+    properties.AngularDamping = Body->getAngularDamping();
+    properties.Friction = Body->getFriction();
+    properties.LinearFactor = Body->getLinearFactor();
+    properties.AngularFactor = Body->getAngularFactor();
+}
+
+DLLEXPORT void PhysicsBody::ApplyProperties(const PhysicsBodyProperties& properties)
+{
+    if(!Body)
+        throw InvalidArgument("PhysicsBody has no longer an internal physics engine body");
+
+    Body->setDamping(properties.LinearDamping, properties.AngularDamping);
+    Body->setFriction(properties.Friction);
+    Body->setLinearFactor(properties.LinearFactor);
+    Body->setAngularFactor(properties.AngularFactor);
 }
 // ------------------------------------ //
 DLLEXPORT void PhysicsBody::SetDamping(float linear, float angular)
@@ -278,6 +373,7 @@ DLLEXPORT void PhysicsBody::SetMass(float mass)
         Shape->GetShape()->calculateLocalInertia(Mass, localInertia);
 
     Body->setMassProps(mass, localInertia);
+    Body->activate();
 }
 // ------------------------------------ //
 DLLEXPORT void PhysicsBody::ConstraintMovementAxises(
@@ -288,6 +384,7 @@ DLLEXPORT void PhysicsBody::ConstraintMovementAxises(
 
     Body->setLinearFactor(movement);
     Body->setAngularFactor(rotation);
+    Body->activate();
 }
 // ------------------------------------ //
 DLLEXPORT void PhysicsBody::ApplyMaterial(PhysicalMaterial& material)
@@ -70,9 +70,45 @@ private:
 };
 
 
+//! \brief The simulated state of a PhysicsBody
+//!
+//! Used to rewind bodies to an earlier tick for resimulating them
+struct PhysicsBodyState {
+
+    Float3 Position;
+    Float4 Orientation;
+    Float3 LinearVelocity;
+    Float3 AngularVelocity;
+
+    //! How long the body has been resting, it falls asleep once this is long enough
+    float DeactivationTime;
+
+    //! The Bullet activation state of the body
+    int32_t ActivationState;
+};
+
+//! \brief Settings of a PhysicsBody that aren't part of PhysicsBodyState
+//!
+//! Used with the shape, mass and material to save bodies so that they can be recreated
+struct PhysicsBodyProperties {
+
+    float LinearDamping;
+    float AngularDamping;
+    float Friction;
+
+    //! Set with PhysicsBody::ConstraintMovementAxises
+    Float3 LinearFactor;
+    Float3 AngularFactor;
+};
+
 //! \brief This is an instance of a collision body
+//!
+//! Bodies that have been resting for a while are put to sleep by the physics engine. Sleeping
+//! bodies aren't simulated and don't update their positions. All the methods that change the
+//! position, velocity, forces or mass wake the body up
 class PhysicsBody : public ReferenceCounted {
     friend class PhysicalWorld;
+    friend class PhysicsSnapshot;
 
 protected:
     friend ReferenceCounted;
@@ -108,6 +144,35 @@ public:
     //! \brief Gets the torque of the body (rotational velocity)
     DLLEXPORT Float3 GetTorque() const;
 
+    //! \brief Makes a sleeping body simulated again
+    //!
+    //! Only needed if something not done through this class affects this body
+    DLLEXPORT void WakeUp();
+
+    //! \returns True if the physics engine has deactivated this body because it was resting
+    DLLEXPORT bool IsSleeping() const;
+
+    //! \brief Controls whether this can fall asleep. Bodies can sleep by default
+    //!
+    //! Disallowing sleeping is useful for bodies that are moved in ways the physics engine
+    //! doesn't see, but it makes them always simulated
+    DLLEXPORT void SetAllowSleeping(bool allow);
+
+    //! \brief Stores the current simulated state of this body
+    DLLEXPORT void GetState(PhysicsBodyState& state) const;
+
+    //! \brief Puts this body back to a state stored with GetState
+    //!
+    //! Also moves the position provider of this body. Forces applied to this body are not
+    //! part of the state and are cleared
+    DLLEXPORT void ApplyState(const PhysicsBodyState& state);
+
+    //! \brief Stores the settings of this body that aren't in the state
+    DLLEXPORT void GetProperties(PhysicsBodyProperties& properties) const;
+
+    //! \brief Applies settings stored with GetProperties
+    DLLEXPORT void ApplyProperties(const PhysicsBodyProperties& properties);
+
     //! \brief Sets the physical material ID of this object
     //! \note You have to fetch the ID from the world's corresponding PhysicalMaterialManager
     //! \todo There needs to be a physical world helper for actually applying the new
@@ -224,6 +289,9 @@ private:
 
 
     int PhysicalMaterialID;
+
+    //! Index of this in PhysicalWorld::PhysicsBodies, -1 when not in a world
+    int WorldIndex = -1;
 };
 
 
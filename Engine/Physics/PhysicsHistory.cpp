@@ -0,0 +1,98 @@
+// ------------------------------------ //
+#include "PhysicsHistory.h"
+
+#include "PhysicalWorld.h"
+
+using namespace Leviathan;
+// ------------------------------------ //
+DLLEXPORT void PhysicsSnapshot::Reset(int ticknumber, float leftoversteptime /*= 0*/)
+{
+    TickNumber = ticknumber;
+    LeftoverStepTime = leftoversteptime;
+    Entries.clear();
+}
+
+DLLEXPORT void PhysicsSnapshot::Add(PhysicsBody& body)
+{
+    Entries.emplace_back();
+    Entries.back().Body = PhysicsBody::pointer(&body);
+    body.GetState(Entries.back().State);
+}
+// ------------------------------------ //
+DLLEXPORT const PhysicsBodyState* PhysicsSnapshot::Find(const PhysicsBody& body) const
+{
+    const int index = _FindIndex(body);
+
+    if(index < 0)
+        return nullptr;
+
+    return &Entries[index].State;
+}
+
+DLLEXPORT bool PhysicsSnapshot::RestoreBody(PhysicsBody& body) const
+{
+    const int index = _FindIndex(body);
+
+    if(index < 0 || !body.GetBody())
+        return false;
+
+    body.ApplyState(Entries[index].State);
+    return true;
+}
+
+DLLEXPORT bool PhysicsSnapshot::UpdateBody(PhysicsBody& body)
+{
+    const int index = _FindIndex(body);
+
+    if(index < 0 || !body.GetBody())
+        return false;
+
+    body.GetState(Entries[index].State);
+    return true;
+}
+
+int PhysicsSnapshot::_FindIndex(const PhysicsBody& body) const
+{
+    // The body is at the same index unless bodies before it have been destroyed //
+    if(body.WorldIndex >= 0 && static_cast<size_t>(body.WorldIndex) < Entries.size() &&
+        Entries[body.WorldIndex].Body.get() == &body)
+        return body.WorldIndex;
+
+    for(size_t i = 0; i < Entries.size(); ++i) {
+        if(Entries[i].Body.get() == &body)
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+// ------------------------------------ //
+DLLEXPORT PhysicsHistory::PhysicsHistory(
+    size_t keptticks /*= DEFAULT_PHYSICS_HISTORY_TICKS*/) :
+    Snapshots(keptticks > 0 ? keptticks : 1)
+{}
+
+DLLEXPORT PhysicsSnapshot& PhysicsHistory::Record(const PhysicalWorld& world, int ticknumber)
+{
+    const auto count = static_cast<int>(Snapshots.size());
+    auto& snapshot = Snapshots[((ticknumber % count) + count) % count];
+
+    world.CaptureSnapshot(snapshot, ticknumber);
+    return snapshot;
+}
+
+DLLEXPORT PhysicsSnapshot* PhysicsHistory::Find(int ticknumber)
+{
+    const auto count = static_cast<int>(Snapshots.size());
+    auto& snapshot = Snapshots[((ticknumber % count) + count) % count];
+
+    if(snapshot.GetTickNumber() != ticknumber)
+        return nullptr;
+
+    return &snapshot;
+}
+
+DLLEXPORT void PhysicsHistory::Clear()
+{
+    for(auto& snapshot : Snapshots)
+        snapshot.Reset(-1);
+}
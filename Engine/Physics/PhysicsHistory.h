@@ -0,0 +1,106 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "PhysicsBody.h"
+
+#include <vector>
+
+namespace Leviathan {
+
+class PhysicalWorld;
+
+//! Number of ticks a PhysicsHistory keeps by default. With the default TICKSPEED this is
+//! 1.6 seconds
+constexpr size_t DEFAULT_PHYSICS_HISTORY_TICKS = 32;
+
+//! \brief The states of all bodies in a PhysicalWorld at one tick
+//!
+//! Created with PhysicalWorld::CaptureSnapshot. The bodies are kept alive by the snapshot, the
+//! states of bodies destroyed after capturing are ignored when restoring
+class PhysicsSnapshot {
+    struct Entry {
+
+        PhysicsBody::pointer Body;
+        PhysicsBodyState State;
+    };
+
+public:
+    //! \brief Forgets the stored bodies but keeps the memory for the next capture
+    //! \param leftoversteptime The simulation time of the world that wasn't yet simulated as
+    //! it didn't fill a whole substep
+    DLLEXPORT void Reset(int ticknumber, float leftoversteptime = 0);
+
+    //! \brief Stores the current state of body
+    DLLEXPORT void Add(PhysicsBody& body);
+
+    //! \returns The stored state of body or null if it wasn't captured
+    DLLEXPORT const PhysicsBodyState* Find(const PhysicsBody& body) const;
+
+    //! \brief Puts body back to the state it had when this was captured
+    //! \returns False if body isn't in this snapshot or has been destroyed
+    DLLEXPORT bool RestoreBody(PhysicsBody& body) const;
+
+    //! \brief Replaces the stored state of body with its current state
+    //!
+    //! Used to fix the later snapshots after resimulating body
+    //! \returns False if body isn't in this snapshot or has been destroyed
+    DLLEXPORT bool UpdateBody(PhysicsBody& body);
+
+    inline int GetTickNumber() const
+    {
+        return TickNumber;
+    }
+
+    inline size_t GetBodyCount() const
+    {
+        return Entries.size();
+    }
+
+    inline float GetLeftoverStepTime() const
+    {
+        return LeftoverStepTime;
+    }
+
+private:
+    //! \returns The index of body in Entries or -1
+    int _FindIndex(const PhysicsBody& body) const;
+
+private:
+    int TickNumber = -1;
+    float LeftoverStepTime = 0;
+
+    //! Stored in the order of the bodies in the world at capture time, so the index of a body
+    //! in the world is usually its index here
+    std::vector<Entry> Entries;
+};
+
+//! \brief Keeps PhysicsSnapshots of the recent ticks of a world
+//!
+//! The snapshots are kept in a ring indexed by tick number, recording a tick overwrites the
+//! tick that was recorded GetKeptTicks() ticks before it. The memory of overwritten snapshots
+//! is reused
+class PhysicsHistory {
+public:
+    DLLEXPORT PhysicsHistory(size_t keptticks = DEFAULT_PHYSICS_HISTORY_TICKS);
+
+    //! \brief Captures the current state of world as tick ticknumber
+    DLLEXPORT PhysicsSnapshot& Record(const PhysicalWorld& world, int ticknumber);
+
+    //! \returns The snapshot of ticknumber or null if it isn't recorded or was overwritten
+    DLLEXPORT PhysicsSnapshot* Find(int ticknumber);
+
+    //! \brief Forgets all snapshots
+    DLLEXPORT void Clear();
+
+    inline size_t GetKeptTicks() const
+    {
+        return Snapshots.size();
+    }
+
+private:
+    std::vector<PhysicsSnapshot> Snapshots;
+};
+
+} // namespace Leviathan
@@ -1,6 +1,7 @@
 // ------------------------------------ //
 #include "PhysicsMaterialManager.h"
 
+#include <algorithm>
 using namespace Leviathan;
 // ------------------------------------ //
 DLLEXPORT void PhysicsMaterialManager::LoadedMaterialAdd(
@@ -9,10 +10,20 @@ DLLEXPORT void PhysicsMaterialManager::LoadedMaterialAdd(
     if(!material)
         return;
 
+    if(material->GetID() < 0) {
+        LOG_ERROR(
+            "PhysicsMaterialManager: material has a negative ID: " + material->GetName());
+        return;
+    }
+
+    material->Owner = this;
+
     // Add to the map //
     PhysicalMaterial* ptr = material.get();
     LoadedMaterials[material->GetName()] = std::move(material);
     LoadedMaterialsByID[ptr->GetID()] = ptr;
+
+    _RebuildPairTable();
 }
 
 DLLEXPORT int PhysicsMaterialManager::GetMaterialID(const std::string& name)
@@ -55,3 +66,45 @@ DLLEXPORT PhysicalMaterial* PhysicsMaterialManager::GetMaterial(int id)
     // Not found //
     return nullptr;
 }
+// ------------------------------------ //
+void PhysicsMaterialManager::_RebuildPairTable()
+{
+    // LoadedMaterials owns the materials so it is used instead of LoadedMaterialsByID
+    std::vector<PhysicalMaterial*> materials;
+    materials.reserve(LoadedMaterials.size());
+
+    int maxID = -1;
+
+    for(const auto& [name, material] : LoadedMaterials) {
+        materials.push_back(material.get());
+        maxID = std::max(maxID, material->GetID());
+    }
+
+    MaterialCount = static_cast<int>(materials.size());
+
+    IndexByID.assign(maxID + 1, -1);
+
+    for(int i = 0; i < MaterialCount; ++i)
+        IndexByID[materials[i]->GetID()] = i;
+
+    PairTable.assign(MaterialCount * MaterialCount, nullptr);
+
+    // The pairs are stored in unordered_maps of the materials, pointers to them stay valid
+    // when more pairs are added
+    for(int i = 0; i < MaterialCount; ++i) {
+        for(int j = i; j < MaterialCount; ++j) {
+
+            const int id1 = materials[i]->GetID();
+            const int id2 = materials[j]->GetID();
+
+            const PhysMaterialDataPair* pair = materials[i]->GetPairWith(id2);
+
+            if(!pair)
+                pair = materials[j]->GetPairWith(id1);
+
+            PairTable[i * MaterialCount + j] = pair;
+        }
+    }
+
+    ++PairTableVersion;
+}
@@ -9,8 +9,15 @@ namespace Leviathan {
 
 //! \brief Contains a material list for applying automatic properties to PhysicsBody and
 //! collision callbacks
+//!
+//! The pairs of all materials are kept in a table that is rebuilt when a material is added or
+//! a pair is formed, so finding the pair of two materials during a physics update doesn't
+//! need any hashing.
+//! \note Materials shouldn't be added or paired while a world using them is being simulated
 //! \todo file loading function
 class PhysicsMaterialManager {
+    friend PhysicalMaterial;
+
 public:
     //! \brief Adds a physics material. This now takes effect instantly and all worlds using
     //! this material manager will see the change on next physics update.
@@ -28,12 +35,71 @@ public:
     //! \brief Accesses material by ID
     DLLEXPORT PhysicalMaterial* GetMaterial(int id);
 
+    //! \returns The index of the pair of two materials in the pair table or -1 if either
+    //! material doesn't exist. The same two materials in either order have the same index
+    //! \note The indexes change when materials are added
+    inline int GetPairIndex(int id1, int id2) const
+    {
+        if(id1 < 0 || id2 < 0 || static_cast<size_t>(id1) >= IndexByID.size() ||
+            static_cast<size_t>(id2) >= IndexByID.size())
+            return -1;
+
+        const int index1 = IndexByID[id1];
+        const int index2 = IndexByID[id2];
+
+        if(index1 < 0 || index2 < 0)
+            return -1;
+
+        return index1 < index2 ? index1 * MaterialCount + index2 :
+                                 index2 * MaterialCount + index1;
+    }
+
+    //! \returns The pair at an index returned by GetPairIndex, null if the materials haven't
+    //! been paired
+    inline const PhysMaterialDataPair* GetPairByIndex(int index) const
+    {
+        return PairTable[index];
+    }
+
+    //! \brief Finds the properties between two materials
+    //! \returns Null if either of the materials doesn't exist or they haven't been paired
+    inline const PhysMaterialDataPair* GetMaterialPair(int id1, int id2) const
+    {
+        const int index = GetPairIndex(id1, id2);
+        return index >= 0 ? PairTable[index] : nullptr;
+    }
+
+    //! \returns The size of the pair table
+    inline int GetPairIndexCount() const
+    {
+        return static_cast<int>(PairTable.size());
+    }
+
+    //! \returns A number that is incremented each time the pair indexes change
+    inline int GetPairTableVersion() const
+    {
+        return PairTableVersion;
+    }
+
+private:
+    //! \brief Fills the pair table from the pairs of the materials
+    void _RebuildPairTable();
 
 private:
     //! Map for fast finding
     std::map<std::string, std::unique_ptr<PhysicalMaterial>> LoadedMaterials;
     //! Also for finding by id
     std::map<int, PhysicalMaterial*> LoadedMaterialsByID;
+
+    //! Index of each material in the pair table by material ID, -1 for unused IDs
+    std::vector<int> IndexByID;
+
+    int MaterialCount = 0;
+
+    //! The pair of materials with indexes i <= j is at i * MaterialCount + j
+    std::vector<const PhysMaterialDataPair*> PairTable;
+
+    int PairTableVersion = 0;
 };
 
 } // namespace Leviathan
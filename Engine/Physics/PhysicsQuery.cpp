@@ -0,0 +1,106 @@
+// ------------------------------------ //
+#include "PhysicsQuery.h"
+
+#include "PhysicsBody.h"
+using namespace Leviathan;
+// ------------------------------------ //
+DLLEXPORT bool PhysicsQueryFilter::Accepts(const PhysicsBody& body) const
+{
+    if(IgnoredEntity != NULL_OBJECT && body.GetOwningEntity() == IgnoredEntity)
+        return false;
+
+    const auto material = body.GetPhysicalMaterialID();
+
+    if(OnlyMaterial != -1 && material != OnlyMaterial)
+        return false;
+
+    if(IgnoredMaterial != -1 && material == IgnoredMaterial)
+        return false;
+
+    return body.GetMass() > 0 ? HitDynamic : HitStatic;
+}
+// ------------------------------------ //
+DLLEXPORT PhysicsQuery PhysicsQuery::Ray(
+    const Float3& from, const Float3& to, const PhysicsQueryFilter& filter /*= {}*/)
+{
+    PhysicsQuery query;
+    query.Type = PHYSICS_QUERY_TYPE::RayClosest;
+    query.From = from;
+    query.To = to;
+    query.Filter = filter;
+    return query;
+}
+
+DLLEXPORT PhysicsQuery PhysicsQuery::RayAll(const Float3& from, const Float3& to,
+    const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/)
+{
+    PhysicsQuery query = Ray(from, to, filter);
+    query.Type = PHYSICS_QUERY_TYPE::RayAll;
+    query.MaxHits = maxhits;
+    return query;
+}
+
+DLLEXPORT PhysicsQuery PhysicsQuery::SphereSweep(const Float3& from, const Float3& to,
+    float radius, const PhysicsQueryFilter& filter /*= {}*/)
+{
+    PhysicsQuery query = Ray(from, to, filter);
+    query.Type = PHYSICS_QUERY_TYPE::SphereSweep;
+    query.Extents = Float3(radius);
+    return query;
+}
+
+DLLEXPORT PhysicsQuery PhysicsQuery::BoxSweep(const Float3& from, const Float3& to,
+    const Float3& halfextents, const Float4& orientation,
+    const PhysicsQueryFilter& filter /*= {}*/)
+{
+    PhysicsQuery query = Ray(from, to, filter);
+    query.Type = PHYSICS_QUERY_TYPE::BoxSweep;
+    query.Extents = halfextents;
+    query.Orientation = orientation;
+    return query;
+}
+
+DLLEXPORT PhysicsQuery PhysicsQuery::AABBOverlap(const Float3& min, const Float3& max,
+    const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/)
+{
+    PhysicsQuery query = Ray(min, max, filter);
+    query.Type = PHYSICS_QUERY_TYPE::AABBOverlap;
+    query.MaxHits = maxhits;
+    return query;
+}
+
+DLLEXPORT PhysicsQuery PhysicsQuery::SphereOverlap(const Float3& center, float radius,
+    const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/)
+{
+    PhysicsQuery query = Ray(center, center, filter);
+    query.Type = PHYSICS_QUERY_TYPE::SphereOverlap;
+    query.Extents = Float3(radius);
+    query.MaxHits = maxhits;
+    return query;
+}
+
+DLLEXPORT PhysicsQuery PhysicsQuery::BoxOverlap(const Float3& center,
+    const Float3& halfextents, const Float4& orientation,
+    const PhysicsQueryFilter& filter /*= {}*/, int maxhits /*= 32*/)
+{
+    PhysicsQuery query = Ray(center, center, filter);
+    query.Type = PHYSICS_QUERY_TYPE::BoxOverlap;
+    query.Extents = halfextents;
+    query.Orientation = orientation;
+    query.MaxHits = maxhits;
+    return query;
+}
+// ------------------------------------ //
+DLLEXPORT size_t PhysicsQueryBatch::Add(const PhysicsQuery& query)
+{
+    Queries.push_back(query);
+    return Queries.size() - 1;
+}
+
+DLLEXPORT void PhysicsQueryBatch::Clear()
+{
+    Queries.clear();
+    HitOffsets.clear();
+    HitCounts.clear();
+    Hits.clear();
+}
@@ -0,0 +1,174 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "Common/Types.h"
+
+#include <vector>
+
+namespace Leviathan {
+
+class PhysicsBody;
+
+//! \brief Limits which bodies a physics query can hit
+struct PhysicsQueryFilter {
+
+    //! \returns True if body should be tested against the query
+    DLLEXPORT bool Accepts(const PhysicsBody& body) const;
+
+    //! Bodies of this entity aren't hit. Useful for ignoring the entity doing the query
+    ObjectID IgnoredEntity = NULL_OBJECT;
+
+    //! If not -1 only bodies with this physics material are hit
+    int OnlyMaterial = -1;
+
+    //! If not -1 bodies with this physics material aren't hit
+    int IgnoredMaterial = -1;
+
+    //! Static bodies are the ones with 0 mass
+    bool HitStatic = true;
+    bool HitDynamic = true;
+};
+
+//! \brief A body found by a physics query
+struct PhysicsQueryHit {
+
+    inline bool HasHit() const
+    {
+        return Body != nullptr;
+    }
+
+    //! Null if nothing was hit. Only valid until the body is destroyed
+    PhysicsBody* Body = nullptr;
+
+    ObjectID Entity = NULL_OBJECT;
+
+    //! The hit point in world space. For overlaps this is the position of the body
+    Float3 Point = Float3(0);
+
+    //! Surface normal at Point, zero for overlaps
+    Float3 Normal = Float3(0);
+
+    //! How far along a ray or sweep the hit is. 0 is the start and 1 the end
+    float Fraction = 1.f;
+};
+
+enum class PHYSICS_QUERY_TYPE : uint8_t {
+
+    //! The first body along a ray
+    RayClosest,
+    //! All bodies along a ray sorted by distance
+    RayAll,
+    //! The first body a sphere hits when moved along a line
+    SphereSweep,
+    //! The first body a box hits when moved along a line
+    BoxSweep,
+    //! Bodies whose bounding boxes overlap an axis aligned box
+    AABBOverlap,
+    //! Bodies that touch a sphere
+    SphereOverlap,
+    //! Bodies that touch a box
+    BoxOverlap
+};
+
+//! \brief One scene query that can be ran alone or as a part of a PhysicsQueryBatch
+//! \see PhysicalWorld::RunQuery
+struct PhysicsQuery {
+
+    DLLEXPORT static PhysicsQuery Ray(
+        const Float3& from, const Float3& to, const PhysicsQueryFilter& filter = {});
+
+    //! \param maxhits Hits beyond this are not returned
+    DLLEXPORT static PhysicsQuery RayAll(const Float3& from, const Float3& to,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32);
+
+    DLLEXPORT static PhysicsQuery SphereSweep(const Float3& from, const Float3& to,
+        float radius, const PhysicsQueryFilter& filter = {});
+
+    //! \param halfextents The half widths of the box along each axis
+    DLLEXPORT static PhysicsQuery BoxSweep(const Float3& from, const Float3& to,
+        const Float3& halfextents, const Float4& orientation,
+        const PhysicsQueryFilter& filter = {});
+
+    DLLEXPORT static PhysicsQuery AABBOverlap(const Float3& min, const Float3& max,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32);
+
+    DLLEXPORT static PhysicsQuery SphereOverlap(const Float3& center, float radius,
+        const PhysicsQueryFilter& filter = {}, int maxhits = 32);
+
+    DLLEXPORT static PhysicsQuery BoxOverlap(const Float3& center, const Float3& halfextents,
+        const Float4& orientation, const PhysicsQueryFilter& filter = {}, int maxhits = 32);
+
+    //! \returns The number of hits this can return
+    inline int GetMaxHits() const
+    {
+        return Type == PHYSICS_QUERY_TYPE::RayAll || Type == PHYSICS_QUERY_TYPE::AABBOverlap ||
+                       Type == PHYSICS_QUERY_TYPE::SphereOverlap ||
+                       Type == PHYSICS_QUERY_TYPE::BoxOverlap ?
+                   MaxHits :
+                   1;
+    }
+
+    PHYSICS_QUERY_TYPE Type = PHYSICS_QUERY_TYPE::RayClosest;
+
+    //! Start of rays and sweeps, the center of shape overlaps or the minimum of AABB overlaps
+    Float3 From = Float3(0);
+
+    //! End of rays and sweeps or the maximum of AABB overlaps
+    Float3 To = Float3(0);
+
+    //! Sphere radius in X or the half extents of a box
+    Float3 Extents = Float3(0);
+
+    Float4 Orientation = Float4::IdentityQuaternion();
+
+    PhysicsQueryFilter Filter;
+
+    int MaxHits = 1;
+};
+
+//! \brief Many physics queries that are ran at the same time on the worker threads
+//!
+//! The results are stored in this object, so reusing a batch each tick doesn't allocate once
+//! it has grown large enough
+//! \see PhysicalWorld::RunQueries
+class PhysicsQueryBatch {
+    friend class PhysicalWorld;
+
+public:
+    //! \returns The index of the query for getting its results
+    DLLEXPORT size_t Add(const PhysicsQuery& query);
+
+    //! \brief Removes all queries and results
+    DLLEXPORT void Clear();
+
+    inline size_t GetQueryCount() const
+    {
+        return Queries.size();
+    }
+
+    //! \returns The number of hits query had in the last run
+    inline int GetHitCount(size_t query) const
+    {
+        return query < HitCounts.size() ? HitCounts[query] : 0;
+    }
+
+    //! \returns A hit of query, the hits are in the same order as RunQuery returns them
+    inline const PhysicsQueryHit& GetHit(size_t query, int index) const
+    {
+        return Hits[HitOffsets[query] + index];
+    }
+
+private:
+    std::vector<PhysicsQuery> Queries;
+
+    //! Where the hits of each query start in Hits
+    std::vector<size_t> HitOffsets;
+    std::vector<int> HitCounts;
+
+    //! Each query has space for its maximum number of hits
+    std::vector<PhysicsQueryHit> Hits;
+};
+
+} // namespace Leviathan
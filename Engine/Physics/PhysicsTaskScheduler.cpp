@@ -0,0 +1,173 @@
+// ------------------------------------ //
+#include "PhysicsTaskScheduler.h"
+
+#include "Threading/ThreadingManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace Leviathan;
+// ------------------------------------ //
+namespace {
+
+//! \brief A loop that is split into grain sized parts that threads take in order
+//!
+//! Workers that start after all the parts are taken return without touching Body, so the
+//! caller only needs to wait for the taken parts to finish
+struct ParallelLoop {
+
+    ParallelLoop(int begin, int end, int grainsize, const btIParallelForBody& body) :
+        Next(begin), End(end), GrainSize(grainsize), Total(end - begin), Body(&body)
+    {}
+
+    void RunParts()
+    {
+        while(true) {
+
+            const int begin = Next.fetch_add(GrainSize, std::memory_order_relaxed);
+
+            if(begin >= End)
+                return;
+
+            const int end = std::min(begin + GrainSize, End);
+
+            Body->forLoop(begin, end);
+
+            if(Finished.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) ==
+                Total) {
+
+                std::lock_guard<std::mutex> lock(Mutex);
+                AllFinished.notify_all();
+            }
+        }
+    }
+
+    void WaitForFinish()
+    {
+        std::unique_lock<std::mutex> lock(Mutex);
+        AllFinished.wait(
+            lock, [this]() { return Finished.load(std::memory_order_acquire) == Total; });
+    }
+
+    std::atomic<int> Next;
+    const int End;
+    const int GrainSize;
+    const int Total;
+
+    const btIParallelForBody* Body;
+
+    std::atomic<int> Finished{0};
+    std::mutex Mutex;
+    std::condition_variable AllFinished;
+};
+
+//! \brief Adds up the results of btIParallelSumBody in parallelFor
+class SumLoopBody : public btIParallelForBody {
+public:
+    SumLoopBody(const btIParallelSumBody& body) : Body(body) {}
+
+    void forLoop(int begin, int end) const override
+    {
+        const btScalar sum = Body.sumLoop(begin, end);
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        Sum += sum;
+    }
+
+    const btIParallelSumBody& Body;
+
+    mutable std::mutex Mutex;
+    mutable btScalar Sum = 0;
+};
+
+} // namespace
+// ------------------------------------ //
+DLLEXPORT PhysicsTaskScheduler::PhysicsTaskScheduler() :
+    btITaskScheduler("LeviathanThreadingManager")
+{
+    setNumThreads(GetDefaultThreadCount());
+}
+// ------------------------------------ //
+int PhysicsTaskScheduler::getMaxNumThreads() const
+{
+    return BT_MAX_THREAD_COUNT;
+}
+
+int PhysicsTaskScheduler::getNumThreads() const
+{
+    return NumThreads;
+}
+
+void PhysicsTaskScheduler::setNumThreads(int numthreads)
+{
+    NumThreads = std::clamp(numthreads, 1, getMaxNumThreads());
+}
+// ------------------------------------ //
+void PhysicsTaskScheduler::parallelFor(
+    int begin, int end, int grainsize, const btIParallelForBody& body)
+{
+    RunParallelFor(begin, end, grainsize, body, NumThreads);
+}
+
+#if BT_BULLET_VERSION >= 288
+btScalar PhysicsTaskScheduler::parallelSum(
+    int begin, int end, int grainsize, const btIParallelSumBody& body)
+{
+    SumLoopBody sum(body);
+    parallelFor(begin, end, grainsize, sum);
+    return sum.Sum;
+}
+#endif // BT_BULLET_VERSION >= 288
+// ------------------------------------ //
+DLLEXPORT void PhysicsTaskScheduler::RunParallelFor(
+    int begin, int end, int grainsize, const btIParallelForBody& body, int maxthreads)
+{
+    if(begin >= end)
+        return;
+
+    grainsize = std::max(grainsize, 1);
+
+    const int parts = (end - begin + grainsize - 1) / grainsize;
+
+    ThreadingManager* threads = ThreadingManager::Get();
+
+    // Waiting for other workers on a worker thread could stall all of them //
+    const bool onWorker = TaskThread::GetThreadSpecificThreadObject() != nullptr;
+
+    if(!threads || maxthreads < 2 || parts < 2 || onWorker) {
+
+        body.forLoop(begin, end);
+        return;
+    }
+
+    auto loop = std::make_shared<ParallelLoop>(begin, end, grainsize, body);
+
+    const int helpers = std::min(maxthreads, parts) - 1;
+
+    for(int i = 0; i < helpers; ++i)
+        threads->QueueTask(std::make_shared<QueuedTask>([loop]() { loop->RunParts(); }));
+
+    loop->RunParts();
+    loop->WaitForFinish();
+}
+
+DLLEXPORT int PhysicsTaskScheduler::GetDefaultThreadCount()
+{
+    const auto threads = ThreadingManager::Get();
+
+    if(threads)
+        return threads->GetThreadCount() + 1;
+
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+// ------------------------------------ //
+DLLEXPORT void PhysicsTaskScheduler::Install()
+{
+    static PhysicsTaskScheduler scheduler;
+
+    if(btGetTaskScheduler() != &scheduler)
+        btSetTaskScheduler(&scheduler);
+}
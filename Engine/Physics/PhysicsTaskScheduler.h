@@ -0,0 +1,53 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "LinearMath/btThreads.h"
+
+namespace Leviathan {
+
+//! \brief Runs the parallel loops of Bullet on the ThreadingManager worker threads
+//!
+//! This keeps Bullet from creating a second thread pool. The calling thread also runs parts
+//! of each loop so loops finish even when all of the workers are busy. Loops started on a
+//! worker thread (by a world that is ticked in parallel) are ran on that thread only, as the
+//! other workers may be waiting for it.
+//! \note Bullet allows only one task scheduler, use Install to set this as it
+class PhysicsTaskScheduler : public btITaskScheduler {
+public:
+    DLLEXPORT PhysicsTaskScheduler();
+
+    int getMaxNumThreads() const override;
+    int getNumThreads() const override;
+    void setNumThreads(int numthreads) override;
+
+    void parallelFor(
+        int begin, int end, int grainsize, const btIParallelForBody& body) override;
+
+#if BT_BULLET_VERSION >= 288
+    btScalar parallelSum(
+        int begin, int end, int grainsize, const btIParallelSumBody& body) override;
+#endif // BT_BULLET_VERSION >= 288
+
+    //! \brief Sets the Bullet task scheduler to an instance of this if not already set
+    //! \note Bullet requires this to be called on the main thread
+    DLLEXPORT static void Install();
+
+    //! \brief Runs body over the range in grain sized parts on the worker threads and this
+    //! thread. Returns once the whole range is done
+    //!
+    //! This works without Bullet multithreading as well
+    //! \param maxthreads The maximum number of threads to use, including the calling one
+    DLLEXPORT static void RunParallelFor(int begin, int end, int grainsize,
+        const btIParallelForBody& body, int maxthreads);
+
+    //! \returns The number of threads RunParallelFor should use, the workers and this one
+    DLLEXPORT static int GetDefaultThreadCount();
+
+private:
+    //! Number of threads that run a loop, including the calling thread
+    int NumThreads;
+};
+
+} // namespace Leviathan
@@ -147,6 +147,17 @@ AudioSource* SoundDevicePlay2DProxy(
     return source.get();
 }
 
+AudioSource* SoundDevicePlay2DStreamProxy(
+    SoundDevice* self, const std::string& filename, bool looping)
+{
+    auto source = self->Play2DStream(filename, looping);
+
+    if(source)
+        source->AddRef();
+
+    return source.get();
+}
+
 // ------------------------------------ //
 static std::string GetLeviathanVersionProxy()
 {
@@ -431,6 +442,11 @@ bool BindEvents(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
+    if(engine->RegisterObjectMethod("EventHandler", "void QueueEvent(GenericEvent@ event)",
+           asMETHODPR(EventHandler, QueueEvent, (GenericEvent*), void), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
     // Event listener //
     ANGELSCRIPT_REGISTER_REF_TYPE("EventListener", Script::EventListener);
 
@@ -834,6 +850,12 @@ bool BindSound(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
+    if(engine->RegisterObjectMethod("SoundDevice",
+           "AudioSource@ Play2DStream(const string &in filename, bool looping)",
+           asFUNCTION(SoundDevicePlay2DStreamProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
     return true;
 }
 
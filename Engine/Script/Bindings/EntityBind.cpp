@@ -6,6 +6,8 @@
 #include "Entities/GameWorld.h"
 #include "Entities/ScriptComponentHolder.h"
 #include "Entities/ScriptSystemWrapper.h"
+#include "Entities/SpatialIndex.h"
+#include "Script/ScriptConversionHelpers.h"
 
 #include "StandardWorldBindHelper.h"
 
@@ -60,6 +62,50 @@ SimpleAnimation* AnimatedGetHelper(Animated* self, uint64_t index)
     return &self->Animations[index];
 }
 
+CScriptArray* SpatialIndexQueryRadiusProxy(
+    const SpatialIndex* self, const Float3& center, float radius)
+{
+    std::vector<ObjectID> result;
+    self->QueryRadius(center, radius, result);
+    return ConvertVectorToASArray(
+        result, ScriptExecutor::Get()->GetASEngine(), "array<ObjectID>");
+}
+
+CScriptArray* SpatialIndexQueryBoxProxy(
+    const SpatialIndex* self, const Float3& min, const Float3& max)
+{
+    std::vector<ObjectID> result;
+    self->QueryBox(min, max, result);
+    return ConvertVectorToASArray(
+        result, ScriptExecutor::Get()->GetASEngine(), "array<ObjectID>");
+}
+
+CScriptArray* SpatialIndexQueryNearestProxy(
+    const SpatialIndex* self, const Float3& point, uint32_t count, float maxdistance)
+{
+    std::vector<ObjectID> result;
+    self->QueryNearest(point, count, result, maxdistance);
+    return ConvertVectorToASArray(
+        result, ScriptExecutor::Get()->GetASEngine(), "array<ObjectID>");
+}
+
+uint32_t SpatialIndexGetEntityCountProxy(const SpatialIndex* self)
+{
+    return static_cast<uint32_t>(self->GetEntityCount());
+}
+
+template<class ComponentT>
+bool ComponentGetMarkedProxy(const ComponentT* self)
+{
+    return self->Marked;
+}
+
+template<class ComponentT>
+void ComponentSetMarkedProxy(ComponentT* self, bool marked)
+{
+    self->Marked = marked;
+}
+
 // ------------------------------------ //
 // Start of the actual bind
 namespace Leviathan {
@@ -86,6 +132,61 @@ bool BindRayCast(asIScriptEngine* engine)
     return true;
 }
 
+//! \brief Binds Marked as a property that goes through ComponentChangeFlag
+template<class ComponentT>
+bool BindComponentMarked(asIScriptEngine* engine, const char* name)
+{
+    if(engine->RegisterObjectMethod(name, "bool get_Marked() const",
+           asFUNCTION(ComponentGetMarkedProxy<ComponentT>), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod(name, "void set_Marked(bool value)",
+           asFUNCTION(ComponentSetMarkedProxy<ComponentT>), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    return true;
+}
+
+bool BindSpatialIndex(asIScriptEngine* engine)
+{
+    if(engine->RegisterObjectType("SpatialIndex", 0, asOBJ_REF | asOBJ_NOCOUNT) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("SpatialIndex",
+           "array<ObjectID>@ QueryRadius(const Float3 &in center, float radius) const",
+           asFUNCTION(SpatialIndexQueryRadiusProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("SpatialIndex",
+           "array<ObjectID>@ QueryBox(const Float3 &in min, const Float3 &in max) const",
+           asFUNCTION(SpatialIndexQueryBoxProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("SpatialIndex",
+           "array<ObjectID>@ QueryNearest(const Float3 &in point, uint count, "
+           "float maxdistance = -1) const",
+           asFUNCTION(SpatialIndexQueryNearestProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("SpatialIndex", "uint GetEntityCount() const",
+           asFUNCTION(SpatialIndexGetEntityCountProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("SpatialIndex", "float GetCellSize() const",
+           asMETHOD(SpatialIndex, GetCellSize), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    return true;
+}
+
 static uint16_t PhysicsTYPEProxy = static_cast<uint16_t>(Physics::TYPE);
 static uint16_t PositionTYPEProxy = static_cast<uint16_t>(Position::TYPE);
 static uint16_t RenderNodeTYPEProxy = static_cast<uint16_t>(RenderNode::TYPE);
@@ -125,10 +226,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty("Position", "bool Marked", asOFFSET(Position, Marked)) <
-        0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Position>(engine, "Position"))
+        return false;
 
     if(engine->RegisterObjectProperty(
            "Position", "Float3 _Position", asOFFSET(Position, Members._Position)) < 0) {
@@ -150,10 +249,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
     }
 
     // Currently does nothing
-    if(engine->RegisterObjectProperty("Physics", "bool Marked", asOFFSET(Physics, Marked)) <
-        0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Physics>(engine, "Physics"))
+        return false;
 
     if(engine->RegisterObjectMethod("Physics", "PhysicsBody@ get_Body() const",
            asMETHOD(Physics, GetBodyWrapper), asCALL_THISCALL) < 0) {
@@ -192,10 +289,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty(
-           "RenderNode", "bool Marked", asOFFSET(RenderNode, Marked)) < 0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<RenderNode>(engine, "RenderNode"))
+        return false;
 
     if(engine->RegisterObjectProperty(
            "RenderNode", "Float3 Scale", asOFFSET(RenderNode, Scale)) < 0) {
@@ -221,10 +316,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty("Sendable", "bool Marked", asOFFSET(Sendable, Marked)) <
-        0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Sendable>(engine, "Sendable"))
+        return false;
 
     if(!BindComponentTypeID(engine, "Sendable", &SendableTYPEProxy))
         return false;
@@ -235,10 +328,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty("Received", "bool Marked", asOFFSET(Received, Marked)) <
-        0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Received>(engine, "Received"))
+        return false;
 
     if(!BindComponentTypeID(engine, "Received", &ReceivedTYPEProxy))
         return false;
@@ -249,9 +340,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty("Model", "bool Marked", asOFFSET(Model, Marked)) < 0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Model>(engine, "Model"))
+        return false;
 
     if(!BindComponentTypeID(engine, "Model", &ModelTYPEProxy))
         return false;
@@ -277,10 +367,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty(
-           "BoxGeometry", "bool Marked", asOFFSET(BoxGeometry, Marked)) < 0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<BoxGeometry>(engine, "BoxGeometry"))
+        return false;
 
     if(!BindComponentTypeID(engine, "BoxGeometry", &BoxGeometryTYPEProxy))
         return false;
@@ -305,9 +393,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty("Camera", "bool Marked", asOFFSET(Camera, Marked)) < 0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Camera>(engine, "Camera"))
+        return false;
 
     if(engine->RegisterObjectProperty("Camera", "uint8 FOV", asOFFSET(Camera, FOV)) < 0) {
         ANGELSCRIPT_REGISTERFAIL;
@@ -347,10 +434,8 @@ bool BindComponentTypes(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    if(engine->RegisterObjectProperty("Animated", "bool Marked", asOFFSET(Animated, Marked)) <
-        0) {
-        ANGELSCRIPT_REGISTERFAIL;
-    }
+    if(!BindComponentMarked<Animated>(engine, "Animated"))
+        return false;
 
     if(!BindComponentTypeID(engine, "Animated", &AnimatedTYPEProxy))
         return false;
@@ -543,6 +628,9 @@ bool Leviathan::BindEntity(asIScriptEngine* engine)
     if(!BindRayCast(engine))
         return false;
 
+    if(!BindSpatialIndex(engine))
+        return false;
+
     if(!BindComponentTypes(engine))
         return false;
 
@@ -7,12 +7,55 @@
 
 #include "Define.h"
 #include "Logger.h"
+#include "Script/ScriptConversionHelpers.h"
 
 using namespace Leviathan;
 // ------------------------------------ //
 
 // Proxies etc.
 // ------------------------------------ //
+void PhysicsQueryFilterConstructorProxy(void* memory)
+{
+    new(memory) PhysicsQueryFilter();
+}
+
+void PhysicsQueryHitConstructorProxy(void* memory)
+{
+    new(memory) PhysicsQueryHit();
+}
+
+CScriptArray* QueryHitsToASArray(const std::vector<PhysicsQueryHit>& hits)
+{
+    return ConvertVectorToASArray(
+        hits, ScriptExecutor::Get()->GetASEngine(), "array<PhysicsQueryHit>");
+}
+
+CScriptArray* PhysicalWorldCastRayAllProxy(const PhysicalWorld* self, const Float3& from,
+    const Float3& to, const PhysicsQueryFilter& filter, int maxhits)
+{
+    return QueryHitsToASArray(self->CastRayAll(from, to, filter, maxhits));
+}
+
+CScriptArray* PhysicalWorldOverlapAABBProxy(const PhysicalWorld* self, const Float3& min,
+    const Float3& max, const PhysicsQueryFilter& filter, int maxhits)
+{
+    return QueryHitsToASArray(self->OverlapAABB(min, max, filter, maxhits));
+}
+
+CScriptArray* PhysicalWorldOverlapSphereProxy(const PhysicalWorld* self, const Float3& center,
+    float radius, const PhysicsQueryFilter& filter, int maxhits)
+{
+    return QueryHitsToASArray(self->OverlapSphere(center, radius, filter, maxhits));
+}
+
+CScriptArray* PhysicalWorldOverlapBoxProxy(const PhysicalWorld* self, const Float3& center,
+    const Float3& halfextents, const Float4& orientation, const PhysicsQueryFilter& filter,
+    int maxhits)
+{
+    return QueryHitsToASArray(
+        self->OverlapBox(center, halfextents, orientation, filter, maxhits));
+}
+// ------------------------------------ //
 
 // ------------------------------------ //
 // Start of the actual bind
@@ -133,6 +176,21 @@ bool BindBody(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
+    if(engine->RegisterObjectMethod("PhysicsBody", "void WakeUp()",
+           asMETHOD(PhysicsBody, WakeUp), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicsBody", "bool IsSleeping() const",
+           asMETHOD(PhysicsBody, IsSleeping), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicsBody", "void SetAllowSleeping(bool allow)",
+           asMETHOD(PhysicsBody, SetAllowSleeping), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
     if(engine->RegisterObjectMethod("PhysicsBody",
            "void ConstraintMovementAxises(const Float3 &in movement = Float3(1, 0, 1), const "
            "Float3 &in rotation = Float3(0, 1, 0))",
@@ -142,6 +200,138 @@ bool BindBody(asIScriptEngine* engine)
 
     return true;
 }
+
+bool BindQueries(asIScriptEngine* engine)
+{
+    if(engine->RegisterObjectType("PhysicsQueryFilter", sizeof(PhysicsQueryFilter),
+           asOBJ_VALUE | asOBJ_POD | asGetTypeTraits<PhysicsQueryFilter>()) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectBehaviour("PhysicsQueryFilter", asBEHAVE_CONSTRUCT, "void f()",
+           asFUNCTION(PhysicsQueryFilterConstructorProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty("PhysicsQueryFilter", "ObjectID IgnoredEntity",
+           asOFFSET(PhysicsQueryFilter, IgnoredEntity)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty("PhysicsQueryFilter", "int OnlyMaterial",
+           asOFFSET(PhysicsQueryFilter, OnlyMaterial)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty("PhysicsQueryFilter", "int IgnoredMaterial",
+           asOFFSET(PhysicsQueryFilter, IgnoredMaterial)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty("PhysicsQueryFilter", "bool HitStatic",
+           asOFFSET(PhysicsQueryFilter, HitStatic)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty("PhysicsQueryFilter", "bool HitDynamic",
+           asOFFSET(PhysicsQueryFilter, HitDynamic)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    // The body pointer isn't exposed as it isn't reference counted
+    if(engine->RegisterObjectType("PhysicsQueryHit", sizeof(PhysicsQueryHit),
+           asOBJ_VALUE | asOBJ_POD | asGetTypeTraits<PhysicsQueryHit>()) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectBehaviour("PhysicsQueryHit", asBEHAVE_CONSTRUCT, "void f()",
+           asFUNCTION(PhysicsQueryHitConstructorProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicsQueryHit", "bool HasHit() const",
+           asMETHOD(PhysicsQueryHit, HasHit), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty("PhysicsQueryHit", "ObjectID Entity",
+           asOFFSET(PhysicsQueryHit, Entity)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty(
+           "PhysicsQueryHit", "Float3 Point", asOFFSET(PhysicsQueryHit, Point)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty(
+           "PhysicsQueryHit", "Float3 Normal", asOFFSET(PhysicsQueryHit, Normal)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectProperty(
+           "PhysicsQueryHit", "float Fraction", asOFFSET(PhysicsQueryHit, Fraction)) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "PhysicsQueryHit CastRay(const Float3 &in from, const Float3 &in to, "
+           "const PhysicsQueryFilter &in filter = PhysicsQueryFilter()) const",
+           asMETHOD(PhysicalWorld, CastRay), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "array<PhysicsQueryHit>@ CastRayAll(const Float3 &in from, const Float3 &in to, "
+           "const PhysicsQueryFilter &in filter = PhysicsQueryFilter(), int maxhits = 32) "
+           "const",
+           asFUNCTION(PhysicalWorldCastRayAllProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "PhysicsQueryHit SweepSphere(const Float3 &in from, const Float3 &in to, "
+           "float radius, const PhysicsQueryFilter &in filter = PhysicsQueryFilter()) const",
+           asMETHOD(PhysicalWorld, SweepSphere), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "PhysicsQueryHit SweepBox(const Float3 &in from, const Float3 &in to, "
+           "const Float3 &in halfextents, const Float4 &in orientation = "
+           "Float4::IdentityQuaternion, const PhysicsQueryFilter &in filter = "
+           "PhysicsQueryFilter()) const",
+           asMETHOD(PhysicalWorld, SweepBox), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "array<PhysicsQueryHit>@ OverlapAABB(const Float3 &in min, const Float3 &in max, "
+           "const PhysicsQueryFilter &in filter = PhysicsQueryFilter(), int maxhits = 32) "
+           "const",
+           asFUNCTION(PhysicalWorldOverlapAABBProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "array<PhysicsQueryHit>@ OverlapSphere(const Float3 &in center, float radius, "
+           "const PhysicsQueryFilter &in filter = PhysicsQueryFilter(), int maxhits = 32) "
+           "const",
+           asFUNCTION(PhysicalWorldOverlapSphereProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "array<PhysicsQueryHit>@ OverlapBox(const Float3 &in center, "
+           "const Float3 &in halfextents, const Float4 &in orientation = "
+           "Float4::IdentityQuaternion, const PhysicsQueryFilter &in filter = "
+           "PhysicsQueryFilter(), int maxhits = 32) const",
+           asFUNCTION(PhysicalWorldOverlapBoxProxy), asCALL_CDECL_OBJFIRST) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    return true;
+}
 } // namespace Leviathan
 // ------------------------------------ //
 bool Leviathan::BindPhysics(asIScriptEngine* engine)
@@ -168,9 +358,32 @@ bool Leviathan::BindPhysics(asIScriptEngine* engine)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
-    // ------------------------------------ //
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "PhysicsShape@ GetSharedSphere(float radius)",
+           asMETHOD(PhysicalWorld, GetSharedSphereWrapper), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "PhysicsShape@ GetSharedBox(float xdimension, float ydimension, float zdimension)",
+           asMETHOD(PhysicalWorld, GetSharedBoxWrapper), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
 
+    if(engine->RegisterFuncdef("void PhysicsContactCallback(PhysicalWorld@ world, "
+                               "PhysicsBody@ body1, PhysicsBody@ body2)") < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
 
+    if(engine->RegisterObjectMethod("PhysicalWorld",
+           "bool SetContactCallback(int material1, int material2, "
+           "PhysicsContactCallback@ callback)",
+           asMETHOD(PhysicalWorld, SetScriptContactCallback), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
+    if(!BindQueries(engine))
+        return false;
 
     return true;
 }
@@ -42,6 +42,11 @@ bool BindGameWorldBaseMethods(asIScriptEngine* engine, const char* classname)
         ANGELSCRIPT_REGISTERFAIL;
     }
 
+    if(engine->RegisterObjectMethod(classname, "SpatialIndex@ GetSpatialIndex()",
+           asMETHOD(WorldType, GetSpatialIndex), asCALL_THISCALL) < 0) {
+        ANGELSCRIPT_REGISTERFAIL;
+    }
+
     if(engine->RegisterObjectMethod(classname,
            "int GetPhysicalMaterial(const string &in name)",
            asMETHOD(WorldType, GetPhysicalMaterial), asCALL_THISCALL) < 0) {
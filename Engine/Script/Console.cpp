@@ -5,6 +5,7 @@
 #include "Iterators/StringIterator.h"
 #include "ScriptModule.h"
 #include "add_on/scripthelper/scripthelper.h"
+#include "utf8/checked.h"
 using namespace Leviathan;
 // ------------------------------------ //
 DLLEXPORT Leviathan::ScriptConsole::ScriptConsole() :
@@ -118,16 +119,29 @@ DLLEXPORT int Leviathan::ScriptConsole::RunConsoleCommand(std::string cmd)
         return CONSOLECOMMANDRESULTSTATE_FAILED;
     }
 
-    StringIterator itr(cmd);
+    StringIterator itr(std::make_unique<UTF8ViewDataIterator>(cmd));
 
-    if(itr.GetCharacter() == '>') {
-        // Skip first character since it is now handled //
-        itr.MoveToNext();
-    }
+    std::unique_ptr<std::string> ccmd;
+    std::unique_ptr<std::string> restofcommand;
+
+    // The iterator throws on invalid utf8 //
+    try {
+        if(itr.GetCharacter() == '>') {
+            // Skip first character since it is now handled //
+            itr.MoveToNext();
+        }
+
+        // get the console main command type //
+        ccmd = itr.GetNextCharacterSequence<std::string>(
+            UNNORMALCHARACTER_TYPE_LOWCODES | UNNORMALCHARACTER_TYPE_WHITESPACE);
+
+        restofcommand = itr.GetUntilEnd<std::string>();
 
-    // get the console main command type //
-    auto ccmd = itr.GetNextCharacterSequence<std::string>(
-        UNNORMALCHARACTER_TYPE_LOWCODES | UNNORMALCHARACTER_TYPE_WHITESPACE);
+    } catch(const utf8::exception&) {
+
+        ConsoleOutput("Invalid command format, command is not valid utf8");
+        return CONSOLECOMMANDRESULTSTATE_FAILED;
+    }
 
     // check if the length is too long or too short to actually be any specific command //
     CONSOLECOMMANDTYPE commandtype = CONSOLECOMMANDTYPE_NONE;
@@ -148,8 +162,6 @@ DLLEXPORT int Leviathan::ScriptConsole::RunConsoleCommand(std::string cmd)
         commandtype = CONSOLECOMMANDTYPE_ERROR;
     }
 
-    auto restofcommand = itr.GetUntilEnd<std::string>();
-
     if((!restofcommand || restofcommand->empty()) && commandtype == CONSOLECOMMANDTYPE_NONE) {
 
         restofcommand.swap(ccmd);
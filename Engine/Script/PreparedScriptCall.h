@@ -0,0 +1,273 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "ScriptExecutor.h"
+
+#include <utility>
+
+namespace Leviathan {
+
+//! \brief A script function whose signature has been verified for calls from the application
+//!
+//! RunScript and RunScriptMethod check the type of each argument against the script function
+//! on every call. This checks the types once when created so repeatedly calling a cached
+//! function only costs preparing a context, setting the arguments and executing.
+//! \note Unlike RunScript this doesn't convert arguments, the script function must take
+//! exactly the types in Args
+//! \code
+//! PreparedScriptCall<void(int32_t)> call(executor, func);
+//! if(call.IsValid())
+//!     call.Run(5);
+//! \endcode
+template<typename ReturnT, class... Args>
+class PreparedScriptCall<ReturnT(Args...)> {
+public:
+    PreparedScriptCall() = default;
+
+    //! \brief Verifies that func can be called with Args and returns ReturnT
+    //! \param printerrors If false a mismatching signature and errors while running aren't
+    //! printed
+    PreparedScriptCall(
+        ScriptExecutor* exec, asIScriptFunction* func, bool printerrors = true) :
+        Exec(exec)
+    {
+        Setup.SetPrintErrors(printerrors);
+
+        if(!Exec || !func)
+            return;
+
+        Setup.Entryfunction = func->GetName();
+
+        if(!_VerifySignature(func, std::index_sequence_for<Args...>()))
+            return;
+
+        Func = func;
+        Func->AddRef();
+    }
+
+    ~PreparedScriptCall()
+    {
+        if(Func)
+            Func->Release();
+    }
+
+    PreparedScriptCall(PreparedScriptCall&& other) :
+        Exec(other.Exec), Func(other.Func), Setup(std::move(other.Setup))
+    {
+        other.Func = nullptr;
+    }
+
+    PreparedScriptCall(const PreparedScriptCall& other) = delete;
+    PreparedScriptCall& operator=(const PreparedScriptCall& other) = delete;
+
+    //! \returns True if the function was verified and can be ran
+    inline bool IsValid() const
+    {
+        return Func != nullptr;
+    }
+
+    inline asIScriptFunction* GetFunction() const
+    {
+        return Func;
+    }
+
+    //! \brief Runs a global function
+    ScriptRunResult<ReturnT> Run(const Args&... args)
+    {
+        return _Run(nullptr, args...);
+    }
+
+    //! \brief Runs a method on obj
+    //! \note The caller is responsible for making sure that the function is part of the class
+    //! of obj
+    ScriptRunResult<ReturnT> RunMethod(void* obj, const Args&... args)
+    {
+        if(!obj)
+            return ScriptRunResult<ReturnT>(SCRIPT_RUN_RESULT::Error);
+
+        return _Run(obj, args...);
+    }
+
+private:
+    ScriptRunResult<ReturnT> _Run(void* obj, const Args&... args)
+    {
+        if(!Func)
+            return ScriptRunResult<ReturnT>(SCRIPT_RUN_RESULT::Error);
+
+        asIScriptContext* scriptContext = Exec->_GetContextForExecution(true);
+
+        if(!scriptContext) {
+            LOG_ERROR("PreparedScriptCall: failed to get a context for running");
+            return ScriptRunResult<ReturnT>(SCRIPT_RUN_RESULT::Error);
+        }
+
+        if(scriptContext->Prepare(Func) < 0 || !_PassArguments(scriptContext, 0, args...) ||
+            (obj && scriptContext->SetObject(obj) < 0)) {
+
+            LOG_ERROR("PreparedScriptCall: failed to prepare context for: " +
+                      std::string(Func->GetDeclaration()));
+            Exec->_DoneWithContext(scriptContext);
+            return ScriptRunResult<ReturnT>(SCRIPT_RUN_RESULT::Error);
+        }
+
+        const int retcode = scriptContext->Execute();
+
+        // The module is only needed for printing errors //
+        std::shared_ptr<ScriptModule> module;
+
+        if(retcode != asEXECUTION_FINISHED)
+            module = Exec->GetScriptModuleByFunction(Func, Setup.PrintErrors);
+
+        auto returnvalue = Exec->template _HandleEndedScriptExecution<ReturnT>(
+            retcode, scriptContext, Setup, Func, module.get());
+
+        Exec->_DoneWithContext(scriptContext);
+        return returnvalue;
+    }
+
+    //! \brief Passes arguments without type checks, the types were checked by
+    //! _VerifySignature
+    template<class CurrentT, class... Rest>
+    static bool _PassArguments(asIScriptContext* scriptcontext, asUINT i,
+        const CurrentT& current, const Rest&... rest)
+    {
+        int r;
+
+        if constexpr(std::is_same_v<CurrentT, int32_t> || std::is_same_v<CurrentT, uint32_t>) {
+
+            r = scriptcontext->SetArgDWord(i, current);
+        } else if constexpr(std::is_same_v<CurrentT, int64_t> ||
+                            std::is_same_v<CurrentT, uint64_t>) {
+
+            r = scriptcontext->SetArgQWord(i, current);
+        } else if constexpr(std::is_same_v<CurrentT, int16_t> ||
+                            std::is_same_v<CurrentT, uint16_t>) {
+
+            r = scriptcontext->SetArgWord(i, current);
+        } else if constexpr(std::is_same_v<CurrentT, float>) {
+
+            r = scriptcontext->SetArgFloat(i, current);
+        } else if constexpr(std::is_same_v<CurrentT, double>) {
+
+            r = scriptcontext->SetArgDouble(i, current);
+        } else if constexpr(std::is_same_v<CurrentT, char> ||
+                            std::is_same_v<CurrentT, int8_t> ||
+                            std::is_same_v<CurrentT, uint8_t> ||
+                            std::is_same_v<CurrentT, bool>) {
+
+            r = scriptcontext->SetArgByte(i, current);
+        } else if constexpr(std::is_pointer_v<CurrentT>) {
+
+            IncrementRefCountIfRefCountedType(current);
+
+            r = scriptcontext->SetArgAddress(
+                i, const_cast<std::add_pointer_t<
+                       std::remove_const_t<std::remove_pointer_t<CurrentT>>>>(current));
+        } else {
+
+            static_assert(std::is_class_v<CurrentT>,
+                "Tried to pass some very weird type to a script function");
+
+            static_assert(!std::is_base_of_v<CurrentT, ReferenceCounted>,
+                "Trying to pass an object of reference type by value to script, call new "
+                "on the argument");
+
+            // _VerifySignature made sure that this is taken as a const reference or by value
+            r = scriptcontext->SetArgObject(i, const_cast<CurrentT*>(&current));
+        }
+
+        if(r < 0)
+            return false;
+
+        return _PassArguments(scriptcontext, i + 1, rest...);
+    }
+
+    static bool _PassArguments(asIScriptContext* scriptcontext, asUINT i)
+    {
+        return true;
+    }
+
+    template<size_t... Indexes>
+    bool _VerifySignature(asIScriptFunction* func, std::index_sequence<Indexes...>)
+    {
+        if(func->GetParamCount() != sizeof...(Args)) {
+
+            if(Setup.PrintErrors) {
+                LOG_ERROR("PreparedScriptCall: script function: " +
+                          std::string(func->GetDeclaration()) + " takes " +
+                          std::to_string(func->GetParamCount()) +
+                          " parameters but application passes " +
+                          std::to_string(sizeof...(Args)));
+            }
+
+            return false;
+        }
+
+        if(!(_VerifyParameter<Args>(func, static_cast<asUINT>(Indexes)) && ...))
+            return false;
+
+        if constexpr(!std::is_void_v<ReturnT> &&
+                     !CanTypeRepresentAngelScriptTypes<ReturnT>()) {
+
+            const auto wanted = AngelScriptTypeIDResolver<ReturnT>::Get(Exec);
+
+            if(func->GetReturnTypeId() != wanted) {
+
+                Exec->_DoReceiveParameterTypeError(
+                    Setup, nullptr, wanted, func->GetReturnTypeId());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<class CurrentT>
+    bool _VerifyParameter(asIScriptFunction* func, asUINT i)
+    {
+        int wantedTypeID;
+        asDWORD flags;
+        if(func->GetParam(i, &wantedTypeID, &flags) < 0)
+            return false;
+
+        const auto parameterType = AngelScriptTypeIDResolver<CurrentT>::Get(Exec);
+
+        // Allow taking a non-const object into the script as a const object
+        if(wantedTypeID != parameterType &&
+            (!(wantedTypeID & asTYPEID_HANDLETOCONST) ||
+                (parameterType | asTYPEID_HANDLETOCONST) != wantedTypeID)) {
+
+            return Exec->_DoPassParameterTypeError(
+                Setup, nullptr, i, wantedTypeID, parameterType);
+        }
+
+        if constexpr(std::is_class_v<CurrentT>) {
+
+            if((flags & asTM_OUTREF) || ((flags & asTM_INREF) && !(flags & asTM_CONST))) {
+
+                if(Setup.PrintErrors) {
+                    LOG_ERROR("PreparedScriptCall: script wants to take parameter: " +
+                              std::to_string(i) +
+                              " as an outref or non-const inref which isn't supported, "
+                              "for func: " +
+                              func->GetName());
+                }
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    ScriptExecutor* Exec = nullptr;
+    asIScriptFunction* Func = nullptr;
+
+    //! Passed to the error handling shared with ScriptExecutor
+    ScriptRunningSetup Setup;
+};
+
+} // namespace Leviathan
@@ -0,0 +1,420 @@
+// ------------------------------------ //
+#include "ScriptBytecodeCache.h"
+
+#include "FileSystem.h"
+#include "Utility/MD5Generator.h"
+#include "Utility/MemoryMappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+using namespace Leviathan;
+// ------------------------------------ //
+namespace {
+
+constexpr char CACHE_MAGIC[4] = {'L', 'A', 'S', 'B'};
+
+//! Increment when the layout of the cache files changes
+constexpr uint32_t CACHE_FORMAT_VERSION = 1;
+
+struct CacheHeader {
+    char Magic[4];
+    uint32_t Version;
+
+    //! MD5 hex digest of the key
+    char Key[32];
+
+    uint32_t MetadataSize;
+    uint32_t BytecodeSize;
+};
+
+//! \brief Reads AngelScript bytecode from a memory range
+class BytecodeReader final : public asIBinaryStream {
+public:
+    BytecodeReader(const char* data, size_t length) : Data(data), Length(length) {}
+
+    int Read(void* ptr, asUINT size) override
+    {
+        if(size > Length - Position)
+            return -1;
+
+        std::memcpy(ptr, Data + Position, size);
+        Position += size;
+        return 0;
+    }
+
+    int Write(const void* ptr, asUINT size) override
+    {
+        return -1;
+    }
+
+private:
+    const char* const Data;
+    const size_t Length;
+    size_t Position = 0;
+};
+
+//! \brief Appends AngelScript bytecode to a string
+class BytecodeWriter final : public asIBinaryStream {
+public:
+    BytecodeWriter(std::string& receiver) : Receiver(receiver) {}
+
+    int Read(void* ptr, asUINT size) override
+    {
+        return -1;
+    }
+
+    int Write(const void* ptr, asUINT size) override
+    {
+        Receiver.append(static_cast<const char*>(ptr), size);
+        return 0;
+    }
+
+private:
+    std::string& Receiver;
+};
+
+void WriteUInt32(std::string& receiver, uint32_t value)
+{
+    receiver.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string& receiver, const std::string& str)
+{
+    WriteUInt32(receiver, static_cast<uint32_t>(str.size()));
+    receiver.append(str);
+}
+
+bool ReadUInt32(const char* data, size_t length, size_t& position, uint32_t& value)
+{
+    if(sizeof(value) > length - position)
+        return false;
+
+    std::memcpy(&value, data + position, sizeof(value));
+    position += sizeof(value);
+    return true;
+}
+
+bool ReadString(const char* data, size_t length, size_t& position, std::string& str)
+{
+    uint32_t size;
+    if(!ReadUInt32(data, length, position, size) || size > length - position)
+        return false;
+
+    str.assign(data + position, size);
+    position += size;
+    return true;
+}
+
+void AddToHash(MD5& hash, const std::string& str)
+{
+    hash.update(str.c_str(), static_cast<MD5::size_type>(str.size()));
+    hash.update("\n", 1);
+}
+
+void AddToHash(MD5& hash, const char* str)
+{
+    AddToHash(hash, std::string(str ? str : ""));
+}
+
+void AddFunctionToHash(MD5& hash, asIScriptFunction* func)
+{
+    if(!func) {
+        AddToHash(hash, "null");
+        return;
+    }
+
+    AddToHash(hash, func->GetDeclaration(true, true, true));
+    AddToHash(hash, std::to_string(func->GetAccessMask()));
+}
+
+} // namespace
+// ------------------------------------ //
+DLLEXPORT ScriptBytecodeCache::ScriptBytecodeCache(const std::string& folder) : Folder(folder)
+{}
+// ------------------------------------ //
+DLLEXPORT void ScriptBytecodeCache::StartKey(
+    MD5& key, asIScriptEngine* engine, AccessFlags accessmask)
+{
+    AddToHash(key, std::to_string(CACHE_FORMAT_VERSION));
+    AddToHash(key, ANGELSCRIPT_VERSION_STRING);
+
+#ifdef LEVIATHAN_VERSION
+    AddToHash(key, VERSIONS);
+#endif // LEVIATHAN_VERSION
+
+    AddToHash(key, std::to_string(accessmask));
+
+    GUARD_LOCK();
+
+    const auto counts = GetInterfaceCounts(engine);
+
+    if(InterfaceHashEngine != engine || InterfaceHashCounts != counts) {
+
+        InterfaceHash = CalculateInterfaceHash(engine);
+        InterfaceHashCounts = counts;
+        InterfaceHashEngine = engine;
+    }
+
+    AddToHash(key, InterfaceHash);
+}
+
+DLLEXPORT void ScriptBytecodeCache::AddSourceToKey(
+    MD5& key, const std::string& section, int line, const char* code, size_t length)
+{
+    AddToHash(key, section);
+    AddToHash(key, std::to_string(line));
+    AddToHash(key, std::to_string(length));
+    key.update(code, static_cast<MD5::size_type>(length));
+}
+// ------------------------------------ //
+DLLEXPORT std::string ScriptBytecodeCache::GetCacheFile(
+    const std::string& modulename, const std::string& source) const
+{
+    return Folder + MD5(modulename + "\n" + source).hexdigest() + ".asbc";
+}
+// ------------------------------------ //
+DLLEXPORT std::unique_ptr<MemoryMappedFile> ScriptBytecodeCache::Find(
+    const std::string& file, const std::string& key) const
+{
+    auto entry = std::make_unique<MemoryMappedFile>(file);
+
+    if(!entry->IsValid() || entry->GetSize() < sizeof(CacheHeader))
+        return nullptr;
+
+    CacheHeader header;
+    std::memcpy(&header, entry->GetData(), sizeof(header));
+
+    if(std::memcmp(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.Version != CACHE_FORMAT_VERSION)
+        return nullptr;
+
+    if(key.size() != sizeof(header.Key) ||
+        std::memcmp(header.Key, key.data(), sizeof(header.Key)) != 0)
+        return nullptr;
+
+    // Detect truncated files //
+    if(static_cast<uint64_t>(header.MetadataSize) + header.BytecodeSize !=
+        entry->GetSize() - sizeof(CacheHeader))
+        return nullptr;
+
+    return entry;
+}
+
+DLLEXPORT bool ScriptBytecodeCache::Load(const MemoryMappedFile& entry,
+    asIScriptModule* module, FunctionMetadata& metadata) const
+{
+    CacheHeader header;
+    std::memcpy(&header, entry.GetData(), sizeof(header));
+
+    const char* data = entry.GetData() + sizeof(CacheHeader);
+    const size_t length = header.MetadataSize;
+    size_t position = 0;
+
+    metadata.clear();
+
+    uint32_t count;
+    if(!ReadUInt32(data, length, position, count))
+        return false;
+
+    for(uint32_t i = 0; i < count; ++i) {
+
+        std::string declaration;
+        uint32_t entries;
+
+        if(!ReadString(data, length, position, declaration) ||
+            !ReadUInt32(data, length, position, entries))
+            return false;
+
+        auto& target = metadata[declaration];
+
+        for(uint32_t j = 0; j < entries; ++j) {
+
+            std::string str;
+            if(!ReadString(data, length, position, str))
+                return false;
+
+            target.push_back(std::move(str));
+        }
+    }
+
+    BytecodeReader reader(data + header.MetadataSize, header.BytecodeSize);
+
+    if(module->LoadByteCode(&reader) < 0) {
+
+        LOG_WARNING("ScriptBytecodeCache: AngelScript failed to load bytecode from: " +
+                    entry.GetFile());
+        metadata.clear();
+        return false;
+    }
+
+    return true;
+}
+// ------------------------------------ //
+DLLEXPORT bool ScriptBytecodeCache::Store(const std::string& file, const std::string& key,
+    asIScriptModule* module, const FunctionMetadata& metadata)
+{
+    std::string data(sizeof(CacheHeader), '\0');
+
+    WriteUInt32(data, static_cast<uint32_t>(metadata.size()));
+
+    for(const auto& entry : metadata) {
+
+        WriteString(data, entry.first);
+        WriteUInt32(data, static_cast<uint32_t>(entry.second.size()));
+
+        for(const auto& str : entry.second)
+            WriteString(data, str);
+    }
+
+    const size_t metadataSize = data.size() - sizeof(CacheHeader);
+
+    // Debug info is kept to have line numbers in script errors //
+    BytecodeWriter writer(data);
+
+    if(module->SaveByteCode(&writer, false) < 0) {
+
+        LOG_WARNING("ScriptBytecodeCache: failed to save bytecode of module: " +
+                    std::string(module->GetName()));
+        return false;
+    }
+
+    if(key.size() != sizeof(CacheHeader::Key)) {
+        LOG_ERROR("ScriptBytecodeCache: Store: invalid key: " + key);
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.Version = CACHE_FORMAT_VERSION;
+    std::memcpy(header.Key, key.data(), sizeof(header.Key));
+    header.MetadataSize = static_cast<uint32_t>(metadataSize);
+    header.BytecodeSize = static_cast<uint32_t>(data.size() - sizeof(CacheHeader) - metadataSize);
+
+    std::memcpy(&data[0], &header, sizeof(header));
+
+    GUARD_LOCK();
+
+    std::error_code error;
+    std::filesystem::create_directories(Folder, error);
+
+    // Written to a temporary file first to not leave behind a partially written entry //
+    const auto temporary = file + ".tmp";
+
+    if(!error && FileSystem::WriteToFile(data, temporary))
+        std::filesystem::rename(temporary, file, error);
+    else
+        error = std::make_error_code(std::errc::io_error);
+
+    if(error) {
+
+        if(!StoreFailed) {
+            LOG_WARNING("ScriptBytecodeCache: failed to write cache file: " + file +
+                        ", script bytecode won't be cached");
+            StoreFailed = true;
+        }
+
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    return true;
+}
+// ------------------------------------ //
+DLLEXPORT std::string ScriptBytecodeCache::CalculateInterfaceHash(asIScriptEngine* engine)
+{
+    MD5 hash;
+
+    for(int property = 1; property < asEP_LAST_PROPERTY; ++property) {
+        AddToHash(hash,
+            std::to_string(engine->GetEngineProperty(static_cast<asEEngineProp>(property))));
+    }
+
+    for(asUINT i = 0; i < engine->GetGlobalFunctionCount(); ++i)
+        AddFunctionToHash(hash, engine->GetGlobalFunctionByIndex(i));
+
+    for(asUINT i = 0; i < engine->GetGlobalPropertyCount(); ++i) {
+
+        const char* name = nullptr;
+        const char* nameSpace = nullptr;
+        int typeId = 0;
+        bool isConst = false;
+        asDWORD accessMask = 0;
+
+        engine->GetGlobalPropertyByIndex(
+            i, &name, &nameSpace, &typeId, &isConst, nullptr, nullptr, &accessMask);
+
+        AddToHash(hash, nameSpace);
+        AddToHash(hash, name);
+        AddToHash(hash, engine->GetTypeDeclaration(typeId, true));
+        AddToHash(hash, std::to_string(isConst) + " " + std::to_string(accessMask));
+    }
+
+    for(asUINT i = 0; i < engine->GetObjectTypeCount(); ++i) {
+
+        asITypeInfo* type = engine->GetObjectTypeByIndex(i);
+
+        AddToHash(hash, type->GetNamespace());
+        AddToHash(hash, type->GetName());
+        AddToHash(hash, std::to_string(type->GetFlags()) + " " +
+                            std::to_string(type->GetSize()) + " " +
+                            std::to_string(type->GetAccessMask()));
+
+        for(asUINT j = 0; j < type->GetFactoryCount(); ++j)
+            AddFunctionToHash(hash, type->GetFactoryByIndex(j));
+
+        for(asUINT j = 0; j < type->GetBehaviourCount(); ++j) {
+
+            asEBehaviours behaviour;
+            asIScriptFunction* func = type->GetBehaviourByIndex(j, &behaviour);
+
+            AddToHash(hash, std::to_string(behaviour));
+            AddFunctionToHash(hash, func);
+        }
+
+        for(asUINT j = 0; j < type->GetMethodCount(); ++j)
+            AddFunctionToHash(hash, type->GetMethodByIndex(j, false));
+
+        for(asUINT j = 0; j < type->GetPropertyCount(); ++j)
+            AddToHash(hash, type->GetPropertyDeclaration(j, true));
+    }
+
+    for(asUINT i = 0; i < engine->GetEnumCount(); ++i) {
+
+        asITypeInfo* type = engine->GetEnumByIndex(i);
+
+        AddToHash(hash, type->GetNamespace());
+        AddToHash(hash, type->GetName());
+
+        for(asUINT j = 0; j < type->GetEnumValueCount(); ++j) {
+
+            int value = 0;
+            const char* name = type->GetEnumValueByIndex(j, &value);
+
+            AddToHash(hash, std::string(name ? name : "") + "=" + std::to_string(value));
+        }
+    }
+
+    for(asUINT i = 0; i < engine->GetFuncdefCount(); ++i) {
+
+        asITypeInfo* type = engine->GetFuncdefByIndex(i);
+        AddFunctionToHash(hash, type->GetFuncdefSignature());
+    }
+
+    for(asUINT i = 0; i < engine->GetTypedefCount(); ++i) {
+
+        asITypeInfo* type = engine->GetTypedefByIndex(i);
+
+        AddToHash(hash, type->GetNamespace());
+        AddToHash(hash, type->GetName());
+        AddToHash(hash, engine->GetTypeDeclaration(type->GetTypedefTypeId(), true));
+    }
+
+    return hash.finalize().hexdigest();
+}
+
+std::vector<asUINT> ScriptBytecodeCache::GetInterfaceCounts(asIScriptEngine* engine)
+{
+    return {engine->GetGlobalFunctionCount(), engine->GetGlobalPropertyCount(),
+        engine->GetObjectTypeCount(), engine->GetEnumCount(), engine->GetFuncdefCount(),
+        engine->GetTypedefCount()};
+}
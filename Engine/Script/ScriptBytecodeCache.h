@@ -0,0 +1,93 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include "AccessMask.h"
+#include "Common/ThreadSafe.h"
+
+#include "angelscript.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Leviathan {
+
+class MD5;
+class MemoryMappedFile;
+
+//! \brief On-disk cache of built script modules
+//!
+//! A cache entry is the saved bytecode of a module and the function metadata that
+//! CScriptBuilder found while preprocessing (metadata isn't part of the bytecode). Entries
+//! are identified by a key which is a hash of all the resolved source sections of the module,
+//! the engine and AngelScript versions and the registered script interface. A stale entry is
+//! just ignored and overwritten when the module is next built.
+class ScriptBytecodeCache : public ThreadSafe {
+public:
+    //! Function declaration to its metadata entries
+    using FunctionMetadata = std::map<std::string, std::vector<std::string>>;
+
+    //! \param folder Where the cache files are stored, created when first needed
+    DLLEXPORT ScriptBytecodeCache(const std::string& folder);
+
+    //! \brief Starts calculating a cache key
+    //!
+    //! Adds the versions and the current script interface of engine to key. The sources
+    //! should be added after this with AddSourceToKey
+    DLLEXPORT void StartKey(MD5& key, asIScriptEngine* engine, AccessFlags accessmask);
+
+    //! \brief Adds a source section to a key
+    DLLEXPORT static void AddSourceToKey(
+        MD5& key, const std::string& section, int line, const char* code, size_t length);
+
+    //! \returns The cache file a module is stored in
+    DLLEXPORT std::string GetCacheFile(
+        const std::string& modulename, const std::string& source) const;
+
+    //! \brief Opens a cache file if it exists and matches key
+    //! \returns Null if there's no usable entry
+    DLLEXPORT std::unique_ptr<MemoryMappedFile> Find(
+        const std::string& file, const std::string& key) const;
+
+    //! \brief Loads an entry found with Find into an empty module
+    //! \returns False if AngelScript couldn't load the bytecode. The module needs to be
+    //! recreated after this fails
+    DLLEXPORT bool Load(const MemoryMappedFile& entry, asIScriptModule* module,
+        FunctionMetadata& metadata) const;
+
+    //! \brief Saves a built module
+    DLLEXPORT bool Store(const std::string& file, const std::string& key,
+        asIScriptModule* module, const FunctionMetadata& metadata);
+
+    //! \brief Calculates a hash of everything that is registered in engine
+    //!
+    //! Bytecode refers to the registered types and functions so it is only valid if they
+    //! haven't changed since it was saved
+    DLLEXPORT static std::string CalculateInterfaceHash(asIScriptEngine* engine);
+
+    inline const std::string& GetFolder() const
+    {
+        return Folder;
+    }
+
+protected:
+    //! \returns A cheap identifier for the amount of registered things in engine. Used to
+    //! detect registering new things after the interface hash has been calculated
+    static std::vector<asUINT> GetInterfaceCounts(asIScriptEngine* engine);
+
+protected:
+    const std::string Folder;
+
+    //! Cached result of CalculateInterfaceHash
+    std::string InterfaceHash;
+    std::vector<asUINT> InterfaceHashCounts;
+    asIScriptEngine* InterfaceHashEngine = nullptr;
+
+    //! Set when the cache folder can't be written, to only print one warning
+    bool StoreFailed = false;
+};
+
+} // namespace Leviathan
@@ -4,6 +4,7 @@
 #include "AccessMask.h"
 #include "Application/Application.h"
 #include "Iterators/StringIterator.h"
+#include "ScriptBytecodeCache.h"
 #include "ScriptModule.h"
 #include "ScriptNotifiers.h"
 
@@ -30,7 +31,66 @@
 
 // Exception support
 
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+
 using namespace Leviathan;
+
+//! Contexts above this are released instead of being kept for reuse
+constexpr size_t MAX_POOLED_CONTEXTS_PER_THREAD = 128;
+
+namespace {
+
+//! \brief The context pool of the current thread for the last used ScriptExecutor
+//!
+//! Avoids searching ScriptExecutor::ThreadContextPools on every script call
+struct ThreadContextPoolCache {
+
+    uint64_t ExecutorID = 0;
+    void* Pool = nullptr;
+};
+
+thread_local ThreadContextPoolCache CurrentThreadPool;
+
+//! \brief Releases the context pools of a thread when it exits
+//!
+//! Without this the contexts of worker threads that have exited would be kept until the
+//! ScriptExecutor is destroyed
+struct ThreadContextPoolReleaser {
+
+    using ReleaseCallback = void (*)(void* pools, std::thread::id thread);
+
+    ~ThreadContextPoolReleaser()
+    {
+        const auto thread = std::this_thread::get_id();
+
+        for(const auto& [owner, release] : Owners) {
+
+            // The executor may already be gone
+            if(const auto pools = owner.lock())
+                release(pools.get(), thread);
+        }
+    }
+
+    void Add(std::weak_ptr<void> owner, ReleaseCallback release)
+    {
+        // Executors that no longer exist don't need to be remembered //
+        Owners.erase(std::remove_if(Owners.begin(), Owners.end(),
+                         [](const auto& entry) { return std::get<0>(entry).expired(); }),
+            Owners.end());
+
+        Owners.emplace_back(std::move(owner), release);
+    }
+
+    std::vector<std::tuple<std::weak_ptr<void>, ReleaseCallback>> Owners;
+};
+
+thread_local ThreadContextPoolReleaser ThreadExitReleaser;
+
+std::atomic<uint64_t> NextExecutorID{0};
+
+} // namespace
 // ------------------------------------ //
 namespace Leviathan {
 
@@ -108,7 +168,9 @@ void ReturnContextCallback(asIScriptEngine* engine, asIScriptContext* context, v
 
 } // namespace Leviathan
 
-ScriptExecutor::ScriptExecutor() : engine(nullptr), AllocatedScriptModules()
+ScriptExecutor::ScriptExecutor() :
+    engine(nullptr), AllocatedScriptModules(),
+    ThreadContextPools(std::make_shared<ThreadContextPoolList>()), ExecutorID(++NextExecutorID)
 {
 
     instance = this;
@@ -242,12 +304,18 @@ ScriptExecutor::~ScriptExecutor()
         AllocatedScriptModules.clear();
     }
 
-    // Release all context objects
-    for(asIScriptContext* context : ContextPool) {
-        context->Release();
-    }
+    // Release all context objects. No thread may be running scripts anymore at this point
+    {
+        Lock lock(ThreadContextPools->Lock);
 
-    ContextPool.clear();
+        for(const auto& pool : ThreadContextPools->Pools) {
+            for(asIScriptContext* context : pool->Contexts) {
+                context->Release();
+            }
+        }
+
+        ThreadContextPools->Pools.clear();
+    }
 
     // release AngelScript //
     if(engine) {
@@ -266,6 +334,15 @@ DLLEXPORT ScriptExecutor* Leviathan::ScriptExecutor::Get()
 
 ScriptExecutor* Leviathan::ScriptExecutor::instance = nullptr;
 // ------------------------------------ //
+DLLEXPORT void ScriptExecutor::SetBytecodeCacheFolder(const std::string& folder)
+{
+    if(folder.empty()) {
+        BytecodeCache.reset();
+    } else {
+        BytecodeCache = std::make_unique<ScriptBytecodeCache>(folder);
+    }
+}
+// ------------------------------------ //
 DLLEXPORT asIScriptFunction* ScriptExecutor::GetFunctionFromModule(
     ScriptModule* module, ScriptRunningSetup& parameters)
 {
@@ -454,16 +531,24 @@ DLLEXPORT bool Leviathan::ScriptExecutor::_PrepareContextForPassingParameters(
 }
 
 // ------------------------------------ //
-DLLEXPORT asIScriptContext* Leviathan::ScriptExecutor::_GetContextForExecution()
+DLLEXPORT asIScriptContext* Leviathan::ScriptExecutor::_GetContextForExecution(
+    bool allownested /*= false*/)
 {
-    // TODO: check for recursive call
+    if(allownested) {
 
-    Lock guard(ContextPoolLock);
+        // Called from a script, the running context can be used without preparing a new one
+        asIScriptContext* active = asGetActiveContext();
+
+        if(active && active->GetEngine() == engine && active->PushState() >= 0)
+            return active;
+    }
 
     // Get from pool if possible
-    if(!ContextPool.empty()) {
-        auto* ptr = ContextPool.back();
-        ContextPool.pop_back();
+    ThreadContextPool& pool = _GetThreadContextPool();
+
+    if(!pool.Contexts.empty()) {
+        auto* ptr = pool.Contexts.back();
+        pool.Contexts.pop_back();
         return ptr;
     }
 
@@ -481,12 +566,20 @@ DLLEXPORT asIScriptContext* Leviathan::ScriptExecutor::_GetContextForExecution()
 
 DLLEXPORT void Leviathan::ScriptExecutor::_DoneWithContext(asIScriptContext* context)
 {
-    Lock guard(ContextPoolLock);
+    // Nested call in a context that is still running the calling script
+    if(context->IsNested()) {
+
+        if(context->PopState() < 0)
+            LOG_ERROR("ScriptExecutor: _DoneWithContext: failed to restore nested context");
+        return;
+    }
 
-    // Only keep 1000 contexts at most
-    if(ContextPool.size() < 1000) {
+    ThreadContextPool& pool = _GetThreadContextPool();
 
-        ContextPool.push_back(context);
+    // Only keep a limited number of contexts per thread
+    if(pool.Contexts.size() < MAX_POOLED_CONTEXTS_PER_THREAD) {
+
+        pool.Contexts.push_back(context);
         context->Unprepare();
 
     } else {
@@ -494,6 +587,64 @@ DLLEXPORT void Leviathan::ScriptExecutor::_DoneWithContext(asIScriptContext* con
         context->Release();
     }
 }
+
+ScriptExecutor::ThreadContextPool& ScriptExecutor::_GetThreadContextPool()
+{
+    if(CurrentThreadPool.ExecutorID == ExecutorID)
+        return *static_cast<ThreadContextPool*>(CurrentThreadPool.Pool);
+
+    // This thread has last used some other executor or this is the first use //
+    const auto thread = std::this_thread::get_id();
+
+    Lock guard(ThreadContextPools->Lock);
+
+    ThreadContextPool* found = nullptr;
+
+    for(const auto& pool : ThreadContextPools->Pools) {
+        if(pool->Thread == thread) {
+            found = pool.get();
+            break;
+        }
+    }
+
+    if(!found) {
+
+        ThreadContextPools->Pools.push_back(std::make_unique<ThreadContextPool>());
+        found = ThreadContextPools->Pools.back().get();
+        found->Thread = thread;
+
+        ThreadExitReleaser.Add(ThreadContextPools, &ScriptExecutor::_ReleaseThreadContextPool);
+    }
+
+    CurrentThreadPool.ExecutorID = ExecutorID;
+    CurrentThreadPool.Pool = found;
+    return *found;
+}
+
+DLLEXPORT size_t ScriptExecutor::GetThreadContextPoolCount()
+{
+    Lock guard(ThreadContextPools->Lock);
+    return ThreadContextPools->Pools.size();
+}
+
+void ScriptExecutor::_ReleaseThreadContextPool(void* pools, std::thread::id thread)
+{
+    auto& list = *static_cast<ThreadContextPoolList*>(pools);
+
+    Lock guard(list.Lock);
+
+    for(auto iter = list.Pools.begin(); iter != list.Pools.end(); ++iter) {
+
+        if((*iter)->Thread != thread)
+            continue;
+
+        for(asIScriptContext* context : (*iter)->Contexts)
+            context->Release();
+
+        list.Pools.erase(iter);
+        return;
+    }
+}
 // ------------------------------------ //
 DLLEXPORT std::weak_ptr<ScriptModule> Leviathan::ScriptExecutor::GetModule(const int& ID)
 {
@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 // angelscript //
@@ -27,6 +28,10 @@
 namespace Leviathan {
 
 class ScriptExecutor;
+class ScriptBytecodeCache;
+
+template<class Signature>
+class PreparedScriptCall;
 
 //! \brief Contains data for script runs where arguments are passed manually
 //! \note This isn't the recommended way if the normal single function call script running can
@@ -55,6 +60,8 @@ private:
 //! \brief Handles ScriptModule creation and AngelScript code execution
 class ScriptExecutor {
     friend CustomScriptRun;
+    template<class Signature>
+    friend class PreparedScriptCall;
     friend asIScriptContext* RequestContextCallback(asIScriptEngine* engine, void* userdata);
     friend void ReturnContextCallback(
         asIScriptEngine* engine, asIScriptContext* context, void* userdata);
@@ -73,11 +80,25 @@ public:
     DLLEXPORT std::weak_ptr<ScriptModule> GetModule(const int& ID);
     DLLEXPORT std::weak_ptr<ScriptModule> GetModuleByAngelScriptName(const char* nameofmodule);
 
+    //! \brief Sets the folder where built modules are cached
+    //! \param folder The folder, or empty to disable the cache. The cache is disabled by
+    //! default, Engine enables it in the Cache/Scripts/ folder in the data folder unless
+    //! CacheScriptBytecode is false in the configuration
+    DLLEXPORT void SetBytecodeCacheFolder(const std::string& folder);
+
+    //! \returns The cache of built modules or null if disabled
+    DLLEXPORT inline ScriptBytecodeCache* GetBytecodeCache()
+    {
+        return BytecodeCache.get();
+    }
+
     //! \brief Runs a function in a script
     //! \note This is the recommended way to run scripts (other than GameModule that has its
     //! own method)
-    //! \todo Allow recursive calls and more context reuse. Also wrap context in an object that
-    //! automatically returns it in case of expections (_HandleEndedScriptExecution can throw)
+    //! \note Can be called from a script called by the application. Such nested calls reuse
+    //! the calling context
+    //! \todo Wrap context in an object that automatically returns it in case of expections
+    //! (_HandleEndedScriptExecution can throw)
     //! \todo Also make all the script module using functions automatically get it if they need
     //! for error reporting
     template<typename ReturnT, class... Args>
@@ -108,7 +129,7 @@ public:
 
 
         // Create a running context for the function //
-        asIScriptContext* scriptContext = _GetContextForExecution();
+        asIScriptContext* scriptContext = _GetContextForExecution(true);
 
         if(!scriptContext) {
             // Should this be fatal?
@@ -164,7 +185,7 @@ public:
             GetScriptModuleByFunction(func, parameters.PrintErrors);
 
         // Create a running context for the function //
-        asIScriptContext* scriptContext = _GetContextForExecution();
+        asIScriptContext* scriptContext = _GetContextForExecution(true);
 
         if(!scriptContext) {
             // Should this be fatal?
@@ -277,6 +298,9 @@ public:
         return engine;
     }
 
+    //! \returns The number of threads that have a pool of contexts
+    DLLEXPORT size_t GetThreadContextPoolCount();
+
     //! \brief Does a full garbage collection cycle
     DLLEXPORT void CollectGarbage();
 
@@ -829,13 +853,47 @@ private:
 
 protected:
     //! \brief Called when a context is required for script execution
-    //! \todo Allow recursive calls
-    DLLEXPORT asIScriptContext* _GetContextForExecution();
+    //!
+    //! Contexts are taken from a pool of the calling thread so this doesn't need locking
+    //! \param allownested If true and this is called from a script running with this engine,
+    //! the state of the running context is pushed and it is returned for a nested call. Only
+    //! calls that are executed and finished before the calling script continues (in the
+    //! reverse order of starting) may use this
+    DLLEXPORT asIScriptContext* _GetContextForExecution(bool allownested = false);
 
     //! \brief Called after a script has been executed and the context is no longer needed
+    //!
+    //! Restores the previous state of a context used for a nested call, other contexts are
+    //! returned to the pool of the calling thread
     //! \note Also called from CustomScriptRun
     DLLEXPORT void _DoneWithContext(asIScriptContext* context);
 
+    //! \brief Contexts that have been created for a single thread
+    struct ThreadContextPool {
+
+        std::thread::id Thread;
+        std::vector<asIScriptContext*> Contexts;
+    };
+
+    //! \brief The pools of all threads
+    //!
+    //! This is shared with the threads that have a pool so that they can release their pool
+    //! when they exit, even if that happens after this executor is destroyed
+    struct ThreadContextPoolList {
+
+        //! Must be locked when touching Pools
+        Mutex Lock;
+        std::vector<std::unique_ptr<ThreadContextPool>> Pools;
+    };
+
+    //! \returns The context pool of the calling thread, created on first use
+    ThreadContextPool& _GetThreadContextPool();
+
+    //! \brief Releases the contexts of a thread and removes its pool. Called when the thread
+    //! exits
+    //! \param pools Is a ThreadContextPoolList
+    static void _ReleaseThreadContextPool(void* pools, std::thread::id thread);
+
 private:
     // AngelScript engine script executing part //
     asIScriptEngine* engine;
@@ -846,11 +904,16 @@ private:
 
     Mutex ModulesLock;
 
-    //! Created context objects that can be reused for faster script execution
-    std::vector<asIScriptContext*> ContextPool;
+    //! Created context objects that can be reused for faster script execution. Each thread
+    //! only touches its own pool so this only needs locking when a thread creates or releases
+    //! its pool
+    std::shared_ptr<ThreadContextPoolList> ThreadContextPools;
+
+    //! Identifies this in the thread local pool cache, as addresses can be reused
+    const uint64_t ExecutorID;
 
-    //! Must be locked when touching ContextPool
-    Mutex ContextPoolLock;
+    //! Used to skip compiling modules that haven't changed
+    std::unique_ptr<ScriptBytecodeCache> BytecodeCache;
 
     static ScriptExecutor* instance;
 };
@@ -8,6 +8,8 @@
 #include "Handlers/ResourceRefreshHandler.h"
 #include "Iterators/StringIterator.h"
 #include "ScriptExecutor.h"
+#include "Utility/MD5Generator.h"
+#include "Utility/MemoryMappedFile.h"
 #include "add_on/serializer/serializer.h"
 
 #include <boost/filesystem.hpp>
@@ -223,12 +225,12 @@ void Leviathan::ScriptModule::_ProcessMetadataForFunc(
     asIScriptFunction* func, asIScriptModule* mod)
 {
     // Start of by getting metadata string //
-    const auto& metaEntries = ScriptBuilder->GetMetadataForFunc(func);
+    const auto found = FunctionMetadata.find(func->GetDeclaration(true, true, false));
 
-    if(metaEntries.empty())
+    if(found == FunctionMetadata.end() || found->second.empty())
         return;
 
-    std::string meta = metaEntries.front();
+    std::string meta = found->second.front();
     StringOperations::RemovePreceedingTrailingSpaces(meta);
 
     if(meta.size() < 1) {
@@ -397,7 +399,22 @@ DLLEXPORT int Leviathan::ScriptModule::ScriptModuleIncludeCallback(
     module->_AddFileToMonitorIfNotAlready(resolved);
 #endif // SCRIPTMODULE_LISTENFORFILECHANGES
 
-    return builder->AddSectionFromFile(resolved.c_str());
+    if(!module->CacheKey)
+        return builder->AddSectionFromFile(resolved.c_str());
+
+    // The included code is needed for the cache key //
+    std::string code;
+    if(!FileSystem::ReadFileEntirely(resolved, code)) {
+
+        LOG_ERROR("ScriptModule: IncludeCallback: failed to read file: " + resolved);
+        return -1;
+    }
+
+    ScriptBytecodeCache::AddSourceToKey(
+        *module->CacheKey, resolved, 1, code.c_str(), code.size());
+
+    return builder->AddSectionFromMemory(
+        resolved.c_str(), code.c_str(), static_cast<unsigned>(code.size()));
 }
 // ------------------------------------ //
 DLLEXPORT size_t Leviathan::ScriptModule::GetScriptSegmentCount() const
@@ -729,21 +746,58 @@ void Leviathan::ScriptModule::_FileChanged(
 // ------------------------------------ //
 void Leviathan::ScriptModule::_BuildTheModule(Lock& guard)
 {
+    LoadedFromBytecodeCache = false;
+    FunctionMetadata.clear();
+
     // Apply the (possibly) updated access mask first //
     ScriptBuilder->GetModule()->SetAccessMask(AccessMask);
 
-    // Add the source files before building //
-    for(size_t i = 0; i < ScriptSourceSegments.size(); i++) {
-        if(ScriptBuilder->AddSectionFromMemory(ScriptSourceSegments[i]->SourceFile.c_str(),
-               ScriptSourceSegments[i]->SourceCode->c_str(), 0,
-               ScriptSourceSegments[i]->StartLine - 1) < 0) {
-            Logger::Get()->Error("ScriptModule: GetModule: failed to build unbuilt module "
-                                 "(adding source file '" +
-                                 ScriptSourceSegments[i]->SourceFile + "' failed), " +
-                                 GetInfoString());
+    ScriptBytecodeCache* cache = ScriptExecutor::Get()->GetBytecodeCache();
 
-            ScriptState = SCRIPTBUILDSTATE_FAILED;
-            return;
+    // The sources need to be added to find out which files are included //
+    MD5 key;
+
+    if(cache)
+        cache->StartKey(key, ScriptBuilder->GetEngine(), AccessMask);
+
+    CacheKey = cache ? &key : nullptr;
+    const bool added = _AddSegmentsToBuilder(guard, CacheKey);
+    CacheKey = nullptr;
+
+    if(!added) {
+        ScriptState = SCRIPTBUILDSTATE_FAILED;
+        return;
+    }
+
+    std::string cacheFile;
+
+    if(cache) {
+
+        key.finalize();
+        cacheFile = cache->GetCacheFile(Name, Source);
+
+        const auto cached = cache->Find(cacheFile, key.hexdigest());
+
+        if(cached) {
+
+            // The sections added to the builder aren't needed //
+            _RestartBuilderModule(guard);
+
+            if(cache->Load(*cached, ScriptBuilder->GetModule(), FunctionMetadata)) {
+
+                ASModule = ScriptBuilder->GetModule();
+                ScriptState = SCRIPTBUILDSTATE_BUILT;
+                LoadedFromBytecodeCache = true;
+                return;
+            }
+
+            // Compile normally as the bytecode is no longer usable //
+            _RestartBuilderModule(guard);
+
+            if(!_AddSegmentsToBuilder(guard, nullptr)) {
+                ScriptState = SCRIPTBUILDSTATE_FAILED;
+                return;
+            }
         }
     }
 
@@ -766,6 +820,60 @@ void Leviathan::ScriptModule::_BuildTheModule(Lock& guard)
 
     ASModule = ScriptBuilder->GetModule();
     ScriptState = SCRIPTBUILDSTATE_BUILT;
+
+    _StoreFunctionMetadata(guard);
+
+    if(cache)
+        cache->Store(cacheFile, key.hexdigest(), ASModule, FunctionMetadata);
+}
+
+bool Leviathan::ScriptModule::_AddSegmentsToBuilder(Lock& guard, MD5* key)
+{
+    // Add the source files before building //
+    for(size_t i = 0; i < ScriptSourceSegments.size(); i++) {
+
+        const auto& segment = *ScriptSourceSegments[i];
+
+        if(key) {
+            ScriptBytecodeCache::AddSourceToKey(*key, segment.SourceFile, segment.StartLine,
+                segment.SourceCode->c_str(), segment.SourceCode->size());
+        }
+
+        if(ScriptBuilder->AddSectionFromMemory(segment.SourceFile.c_str(),
+               segment.SourceCode->c_str(), 0, segment.StartLine - 1) < 0) {
+            Logger::Get()->Error("ScriptModule: GetModule: failed to build unbuilt module "
+                                 "(adding source file '" +
+                                 segment.SourceFile + "' failed), " + GetInfoString());
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Leviathan::ScriptModule::_RestartBuilderModule(Lock& guard)
+{
+    // This replaces the module in the engine with an empty one //
+    ScriptBuilder->StartNewModule(ScriptBuilder->GetEngine(), ModuleName.c_str());
+    ScriptBuilder->GetModule()->SetAccessMask(AccessMask);
+}
+
+void Leviathan::ScriptModule::_StoreFunctionMetadata(Lock& guard)
+{
+    FunctionMetadata.clear();
+
+    const asUINT count = ASModule->GetFunctionCount();
+
+    for(asUINT i = 0; i < count; ++i) {
+
+        asIScriptFunction* func = ASModule->GetFunctionByIndex(i);
+
+        auto metadata = ScriptBuilder->GetMetadataForFunc(func);
+
+        if(!metadata.empty())
+            FunctionMetadata[func->GetDeclaration(true, true, false)] = std::move(metadata);
+    }
 }
 // ------------------------------------ //
 DLLEXPORT bool Leviathan::ScriptModule::OnAddedToBridge(
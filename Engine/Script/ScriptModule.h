@@ -7,6 +7,7 @@
 
 #include "Common/ThreadSafe.h"
 #include "ScriptArgumentsProvider.h"
+#include "ScriptBytecodeCache.h"
 
 #include "add_on/scriptbuilder/scriptbuilder.h"
 #include "angelscript.h"
@@ -17,6 +18,8 @@
 
 namespace Leviathan {
 
+class MD5;
+
 enum SCRIPTBUILDSTATE {
 
     SCRIPTBUILDSTATE_EMPTY,
@@ -142,6 +145,13 @@ public:
         ScriptState = state;
     }
 
+    //! \returns True if the last build was loaded from the ScriptBytecodeCache instead of
+    //! being compiled
+    DLLEXPORT inline bool WasLoadedFromBytecodeCache() const
+    {
+        return LoadedFromBytecodeCache;
+    }
+
     //! \brief Gets the number of code segments
     //! \see GetScriptSegment
     DLLEXPORT size_t GetScriptSegmentCount() const;
@@ -215,8 +225,20 @@ private:
         Lock& guard, const std::string& listenername, const std::string* generictype = NULL);
 
     //! \brief Tries to build the module and sets the state accordingly
+    //!
+    //! Loads the module from the bytecode cache instead if it has the current version
     void _BuildTheModule(Lock& guard);
 
+    //! \brief Adds all ScriptSourceSegments to the builder
+    //! \param key If not null the sources (and included files) are added to this cache key
+    bool _AddSegmentsToBuilder(Lock& guard, MD5* key);
+
+    //! \brief Restarts the builder with an empty module
+    void _RestartBuilderModule(Lock& guard);
+
+    //! \brief Copies the function metadata from the builder after compiling
+    void _StoreFunctionMetadata(Lock& guard);
+
 #ifdef SCRIPTMODULE_LISTENFORFILECHANGES
 
     //! \brief Starts monitoring for changes to all script segments and all included files
@@ -266,6 +288,15 @@ private:
     //! Map of found listener functions
     std::map<std::string, std::shared_ptr<ValidListenerData>> FoundListenerFunctions;
 
+    //! Metadata of functions. This is stored here instead of using ScriptBuilder as the
+    //! builder doesn't have it when the module is loaded from the cache
+    ScriptBytecodeCache::FunctionMetadata FunctionMetadata;
+
+    //! Set while adding sources, the include callback adds included files to this
+    MD5* CacheKey = nullptr;
+
+    bool LoadedFromBytecodeCache = false;
+
 
     //! Last ID of a ScriptModule, used to generate unique IDs for modules
     static int LatestAssigned;
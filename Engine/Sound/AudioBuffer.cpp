@@ -6,8 +6,10 @@
 using namespace Leviathan;
 using namespace Leviathan::Sound;
 // ------------------------------------ //
-DLLEXPORT AudioBuffer::AudioBuffer(alure::Buffer buffertowrap, SoundDevice* owner) :
-    Buffer(buffertowrap), Owner(owner)
+DLLEXPORT AudioBuffer::AudioBuffer(const std::string& name,
+    alure::SharedFuture<alure::Buffer> loading, SoundDevice* owner, size_t simulatedsize) :
+    Name(name),
+    Loading(std::move(loading)), Size(simulatedsize), Owner(owner)
 {
     LEVIATHAN_ASSERT(Owner, "AudioBuffer must be associated with a SoundDevice");
 }
@@ -15,8 +17,45 @@ DLLEXPORT AudioBuffer::AudioBuffer(alure::Buffer buffertowrap, SoundDevice* owne
 DLLEXPORT AudioBuffer::~AudioBuffer()
 {
     // TODO: should this invoke if not called on the main thread?
-    if(Buffer) {
+    // This is done even if the buffer is still loading as it would otherwise stay in the
+    // alure cache
+    Owner->ReportDestroyedBuffer(*this);
+}
+// ------------------------------------ //
+DLLEXPORT bool AudioBuffer::IsLoaded() const
+{
+    return Resolved || !Loading.valid() ||
+           Loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+DLLEXPORT size_t AudioBuffer::GetSize()
+{
+    if(!IsLoaded())
+        return 0;
+
+    GetBuffer();
+    return Size;
+}
+// ------------------------------------ //
+alure::Buffer& AudioBuffer::GetBuffer()
+{
+    if(Resolved)
+        return Buffer;
+
+    Resolved = true;
 
-        Owner->ReportDestroyedBuffer(*this);
+    if(!Loading.valid())
+        return Buffer;
+
+    try {
+        Buffer = Loading.get();
+    } catch(const std::exception& e) {
+        LOG_ERROR("AudioBuffer: failed to decode \"" + Name + "\": " + e.what());
+        return Buffer;
     }
+
+    if(Buffer)
+        Size = Buffer.getSize();
+
+    return Buffer;
 }
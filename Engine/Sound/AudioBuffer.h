@@ -18,6 +18,9 @@ namespace Sound {
 
 
 //! \brief Small ReferenceCounted wrapper around an audio buffer
+//!
+//! The buffer may still be decoding in the background when this is created. AudioSource can
+//! play a buffer that is still loading, the playback starts once it is ready
 class AudioBuffer : public ReferenceCounted {
 protected:
     friend SoundDevice;
@@ -27,23 +30,50 @@ protected:
     // counted instances through MakeShared
     friend ReferenceCounted;
 
-    DLLEXPORT AudioBuffer(alure::Buffer buffertowrap, SoundDevice* owner);
+    //! \param name The name the buffer was loaded with, used to release the buffer
+    //! \param loading The buffer being decoded
+    //! \param simulatedsize Used as the size when there is no audio device to decode with
+    DLLEXPORT AudioBuffer(const std::string& name, alure::SharedFuture<alure::Buffer> loading,
+        SoundDevice* owner, size_t simulatedsize = 0);
 
 public:
     DLLEXPORT ~AudioBuffer();
 
+    //! \returns True once the buffer is decoded (or decoding failed)
+    DLLEXPORT bool IsLoaded() const;
+
+    //! \returns The size of the decoded audio data in bytes. 0 until loaded
+    DLLEXPORT size_t GetSize();
+
+    inline const std::string& GetName() const
+    {
+        return Name;
+    }
+
     // ------------------------------------ //
 
     REFERENCE_COUNTED_PTR_TYPE(AudioBuffer);
 
 protected:
-    alure::Buffer& GetBuffer()
+    //! \brief Waits for the buffer to be decoded
+    //! \returns The buffer, null if decoding failed
+    alure::Buffer& GetBuffer();
+
+    inline const alure::SharedFuture<alure::Buffer>& GetLoadingBuffer() const
     {
-        return Buffer;
+        return Loading;
     }
 
 private:
+    const std::string Name;
+
+    alure::SharedFuture<alure::Buffer> Loading;
+
+    //! Set from Loading once it is ready
     alure::Buffer Buffer;
+    bool Resolved = false;
+
+    size_t Size;
 
     //! Used to release the source properly
     SoundDevice* Owner;
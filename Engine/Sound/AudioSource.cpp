@@ -17,7 +17,20 @@ DLLEXPORT void AudioSource::Play2D(const Sound::AudioBuffer::pointer& buffer)
 {
     PlayedBuffer = buffer;
 
-    if(PlayedBuffer && PlayedBuffer->GetBuffer()) {
+    if(!PlayedBuffer) {
+        Source.stop();
+        return;
+    }
+
+    if(!PlayedBuffer->IsLoaded()) {
+
+        // Don't wait for the decoding, alure starts playing once it is done
+        Source.set3DSpatialize(alure::Spatialize::Off);
+        Source.play(alure::SharedFuture<alure::Buffer>(PlayedBuffer->GetLoadingBuffer()));
+        return;
+    }
+
+    if(PlayedBuffer->GetBuffer()) {
 
         Source.set3DSpatialize(alure::Spatialize::Off);
         Source.play(PlayedBuffer->GetBuffer());
@@ -28,13 +41,14 @@ DLLEXPORT void AudioSource::Play2D(const Sound::AudioBuffer::pointer& buffer)
 }
 
 DLLEXPORT void AudioSource::PlayWithDecoder(
-    const Sound::ProceduralSoundData::pointer& data, size_t chunksize, size_t chunkstoqueue)
+    const alure::SharedPtr<alure::Decoder>& data, size_t chunksize, size_t chunkstoqueue)
 {
     PlayedBuffer.reset();
 
     if(data) {
 
-        Source.play(data, chunksize, chunkstoqueue);
+        // A copy is passed as alure takes the pointer by rvalue
+        Source.play(alure::SharedPtr<alure::Decoder>(data), chunksize, chunkstoqueue);
 
     } else {
         Source.stop();
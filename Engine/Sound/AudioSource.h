@@ -36,8 +36,13 @@ public:
     }
 
     // ------------------------------------ //
+    //! \brief Plays a buffer, if the buffer is still loading the playback starts once it is
+    //! loaded
     DLLEXPORT void Play2D(const Sound::AudioBuffer::pointer& buffer);
-    DLLEXPORT void PlayWithDecoder(const Sound::ProceduralSoundData::pointer& data,
+
+    //! \brief Plays data from a decoder in chunks, used for procedural sounds and streaming
+    //! long sounds from files
+    DLLEXPORT void PlayWithDecoder(const alure::SharedPtr<alure::Decoder>& data,
         size_t chunksize = 12000, size_t chunkstoqueue = 4);
 
     DLLEXPORT inline void Resume()
@@ -14,6 +14,7 @@
 #include <boost/filesystem.hpp>
 
 #include <algorithm>
+#include <list>
 using namespace Leviathan;
 using namespace Leviathan::Sound;
 // ------------------------------------ //
@@ -48,8 +49,30 @@ struct SoundDevice::Implementation {
     //! List of audio sources that this class will close on tick if they have stopped
     std::vector<AudioSource::pointer> HandledAudioSources;
 
-    //! Cache of buffers for short sounds
-    std::unordered_map<std::string, std::tuple<AudioBuffer::pointer, int64_t>> BufferCache;
+    struct CachedBuffer {
+
+        std::string Name;
+        AudioBuffer::pointer Buffer;
+        int64_t LastUsed;
+
+        //! Precached buffers aren't removed by CleanBufferCache
+        bool Precached;
+    };
+
+    //! \brief Removes a buffer from the cache
+    //! \returns Iterator to the next buffer
+    std::list<CachedBuffer>::iterator RemoveCachedBuffer(
+        std::list<CachedBuffer>::iterator iter)
+    {
+        BufferCacheIndex.erase(iter->Name);
+        return BufferCache.erase(iter);
+    }
+
+    //! Cache of buffers for short sounds, the most recently used first
+    std::list<CachedBuffer> BufferCache;
+
+    //! Allows finding buffers by name in BufferCache
+    std::unordered_map<std::string, std::list<CachedBuffer>::iterator> BufferCacheIndex;
 };
 
 
@@ -65,6 +88,7 @@ bool SoundDevice::Init(bool simulatesound /*= false*/)
 {
     if(simulatesound) {
         LOG_WARNING("SoundDevice: simulating not having a playing device");
+        _PrecacheFromDefinition();
         return true;
     }
 
@@ -202,17 +226,24 @@ bool SoundDevice::Init(bool simulatesound /*= false*/)
         // Orientation, at and up
         {{0, 0, 0}, {0, 1, 0}});
 
+    // Makes alure fill streaming sources from its background thread instead of only when
+    // Tick calls update
+    Pimpl->Context.setAsyncWakeInterval(std::chrono::milliseconds(50));
+
+    _PrecacheFromDefinition();
     return true;
 }
 
 void SoundDevice::Release()
 {
-    if(!Pimpl->Device)
-        return;
-
+    // The cache is also used without a device
     Pimpl->HandledAudioSources.clear();
+    Pimpl->BufferCacheIndex.clear();
     Pimpl->BufferCache.clear();
 
+    if(!Pimpl->Device)
+        return;
+
     alure::Context::MakeCurrent(nullptr);
     Pimpl->Listener = nullptr;
     Pimpl->Context.destroy();
@@ -225,7 +256,8 @@ void SoundDevice::Tick(int PassedMs)
 {
     ElapsedSinceLastClean += PassedMs;
 
-    Pimpl->Context.update();
+    if(Pimpl->Context)
+        Pimpl->Context.update();
 
     if(ElapsedSinceLastClean > 200) {
         ElapsedSinceLastClean = 0;
@@ -241,19 +273,7 @@ void SoundDevice::Tick(int PassedMs)
             }
         }
 
-        const auto now = Time::GetTimeMs64();
-
-        // Clear cache entries
-        for(auto iter = Pimpl->BufferCache.begin(); iter != Pimpl->BufferCache.end();) {
-
-            if(std::get<1>(iter->second) - now > CacheSoundEffectMilliseconds) {
-                // Remove from cache
-
-                iter = Pimpl->BufferCache.erase(iter);
-            } else {
-                ++iter;
-            }
-        }
+        CleanBufferCache();
     }
 }
 
@@ -285,6 +305,9 @@ DLLEXPORT void SoundDevice::SetSoundListenerPosition(
 
 DLLEXPORT void SoundDevice::SetGlobalVolume(float vol)
 {
+    if(!Pimpl->Listener)
+        return;
+
     vol = std::clamp(vol, 0.f, 1.f);
 
     Pimpl->Listener.setGain(vol);
@@ -329,6 +352,37 @@ DLLEXPORT AudioSource::pointer SoundDevice::Play2DSound(
     return source;
 }
 
+DLLEXPORT AudioSource::pointer SoundDevice::Play2DStream(
+    const std::string& filename, bool looping, size_t chunksize, size_t chunkstoqueue)
+{
+    Engine::Get()->AssertIfNotMainThread();
+
+    if(!Pimpl->Context)
+        return nullptr;
+
+    // This only reads the header of the file, the data is decoded while playing //
+    alure::SharedPtr<alure::Decoder> decoder;
+
+    try {
+        decoder = Pimpl->Context.createDecoder(filename);
+    } catch(const std::exception& e) {
+        LOG_ERROR("SoundDevice: failed to open stream from file: " + filename +
+                  ", error: " + e.what());
+        return nullptr;
+    }
+
+    const auto source = GetAudioSource();
+
+    if(!source)
+        return nullptr;
+
+    source->PlayWithDecoder(decoder, chunksize, chunkstoqueue);
+
+    if(looping)
+        source->SetLooping(true);
+    return source;
+}
+
 DLLEXPORT AudioSource::pointer SoundDevice::CreateProceduralSound(
     const ProceduralSoundData::pointer& data, size_t chunksize /*= 56000*/,
     size_t chunkstoqueue /*= 4*/)
@@ -352,38 +406,165 @@ DLLEXPORT Sound::AudioBuffer::pointer SoundDevice::GetBufferFromFile(
 {
     const auto now = Time::GetTimeMs64();
 
-    AudioBuffer::pointer buffer;
-
     // Find buffer from cache
     if(cache) {
-        const auto found = Pimpl->BufferCache.find(filename);
+        const auto found = Pimpl->BufferCacheIndex.find(filename);
+
+        if(found != Pimpl->BufferCacheIndex.end()) {
 
-        if(found != Pimpl->BufferCache.end()) {
-            buffer = std::get<0>(found->second);
-            std::get<1>(found->second) = now;
+            // Now the most recently used one //
+            Pimpl->BufferCache.splice(
+                Pimpl->BufferCache.begin(), Pimpl->BufferCache, found->second);
+
+            found->second->LastUsed = now;
+            return found->second->Buffer;
         }
     }
 
-    if(!buffer) {
-        // Not cached
-        auto alureBuffer = Pimpl->Context.getBuffer(filename);
+    // Not cached
+    if(!boost::filesystem::exists(filename)) {
+        LOG_ERROR("SoundDevice: failed to create buffer, file doesn't exist: " + filename);
+        return nullptr;
+    }
+
+    AudioBuffer::pointer buffer;
+
+    if(Pimpl->Context) {
 
-        if(!alureBuffer) {
-            LOG_ERROR("SoundDevice: failed to create buffer from file: " + filename);
+        // Decoded by the alure background thread //
+        try {
+            buffer = AudioBuffer::MakeShared<AudioBuffer>(
+                filename, Pimpl->Context.getBufferAsync(filename), this);
+        } catch(const std::exception& e) {
+            LOG_ERROR("SoundDevice: failed to create buffer from file: " + filename +
+                      ", error: " + e.what());
             return nullptr;
         }
 
-        buffer = AudioBuffer::MakeShared<AudioBuffer>(std::move(alureBuffer), this);
+    } else {
 
-        if(cache)
-            Pimpl->BufferCache[filename] = {buffer, now};
+        // Without a device nothing can be decoded, the file size is used as the size //
+        buffer = AudioBuffer::MakeShared<AudioBuffer>(filename,
+            alure::SharedFuture<alure::Buffer>(), this,
+            static_cast<size_t>(boost::filesystem::file_size(filename)));
+    }
+
+    if(cache) {
+        Pimpl->BufferCache.push_front({filename, buffer, now, false});
+        Pimpl->BufferCacheIndex[filename] = Pimpl->BufferCache.begin();
     }
 
     return buffer;
 }
 
+DLLEXPORT void SoundDevice::PrecacheBuffers(const std::vector<std::string>& files)
+{
+    for(const auto& file : files) {
+
+        if(!GetBufferFromFile(file, true))
+            continue;
+
+        Pimpl->BufferCacheIndex[file]->Precached = true;
+    }
+}
+
+DLLEXPORT bool SoundDevice::PrecacheBuffersFromManifest(const std::string& manifestfile)
+{
+    auto manifest = ObjectFileProcessor::ProcessObjectFile(manifestfile, Logger::Get());
+
+    if(!manifest) {
+        LOG_ERROR("SoundDevice: failed to read sound manifest: " + manifestfile);
+        return false;
+    }
+
+    const auto sounds = manifest->GetVariables()->GetValueDirectRaw("Sounds");
+
+    if(!sounds) {
+        LOG_ERROR("SoundDevice: sound manifest has no Sounds variable: " + manifestfile);
+        return false;
+    }
+
+    std::vector<std::string> files;
+    files.reserve(sounds->GetVariableCount());
+
+    for(size_t i = 0; i < sounds->GetVariableCount(); ++i) {
+        files.push_back(sounds->GetValueDirect(i)->ConvertAndReturnVariable<std::string>());
+    }
+
+    PrecacheBuffers(files);
+    return true;
+}
+
+void SoundDevice::_PrecacheFromDefinition()
+{
+    const auto engine = Engine::Get();
+
+    if(!engine || !engine->GetDefinition())
+        return;
+
+    std::string manifest;
+    ObjectFileProcessor::LoadValueFromNamedVars<std::string>(
+        engine->GetDefinition()->GetValues(), "SoundPrecacheManifest", manifest, "");
+
+    if(!manifest.empty())
+        PrecacheBuffersFromManifest(manifest);
+}
+// ------------------------------------ //
+DLLEXPORT size_t SoundDevice::GetBufferCacheSize() const
+{
+    size_t size = 0;
+
+    for(const auto& cached : Pimpl->BufferCache)
+        size += cached.Buffer->GetSize();
+
+    return size;
+}
+
+DLLEXPORT size_t SoundDevice::GetCachedBufferCount() const
+{
+    return Pimpl->BufferCache.size();
+}
+
+DLLEXPORT void SoundDevice::CleanBufferCache()
+{
+    const auto now = Time::GetTimeMs64();
+
+    // Precached buffers are always kept so they take space from the others //
+    size_t usedSize = 0;
+
+    for(const auto& cached : Pimpl->BufferCache) {
+        if(cached.Precached)
+            usedSize += cached.Buffer->GetSize();
+    }
+
+    // Buffers are kept from the most recently used until the budget runs out //
+    for(auto iter = Pimpl->BufferCache.begin(); iter != Pimpl->BufferCache.end();) {
+
+        if(iter->Precached) {
+            ++iter;
+            continue;
+        }
+
+        const auto size = iter->Buffer->GetSize();
+
+        if(now - iter->LastUsed > CacheSoundEffectMilliseconds ||
+            usedSize + size > BufferCacheBudget) {
+
+            iter = Pimpl->RemoveCachedBuffer(iter);
+            continue;
+        }
+
+        usedSize += size;
+        ++iter;
+    }
+}
+// ------------------------------------ //
 DLLEXPORT AudioSource::pointer SoundDevice::GetAudioSource()
 {
+    // No device, nothing is played
+    if(!Pimpl->Context)
+        return nullptr;
+
     auto alureSource = Pimpl->Context.createSource();
 
     if(!alureSource) {
@@ -403,5 +584,14 @@ DLLEXPORT void SoundDevice::BabysitAudio(AudioSource::pointer audio)
 // ------------------------------------ //
 DLLEXPORT void SoundDevice::ReportDestroyedBuffer(Sound::AudioBuffer& buffer)
 {
-    Pimpl->Context.removeBuffer(buffer.GetBuffer());
+    if(!Pimpl || !Pimpl->Context)
+        return;
+
+    // The buffer is removed by name as it may still be loading
+    try {
+        Pimpl->Context.removeBuffer(buffer.GetName());
+    } catch(const std::exception& e) {
+        LOG_WARNING("SoundDevice: failed to remove buffer \"" + buffer.GetName() +
+                    "\": " + e.what());
+    }
 }
@@ -9,9 +9,16 @@
 
 #include "Common/Types.h"
 
+#include <vector>
+
 namespace Leviathan {
 
 //! \brief Manages loading the audio library and provides some helpers
+//!
+//! Sound files are decoded in the background so playing a sound doesn't block. Decoded
+//! buffers are kept in a cache that is limited by size and removes the least recently used
+//! buffers first. Long sounds should be played with Play2DStream to decode them while
+//! playing instead.
 class SoundDevice {
     struct Implementation;
 
@@ -20,7 +27,10 @@ public:
     DLLEXPORT ~SoundDevice();
 
     //! \param simulatenosound If true the sound device isn't initialized to simulate not
-    //! having a valid audio device (or if the user just doesn't want sound)
+    //! having a valid audio device (or if the user just doesn't want sound). Buffers are
+    //! still cached in this mode but nothing is decoded or played
+    //! \note If the application definition has "SoundPrecacheManifest" the sounds in it are
+    //! precached here
     DLLEXPORT bool Init(bool simulatesound = false);
     DLLEXPORT void Release();
 
@@ -50,17 +60,60 @@ public:
     //! \returns The audio source that is playing the sound (this must be held onto until it is
     //! done playing, can be passed to BabysitAudio if not manually wanted to be managed or use
     //! the SoundEffect variant of this method) may be null on error
+    //! \note If the file isn't cached yet the playback starts once it has been decoded
     DLLEXPORT AudioSource::pointer Play2DSound(const std::string& filename, bool looping);
 
+    //! \brief Plays a 2d sound by decoding it in chunks while it plays
+    //!
+    //! Meant for music and other long sounds that would take a long time to decode and a lot
+    //! of memory if loaded fully. Streamed sounds aren't cached
+    //! \returns The audio source that is playing the sound, may be null on error
+    DLLEXPORT AudioSource::pointer Play2DStream(const std::string& filename, bool looping,
+        size_t chunksize = 12000, size_t chunkstoqueue = 4);
+
     //! \brief Opens an audio source from a procedural data stream
     DLLEXPORT AudioSource::pointer CreateProceduralSound(
         const Sound::ProceduralSoundData::pointer& data, size_t chunksize = 56000,
         size_t chunkstoqueue = 4);
 
     //! \brief Creates a sound buffer from a file
+    //!
+    //! The file is decoded in the background, the returned buffer can be played right away
+    //! \param cache If true the buffer is stored in the cache for the following calls
+    //! \returns Null if the file doesn't exist
     DLLEXPORT Sound::AudioBuffer::pointer GetBufferFromFile(
         const std::string& filename, bool cache = true);
 
+    //! \brief Starts decoding files into the cache so that they are ready when first played
+    //!
+    //! Precached buffers aren't removed from the cache, but they count towards the cache size
+    DLLEXPORT void PrecacheBuffers(const std::vector<std::string>& files);
+
+    //! \brief Precaches the files listed in the "Sounds" variable of an ObjectFile
+    //!
+    //! For example: Sounds = [["Data/Sound/click.ogg"]["Data/Sound/hit.ogg"]];
+    //! \returns False if the manifest couldn't be read
+    DLLEXPORT bool PrecacheBuffersFromManifest(const std::string& manifestfile);
+
+    //! \brief Sets the maximum size of the decoded buffers in the cache
+    DLLEXPORT inline void SetBufferCacheBudget(size_t bytes)
+    {
+        BufferCacheBudget = bytes;
+    }
+
+    //! \returns The size of the loaded buffers in the cache in bytes
+    DLLEXPORT size_t GetBufferCacheSize() const;
+
+    //! \returns The number of buffers in the cache (also ones that are still loading)
+    DLLEXPORT size_t GetCachedBufferCount() const;
+
+    //! \brief Removes buffers that haven't been used recently from the cache
+    //!
+    //! Removes the least recently used buffers until the cache is within the budget and
+    //! buffers that have not been used in CacheSoundEffectMilliseconds
+    //! \note This is called periodically by Tick
+    DLLEXPORT void CleanBufferCache();
+
     //! \brief Creates an audio source with no settings applied
     DLLEXPORT AudioSource::pointer GetAudioSource();
 
@@ -71,10 +124,17 @@ public:
     // ------------------------------------ //
     DLLEXPORT void ReportDestroyedBuffer(Sound::AudioBuffer& buffer);
 
+private:
+    //! \brief Precaches the manifest set in the application definition
+    void _PrecacheFromDefinition();
+
 private:
     std::unique_ptr<Implementation> Pimpl;
 
     int CacheSoundEffectMilliseconds = 30000;
+
+    //! Max size of the cached buffers in bytes
+    size_t BufferCacheBudget = 64 * 1024 * 1024;
     int ElapsedSinceLastClean = 0;
 };
 
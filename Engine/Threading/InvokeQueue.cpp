@@ -0,0 +1,79 @@
+// ------------------------------------ //
+#include "InvokeQueue.h"
+
+using namespace Leviathan;
+// ------------------------------------ //
+DLLEXPORT InvokeQueue::InvokeQueue() : Head(&Stub), Tail(&Stub) {}
+
+DLLEXPORT InvokeQueue::~InvokeQueue()
+{
+    // Remaining functions are destroyed without running them //
+    InvokeFunction discarded;
+
+    while(Pop(discarded))
+        discarded.Reset();
+}
+// ------------------------------------ //
+DLLEXPORT void InvokeQueue::Push(InvokeFunction&& function)
+{
+    _PushNode(new Node(std::move(function)));
+}
+
+void InvokeQueue::_PushNode(Node* node)
+{
+    node->Next.store(nullptr, std::memory_order_relaxed);
+
+    Node* previous = Head.exchange(node, std::memory_order_acq_rel);
+
+    // Between the exchange and this store the consumer can't see node or anything after it
+    previous->Next.store(node, std::memory_order_release);
+}
+// ------------------------------------ //
+DLLEXPORT bool InvokeQueue::Pop(InvokeFunction& receiver)
+{
+    Node* tail = Tail;
+    Node* next = tail->Next.load(std::memory_order_acquire);
+
+    // Skip the stub //
+    if(tail == &Stub) {
+
+        if(!next)
+            return false;
+
+        Tail = next;
+        tail = next;
+        next = next->Next.load(std::memory_order_acquire);
+    }
+
+    if(next) {
+
+        Tail = next;
+        receiver = std::move(tail->Function);
+        delete tail;
+        return true;
+    }
+
+    // tail is the last node unless a push hasn't finished linking yet //
+    if(tail != Head.load(std::memory_order_acquire))
+        return false;
+
+    // The stub is put back so that tail can be removed
+    _PushNode(&Stub);
+
+    next = tail->Next.load(std::memory_order_acquire);
+
+    if(next) {
+
+        Tail = next;
+        receiver = std::move(tail->Function);
+        delete tail;
+        return true;
+    }
+
+    return false;
+}
+
+DLLEXPORT bool InvokeQueue::IsEmpty() const
+{
+    return Tail == &Stub && !Stub.Next.load(std::memory_order_acquire);
+}
@@ -0,0 +1,213 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+#include "Define.h"
+// ------------------------------------ //
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Leviathan {
+
+//! \brief Priority of a function passed to Engine::Invoke
+enum class INVOKE_PRIORITY : uint8_t {
+
+    //! Always ran on the next tick, even if the invoke time budget is exceeded
+    High = 0,
+    Normal,
+    //! Ran after all other invokes if there is time left
+    Low
+};
+
+constexpr size_t INVOKE_PRIORITY_COUNT = 3;
+
+//! \brief Move only void() callable that stores small functors without allocating
+//!
+//! Functors up to INLINE_STORAGE_SIZE bytes (which includes std::function and lambdas
+//! capturing a few pointers or a shared_ptr) are stored inline. Larger ones are allocated.
+class InvokeFunction {
+    struct Operations {
+
+        void (*Call)(void* storage);
+        void (*MoveTo)(void* storage, void* target);
+        void (*Destroy)(void* storage);
+    };
+
+    template<class FunctorT>
+    struct InlineOperations {
+
+        static void Call(void* storage)
+        {
+            (*static_cast<FunctorT*>(storage))();
+        }
+
+        static void MoveTo(void* storage, void* target)
+        {
+            new(target) FunctorT(std::move(*static_cast<FunctorT*>(storage)));
+            static_cast<FunctorT*>(storage)->~FunctorT();
+        }
+
+        static void Destroy(void* storage)
+        {
+            static_cast<FunctorT*>(storage)->~FunctorT();
+        }
+
+        static constexpr Operations Table = {&Call, &MoveTo, &Destroy};
+    };
+
+    template<class FunctorT>
+    struct AllocatedOperations {
+
+        static void Call(void* storage)
+        {
+            (**static_cast<FunctorT**>(storage))();
+        }
+
+        static void MoveTo(void* storage, void* target)
+        {
+            *static_cast<FunctorT**>(target) = *static_cast<FunctorT**>(storage);
+        }
+
+        static void Destroy(void* storage)
+        {
+            delete *static_cast<FunctorT**>(storage);
+        }
+
+        static constexpr Operations Table = {&Call, &MoveTo, &Destroy};
+    };
+
+public:
+    static constexpr size_t INLINE_STORAGE_SIZE = 48;
+
+    InvokeFunction() = default;
+
+    template<class FunctionT,
+        class = std::enable_if_t<!std::is_same_v<std::decay_t<FunctionT>, InvokeFunction>>>
+    InvokeFunction(FunctionT&& function)
+    {
+        using FunctorT = std::decay_t<FunctionT>;
+
+        if constexpr(sizeof(FunctorT) <= INLINE_STORAGE_SIZE &&
+                     alignof(FunctorT) <= alignof(std::max_align_t) &&
+                     std::is_nothrow_move_constructible_v<FunctorT>) {
+
+            new(&Storage) FunctorT(std::forward<FunctionT>(function));
+            Ops = &InlineOperations<FunctorT>::Table;
+
+        } else {
+
+            *reinterpret_cast<FunctorT**>(&Storage) =
+                new FunctorT(std::forward<FunctionT>(function));
+            Ops = &AllocatedOperations<FunctorT>::Table;
+        }
+    }
+
+    InvokeFunction(InvokeFunction&& other) noexcept
+    {
+        if(other.Ops) {
+            other.Ops->MoveTo(&other.Storage, &Storage);
+            Ops = other.Ops;
+            other.Ops = nullptr;
+        }
+    }
+
+    InvokeFunction& operator=(InvokeFunction&& other) noexcept
+    {
+        if(this != &other) {
+
+            Reset();
+
+            if(other.Ops) {
+                other.Ops->MoveTo(&other.Storage, &Storage);
+                Ops = other.Ops;
+                other.Ops = nullptr;
+            }
+        }
+
+        return *this;
+    }
+
+    InvokeFunction(const InvokeFunction& other) = delete;
+    InvokeFunction& operator=(const InvokeFunction& other) = delete;
+
+    ~InvokeFunction()
+    {
+        Reset();
+    }
+
+    inline void operator()()
+    {
+        Ops->Call(&Storage);
+    }
+
+    inline explicit operator bool() const
+    {
+        return Ops != nullptr;
+    }
+
+    //! \brief Destroys the stored functor
+    inline void Reset()
+    {
+        if(Ops) {
+            Ops->Destroy(&Storage);
+            Ops = nullptr;
+        }
+    }
+
+private:
+    std::aligned_storage_t<INLINE_STORAGE_SIZE, alignof(std::max_align_t)> Storage;
+    const Operations* Ops = nullptr;
+};
+
+//! \brief Lock-free multiple producer, single consumer queue of functions
+//!
+//! Any thread can Push without waiting for other threads. Only one thread at a time may Pop.
+//! This is an intrusive linked list with a stub node, pushing only needs an atomic exchange.
+//! \note Pop may fail to see a function that is being pushed at the same time, it will be
+//! returned by a later Pop
+class InvokeQueue {
+    struct Node {
+
+        Node() = default;
+        Node(InvokeFunction&& function) : Function(std::move(function)) {}
+
+        std::atomic<Node*> Next{nullptr};
+        InvokeFunction Function;
+    };
+
+public:
+    DLLEXPORT InvokeQueue();
+    DLLEXPORT ~InvokeQueue();
+
+    InvokeQueue(const InvokeQueue& other) = delete;
+    InvokeQueue& operator=(const InvokeQueue& other) = delete;
+
+    //! \brief Adds a function to the end of the queue. Can be called from any thread
+    DLLEXPORT void Push(InvokeFunction&& function);
+
+    //! \brief Takes the first function from the queue
+    //! \returns False if the queue is empty
+    //! \note Only one thread may call this at a time
+    DLLEXPORT bool Pop(InvokeFunction& receiver);
+
+    //! \returns True if there is nothing to Pop
+    //! \note Only the thread that calls Pop may call this
+    DLLEXPORT bool IsEmpty() const;
+
+private:
+    void _PushNode(Node* node);
+
+private:
+    //! The last pushed node, producers swap themselves here
+    std::atomic<Node*> Head;
+
+    //! The next node to pop, only accessed by the consumer
+    Node* Tail;
+
+    //! Kept in the queue so that Head and Tail are never null
+    Node Stub;
+};
+
+} // namespace Leviathan
@@ -111,6 +111,12 @@ public:
     //! Must be called if MakeThreadsWorkWithOgre has been called, BEFORE releasing graphics
     DLLEXPORT void UnregisterGraphics();
 
+    //! \returns The number of worker threads
+    DLLEXPORT inline int GetThreadCount() const
+    {
+        return WantedThreadCount;
+    }
+
     DLLEXPORT static ThreadingManager* Get();
 
 protected:
@@ -0,0 +1,104 @@
+// ------------------------------------ //
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+#include "Utility/Convert.h"
+#include "WindowsInclude.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif //_WIN32
+using namespace Leviathan;
+// ------------------------------------ //
+#ifdef _WIN32
+DLLEXPORT MemoryMappedFile::MemoryMappedFile(const std::string& file) : File(file)
+{
+    // Sharing delete allows replacing the file by renaming while it is mapped
+    HANDLE handle = CreateFileW(Convert::Utf8ToUtf16(file).c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if(handle == INVALID_HANDLE_VALUE)
+        return;
+
+    FileHandle = handle;
+
+    LARGE_INTEGER length;
+    if(!GetFileSizeEx(handle, &length))
+        return;
+
+    if(length.QuadPart == 0) {
+        Valid = true;
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if(!mapping)
+        return;
+
+    MappingHandle = mapping;
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if(!view)
+        return;
+
+    Data = static_cast<const char*>(view);
+    Size = static_cast<size_t>(length.QuadPart);
+    Valid = true;
+}
+
+DLLEXPORT MemoryMappedFile::~MemoryMappedFile()
+{
+    if(Data)
+        UnmapViewOfFile(Data);
+
+    if(MappingHandle)
+        CloseHandle(MappingHandle);
+
+    if(FileHandle)
+        CloseHandle(FileHandle);
+}
+#else
+DLLEXPORT MemoryMappedFile::MemoryMappedFile(const std::string& file) : File(file)
+{
+    const int fd = open(file.c_str(), O_RDONLY);
+
+    if(fd < 0)
+        return;
+
+    struct stat info;
+    if(fstat(fd, &info) != 0) {
+        close(fd);
+        return;
+    }
+
+    if(info.st_size == 0) {
+        close(fd);
+        Valid = true;
+        return;
+    }
+
+    void* view =
+        mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+
+    if(view == MAP_FAILED)
+        return;
+
+    Data = static_cast<const char*>(view);
+    Size = static_cast<size_t>(info.st_size);
+    Valid = true;
+}
+
+DLLEXPORT MemoryMappedFile::~MemoryMappedFile()
+{
+    if(Data)
+        munmap(const_cast<char*>(Data), Size);
+}
+#endif //_WIN32
@@ -0,0 +1,61 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+// ------------------------------------ //
+#include "Define.h"
+
+#include <string>
+
+namespace Leviathan {
+
+//! \brief Read-only view of a whole file mapped into memory
+//!
+//! Used for loading compiled data files without copying them into a buffer first. The data
+//! stays valid as long as this object is alive.
+class MemoryMappedFile {
+public:
+    //! \brief Maps the file, check IsValid to see if it succeeded
+    DLLEXPORT MemoryMappedFile(const std::string& file);
+    DLLEXPORT ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile& other) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile& other) = delete;
+
+    //! \returns True if the file was opened and mapped
+    inline bool IsValid() const
+    {
+        return Valid;
+    }
+
+    inline const char* GetData() const
+    {
+        return Data;
+    }
+
+    inline size_t GetSize() const
+    {
+        return Size;
+    }
+
+    inline const std::string& GetFile() const
+    {
+        return File;
+    }
+
+private:
+    const std::string File;
+
+    const char* Data = nullptr;
+    size_t Size = 0;
+
+    //! True when the file was mapped or it was found to be empty (an empty file can't be
+    //! mapped). False if opening, checking the size or mapping failed
+    bool Valid = false;
+
+#ifdef _WIN32
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+#endif //_WIN32
+};
+
+} // namespace Leviathan
@@ -54,7 +54,8 @@ class GameWorldClass < OutputClass
 
   # Default includes
   def getExtraIncludes
-    return ["Script/ScriptConversionHelpers.h", "boost/range/adaptor/map.hpp"]
+    return ["Script/ScriptConversionHelpers.h", "Entities/ComponentTypeAccess.h",
+            "boost/range/adaptor/map.hpp"]
   end
 
   def genMemberConstructor(f, opts)
@@ -464,43 +465,27 @@ class GameWorldClass < OutputClass
     end
     
     if opts.include?(:header)
-      f.puts <<-END
-//! Helper for getting component of type. This is much slower than
-//! direct lookups with the actual implementation class' GetComponent_Position etc.
-//! methods
-//! \\exception NotFound if entity has no component of the wanted type
-//!
-//! This is copied here as a method with the same name would overwrite this otherwise
-template<class TComponent>
-TComponent& GetComponent(ObjectID id){
-
-    std::tuple<void*, bool> component = GetComponent(id, TComponent::TYPE);
-
-    if(!std::get<1>(component))
-        throw Leviathan::InvalidArgument("Unrecognized component type as template parameter");
-
-    void* ptr = std::get<0>(component);
-
-    if(!ptr)
-        throw Leviathan::NotFound("Component for entity with id was not found");
-    
-    return *static_cast<TComponent*>(ptr);
-}
+      genTypedComponentAccess f
+    end
 
-template<class TComponent>
-Leviathan::StateHolder<typename TComponent::StateT>& GetStatesFor(){
+    f.write "#{export}const Leviathan::ComponentTypeAccess* #{qualifier opts}" +
+            "GetComponentTypeAccess(Leviathan::COMPONENT_TYPE type) const#{override opts}"
 
-    std::tuple<void*, bool> stateHolder = GetStatesFor(TComponent::TYPE);
+    if opts.include?(:impl)
+      f.puts "{"
+      f.puts "switch(static_cast<uint16_t>(type)){"
 
-    if(!std::get<1>(stateHolder))
-        throw InvalidArgument("Unrecognized component type as template parameter for "
-            "state holder");
+      @ComponentTypes.each{|c|
+        f.puts "case static_cast<uint16_t>(#{c.type}::TYPE):"
+        f.puts "return &Leviathan::ComponentTypeAccessFor<#{@Name}, #{c.type}>::Table;"
+      }
 
-    void* ptr = std::get<0>(stateHolder);
-    
-    return *static_cast<Leviathan::StateHolder<typename TComponent::StateT>*>(ptr);
-}
-END
+      f.puts "default:"
+      f.puts "return #{@BaseClass}::GetComponentTypeAccess(type);"
+      f.puts "}"
+      f.puts "}"
+    else
+      f.puts ";"
     end
 
     f.write "#{export}std::tuple<void*, bool> #{qualifier opts}GetStatesFor(" +
@@ -565,39 +550,7 @@ END
               "const #{override opts}"
 
       if opts.include?(:impl)
-        f.puts "{"
-
-        f.puts "uint32_t addedComponentCount = 0;"
-        
-        @ComponentTypes.each{|c|
-
-          # Skip types like Sendable and Received
-          if c.NoSynchronize
-            next
-          end
-
-          f.puts ""
-          f.puts "const auto& #{c.type.downcase} = Component#{c.type}.Find(id);"
-          f.puts "if(#{c.type.downcase}){"
-          f.puts "    ++addedComponentCount;"
-          f.puts "    receiver << static_cast<uint16_t>(#{c.type}::TYPE);"
-
-          c.constructors[0].Parameters.each{|p|
-
-            if p.NonMethodParam or p.NonSerializeParam
-              next
-            end
-
-            f.puts "    receiver << " + p.formatMemberSerializer(c.type.downcase + "->") + ";"
-          }
-          
-          f.puts "}"
-        }
-
-        f.puts ""
-        f.puts "return addedComponentCount + " +
-               "#{@BaseClass}::CaptureEntityStaticState(id, receiver);"
-        f.puts "}"
+        genComponentSerializers f, "CaptureEntityStaticState", includeall: false
       else
         f.puts ";"
       end
@@ -606,6 +559,18 @@ END
 
     end
 
+    f.write "#{export}#{virtual opts} uint32_t #{qualifier opts}CaptureEntitySnapshotState(" +
+            "ObjectID id, sf::Packet& receiver) " +
+            "const #{override opts}"
+
+    if opts.include?(:impl)
+      genComponentSerializers f, "CaptureEntitySnapshotState", includeall: true
+    else
+      f.puts ";"
+    end
+
+    f.puts ""
+
     f.write "#{export}void #{qualifier opts}RunFrameRenderSystems(int tick, " +
             "int timeintick)#{override opts}"
 
@@ -851,111 +816,7 @@ END
               "#{override opts}"
 
       if opts.include?(:impl)
-        f.puts "{"
-
-        f.puts "while(entriesleft > 0){"
-
-        f.puts "if(decodedtype == -1){"
-        f.puts "    // Type not decoded yet"
-        f.puts "    uint16_t tmpType;"
-        f.puts "    data >> tmpType;"
-        f.puts "    decodedtype = tmpType;"
-        f.puts "}"
-        f.puts "if(!data){"
-        f.puts %{    LOG_ERROR("GameWorld: entity decode: packet data ended too soon");}
-        f.puts "    return;"
-        f.puts "}"
-        
-        f.puts ""
-
-        f.puts "switch(decodedtype){"
-
-        counter = 0
-
-        @ComponentTypes.each{|c|
-
-          # Skip types like Sendable and Received
-          if c.NoSynchronize
-            next
-          end
-
-          f.puts "case static_cast<int>(#{c.type}::TYPE):"
-          f.puts "{"
-
-          # parameter decoding
-          c.constructors[0].Parameters.each{|p|
-
-            if p.NonMethodParam or p.NonSerializeParam
-              next
-            end
-
-            f.puts "#{p.Type} #{p.Name.downcase};"
-            f.puts p.formatDeserializer("data", target: p.Name.downcase)
-          }
-
-          f.puts "if(!data){"
-          f.puts %{    LOG_ERROR("GameWorld: entity decode: packet data ended } +
-                 %{too soon (no component parameters)");}
-          f.puts "    return;"
-          f.puts "}"
-
-          # Figuring out where to grab this data is hard...
-          # should make the ECS used by Leviathan to be more pure to have this data
-          # available easier
-          c.constructors[0].Parameters.each{|p|
-
-            if p.NonMethodParam or !p.NonSerializeParam
-              next
-            end
-
-            helper = "helper#{counter += 1}"
-
-            errorhelper = <<-END
-if(!#{helper}){
-LOG_ERROR("GameWorld: entity decode: magic deserialize on type '#{p.Type}' failed,"
-"canceling entity creation");
-throw InvalidArgument("can't find related required deserialize resources");
-}
-END
-
-            case p.Type
-            when "Ogre::SceneNode*"
-              f.puts "auto #{helper} = GetComponentPtr_RenderNode(id);"
-              f.puts errorhelper
-              helperProperty = helper + "->Node";
-            when "Ogre::Item*"
-              # This won't be good enough once there can be multiple different types of these
-              f.puts "auto #{helper} = GetComponentPtr_Model(id);"
-              f.puts errorhelper
-              helperProperty = helper + "->GraphicalObject";
-            when "Position"
-              f.puts "auto #{helper} = GetComponentPtr_Position(id);"
-              f.puts errorhelper
-              helperProperty = "*" + helper;
-            else
-              abort("Can't do magic deserialize on Variable: #{p.Type}")
-            end
-
-            f.puts "#{p.Type}& #{p.formatForArgumentList} = #{helperProperty};"  
-          }        
-          
-          f.puts "Create_#{c.type}(id" + c.constructors[0].formatNamesForForward + ");"
-          f.puts "--entriesleft;"
-          f.puts "decodedtype = -1;"
-          f.puts "continue;"
-
-          f.puts "}"
-        }
-
-        f.puts "default:"
-        f.puts "return #{@BaseClass}::_CreateComponentsFromCreationMessage(id, data, " +
-               "entriesleft, decodedtype);"      
-        
-        f.puts "}"
-        
-        f.puts "}"
-        f.puts "}"
-
+        genComponentLoaders f, "_CreateComponentsFromCreationMessage", includeall: false
       else
         f.puts ";"
       end
@@ -1091,11 +952,309 @@ END
         f.puts ";"
       end
     end
+
+    f.write "#{export}void #{qualifier opts}_CreateComponentsFromSnapshot(" +
+            "ObjectID id, sf::Packet& data, int entriesleft, int decodedtype)" +
+            "#{override opts}"
+
+    if opts.include?(:impl)
+      genComponentLoaders f, "_CreateComponentsFromSnapshot", includeall: true
+    else
+      f.puts ";"
+    end
     
     # f.puts "public:"
     
   end
 
+  # Generates the body of a method that writes the types and constructor parameters of the
+  # components of an entity. Types like Sendable and Received are skipped unless includeall
+  # is true
+  def genComponentSerializers(f, basemethod, includeall: false)
+    f.puts "{"
+
+    f.puts "uint32_t addedComponentCount = 0;"
+    
+    @ComponentTypes.each{|c|
+
+      # Skip types like Sendable and Received
+      if c.NoSynchronize and !includeall
+        next
+      end
+
+      f.puts ""
+      f.puts "const auto& #{c.type.downcase} = Component#{c.type}.Find(id);"
+      f.puts "if(#{c.type.downcase}){"
+      f.puts "    ++addedComponentCount;"
+      f.puts "    receiver << static_cast<uint16_t>(#{c.type}::TYPE);"
+
+      if c.CustomStaticSerializer
+        f.puts c.CustomStaticSerializer
+      else
+        c.constructors[0].Parameters.each{|p|
+
+          if p.NonMethodParam or p.NonSerializeParam
+            next
+          end
+
+          f.puts "    receiver << " + p.formatMemberSerializer(c.type.downcase + "->") + ";"
+        }
+      end
+      
+      f.puts "}"
+    }
+
+    f.puts ""
+    f.puts "return addedComponentCount + " +
+           "#{@BaseClass}::#{basemethod}(id, receiver);"
+    f.puts "}"
+  end
+
+  # Generates the body of a method that creates the components written by
+  # genComponentSerializers
+  def genComponentLoaders(f, basemethod, includeall: false)
+    f.puts "{"
+
+    f.puts "while(entriesleft > 0){"
+
+    f.puts "if(decodedtype == -1){"
+    f.puts "    // Type not decoded yet"
+    f.puts "    uint16_t tmpType;"
+    f.puts "    data >> tmpType;"
+    f.puts "    decodedtype = tmpType;"
+    f.puts "}"
+    f.puts "if(!data){"
+    f.puts %{    LOG_ERROR("GameWorld: entity decode: packet data ended too soon");}
+    f.puts "    return;"
+    f.puts "}"
+    
+    f.puts ""
+
+    f.puts "switch(decodedtype){"
+
+    counter = 0
+
+    @ComponentTypes.each{|c|
+
+      # Skip types like Sendable and Received
+      if c.NoSynchronize and !includeall
+        next
+      end
+
+      f.puts "case static_cast<int>(#{c.type}::TYPE):"
+      f.puts "{"
+
+      # parameter decoding
+      if c.CustomStaticLoader
+        f.puts c.CustomStaticLoader
+      else
+        c.constructors[0].Parameters.each{|p|
+
+          if p.NonMethodParam or p.NonSerializeParam
+            next
+          end
+
+          f.puts "#{p.Type} #{p.Name.downcase};"
+          f.puts p.formatDeserializer("data", target: p.Name.downcase)
+        }
+      end
+
+      f.puts "if(!data){"
+      f.puts %{    LOG_ERROR("GameWorld: entity decode: packet data ended } +
+             %{too soon (no component parameters)");}
+      f.puts "    return;"
+      f.puts "}"
+
+      # Figuring out where to grab this data is hard...
+      # should make the ECS used by Leviathan to be more pure to have this data
+      # available easier
+      c.constructors[0].Parameters.each{|p|
+
+        if p.NonMethodParam or !p.NonSerializeParam
+          next
+        end
+
+        helper = "helper#{counter += 1}"
+
+        errorhelper = <<-END
+if(!#{helper}){
+LOG_ERROR("GameWorld: entity decode: magic deserialize on type '#{p.Type}' failed,"
+"canceling entity creation");
+throw InvalidArgument("can't find related required deserialize resources");
+}
+END
+
+        case p.Type
+        when "Ogre::SceneNode*"
+          f.puts "auto #{helper} = GetComponentPtr_RenderNode(id);"
+          f.puts errorhelper
+          helperProperty = helper + "->Node";
+        when "Ogre::Item*"
+          # This won't be good enough once there can be multiple different types of these
+          f.puts "auto #{helper} = GetComponentPtr_Model(id);"
+          f.puts errorhelper
+          helperProperty = helper + "->GraphicalObject";
+        when "Position"
+          f.puts "auto #{helper} = GetComponentPtr_Position(id);"
+          f.puts errorhelper
+          helperProperty = "*" + helper;
+        else
+          abort("Can't do magic deserialize on Variable: #{p.Type}")
+        end
+
+        f.puts "#{p.Type}& #{p.formatForArgumentList} = #{helperProperty};"  
+      }        
+      
+      f.puts "Create_#{c.type}(id" + c.constructors[0].formatNamesForForward + ");"
+      f.puts "--entriesleft;"
+      f.puts "decodedtype = -1;"
+      f.puts "continue;"
+
+      f.puts "}"
+    }
+
+    f.puts "default:"
+    f.puts "return #{@BaseClass}::#{basemethod}(id, data, " +
+           "entriesleft, decodedtype);"      
+    
+    f.puts "}"
+    
+    f.puts "}"
+    f.puts "}"
+  end
+
+
+  # Templates that resolve the component holders at compile time. The methods with the same
+  # names in GameWorld go through the virtual COMPONENT_TYPE switches
+  def genTypedComponentAccess(f)
+
+    f.puts "//! The component types stored directly in this world"
+    f.puts "using ComponentTypes = Leviathan::ComponentTypeList<" +
+           @ComponentTypes.map{|c| c.type}.join(", ") + ">;"
+    f.puts ""
+
+    f.puts "//! \\brief Returns the holder of a component type, resolved at compile time"
+    f.puts "template<class TComponent>"
+    f.puts "Leviathan::ComponentHolder<TComponent>& GetComponentHolder(){"
+    f.puts ""
+
+    @ComponentTypes.each_with_index{|c, i|
+      f.puts "#{i == 0 ? '' : '} else '}if constexpr(std::is_same_v<TComponent, #{c.type}>){"
+      f.puts "    return Component#{c.type};"
+    }
+
+    f.puts "#{@ComponentTypes.empty? ? '{' : '} else {'}"
+    f.puts "    static_assert(sizeof(TComponent) == 0, " +
+           "\"component type is not in this world\");"
+    f.puts "}"
+    f.puts "}"
+    f.puts ""
+
+    f.puts "//! \\brief Returns the state holder of a component type, resolved at compile time"
+    f.puts "template<class TComponent>"
+    f.puts "Leviathan::StateHolder<typename TComponent::StateT>& GetStatesFor(){"
+    f.puts ""
+
+    first = true
+    @ComponentTypes.each{|c|
+
+      if !c.StateType
+        next
+      end
+
+      f.puts "#{first ? '' : '} else '}if constexpr(std::is_same_v<TComponent, #{c.type}>){"
+      f.puts "    return #{c.type}States;"
+      first = false
+    }
+
+    f.puts "#{first ? '{' : '} else {'}"
+    f.puts <<-END
+    std::tuple<void*, bool> stateHolder = GetStatesFor(TComponent::TYPE);
+
+    if(!std::get<1>(stateHolder))
+        throw Leviathan::InvalidArgument("Unrecognized component type as template parameter "
+            "for state holder");
+
+    return *static_cast<Leviathan::StateHolder<typename TComponent::StateT>*>(
+        std::get<0>(stateHolder));
+}
+}
+END
+
+    f.puts <<-END
+
+//! \\brief Returns a component of an entity
+//!
+//! Types in ComponentTypes are looked up directly from their holder, other types go through
+//! the virtual GetComponent(ObjectID, COMPONENT_TYPE)
+//! \\exception NotFound if entity has no component of the wanted type
+//!
+//! This is copied here as a method with the same name would overwrite this otherwise
+template<class TComponent>
+TComponent& GetComponent(ObjectID id){
+
+    if constexpr(ComponentTypes::Contains<TComponent>){
+
+        TComponent* component = GetComponentHolder<TComponent>().Find(id);
+
+        if(!component)
+            throw Leviathan::NotFound("Component for entity with id was not found");
+
+        return *component;
+
+    } else {
+
+        std::tuple<void*, bool> component = GetComponent(id, TComponent::TYPE);
+
+        if(!std::get<1>(component))
+            throw Leviathan::InvalidArgument(
+                "Unrecognized component type as template parameter");
+
+        void* ptr = std::get<0>(component);
+
+        if(!ptr)
+            throw Leviathan::NotFound("Component for entity with id was not found");
+
+        return *static_cast<TComponent*>(ptr);
+    }
+}
+
+//! \\brief Returns a component of an entity or null
+//! \\see GetComponent
+template<class TComponent>
+TComponent* GetComponentPtr(ObjectID id){
+
+    if constexpr(ComponentTypes::Contains<TComponent>){
+
+        return GetComponentHolder<TComponent>().Find(id);
+
+    } else {
+
+        return static_cast<TComponent*>(std::get<0>(GetComponent(id, TComponent::TYPE)));
+    }
+}
+
+//! \\brief Calls callback(ObjectID, TFirst&, TRest&...) for each entity that has all of the
+//! component types
+//!
+//! All of the TFirst components are looped so it should be the least common of the types.
+//! Components must not be created or destroyed from the callback.
+template<class TFirst, class... TRest, class CallbackT>
+void View(CallbackT&& callback){
+
+    for(const auto& [id, first] : GetComponentHolder<TFirst>().GetIndex()){
+
+        const std::tuple<TRest*...> rest(GetComponentHolder<TRest>().Find(id)...);
+
+        if(!(std::get<TRest*>(rest) && ...))
+            continue;
+
+        callback(id, *first, *std::get<TRest*>(rest)...);
+    }
+}
+END
+  end
+
   def genComponentBinding(c)
     str = ""
 
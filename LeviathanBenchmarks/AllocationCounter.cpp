@@ -0,0 +1,200 @@
+// ------------------------------------ //
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+
+#include <psapi.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <string>
+#endif
+
+using namespace Leviathan::Benchmark;
+// ------------------------------------ //
+static std::atomic<uint64_t> AllocationCount{0};
+static std::atomic<uint64_t> AllocatedByteCount{0};
+
+static void* CountedAllocate(std::size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    AllocatedByteCount.fetch_add(size, std::memory_order_relaxed);
+
+    // malloc(0) may return null //
+    void* memory = std::malloc(size ? size : 1);
+
+    if(!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+static void* CountedAllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    AllocatedByteCount.fetch_add(size, std::memory_order_relaxed);
+
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+
+#ifdef _WIN32
+    void* memory = _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc requires the size to be a multiple of the alignment //
+    void* memory = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+
+    if(!memory)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+static void CountedFreeAligned(void* memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return CountedAllocate(size);
+    } catch(const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return CountedAllocate(size);
+    } catch(const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+// Over aligned types (like the network message pools) use these //
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new(
+    std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try {
+        return CountedAllocateAligned(size, alignment);
+    } catch(const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](
+    std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    try {
+        return CountedAllocateAligned(size, alignment);
+    } catch(const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    CountedFreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    CountedFreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    CountedFreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    CountedFreeAligned(memory);
+}
+// ------------------------------------ //
+namespace Leviathan { namespace Benchmark {
+
+AllocationCounts GetAllocationCounts()
+{
+    return {AllocationCount.load(std::memory_order_relaxed),
+        AllocatedByteCount.load(std::memory_order_relaxed)};
+}
+
+int64_t GetResidentMemory()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if(!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+
+    return static_cast<int64_t>(counters.WorkingSetSize);
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while(std::getline(status, line)) {
+
+        // The line is like "VmRSS:     1234 kB" //
+        if(line.compare(0, 6, "VmRSS:") == 0)
+            return std::stoll(line.substr(6)) * 1024;
+    }
+
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+}} // namespace Leviathan::Benchmark
@@ -0,0 +1,30 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+// ------------------------------------ //
+#include <cstdint>
+
+namespace Leviathan { namespace Benchmark {
+
+//! \brief Counts of the global operator new calls made since the start of the program
+//!
+//! The benchmark executable replaces the global allocation functions to count these
+//! \note On Windows only the allocations made by code in this executable are counted as the
+//! engine library has its own allocation functions
+struct AllocationCounts {
+
+    uint64_t Allocations = 0;
+    uint64_t AllocatedBytes = 0;
+
+    AllocationCounts operator-(const AllocationCounts& other) const
+    {
+        return {Allocations - other.Allocations, AllocatedBytes - other.AllocatedBytes};
+    }
+};
+
+AllocationCounts GetAllocationCounts();
+
+//! \returns The resident memory size of this process in bytes, or -1 if not supported
+int64_t GetResidentMemory();
+
+}} // namespace Leviathan::Benchmark
@@ -0,0 +1,200 @@
+// Headless benchmarks for measuring how long StandardWorld ticks and decoding network
+// messages take. Results are printed as JSON so that they can be compared between runs
+#include "NetworkMessageBenchmark.h"
+#include "TickBenchmark.h"
+
+// The test engine uses catch assertions, this provides them without a main
+#define CATCH_CONFIG_RUNNER
+#include "PartialEngine.h"
+
+#include "Entities/GameWorldFactory.h"
+#include "Exceptions.h"
+#include "Script/ScriptExecutor.h"
+
+#include "boost/program_options.hpp"
+
+#include <fstream>
+#include <iostream>
+
+using namespace Leviathan;
+using namespace Leviathan::Benchmark;
+// ------------------------------------ //
+std::vector<TickBenchmarkScenario> GetBuiltinScenarios()
+{
+    std::vector<TickBenchmarkScenario> scenarios;
+
+    const auto add = [&](const std::string& name, int entities, int physics, int scripts,
+                         int churn) {
+        TickBenchmarkScenario scenario;
+        scenario.Name = name;
+        scenario.Entities = entities;
+        scenario.PhysicsBodies = physics;
+        scenario.ScriptSystems = scripts;
+        scenario.ChurnPerTick = churn;
+        scenarios.push_back(scenario);
+    };
+
+    add("empty", 0, 0, 0, 0);
+    add("positions_1k", 1000, 0, 0, 0);
+    add("positions_10k", 10000, 0, 0, 0);
+    add("physics_500", 500, 500, 0, 0);
+    add("scripts_1k_4", 1000, 0, 4, 0);
+    add("churn_1k_100", 1000, 0, 0, 100);
+    add("mixed", 5000, 500, 2, 50);
+
+    return scenarios;
+}
+
+int main(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    std::vector<std::string> scenarioNames;
+    TickBenchmarkScenario custom;
+    NetworkDecodeBenchmarkScenario networkDecode;
+    std::string output;
+    bool client = false;
+    bool list = false;
+    bool network = false;
+
+    po::options_description desc("Tick benchmark options");
+    // clang-format off
+    desc.add_options()
+        ("help", "Print this help")
+        ("list", po::bool_switch(&list), "List the builtin scenarios")
+        ("scenario", po::value<std::vector<std::string>>(&scenarioNames)->multitoken(),
+            "Builtin scenarios to run, all are ran if neither this or --entities is given")
+        ("entities", po::value<int>(&custom.Entities),
+            "Run a custom scenario with this many entities")
+        ("physics", po::value<int>(&custom.PhysicsBodies),
+            "Entities with physics bodies in the custom scenario")
+        ("scripts", po::value<int>(&custom.ScriptSystems),
+            "Script systems in the custom scenario")
+        ("churn", po::value<int>(&custom.ChurnPerTick),
+            "Entities destroyed and created each tick in the custom scenario")
+        ("client", po::bool_switch(&client), "Run the worlds as clients instead of servers")
+        ("ticks", po::value<int>(), "Measured ticks in each scenario")
+        ("warmup", po::value<int>(), "Ticks ran before measuring in each scenario")
+        ("network", po::bool_switch(&network),
+            "Benchmark decoding received network messages instead of ticking worlds")
+        ("messages", po::value<int>(&networkDecode.Messages),
+            "Messages decoded in each round of the network benchmark")
+        ("output", po::value<std::string>(&output), "Write the results to this file")
+        ;
+    // clang-format on
+
+    po::variables_map vm;
+
+    try {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch(const po::error& e) {
+        std::cerr << "Parsing command line failed: " << e.what() << "\n" << desc;
+        return 2;
+    }
+
+    if(vm.count("help")) {
+        std::cout << desc;
+        return 0;
+    }
+
+    auto scenarios = GetBuiltinScenarios();
+
+    if(list) {
+        for(const auto& scenario : scenarios)
+            std::cout << scenario.Name << "\n";
+        return 0;
+    }
+
+    if(vm.count("entities")) {
+
+        custom.Name = "custom";
+        scenarios = {custom};
+
+    } else if(!scenarioNames.empty()) {
+
+        std::vector<TickBenchmarkScenario> selected;
+
+        for(const auto& name : scenarioNames) {
+
+            const auto found = std::find_if(scenarios.begin(), scenarios.end(),
+                [&](const TickBenchmarkScenario& scenario) { return scenario.Name == name; });
+
+            if(found == scenarios.end()) {
+                std::cerr << "Unknown scenario: " << name << "\n";
+                return 2;
+            }
+
+            selected.push_back(*found);
+        }
+
+        scenarios = selected;
+    }
+
+    for(auto& scenario : scenarios) {
+
+        scenario.Server = !client;
+
+        if(vm.count("ticks"))
+            scenario.Ticks = vm["ticks"].as<int>();
+
+        if(vm.count("warmup"))
+            scenario.WarmupTicks = vm["warmup"].as<int>();
+    }
+
+    Test::PartialEngine<false, Logger> engine;
+    ScriptExecutor scripts;
+    GameWorldFactory worldFactory;
+
+    Json::Value results(Json::arrayValue);
+
+    if(network) {
+
+        std::cerr << "Running network message decoding" << std::endl;
+
+        try {
+            results.append(RunNetworkDecodeBenchmark(networkDecode).ToJSON());
+        } catch(const std::exception& e) {
+            std::cerr << "Network message decoding failed: " << e.what() << std::endl;
+            return 1;
+        }
+
+        scenarios.clear();
+    }
+
+    for(const auto& scenario : scenarios) {
+
+        std::cerr << "Running scenario: " << scenario.Name << std::endl;
+
+        try {
+            results.append(RunTickBenchmark(scenario, scripts).ToJSON());
+        } catch(const std::exception& e) {
+            std::cerr << "Scenario " << scenario.Name << " failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    Json::Value root;
+    root["leviathan_version"] = LEVIATHAN_VERSION_ANSIS;
+    root["tickspeed_ms"] = TICKSPEED;
+    root["results"] = results;
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+
+    const auto json = Json::writeString(builder, root);
+
+    if(output.empty()) {
+        std::cout << json << std::endl;
+        return 0;
+    }
+
+    std::ofstream file(output);
+
+    if(!file.good() || !(file << json << std::endl)) {
+        std::cerr << "Failed to write results to: " << output << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
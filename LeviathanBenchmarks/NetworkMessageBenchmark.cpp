@@ -0,0 +1,190 @@
+// ------------------------------------ //
+#include "NetworkMessageBenchmark.h"
+
+#include "Entities/Component.h"
+#include "Exceptions.h"
+#include "Networking/NetworkResponse.h"
+#include "TimeIncludes.h"
+
+#include <algorithm>
+
+using namespace Leviathan;
+using namespace Leviathan::Benchmark;
+// ------------------------------------ //
+Json::Value NetworkDecodeStats::ToJSON(int rounds) const
+{
+    Json::Value value;
+    value["round_us"] = Round.ToJSON();
+
+    const auto divider = static_cast<uint64_t>(std::max(rounds, 1));
+
+    value["allocations_per_round"] = Json::UInt64(Allocations.Allocations / divider);
+    value["bytes_per_round"] = Json::UInt64(Allocations.AllocatedBytes / divider);
+    return value;
+}
+
+Json::Value NetworkDecodeBenchmarkResult::ToJSON() const
+{
+    Json::Value value;
+
+    Json::Value& scenario = value["scenario"];
+    scenario["name"] = "network_decode";
+    scenario["messages"] = Scenario.Messages;
+    scenario["warmup_rounds"] = Scenario.WarmupRounds;
+    scenario["rounds"] = Scenario.Rounds;
+
+    value["make_shared"] = MakeShared.ToJSON(Scenario.Rounds);
+    value["pooled"] = Pooled.ToJSON(Scenario.Rounds);
+
+    Json::Value& updates = value["entity_updates_with_filled_pools"];
+    updates["decoded"] = EntityUpdates;
+    updates["allocations"] = Json::UInt64(EntityUpdateAllocations.Allocations);
+    updates["bytes"] = Json::UInt64(EntityUpdateAllocations.AllocatedBytes);
+
+    return value;
+}
+// ------------------------------------ //
+namespace {
+std::vector<sf::Packet> GenerateResponseStream(int count)
+{
+    std::vector<sf::Packet> result;
+    result.reserve(count);
+
+    for(int i = 0; i < count; ++i) {
+
+        sf::Packet packet;
+
+        if(i % 50 == 0) {
+
+            sf::Packet componentData;
+            componentData << static_cast<uint16_t>(COMPONENT_TYPE::Position) << 1.f << 2.f
+                          << 3.f << "some component data";
+
+            ResponseEntityCreation(0, 1, i, 1, std::move(componentData))
+                .AddDataToPacket(packet);
+
+        } else if(i % 50 == 25) {
+
+            ResponseEntityDestruction(0, 1, i - 25).AddDataToPacket(packet);
+
+        } else if(i % 10 == 0) {
+
+            ResponseNone(NETWORK_RESPONSE_TYPE::Keepalive, i).AddDataToPacket(packet);
+
+        } else {
+
+            sf::Packet updateData;
+            updateData << static_cast<uint16_t>(COMPONENT_TYPE::Position) << 1.f << 2.f << 3.f
+                       << 0.f << 0.f << 0.f << 1.f;
+
+            ResponseEntityUpdate(0, 1, i, i - 1, i % 200, std::move(updateData))
+                .AddDataToPacket(packet);
+        }
+
+        result.push_back(std::move(packet));
+    }
+
+    return result;
+}
+
+//! Same as NetworkResponse::LoadFromPacket but allocating with std::make_shared
+std::shared_ptr<NetworkResponse> LoadWithMakeShared(sf::Packet& packet)
+{
+    uint16_t rawtype;
+    uint32_t responseid;
+    packet >> rawtype >> responseid;
+
+    const auto type = static_cast<NETWORK_RESPONSE_TYPE>(rawtype);
+
+    switch(type) {
+    case NETWORK_RESPONSE_TYPE::EntityCreation:
+        return std::make_shared<ResponseEntityCreation>(responseid, packet);
+    case NETWORK_RESPONSE_TYPE::EntityDestruction:
+        return std::make_shared<ResponseEntityDestruction>(responseid, packet);
+    case NETWORK_RESPONSE_TYPE::EntityUpdate:
+        return std::make_shared<ResponseEntityUpdate>(responseid, packet);
+    default: return std::make_shared<ResponseNone>(type, responseid, packet);
+    }
+}
+
+//! \returns The number of decoded messages
+template<class LoadT>
+int DecodeRounds(const NetworkDecodeBenchmarkScenario& scenario,
+    const std::vector<sf::Packet>& stream, NetworkDecodeStats& stats, LoadT load)
+{
+    std::vector<int64_t> durations;
+    durations.reserve(scenario.Rounds);
+
+    int decoded = 0;
+
+    for(int round = 0; round < scenario.WarmupRounds + scenario.Rounds; ++round) {
+
+        // Decoding reads the packets so each round needs its own copies //
+        auto packets = stream;
+
+        const auto allocationsBefore = GetAllocationCounts();
+        const auto start = WantedClockType::now();
+
+        for(sf::Packet& packet : packets) {
+            if(load(packet))
+                ++decoded;
+        }
+
+        const auto end = WantedClockType::now();
+        const auto allocations = GetAllocationCounts() - allocationsBefore;
+
+        if(round < scenario.WarmupRounds)
+            continue;
+
+        stats.Allocations.Allocations += allocations.Allocations;
+        stats.Allocations.AllocatedBytes += allocations.AllocatedBytes;
+
+        durations.push_back(
+            std::chrono::duration_cast<MicrosecondDuration>(end - start).count());
+    }
+
+    stats.Round = DurationStats::Calculate(std::move(durations));
+    return decoded;
+}
+} // namespace
+// ------------------------------------ //
+namespace Leviathan { namespace Benchmark {
+
+NetworkDecodeBenchmarkResult RunNetworkDecodeBenchmark(
+    const NetworkDecodeBenchmarkScenario& scenario)
+{
+    NetworkDecodeBenchmarkResult result;
+    result.Scenario = scenario;
+
+    const auto stream = GenerateResponseStream(scenario.Messages);
+
+    const auto makeSharedCount = DecodeRounds(scenario, stream, result.MakeShared,
+        [](sf::Packet& packet) { return LoadWithMakeShared(packet); });
+
+    const auto pooledCount = DecodeRounds(scenario, stream, result.Pooled,
+        [](sf::Packet& packet) { return NetworkResponse::LoadFromPacket(packet); });
+
+    if(makeSharedCount != pooledCount)
+        throw InvalidState("std::make_shared and the pools decoded different message counts");
+
+    // The pools are filled by the rounds above so the entity updates shouldn't allocate //
+    auto packets = stream;
+
+    for(sf::Packet& packet : packets) {
+
+        const auto allocationsBefore = GetAllocationCounts();
+        auto loaded = NetworkResponse::LoadFromPacket(packet);
+        const auto allocations = GetAllocationCounts() - allocationsBefore;
+
+        if(!loaded || loaded->GetType() != NETWORK_RESPONSE_TYPE::EntityUpdate)
+            continue;
+
+        ++result.EntityUpdates;
+        result.EntityUpdateAllocations.Allocations += allocations.Allocations;
+        result.EntityUpdateAllocations.AllocatedBytes += allocations.AllocatedBytes;
+    }
+
+    return result;
+}
+
+}} // namespace Leviathan::Benchmark
@@ -0,0 +1,54 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+// ------------------------------------ //
+#include "TickBenchmark.h"
+
+namespace Leviathan { namespace Benchmark {
+
+//! \brief Configuration for decoding a stream of messages like the ones a client receives
+//! while in a world
+struct NetworkDecodeBenchmarkScenario {
+
+    //! Mostly entity updates with some creations, destructions and keepalives mixed in
+    int Messages = 10000;
+
+    int WarmupRounds = 2;
+    int Rounds = 20;
+};
+
+//! \brief Durations and allocations of decoding the whole stream with one method
+struct NetworkDecodeStats {
+
+    DurationStats Round;
+
+    //! Allocations made by the measured rounds
+    AllocationCounts Allocations;
+
+    Json::Value ToJSON(int rounds) const;
+};
+
+struct NetworkDecodeBenchmarkResult {
+
+    NetworkDecodeBenchmarkScenario Scenario;
+
+    //! Decoded with std::make_shared for comparison
+    NetworkDecodeStats MakeShared;
+
+    //! Decoded with NetworkResponse::LoadFromPacket which uses the message pools
+    NetworkDecodeStats Pooled;
+
+    //! Allocations made by decoding entity updates after the pools have been filled. This
+    //! should be 0
+    AllocationCounts EntityUpdateAllocations;
+    int EntityUpdates = 0;
+
+    Json::Value ToJSON() const;
+};
+
+//! \brief Decodes the same messages with std::make_shared and with the message pools
+//! \exception InvalidState if the two methods don't decode the same amount of messages
+NetworkDecodeBenchmarkResult RunNetworkDecodeBenchmark(
+    const NetworkDecodeBenchmarkScenario& scenario);
+
+}} // namespace Leviathan::Benchmark
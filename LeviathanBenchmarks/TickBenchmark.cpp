@@ -0,0 +1,236 @@
+// ------------------------------------ //
+#include "TickBenchmark.h"
+
+#include "Entities/GameWorldFactory.h"
+#include "Exceptions.h"
+#include "Generated/StandardWorld.h"
+#include "Physics/PhysicalWorld.h"
+#include "Physics/PhysicsMaterialManager.h"
+#include "Script/ScriptExecutor.h"
+#include "Script/ScriptModule.h"
+#include "TimeIncludes.h"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+
+using namespace Leviathan;
+using namespace Leviathan::Benchmark;
+// ------------------------------------ //
+constexpr auto BENCHMARK_SCRIPT_FILE = "Data/Scripts/benchmarks/TickBenchmark.as";
+
+DurationStats DurationStats::Calculate(std::vector<int64_t> durations)
+{
+    DurationStats stats;
+
+    if(durations.empty())
+        return stats;
+
+    std::sort(durations.begin(), durations.end());
+
+    const auto percentile = [&](size_t percent) {
+        return durations[std::min(durations.size() - 1, durations.size() * percent / 100)];
+    };
+
+    stats.Mean = std::accumulate(durations.begin(), durations.end(), int64_t(0)) /
+                 static_cast<int64_t>(durations.size());
+    stats.P50 = percentile(50);
+    stats.P90 = percentile(90);
+    stats.P99 = percentile(99);
+    stats.Max = durations.back();
+    return stats;
+}
+
+Json::Value DurationStats::ToJSON() const
+{
+    Json::Value value;
+    value["mean"] = Json::Int64(Mean);
+    value["p50"] = Json::Int64(P50);
+    value["p90"] = Json::Int64(P90);
+    value["p99"] = Json::Int64(P99);
+    value["max"] = Json::Int64(Max);
+    return value;
+}
+// ------------------------------------ //
+Json::Value TickBenchmarkResult::ToJSON() const
+{
+    Json::Value value;
+
+    Json::Value& scenario = value["scenario"];
+    scenario["name"] = Scenario.Name;
+    scenario["entities"] = Scenario.Entities;
+    scenario["physics_bodies"] = Scenario.PhysicsBodies;
+    scenario["script_systems"] = Scenario.ScriptSystems;
+    scenario["churn_per_tick"] = Scenario.ChurnPerTick;
+    scenario["server"] = Scenario.Server;
+    scenario["warmup_ticks"] = Scenario.WarmupTicks;
+    scenario["ticks"] = Scenario.Ticks;
+
+    // All durations are in microseconds //
+    Json::Value& phases = value["tick_us"];
+    phases["total"] = Total.ToJSON();
+    phases["packets"] = Packets.ToJSON();
+    phases["deletes"] = Deletes.ToJSON();
+    phases["node_creation"] = NodeCreation.ToJSON();
+    phases["physics"] = Physics.ToJSON();
+    phases["systems"] = Systems.ToJSON();
+    phases["send"] = Send.ToJSON();
+
+    const auto ticks = static_cast<uint64_t>(std::max(Scenario.Ticks, 1));
+
+    Json::Value& allocations = value["allocations"];
+    allocations["total"] = Json::UInt64(TickAllocations.Allocations);
+    allocations["total_bytes"] = Json::UInt64(TickAllocations.AllocatedBytes);
+    allocations["per_tick"] = Json::UInt64(TickAllocations.Allocations / ticks);
+    allocations["bytes_per_tick"] = Json::UInt64(TickAllocations.AllocatedBytes / ticks);
+
+    Json::Value& memory = value["memory"];
+    memory["before_setup_bytes"] = Json::Int64(MemoryBeforeSetup);
+    memory["after_ticks_bytes"] = Json::Int64(MemoryAfterTicks);
+
+    return value;
+}
+// ------------------------------------ //
+namespace Leviathan { namespace Benchmark {
+
+TickBenchmarkResult RunTickBenchmark(
+    const TickBenchmarkScenario& scenario, ScriptExecutor& scripts)
+{
+    TickBenchmarkResult result;
+    result.Scenario = scenario;
+    result.MemoryBeforeSetup = GetResidentMemory();
+
+    auto materials =
+        scenario.PhysicsBodies > 0 ? std::make_shared<PhysicsMaterialManager>() : nullptr;
+
+    auto world = std::dynamic_pointer_cast<StandardWorld>(
+        GameWorldFactory::Get()->CreateNewWorld(0, materials));
+
+    if(!world)
+        throw InvalidState("GameWorldFactory didn't create a StandardWorld");
+
+    world->SetRunInBackground(true);
+
+    if(!world->Init(scenario.Server ? WorldNetworkSettings::GetSettingsForServer() :
+                                      WorldNetworkSettings::GetSettingsForSinglePlayer(),
+           nullptr))
+        throw InvalidState("Failed to init the benchmark world");
+
+    std::shared_ptr<ScriptModule> module;
+
+    if(scenario.ScriptSystems > 0) {
+
+        module = scripts.CreateNewModule("TickBenchmark", "LeviathanBenchmarks").lock();
+
+        if(!module || !module->AddScriptSegmentFromFile(BENCHMARK_SCRIPT_FILE))
+            throw InvalidState("Failed to load benchmark script");
+
+        ScriptRunningSetup setup("SetupBenchmarkSystems");
+
+        auto returned = scripts.RunScript<bool>(
+            module, setup, static_cast<GameWorld*>(world.get()), scenario.ScriptSystems);
+
+        if(returned.Result != SCRIPT_RUN_RESULT::Success || !returned.Value)
+            throw InvalidState("Failed to setup benchmark script systems");
+    }
+
+    PhysicalWorld* physicsWorld = world->GetPhysicalWorld();
+    PhysicsShape::pointer sphere;
+
+    if(physicsWorld)
+        sphere = physicsWorld->CreateSphere(1);
+
+    const auto createEntity = [&](int number, bool physics) {
+        const auto id = world->CreateEntity();
+
+        // Spread out on a grid so that the bodies don't all collide //
+        const Float3 start(static_cast<float>((number % 32) * 3),
+            static_cast<float>(5 + (number / 1024) * 3),
+            static_cast<float>(((number / 32) % 32) * 3));
+
+        auto& position = world->Create_Position(id, start, Float4::IdentityQuaternion());
+
+        if(physics) {
+
+            auto& body = world->Create_Physics(id, position);
+
+            if(!body.CreatePhysicsBody(physicsWorld, sphere, 10))
+                throw InvalidState("Failed to create a physics body");
+        }
+
+        return id;
+    };
+
+    for(int i = 0; i < scenario.Entities; ++i)
+        createEntity(i, i < scenario.PhysicsBodies);
+
+    std::deque<ObjectID> churned;
+
+    for(int i = 0; i < scenario.ChurnPerTick; ++i)
+        churned.push_back(createEntity(i, false));
+
+    std::vector<int64_t> total, packets, deletes, nodeCreation, physics, systems, send;
+
+    for(auto* durations :
+        {&total, &packets, &deletes, &nodeCreation, &physics, &systems, &send})
+        durations->reserve(scenario.Ticks);
+
+    WorldTickTimings timings;
+    world->SetTickTimingsTarget(&timings);
+
+    const int tickCount = scenario.WarmupTicks + scenario.Ticks;
+
+    for(int tick = 1; tick <= tickCount; ++tick) {
+
+        // The churned entities are destroyed at the start of the next tick //
+        for(int i = 0; i < scenario.ChurnPerTick; ++i) {
+
+            world->QueueDestroyEntity(churned.front());
+            churned.pop_front();
+            churned.push_back(createEntity(i, false));
+        }
+
+        const auto allocationsBefore = GetAllocationCounts();
+        const auto start = WantedClockType::now();
+
+        world->Tick(tick);
+
+        const auto end = WantedClockType::now();
+        const auto allocations = GetAllocationCounts() - allocationsBefore;
+
+        if(tick <= scenario.WarmupTicks)
+            continue;
+
+        result.TickAllocations.Allocations += allocations.Allocations;
+        result.TickAllocations.AllocatedBytes += allocations.AllocatedBytes;
+
+        total.push_back(std::chrono::duration_cast<MicrosecondDuration>(end - start).count());
+        packets.push_back(timings.Packets);
+        deletes.push_back(timings.Deletes);
+        nodeCreation.push_back(timings.NodeCreation);
+        physics.push_back(timings.Physics);
+        systems.push_back(timings.Systems);
+        send.push_back(timings.Send);
+    }
+
+    result.MemoryAfterTicks = GetResidentMemory();
+
+    world->SetTickTimingsTarget(nullptr);
+    world->Release();
+    world.reset();
+
+    if(module)
+        scripts.DeleteModule(module.get());
+
+    result.Total = DurationStats::Calculate(std::move(total));
+    result.Packets = DurationStats::Calculate(std::move(packets));
+    result.Deletes = DurationStats::Calculate(std::move(deletes));
+    result.NodeCreation = DurationStats::Calculate(std::move(nodeCreation));
+    result.Physics = DurationStats::Calculate(std::move(physics));
+    result.Systems = DurationStats::Calculate(std::move(systems));
+    result.Send = DurationStats::Calculate(std::move(send));
+
+    return result;
+}
+
+}} // namespace Leviathan::Benchmark
@@ -0,0 +1,83 @@
+// Leviathan Game Engine
+// Copyright (c) 2012-2019 Henri Hyyryläinen
+#pragma once
+// ------------------------------------ //
+#include "AllocationCounter.h"
+
+#include "json/json.h"
+
+#include <string>
+#include <vector>
+
+namespace Leviathan {
+
+class ScriptExecutor;
+
+namespace Benchmark {
+
+//! \brief Configuration of a headless StandardWorld that is ticked for measuring
+struct TickBenchmarkScenario {
+
+    std::string Name;
+
+    //! All entities have a Position
+    int Entities = 1000;
+
+    //! This many of the entities also get a physics body
+    int PhysicsBodies = 0;
+
+    //! Number of script systems that go through all the positions each tick
+    int ScriptSystems = 0;
+
+    //! Entities that are destroyed and created again each tick
+    int ChurnPerTick = 0;
+
+    //! Server worlds create Sendable components for all entities
+    bool Server = true;
+
+    int WarmupTicks = 10;
+    int Ticks = 200;
+};
+
+//! \brief Percentiles of durations in microseconds
+struct DurationStats {
+
+    int64_t Mean = 0;
+    int64_t P50 = 0;
+    int64_t P90 = 0;
+    int64_t P99 = 0;
+    int64_t Max = 0;
+
+    static DurationStats Calculate(std::vector<int64_t> durations);
+
+    Json::Value ToJSON() const;
+};
+
+struct TickBenchmarkResult {
+
+    TickBenchmarkScenario Scenario;
+
+    DurationStats Total;
+    DurationStats Packets;
+    DurationStats Deletes;
+    DurationStats NodeCreation;
+    DurationStats Physics;
+    DurationStats Systems;
+    DurationStats Send;
+
+    //! Allocations made by the measured ticks
+    AllocationCounts TickAllocations;
+
+    int64_t MemoryBeforeSetup = -1;
+    int64_t MemoryAfterTicks = -1;
+
+    Json::Value ToJSON() const;
+};
+
+//! \brief Creates the world for scenario with the GameWorldFactory and ticks it
+//! \param scripts Used to load the script systems if the scenario has any
+//! \exception InvalidState if the scenario can't be setup
+TickBenchmarkResult RunTickBenchmark(
+    const TickBenchmarkScenario& scenario, ScriptExecutor& scripts);
+
+}} // namespace Leviathan::Benchmark
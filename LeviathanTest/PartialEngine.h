@@ -193,7 +193,9 @@ public:
 
 
 //! \brief Partial implementation of Leviathan::Engine for tests
-template<bool UseActualInit>
+//! \param LoggerT The type of Log. Benchmarks use a plain Logger as they don't run inside
+//! catch test cases
+template<bool UseActualInit, class LoggerT = TestLogger>
 class PartialEngine : public Engine {
 public:
     PartialEngine(NetworkHandler* handler = nullptr) : Engine(&App), Log("Test/TestLog.txt")
@@ -259,7 +261,7 @@ public:
     }
 
     PartialApplication App;
-    TestLogger Log;
+    LoggerT Log;
     AppDef Def;
 };
 
@@ -9,6 +9,8 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+
 using namespace Leviathan;
 using namespace Leviathan::Test;
 
@@ -74,6 +76,91 @@ TEST_CASE("RenderingPositionSystem creates nodes", "[entity]"){
 
 }
 
+TEST_CASE("ComponentHolder tracks marked components", "[entity]")
+{
+    ComponentHolder<Position> ComponentPosition;
+
+    auto first = ComponentPosition.ConstructNew(
+        1, Position::Data{Float3(0, 1, 2), Float4::IdentityQuaternion()});
+    auto second = ComponentPosition.ConstructNew(
+        2, Position::Data{Float3(0, 1, 2), Float4::IdentityQuaternion()});
+    ComponentPosition.ConstructNew(
+        3, Position::Data{Float3(0, 1, 2), Float4::IdentityQuaternion()});
+
+    // New components are marked
+    CHECK(ComponentPosition.GetMarkedCount() == 3);
+    CHECK(ComponentPosition.GetStateMarkedCount() == 3);
+
+    first->Marked = false;
+    second->Marked = false;
+    second->Marked = false;
+
+    std::vector<ObjectID> marked;
+    ComponentPosition.ForEachMarked([&](Position& position, ObjectID id) {
+        CHECK(position.Marked);
+        marked.push_back(id);
+    });
+
+    CHECK(marked == std::vector<ObjectID>{3});
+
+    SECTION("Unmarking while looping")
+    {
+        second->Marked = true;
+
+        int calls = 0;
+        ComponentPosition.ForEachMarked([&](Position& position, ObjectID id) {
+            ++calls;
+            position.Marked = false;
+        });
+
+        CHECK(calls == 2);
+        CHECK(ComponentPosition.GetMarkedCount() == 0);
+        CHECK(!second->Marked);
+    }
+
+    SECTION("Destroyed components are removed")
+    {
+        first->Marked = true;
+        ComponentPosition.Destroy(3);
+
+        marked.clear();
+        ComponentPosition.ForEachMarked(
+            [&](Position& position, ObjectID id) { marked.push_back(id); });
+
+        CHECK(marked == std::vector<ObjectID>{1});
+    }
+
+    SECTION("Buffered flags update the list when applied")
+    {
+        ComponentChangeBuffer buffer;
+
+        {
+            ComponentChangeBuffer::Scope buffering(buffer);
+
+            first->Marked = true;
+            second->Marked = true;
+            second->Marked = false;
+            second->Marked = true;
+
+            CHECK(first->Marked);
+            CHECK(ComponentPosition.GetMarkedCount() == 1);
+        }
+
+        // Not buffered anymore
+        ComponentPosition.Find(3)->Marked = false;
+        CHECK(ComponentPosition.GetMarkedCount() == 0);
+
+        buffer.Apply();
+
+        marked.clear();
+        ComponentPosition.ForEachMarked(
+            [&](Position& position, ObjectID id) { marked.push_back(id); });
+
+        std::sort(marked.begin(), marked.end());
+        CHECK(marked == std::vector<ObjectID>{1, 2});
+    }
+}
+
 TEST_CASE("PositionStateSystem creates state objects", "[entity]"){
 
     PartialEngine<false> engine;
@@ -97,14 +184,14 @@ TEST_CASE("PositionStateSystem creates state objects", "[entity]"){
     CHECK(PositionStates.GetNumberOfEntitiesWithStates() == 0);
     CHECK(!PositionStates.GetEntityStates(id));
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, ++tick);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, ++tick);
 
     CHECK(PositionStates.GetNumberOfEntitiesWithStates() == 1);
     REQUIRE(PositionStates.GetEntityStates(id));
     CHECK(PositionStates.GetEntityStates(id)->GetNumberOfStates() == 1);
 
     // No new state is created
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, ++tick);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, ++tick);
 
     CHECK(PositionStates.GetNumberOfEntitiesWithStates() == 1);
     REQUIRE(PositionStates.GetEntityStates(id));
@@ -113,7 +200,7 @@ TEST_CASE("PositionStateSystem creates state objects", "[entity]"){
     // Even if marked
     pos->Marked = true;
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, ++tick);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, ++tick);
 
     CHECK(PositionStates.GetNumberOfEntitiesWithStates() == 1);
     REQUIRE(PositionStates.GetEntityStates(id));
@@ -123,7 +210,7 @@ TEST_CASE("PositionStateSystem creates state objects", "[entity]"){
     pos->Marked = true;
     pos->Members._Position = Float3(1, 1, 1);
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, ++tick);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, ++tick);
 
     CHECK(PositionStates.GetNumberOfEntitiesWithStates() == 1);
     REQUIRE(PositionStates.GetEntityStates(id));
@@ -170,7 +257,7 @@ TEST_CASE("PositionStateSystem single state is interpolated", "[entity]"){
 
     // State marked by default to always apply the initial position even if there are no states
     //CHECK(!pos->StateMarked);
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 1);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 1);
     CHECK(pos->StateMarked);
 
     REQUIRE(PositionStates.GetEntityStates(id));
@@ -225,12 +312,12 @@ TEST_CASE("PositionStateSystem created states can be interpolated", "[entity]"){
     auto pos = ComponentPosition.ConstructNew(id,
         Position::Data{Float3(1, 6, 0), Float4::IdentityQuaternion()});
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 1);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 1);
 
     pos->Marked = true;
     pos->Members._Position = Float3(3, 12, 1);
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 2);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 2);
 
     REQUIRE(PositionStates.GetEntityStates(id));
     CHECK(PositionStates.GetEntityStates(id)->GetNumberOfStates() == 2);
@@ -291,31 +378,31 @@ TEST_CASE("PositionStateSystem multiple states with gaps can be interpolated", "
     auto pos = ComponentPosition.ConstructNew(id,
         Position::Data{Float3(0, 0, 0), Float4::IdentityQuaternion()});
     
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 1);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 1);
 
     
     pos->Members._Position = Float3(1, 0, 0);
     pos->Marked = true;
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 2);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 2);
 
     
     pos->Members._Position = Float3(2, 0, 0);
     pos->Marked = true;
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 3);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 3);
 
     
     pos->Members._Position = Float3(3, 0, 0);
     pos->Marked = true; 
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 5);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 5);
 
     
     pos->Members._Position = Float3(4, 0, 0);
     pos->Marked = true; 
 
-    _PositionStateSystem.Run(dummyWorld, ComponentPosition.GetIndex(), PositionStates, 6);
+    _PositionStateSystem.Run(dummyWorld, ComponentPosition, PositionStates, 6);
 
     // Initial time set
     StateInterpolator::Interpolate(PositionStates, id, pos, 1, 0);
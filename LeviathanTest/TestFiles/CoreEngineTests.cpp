@@ -6,6 +6,10 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <array>
+#include <thread>
+
 using namespace Leviathan;
 using namespace Leviathan::Test;
 
@@ -14,13 +18,19 @@ class InvokeTestPartialEngine : public Test::PartialEngine<false> {
 public:
     void RunInvokes()
     {
+        CHECK(HasInvokes());
 
-        {
-            RecursiveLock lock(InvokeLock);
-            CHECK(!InvokeQueue.empty());
+        ProcessInvokes();
+    }
+
+    bool HasInvokes() const
+    {
+        for(const auto& queue : InvokeQueues) {
+            if(!queue.IsEmpty())
+                return true;
         }
 
-        ProcessInvokes();
+        return false;
     }
 };
 
@@ -53,6 +63,110 @@ TEST_CASE("Invokes work", "[engine][threading]")
 
         CHECK(invokeCalled);
     }
+
+    SECTION("Higher priority invokes run first")
+    {
+        std::vector<int> order;
+
+        engine.Invoke([&]() { order.push_back(3); }, INVOKE_PRIORITY::Low);
+        engine.Invoke([&]() { order.push_back(2); });
+        engine.Invoke([&]() { order.push_back(1); }, INVOKE_PRIORITY::High);
+        engine.Invoke([&]() { order.push_back(4); }, INVOKE_PRIORITY::Low);
+
+        engine.RunInvokes();
+
+        CHECK(order == std::vector<int>{1, 2, 3, 4});
+    }
+
+    SECTION("Invokes over the time budget are left for the next tick")
+    {
+        engine.SetInvokeTimeBudget(1);
+
+        int normalCalled = 0;
+        bool highCalled = false;
+
+        for(int i = 0; i < 2; ++i) {
+            engine.Invoke([&]() {
+                ++normalCalled;
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            });
+        }
+
+        engine.Invoke([&]() { highCalled = true; }, INVOKE_PRIORITY::High);
+
+        engine.RunInvokes();
+
+        CHECK(highCalled);
+        CHECK(normalCalled == 1);
+        CHECK(engine.HasInvokes());
+
+        engine.RunInvokes();
+
+        CHECK(normalCalled == 2);
+        CHECK(!engine.HasInvokes());
+    }
+
+    SECTION("Invokes from multiple threads")
+    {
+        constexpr int THREADS = 4;
+        constexpr int INVOKES_PER_THREAD = 1000;
+
+        std::vector<int> received(THREADS * INVOKES_PER_THREAD, 0);
+        std::vector<std::thread> threads;
+
+        for(int thread = 0; thread < THREADS; ++thread) {
+            threads.emplace_back([&, thread]() {
+                for(int i = 0; i < INVOKES_PER_THREAD; ++i) {
+                    const auto index = thread * INVOKES_PER_THREAD + i;
+                    engine.Invoke([&received, index]() { ++received[index]; });
+                }
+            });
+        }
+
+        for(auto& thread : threads)
+            thread.join();
+
+        engine.SetInvokeTimeBudget(0);
+        engine.RunInvokes();
+
+        CHECK(std::count(received.begin(), received.end(), 1) == THREADS * INVOKES_PER_THREAD);
+    }
+}
+
+TEST_CASE("InvokeFunction stores small and large functors", "[threading]")
+{
+    auto captured = std::make_shared<int>(0);
+
+    SECTION("Small functor")
+    {
+        InvokeFunction function([captured]() { ++*captured; });
+        CHECK(captured.use_count() == 2);
+
+        InvokeFunction moved(std::move(function));
+        CHECK(!function);
+
+        moved();
+        CHECK(*captured == 1);
+
+        moved.Reset();
+        CHECK(captured.use_count() == 1);
+    }
+
+    SECTION("Large functor")
+    {
+        std::array<char, InvokeFunction::INLINE_STORAGE_SIZE * 2> data{};
+        data[0] = 2;
+
+        InvokeFunction function([captured, data]() { *captured += data[0]; });
+
+        InvokeFunction moved;
+        moved = std::move(function);
+
+        moved();
+        CHECK(*captured == 2);
+    }
+
+    CHECK(captured.use_count() == 1);
 }
 
 TEST_CASE("Invokes work from scripts", "[engine][script]")
@@ -211,3 +325,65 @@ TEST_CASE("Random gives values between the correct things", "[engine][random]")
         }
     }
 }
+
+TEST_CASE("Engine ticks as fast as possible", "[engine]")
+{
+    PartialEngine<false> engine;
+
+    engine.SetTickAsFastAsPossible(true);
+    engine.SetMaxTicksPerCall(10);
+
+    // The clock is not looked at //
+    engine.ResetClock(0);
+
+    engine.Tick();
+    CHECK(engine.GetCurrentTick() == 10);
+
+    engine.Tick();
+    CHECK(engine.GetCurrentTick() == 20);
+    CHECK(engine.GetSkippedTicks() == 0);
+}
+
+TEST_CASE("Engine limits catching up with ticks", "[engine]")
+{
+    PartialEngine<false> engine;
+
+    // Skipping ticks prints a warning //
+    engine.Log.IgnoreWarnings = true;
+
+    engine.SetMaxTicksPerCall(2);
+
+    SECTION("Not behind")
+    {
+        engine.ResetClock(TICKSPEED / 2);
+
+        engine.Tick();
+        CHECK(engine.GetCurrentTick() == 0);
+    }
+
+    SECTION("Catching up runs at most MaxTicksPerCall")
+    {
+        engine.SetMaxTicksBehind(0);
+        engine.ResetClock(TICKSPEED * 5 + TICKSPEED / 2);
+
+        engine.Tick();
+        CHECK(engine.GetCurrentTick() == 2);
+
+        engine.Tick();
+        CHECK(engine.GetCurrentTick() == 4);
+        CHECK(engine.GetSkippedTicks() == 0);
+    }
+
+    SECTION("Ticks too far behind are skipped")
+    {
+        engine.SetMaxTicksBehind(5);
+        engine.ResetClock(TICKSPEED * 20 + TICKSPEED / 2);
+
+        engine.Tick();
+        CHECK(engine.GetCurrentTick() == 2);
+
+        // 18 ticks behind after running 2 //
+        CHECK(engine.GetSkippedTicks() == 13);
+        CHECK(engine.GetTimeSinceLastTick() < TICKSPEED * 6);
+    }
+}
@@ -3,15 +3,22 @@
 // from it
 #include "../PartialEngine.h"
 
+#include "Entities/WorldSnapshot.h"
 #include "Generated/StandardWorld.h"
 
 #include "Handlers/IDFactory.h"
 #include "Script/Bindings/BindHelpers.h"
 #include "Script/ScriptExecutor.h"
 #include "Script/ScriptModule.h"
+#include "Threading/ThreadingManager.h"
+
+#include "add_on/scriptarray/scriptarray.h"
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <sstream>
+
 using namespace Leviathan;
 using namespace Leviathan::Test;
 
@@ -118,3 +125,502 @@ TEST_CASE("Script node helper works with multiple script classes", "[script][ent
 
     REQUIRE_NOTHROW(world.Release());
 }
+
+TEST_CASE("Script node helper handles nodes being removed and re-added", "[script][entity]")
+{
+    PartialEngine<false> engine;
+
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    // Script needs to be valid for releasing the components
+    StandardWorld world(nullptr);
+    world.SetRunInBackground(true);
+
+    // setup the script //
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+    CHECK(mod->AddScriptSegmentFromFile("Data/Scripts/tests/CustomScriptComponentTest.as"));
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    ScriptRunningSetup ssetup("SetupCustomComponents");
+
+    auto returned = exec.RunScript<bool>(mod, ssetup, static_cast<GameWorld*>(&world));
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    REQUIRE(returned.Value == true);
+
+    world.Tick(1);
+
+    const auto nodeCount = [&]() {
+        ScriptRunningSetup setup("GetCachedNodeCount");
+        auto result = exec.RunScript<uint32_t>(mod, setup, static_cast<GameWorld*>(&world));
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+        return result.Value;
+    };
+
+    const auto nodesFor = [&](ObjectID id) {
+        ScriptRunningSetup setup("CountCachedNodes");
+        auto result = exec.RunScript<int>(mod, setup, static_cast<GameWorld*>(&world), id);
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+        return result.Value;
+    };
+
+    const auto runWithID = [&](const char* function, ObjectID id) {
+        ScriptRunningSetup setup(function);
+        auto result = exec.RunScript<void>(mod, setup, static_cast<GameWorld*>(&world), id);
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+    };
+
+    auto* holder = world.GetScriptComponentHolder("CoolTimer");
+    REQUIRE(holder);
+
+    const auto getIndex = [&]() {
+        CScriptArray* array = holder->GetIndex();
+        REQUIRE(array);
+
+        std::vector<ObjectID> result;
+
+        for(asUINT i = 0; i < array->GetSize(); ++i)
+            result.push_back(*static_cast<ObjectID*>(array->At(i)));
+
+        array->Release();
+        return result;
+    };
+
+    const auto entities = getIndex();
+    REQUIRE(entities.size() == 3);
+    CHECK(nodeCount() == 3);
+
+    SECTION("Index stays sorted after removing components")
+    {
+        CHECK(std::is_sorted(entities.begin(), entities.end()));
+
+        // This moves the last component to the first slot //
+        CHECK(holder->Destroy(entities[0]));
+
+        CHECK(getIndex() == std::vector<ObjectID>{entities[1], entities[2]});
+    }
+
+    SECTION("C++ component removed and re-added")
+    {
+        CHECK(world.RemoveComponent_Position(entities[1]));
+        world.Tick(2);
+
+        CHECK(nodeCount() == 2);
+        CHECK(nodesFor(entities[1]) == 0);
+
+        world.Create_Position(entities[1], Float3(5, 0, 0), Float4::IdentityQuaternion());
+        world.Tick(3);
+
+        CHECK(nodeCount() == 3);
+        CHECK(nodesFor(entities[1]) == 1);
+        CHECK(nodesFor(entities[0]) == 1);
+        CHECK(nodesFor(entities[2]) == 1);
+    }
+
+    SECTION("Script component removed and re-added")
+    {
+        CHECK(holder->Destroy(entities[0]));
+        world.Tick(2);
+
+        CHECK(nodeCount() == 2);
+        CHECK(nodesFor(entities[0]) == 0);
+
+        runWithID("RecreateTimer", entities[0]);
+        world.Tick(3);
+
+        CHECK(nodeCount() == 3);
+        CHECK(nodesFor(entities[0]) == 1);
+    }
+
+    SECTION("Script clearing the cached array")
+    {
+        ScriptRunningSetup setup("ClearCachedNodes");
+        REQUIRE(exec.RunScript<void>(mod, setup, static_cast<GameWorld*>(&world)).Result ==
+                SCRIPT_RUN_RESULT::Success);
+
+        world.Tick(2);
+        CHECK(nodeCount() == 0);
+
+        setup.SetEntrypoint("CreateTimerEntity");
+        auto created = exec.RunScript<ObjectID>(mod, setup, static_cast<GameWorld*>(&world));
+        REQUIRE(created.Result == SCRIPT_RUN_RESULT::Success);
+
+        // Removing a node that was cleared doesn't affect the others //
+        CHECK(holder->Destroy(entities[2]));
+        world.Tick(3);
+
+        CHECK(nodeCount() == 1);
+        CHECK(nodesFor(created.Value) == 1);
+
+        CHECK(world.RemoveComponent_Position(created.Value));
+        world.Tick(4);
+
+        CHECK(nodeCount() == 0);
+    }
+
+    SECTION("Script replacing a node without resizing the array")
+    {
+        ScriptRunningSetup setup("ReplaceNodeWithScriptNode");
+        auto replaced =
+            exec.RunScript<bool>(mod, setup, static_cast<GameWorld*>(&world), entities[1]);
+        REQUIRE(replaced.Result == SCRIPT_RUN_RESULT::Success);
+        CHECK(replaced.Value == true);
+
+        CHECK(nodesFor(entities[1]) == 0);
+
+        // The entity is still in the index of the helper so this must not be skipped //
+        runWithID("RecreateTimer", entities[1]);
+        world.Tick(2);
+
+        CHECK(nodeCount() == 4);
+        CHECK(nodesFor(entities[1]) == 1);
+
+        setup.SetEntrypoint("NodeUsesCurrentTimer");
+        auto current =
+            exec.RunScript<bool>(mod, setup, static_cast<GameWorld*>(&world), entities[1]);
+        REQUIRE(current.Result == SCRIPT_RUN_RESULT::Success);
+        CHECK(current.Value == true);
+    }
+
+    holder->Release();
+
+    REQUIRE_NOTHROW(world.Release());
+}
+
+TEST_CASE("Script systems over C++ components follow added and removed components",
+    "[script][entity]")
+{
+    PartialEngine<false> engine;
+
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    // Script needs to be valid for releasing the components
+    StandardWorld world(nullptr);
+    world.SetRunInBackground(true);
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+    CHECK(mod->AddScriptSegmentFromFile("Data/Scripts/tests/CustomScriptComponentTest.as"));
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    ScriptRunningSetup ssetup("SetupCppComponentSystem");
+
+    auto returned = exec.RunScript<bool>(mod, ssetup, static_cast<GameWorld*>(&world));
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    REQUIRE(returned.Value == true);
+
+    const auto createEntity = [&](float x) {
+        ScriptRunningSetup setup("CreateCppComponentEntity");
+        auto result =
+            exec.RunScript<ObjectID>(mod, setup, static_cast<GameWorld*>(&world), x);
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+        return result.Value;
+    };
+
+    const auto nodeCount = [&]() {
+        ScriptRunningSetup setup("GetCppComponentNodeCount");
+        auto result = exec.RunScript<uint32_t>(mod, setup, static_cast<GameWorld*>(&world));
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+        return result.Value;
+    };
+
+    // -1 if a node has stale components
+    const auto nodesFor = [&](ObjectID id) {
+        ScriptRunningSetup setup("CountCppComponentNodes");
+        auto result = exec.RunScript<int>(mod, setup, static_cast<GameWorld*>(&world), id);
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+        return result.Value;
+    };
+
+    const std::vector<ObjectID> entities = {createEntity(1), createEntity(2), createEntity(3)};
+
+    // Both types go through the access tables of the world //
+    REQUIRE(world.GetComponentTypeAccess(COMPONENT_TYPE::Received));
+    REQUIRE(world.GetComponentTypeAccess(COMPONENT_TYPE::Position));
+
+    world.Tick(1);
+
+    CHECK(nodeCount() == 3);
+
+    for(auto id : entities)
+        CHECK(nodesFor(id) == 1);
+
+    SECTION("Removing either component removes the node")
+    {
+        CHECK(world.RemoveComponent_Received(entities[0]));
+        CHECK(world.RemoveComponent_Position(entities[1]));
+        world.Tick(2);
+
+        CHECK(nodeCount() == 1);
+        CHECK(nodesFor(entities[0]) == 0);
+        CHECK(nodesFor(entities[1]) == 0);
+        CHECK(nodesFor(entities[2]) == 1);
+    }
+
+    SECTION("Re-added component gets a new node")
+    {
+        CHECK(world.RemoveComponent_Position(entities[1]));
+        world.Tick(2);
+
+        CHECK(nodeCount() == 2);
+
+        world.Create_Position(entities[1], Float3(5, 0, 0), Float4::IdentityQuaternion());
+        world.Tick(3);
+
+        CHECK(nodeCount() == 3);
+        CHECK(nodesFor(entities[1]) == 1);
+    }
+
+    SECTION("Component replaced within a tick")
+    {
+        CHECK(world.RemoveComponent_Received(entities[0]));
+        world.Create_Received(entities[0]);
+        world.Tick(2);
+
+        CHECK(nodeCount() == 3);
+        CHECK(nodesFor(entities[0]) == 1);
+    }
+
+    SECTION("Destroyed and new entities")
+    {
+        world.DestroyEntity(entities[2]);
+        const auto created = createEntity(4);
+        world.Tick(2);
+
+        CHECK(nodeCount() == 3);
+        CHECK(nodesFor(entities[2]) == 0);
+        CHECK(nodesFor(created) == 1);
+    }
+
+    REQUIRE_NOTHROW(world.Release());
+}
+
+TEST_CASE("Thread safe script systems are ran in parallel", "[script][entity][threading]")
+{
+    PartialEngine<false> engine;
+
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    ThreadingManager threads;
+    REQUIRE(threads.Init());
+
+    // Script needs to be valid for releasing the components
+    StandardWorld world(nullptr);
+    world.SetRunInBackground(true);
+
+    // setup the script //
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+    CHECK(mod->AddScriptSegmentFromFile("Data/Scripts/tests/CustomScriptComponentTest.as"));
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    ScriptRunningSetup ssetup("SetupParallelSystems");
+
+    auto returned = exec.RunScript<bool>(mod, ssetup, static_cast<GameWorld*>(&world));
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    REQUIRE(returned.Value == true);
+
+    for(int tick = 1; tick <= 10; ++tick)
+        world.Tick(tick);
+
+    ssetup.SetEntrypoint("VerifyParallelRuns");
+
+    returned = exec.RunScript<bool>(mod, ssetup, static_cast<GameWorld*>(&world), 10);
+
+    CHECK(returned.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(returned.Value == true);
+
+    REQUIRE_NOTHROW(world.Release());
+
+    threads.Release();
+}
+
+
+TEST_CASE("Thread safe script systems can mark the same components in parallel",
+    "[script][entity][threading]")
+{
+    PartialEngine<false> engine;
+
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    ThreadingManager threads;
+    REQUIRE(threads.Init());
+
+    // Script needs to be valid for releasing the components
+    StandardWorld world(nullptr);
+    world.SetRunInBackground(true);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+    CHECK(mod->AddScriptSegmentFromFile("Data/Scripts/tests/CustomScriptComponentTest.as"));
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    ScriptRunningSetup ssetup("SetupParallelMarkingSystems");
+
+    auto returned = exec.RunScript<bool>(mod, ssetup, static_cast<GameWorld*>(&world));
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    REQUIRE(returned.Value == true);
+
+    constexpr int ticks = 10;
+
+    for(int tick = 1; tick <= ticks; ++tick)
+        world.Tick(tick);
+
+    ssetup.SetEntrypoint("VerifyParallelRuns");
+
+    returned = exec.RunScript<bool>(mod, ssetup, static_cast<GameWorld*>(&world), ticks);
+
+    CHECK(returned.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(returned.Value == true);
+
+    // Each tick the index is updated from the marked Positions which are then unmarked, so
+    // any mark missing from the change list leaves the index behind or the mark set
+    int checked = 0;
+
+    world.View<Position>([&](ObjectID id, Position& position) {
+        const auto& current = position.Members._Position;
+        const int x = static_cast<int>(current.X);
+
+        CHECK(current.Y == (x % 2 == 0 ? ticks : 0));
+        CHECK(current.Z == (x % 2 == 1 ? ticks : 0));
+        CHECK(!position.Marked);
+
+        Float3 indexed;
+        CHECK(world.GetSpatialIndex().GetPosition(id, indexed));
+        CHECK(indexed == current);
+        ++checked;
+    });
+
+    CHECK(checked == 100);
+
+    REQUIRE_NOTHROW(world.Release());
+
+    threads.Release();
+}
+
+TEST_CASE("World snapshots store script components", "[script][entity]")
+{
+    PartialEngine<false> engine;
+
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    // Script needs to be valid for releasing the components
+    StandardWorld world(nullptr);
+    StandardWorld loaded(nullptr);
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+    CHECK(mod->AddScriptSegmentFromFile("Data/Scripts/tests/CustomScriptComponentTest.as"));
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    ScriptRunningSetup setup("RegisterSnapshotComponents");
+
+    auto registered = exec.RunScript<bool>(mod, setup, static_cast<GameWorld*>(&world));
+    REQUIRE(registered.Result == SCRIPT_RUN_RESULT::Success);
+    REQUIRE(registered.Value == true);
+
+    setup.SetEntrypoint("CreateSavedStateEntity");
+    auto created = exec.RunScript<ObjectID>(mod, setup, static_cast<GameWorld*>(&world));
+    REQUIRE(created.Result == SCRIPT_RUN_RESULT::Success);
+
+    std::stringstream snapshot;
+    REQUIRE(world.SaveSnapshot(snapshot));
+
+    SECTION("Components are recreated with their properties")
+    {
+        setup.SetEntrypoint("RegisterSnapshotComponents");
+        registered = exec.RunScript<bool>(mod, setup, static_cast<GameWorld*>(&loaded));
+        REQUIRE(registered.Value == true);
+
+        WorldSnapshotReader reader(snapshot);
+
+        while(loaded.LoadSnapshotChunk(reader)) {
+        }
+
+        CHECK(!reader.HasFailed());
+
+        const auto id = reader.GetLoadedEntity(created.Value);
+        REQUIRE(id != NULL_OBJECT);
+        CHECK(loaded.GetComponent_Position(id).Members._Position == Float3(1, 0, 0));
+
+        setup.SetEntrypoint("VerifySavedState");
+        auto verified =
+            exec.RunScript<bool>(mod, setup, static_cast<GameWorld*>(&loaded), id);
+        CHECK(verified.Result == SCRIPT_RUN_RESULT::Success);
+        CHECK(verified.Value == true);
+    }
+
+    SECTION("Loading fails without the component types")
+    {
+        // Overwrite the logger in engine
+        TestLogRequireError requireError;
+
+        CHECK(!loaded.LoadSnapshot(snapshot));
+    }
+
+    REQUIRE_NOTHROW(loaded.Release());
+    REQUIRE_NOTHROW(world.Release());
+}
+
+TEST_CASE("Script node helper rejects factories that don't match the components",
+    "[script][entity]")
+{
+    PartialEngine<false> engine;
+
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    StandardWorld world(nullptr);
+    world.SetRunInBackground(true);
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+    CHECK(mod->AddScriptSegmentFromFile("Data/Scripts/tests/CustomScriptComponentTest.as"));
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    bool scriptParameter = false;
+
+    SECTION("Script component parameter")
+    {
+        scriptParameter = true;
+    }
+
+    SECTION("C++ component parameter")
+    {
+        scriptParameter = false;
+    }
+
+    ScriptRunningSetup setup("SetupMismatchedSystem");
+    auto returned =
+        exec.RunScript<bool>(mod, setup, static_cast<GameWorld*>(&world), scriptParameter);
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    REQUIRE(returned.Value == true);
+
+    {
+        // Overwrite the logger in engine
+        TestLogRequireError requireError;
+
+        world.Tick(1);
+    }
+
+    setup.SetEntrypoint("GetMismatchedNodeCount");
+    auto count = exec.RunScript<uint32_t>(
+        mod, setup, static_cast<GameWorld*>(&world), scriptParameter);
+
+    REQUIRE(count.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(count.Value == 0);
+
+    REQUIRE_NOTHROW(world.Release());
+}
@@ -1,13 +1,21 @@
 #include "../PartialEngine.h"
 
+#include "Entities/ComponentTypeAccess.h"
 #include "Entities/GameWorld.h"
 #include "Entities/Components.h"
+#include "Entities/EntityIDAllocator.h"
+#include "Entities/SpatialIndex.h"
+#include "Entities/WorldSnapshot.h"
 #include "Handlers/ObjectLoader.h"
 
 #include "Generated/StandardWorld.h"
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
 using namespace Leviathan;
 using namespace Leviathan::Test;
 
@@ -59,3 +67,384 @@ TEST_CASE("Entity parent destruction deletes children", "[entity]"){
     TargetWorld.Release();
     CHECK(TargetWorld.GetEntityCount() == 0);
 }
+
+TEST_CASE("EntityIDAllocator creates dense IDs and reuses them", "[entity]")
+{
+    EntityIDAllocator ids(0);
+
+    const auto first = ids.Allocate();
+    const auto second = ids.Allocate();
+
+    CHECK(first != NULL_OBJECT);
+    CHECK(GetEntityIndex(first) == 1);
+    CHECK(GetEntityIndex(second) == 2);
+    CHECK(GetEntityGeneration(first) == 0);
+    CHECK(ids.GetAliveCount() == 2);
+    CHECK(ids.GetIndexCount() == 3);
+
+    CHECK(ids.Release(first));
+    CHECK(!ids.Release(first));
+    CHECK(!ids.IsAlive(first));
+    CHECK(ids.IsAlive(second));
+
+    SECTION("Released index gets a new generation")
+    {
+        const auto reused = ids.Allocate();
+
+        CHECK(GetEntityIndex(reused) == GetEntityIndex(first));
+        CHECK(GetEntityGeneration(reused) == 1);
+        CHECK(reused != first);
+        CHECK(ids.IsAlive(reused));
+        CHECK(!ids.IsAlive(first));
+        CHECK(ids.GetIndexCount() == 3);
+    }
+
+    SECTION("Clear releases everything")
+    {
+        ids.Clear();
+
+        CHECK(ids.GetAliveCount() == 0);
+        CHECK(!ids.IsAlive(second));
+    }
+}
+
+TEST_CASE("EntityIDAllocator waits for enough free indexes before reusing", "[entity]")
+{
+    EntityIDAllocator ids(2);
+
+    std::vector<ObjectID> created;
+
+    for(int i = 0; i < 3; ++i)
+        created.push_back(ids.Allocate());
+
+    for(auto id : created)
+        CHECK(ids.Release(id));
+
+    // Only 3 free so the first one is reused //
+    CHECK(GetEntityIndex(ids.Allocate()) == GetEntityIndex(created[0]));
+    CHECK(GetEntityIndex(ids.Allocate()) == 4);
+}
+
+TEST_CASE("EntityIDAllocator flags separate local IDs", "[entity]")
+{
+    EntityIDAllocator ids(0);
+    ids.SetFlags(ENTITY_ID_LOCAL_FLAG);
+
+    const auto local = ids.Allocate();
+
+    CHECK((static_cast<uint32_t>(local) & ENTITY_ID_LOCAL_FLAG) != 0);
+    CHECK(ids.IsAlive(local));
+
+    // An ID with the same index from somewhere else is not affected //
+    const auto remote = static_cast<ObjectID>(GetEntityIndex(local));
+
+    CHECK(!ids.IsAlive(remote));
+    CHECK(!ids.Release(remote));
+    CHECK(ids.IsAlive(local));
+}
+
+TEST_CASE("GameWorld entity IDs are per world", "[entity]")
+{
+    PartialEngine<false> engine;
+
+    StandardWorld world(nullptr);
+    StandardWorld otherWorld(nullptr);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+    REQUIRE(otherWorld.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    const auto first = world.CreateEntity();
+    const auto second = world.CreateEntity();
+
+    CHECK(GetEntityIndex(second) == GetEntityIndex(first) + 1);
+
+    // Other worlds don't affect the IDs //
+    CHECK(otherWorld.CreateEntity() == first);
+
+    world.DestroyEntity(first);
+
+    CHECK(world.GetEntityCount() == 1);
+
+    world.Release();
+    otherWorld.Release();
+}
+
+TEST_CASE("SpatialIndex finds entities near a point", "[entity]")
+{
+    SpatialIndex index(10.f);
+
+    index.Set(1, Float3(0, 0, 0));
+    index.Set(2, Float3(5, 0, 0));
+    index.Set(3, Float3(-15, 2, 0));
+    index.Set(4, Float3(100, 0, 100));
+
+    CHECK(index.GetEntityCount() == 4);
+
+    SECTION("Radius")
+    {
+        std::vector<ObjectID> found;
+        CHECK(index.QueryRadius(Float3(1, 0, 0), 5, found) == 2);
+        std::sort(found.begin(), found.end());
+        CHECK(found == std::vector<ObjectID>{1, 2});
+
+        found.clear();
+        CHECK(index.QueryRadius(Float3(-15, 0, 0), 1, found) == 0);
+    }
+
+    SECTION("Box")
+    {
+        std::vector<ObjectID> found;
+        CHECK(index.QueryBox(Float3(-20, 0, -1), Float3(1, 5, 1), found) == 2);
+        std::sort(found.begin(), found.end());
+        CHECK(found == std::vector<ObjectID>{1, 3});
+    }
+
+    SECTION("Nearest")
+    {
+        std::vector<ObjectID> found;
+        CHECK(index.QueryNearest(Float3(4, 0, 0), 3, found) == 3);
+        CHECK(found == std::vector<ObjectID>{2, 1, 3});
+
+        found.clear();
+        CHECK(index.QueryNearest(Float3(90, 0, 90), 1, found) == 1);
+        CHECK(found == std::vector<ObjectID>{4});
+
+        found.clear();
+        CHECK(index.QueryNearest(Float3(90, 0, 90), 2, found, 20) == 1);
+    }
+
+    SECTION("Nearest with NaN positions")
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+
+        // These need to stop even though there is no distance limit
+        std::vector<ObjectID> found;
+        CHECK(index.QueryNearest(Float3(nan, 0, 0), 2, found) == 0);
+
+        index.Set(5, Float3(nan, nan, nan));
+
+        CHECK(index.QueryNearest(Float3(0, 0, 0), 5, found) == 4);
+        CHECK(found == std::vector<ObjectID>{1, 2, 3, 4});
+    }
+
+    SECTION("Moving and removing")
+    {
+        index.Set(4, Float3(1, 1, 1));
+        index.Set(2, Float3(6, 0, 0));
+        CHECK(index.Remove(1));
+        CHECK(!index.Remove(1));
+
+        Float3 position;
+        CHECK(index.GetPosition(2, position));
+        CHECK(position == Float3(6, 0, 0));
+        CHECK(!index.GetPosition(1, position));
+
+        std::vector<ObjectID> found;
+        CHECK(index.QueryRadius(Float3(0, 0, 0), 3, found) == 1);
+        CHECK(found == std::vector<ObjectID>{4});
+
+        index.SetCellSize(1.f);
+        CHECK(index.GetEntityCount() == 3);
+
+        found.clear();
+        CHECK(index.QueryBox(Float3(0), Float3(10), found) == 2);
+    }
+}
+
+TEST_CASE("GameWorld spatial index follows Position components", "[entity]")
+{
+    PartialEngine<false> engine;
+
+    StandardWorld world(nullptr);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    const auto first = world.CreateEntity();
+    auto& position =
+        world.Create_Position(first, Float3(0, 0, 0), Float4::IdentityQuaternion());
+
+    const auto second = world.CreateEntity();
+    world.Create_Position(second, Float3(50, 0, 0), Float4::IdentityQuaternion());
+
+    SpatialIndex& index = world.GetSpatialIndex();
+
+    // Updated only once the world ticks //
+    CHECK(index.GetEntityCount() == 0);
+
+    world.Tick(1);
+
+    CHECK(index.GetEntityCount() == 2);
+
+    std::vector<ObjectID> found;
+    CHECK(index.QueryRadius(Float3(0), 1, found) == 1);
+    CHECK(found == std::vector<ObjectID>{first});
+
+    position.Members._Position = Float3(49, 0, 0);
+    position.Marked = true;
+    world.DestroyEntity(second);
+
+    world.Tick(2);
+
+    found.clear();
+    CHECK(index.QueryRadius(Float3(50, 0, 0), 2, found) == 1);
+    CHECK(found == std::vector<ObjectID>{first});
+    CHECK(index.GetEntityCount() == 1);
+
+    world.Release();
+}
+
+TEST_CASE("StandardWorld typed component access", "[entity]")
+{
+    PartialEngine<false> engine;
+
+    StandardWorld world(nullptr);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    static_assert(StandardWorld::ComponentTypes::Contains<Position>);
+
+    const auto first = world.CreateEntity();
+    world.Create_Position(first, Float3(1, 0, 0), Float4::IdentityQuaternion());
+
+    const auto second = world.CreateEntity();
+    world.Create_Position(second, Float3(2, 0, 0), Float4::IdentityQuaternion());
+    auto& sendable = world.Create_Sendable(second);
+
+    CHECK(&world.GetComponent<Position>(first) == &world.GetComponent_Position(first));
+    CHECK(world.GetComponentPtr<Sendable>(first) == nullptr);
+    CHECK(world.GetComponentPtr<Sendable>(second) == &sendable);
+    CHECK_THROWS_AS(world.GetComponent<Sendable>(first), NotFound);
+
+    SECTION("View only visits entities with all of the types")
+    {
+        std::vector<ObjectID> visited;
+
+        world.View<Sendable, Position>([&](ObjectID id, Sendable& found, Position& position) {
+            CHECK(&found == &sendable);
+            CHECK(position.Members._Position == Float3(2, 0, 0));
+            visited.push_back(id);
+        });
+
+        CHECK(visited == std::vector<ObjectID>{second});
+    }
+
+    SECTION("Access tables go to the same components")
+    {
+        const ComponentTypeAccess* access =
+            world.GetComponentTypeAccess(COMPONENT_TYPE::Position);
+
+        REQUIRE(access);
+        CHECK(access->Type == COMPONENT_TYPE::Position);
+        CHECK(access->Find(world, first) == &world.GetComponent_Position(first));
+        CHECK(access->Find(world, world.CreateEntity()) == nullptr);
+        CHECK(access->GetAddedCount(world) == 2);
+        CHECK(access->GetAddedEntity(world, 1) == second);
+    }
+
+    world.Release();
+}
+
+TEST_CASE("GameWorld snapshot restores entities and parents", "[entity]")
+{
+    PartialEngine<false> engine;
+
+    std::stringstream snapshot;
+
+    StandardWorld world(nullptr);
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    const auto parent = world.CreateEntity();
+    world.Create_Position(parent, Float3(1, 2, 3), Float4::IdentityQuaternion());
+    world.Create_Camera(parent, 70, false);
+    world.Create_Sendable(parent);
+
+    const auto child = world.CreateEntity();
+    world.Create_Position(child, Float3(4, 5, 6), Float4::IdentityQuaternion());
+    world.Create_BoxGeometry(child, Float3(1, 2, 3), "Material");
+    world.SetEntitysParent(child, parent);
+
+    // Enough entities for multiple chunks //
+    for(int i = 0; i < 5000; ++i) {
+        world.Create_Position(
+            world.CreateEntity(), Float3(static_cast<float>(i), 0, 0), Float4(0, 0, 0, 1));
+    }
+
+    REQUIRE(world.SaveSnapshot(snapshot));
+    world.Release();
+
+    StandardWorld loaded(nullptr);
+    REQUIRE(loaded.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    SECTION("Everything at once")
+    {
+        CHECK(loaded.LoadSnapshot(snapshot));
+        CHECK(loaded.GetEntityCount() == 5002);
+    }
+
+    SECTION("One chunk at a time")
+    {
+        WorldSnapshotReader reader(snapshot);
+        REQUIRE(!reader.HasFailed());
+
+        int chunks = 0;
+
+        while(loaded.LoadSnapshotChunk(reader))
+            ++chunks;
+
+        CHECK(chunks > 2);
+        CHECK(reader.HasEnded());
+        CHECK(!reader.HasFailed());
+        CHECK(loaded.GetEntityCount() == 5002);
+
+        const auto loadedParent = reader.GetLoadedEntity(parent);
+        const auto loadedChild = reader.GetLoadedEntity(child);
+
+        REQUIRE(loadedParent != NULL_OBJECT);
+        REQUIRE(loadedChild != NULL_OBJECT);
+
+        CHECK(loaded.GetComponent_Position(loadedParent).Members._Position == Float3(1, 2, 3));
+        CHECK(loaded.GetComponent_Position(loadedChild).Members._Position == Float3(4, 5, 6));
+
+        // Also the components that aren't sent over the network are stored
+        CHECK(loaded.GetComponent_Camera(loadedParent).FOV == 70);
+        CHECK(!loaded.GetComponent_Camera(loadedParent).SoundPerceiver);
+        CHECK(loaded.GetComponentPtr_Sendable(loadedParent));
+        CHECK(loaded.GetComponent_BoxGeometry(loadedChild).Sizes == Float3(1, 2, 3));
+        CHECK(loaded.GetComponent_BoxGeometry(loadedChild).Material == "Material");
+
+        loaded.DestroyEntity(loadedParent);
+        CHECK(!loaded.DoesEntityExist(loadedChild));
+    }
+
+    loaded.Release();
+}
+
+TEST_CASE("WorldSnapshotReader rejects invalid data", "[entity]")
+{
+    PartialEngine<false> engine;
+    // Overwrite the logger in engine
+    TestLogRequireError requireError;
+
+    std::stringstream notSnapshot("this is not a snapshot");
+    WorldSnapshotReader reader(notSnapshot);
+    CHECK(reader.HasFailed());
+    CHECK(!reader.ReadChunk());
+
+    std::stringstream full;
+    {
+        WorldSnapshotWriter writer(full);
+        writer.BeginItem(WORLD_SNAPSHOT_CHUNK::Parents) << ObjectID(1) << ObjectID(2);
+        writer.EndItem();
+        REQUIRE(writer.Finish());
+    }
+
+    // Without the end marker //
+    const auto data = full.str();
+    std::stringstream truncated(data.substr(0, data.size() - 1));
+
+    WorldSnapshotReader truncatedReader(truncated);
+    CHECK(truncatedReader.ReadChunk());
+    CHECK(truncatedReader.GetChunkItemCount() == 1);
+    CHECK(!truncatedReader.ReadChunk());
+    CHECK(truncatedReader.HasFailed());
+}
@@ -1,5 +1,6 @@
 #include "Entities/GameWorld.h"
 #include "Generated/StandardWorld.h"
+#include "Networking/ConnectedPlayer.h"
 #include "Networking/Connection.h"
 #include "Networking/NetworkRequest.h"
 #include "Networking/NetworkResponse.h"
@@ -96,3 +97,62 @@ TEST_CASE_METHOD(WorldSynchronizationTestFixture,
     ClientInterface.GetWorld()->Release();
     CloseServerProperly();
 }
+
+TEST_CASE_METHOD(WorldSynchronizationTestFixture,
+    "Players only receive entities within the relevance radius", "[networking][entity]")
+{
+    // Replace the world with one that limits what players receive
+    ServerInterface.World->Release();
+    ServerInterface.World = std::make_shared<StandardWorld>(nullptr);
+
+    auto settings = WorldNetworkSettings::GetSettingsForServer();
+    settings.EntityRelevanceRadius = 20.f;
+
+    REQUIRE(ServerInterface.World->Init(settings, nullptr));
+    ServerInterface.World->SetRunInBackground(true);
+
+    ConnectClientToServerWorld();
+
+    auto& world = *ServerInterface.World;
+
+    auto player = ServerInterface.GetPlayerForConnection(*ServerConnection);
+    REQUIRE(player);
+
+    const auto playerEntity = world.CreateEntity();
+    auto& playerPosition =
+        world.Create_Position(playerEntity, Float3(0, 0, 0), Float4::IdentityQuaternion());
+
+    auto& nearPosition = world.Create_Position(
+        world.CreateEntity(), Float3(10, 0, 0), Float4::IdentityQuaternion());
+    auto& farPosition = world.Create_Position(
+        world.CreateEntity(), Float3(50, 0, 0), Float4::IdentityQuaternion());
+
+    // Updates the spatial index
+    world.Tick(0);
+
+    // Players without an entity receive everything
+    CHECK(world.ShouldPlayerReceiveEntity(farPosition, *ServerConnection));
+
+    player->SetPositionInWorld(&world, playerEntity);
+    CHECK(player->GetPositionInWorld(&world) == playerEntity);
+
+    CHECK(world.ShouldPlayerReceiveEntity(nearPosition, *ServerConnection));
+    CHECK(!world.ShouldPlayerReceiveEntity(farPosition, *ServerConnection));
+
+    // Connections that aren't players in the world aren't limited
+    CHECK(world.ShouldPlayerReceiveEntity(farPosition, *ClientConnection));
+
+    // The relevant area follows the player entity
+    playerPosition.Members._Position = Float3(45, 0, 0);
+    playerPosition.Marked = true;
+    world.Tick(1);
+
+    CHECK(!world.ShouldPlayerReceiveEntity(nearPosition, *ServerConnection));
+    CHECK(world.ShouldPlayerReceiveEntity(farPosition, *ServerConnection));
+
+    player->SetPositionInWorld(&world, NULL_OBJECT);
+    CHECK(world.ShouldPlayerReceiveEntity(nearPosition, *ServerConnection));
+
+    ClientInterface.GetWorld()->Release();
+    CloseServerProperly();
+}
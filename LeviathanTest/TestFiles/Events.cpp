@@ -2,6 +2,8 @@
 
 #include "catch.hpp"
 
+#include <functional>
+
 using namespace Leviathan;
 // using namespace Leviathan::Test;
 
@@ -27,3 +29,168 @@ TEST_CASE("Events are properly released by EventHandler", "[event]"){
 
 
 
+class CountingEventListener : public CallableObject {
+public:
+    int OnEvent(Event* event) override
+    {
+        ++Received;
+
+        if(OnReceive)
+            OnReceive();
+
+        return UnregisterAfterEvent ? -1 : 0;
+    }
+
+    int OnGenericEvent(GenericEvent* event) override
+    {
+        ++ReceivedGeneric;
+        return 0;
+    }
+
+    int Received = 0;
+    int ReceivedGeneric = 0;
+    bool UnregisterAfterEvent = false;
+    std::function<void()> OnReceive;
+};
+
+TEST_CASE("EventHandler only sends events to listeners of the type", "[event]")
+{
+    EventHandler handler;
+
+    CountingEventListener tickListener;
+    CountingEventListener frameListener;
+    CountingEventListener genericListener;
+
+    handler.RegisterForEvent(&tickListener, EVENT_TYPE_TICK);
+    handler.RegisterForEvent(&frameListener, EVENT_TYPE_FRAME_END);
+    handler.RegisterForEvent(&genericListener, "TestEvent");
+
+    CHECK(handler.HasListeners(EVENT_TYPE_TICK));
+    CHECK(!handler.HasListeners(EVENT_TYPE_FRAME_BEGIN));
+
+    handler.CallIntegerEvent(EVENT_TYPE_TICK, 1);
+    handler.CallIntegerEvent(EVENT_TYPE_TICK, 2);
+    handler.CallIntegerEvent(EVENT_TYPE_FRAME_BEGIN, 2);
+    handler.CallEvent(new GenericEvent("TestEvent"));
+    handler.CallEvent(new GenericEvent("OtherEvent"));
+
+    CHECK(tickListener.Received == 2);
+    CHECK(frameListener.Received == 0);
+    CHECK(genericListener.ReceivedGeneric == 1);
+    CHECK(tickListener.ReceivedGeneric == 0);
+
+    handler.Unregister(&tickListener, EVENT_TYPE_ALL, true);
+    handler.Unregister(&genericListener, "", true);
+
+    CHECK(!handler.HasListeners(EVENT_TYPE_TICK));
+
+    handler.CallIntegerEvent(EVENT_TYPE_TICK, 3);
+    handler.CallEvent(new GenericEvent("TestEvent"));
+
+    CHECK(tickListener.Received == 2);
+    CHECK(genericListener.ReceivedGeneric == 1);
+
+    handler.Release();
+}
+
+TEST_CASE("EventHandler listeners can change while sending", "[event]")
+{
+    EventHandler handler;
+
+    CountingEventListener first;
+    CountingEventListener second;
+    CountingEventListener added;
+
+    handler.RegisterForEvent(&first, EVENT_TYPE_TICK);
+    handler.RegisterForEvent(&second, EVENT_TYPE_TICK);
+
+    SECTION("Unregistering another listener")
+    {
+        first.OnReceive = [&]() { handler.Unregister(&second, EVENT_TYPE_TICK); };
+
+        handler.CallIntegerEvent(EVENT_TYPE_TICK, 1);
+        handler.CallIntegerEvent(EVENT_TYPE_TICK, 2);
+
+        CHECK(first.Received == 2);
+        CHECK(second.Received == 0);
+    }
+
+    SECTION("Registering new listeners")
+    {
+        first.OnReceive = [&]() {
+            for(int i = 0; i < 50; ++i)
+                handler.RegisterForEvent(&added, EVENT_TYPE_TICK);
+        };
+        first.UnregisterAfterEvent = true;
+
+        handler.CallIntegerEvent(EVENT_TYPE_TICK, 1);
+
+        CHECK(first.Received == 1);
+        CHECK(second.Received == 1);
+        CHECK(added.Received == 0);
+
+        handler.CallIntegerEvent(EVENT_TYPE_TICK, 2);
+
+        CHECK(first.Received == 1);
+        CHECK(second.Received == 2);
+        CHECK(added.Received == 50);
+    }
+
+    handler.Release();
+}
+
+TEST_CASE("EventHandler queued events are sent on flush", "[event]")
+{
+    EventHandler handler;
+
+    CountingEventListener listener;
+    handler.RegisterForEvent(&listener, EVENT_TYPE_TEST);
+
+    Event* event = new Event(EVENT_TYPE_TEST, nullptr);
+    event->AddRef();
+
+    handler.QueueEvent(event);
+    handler.QueueEvent(new Event(EVENT_TYPE_TEST, nullptr));
+
+    CHECK(listener.Received == 0);
+    CHECK(event->GetRefCount() == 2);
+
+    handler.FlushQueuedEvents();
+
+    CHECK(listener.Received == 2);
+    CHECK(event->GetRefCount() == 1);
+
+    event->Release();
+    handler.Release();
+}
+
+TEST_CASE("EventHandler ignores invalid event types", "[event]")
+{
+    EventHandler handler;
+
+    CountingEventListener listener;
+
+    const auto invalid = static_cast<EVENT_TYPE>(EVENT_TYPE_ALL + 1);
+    const auto negative = static_cast<EVENT_TYPE>(-1);
+
+    CHECK(!handler.RegisterForEvent(&listener, invalid));
+    CHECK(!handler.RegisterForEvent(&listener, negative));
+
+    CHECK(!handler.HasListeners(invalid));
+    CHECK(!handler.HasListeners(negative));
+
+    handler.CallIntegerEvent(invalid, 1);
+    handler.CallIntegerEvent(negative, 1);
+
+    Event* event = new Event(invalid, nullptr);
+    event->AddRef();
+
+    handler.CallEvent(event);
+    CHECK(event->GetRefCount() == 1);
+
+    event->Release();
+
+    CHECK(listener.Received == 0);
+
+    handler.Release();
+}
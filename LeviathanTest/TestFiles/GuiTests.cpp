@@ -39,3 +39,33 @@ using namespace Leviathan::GUI;
 
 //     sound.Release();
 // }
+
+TEST_CASE("VideoPlayer decode thread decodes all frames", "[gui][video]")
+{
+    PartialEngine<false> engine;
+
+    VideoPlayer player;
+
+    // 64x48 VP9 video with 24 frames and an opus audio track
+    CHECK(player.DecodeAllFrames("Data/Scripts/tests/TestVideo.webm") == 24);
+    CHECK(!player.IsStreamValid());
+
+    // The player can be used again after the decode thread has quit
+    CHECK(player.DecodeAllFrames("Data/Scripts/tests/TestVideo.webm") == 24);
+}
+
+// Hidden by default, run with: LeviathanTest "[benchmark]"
+TEST_CASE("VideoPlayer decode thread throughput", "[gui][video][benchmark][.]")
+{
+    PartialEngine<false> engine;
+
+    VideoPlayer player;
+    int frames = 0;
+
+    BENCHMARK("Decoding all frames of the test video")
+    {
+        frames = player.DecodeAllFrames("Data/Scripts/tests/TestVideo.webm");
+    }
+
+    CHECK(frames == 24);
+}
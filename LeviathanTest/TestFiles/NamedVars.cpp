@@ -374,6 +374,168 @@ TEST_CASE("Parsing values back from ToText", "[variable][datablock]")
     }
 }
 
+TEST_CASE("NamedVars indexed lookups stay correct", "[variable]")
+{
+    NamedVars holder;
+
+    // Enough variables for the hash index to be used //
+    for(int i = 0; i < 50; ++i)
+        holder.AddVar("var" + std::to_string(i), new VariableBlock(i));
+
+    REQUIRE(holder.GetVariableCount() == 50);
+
+    for(int i = 0; i < 50; ++i) {
+
+        int value = -1;
+        REQUIRE(holder.GetValueAndConvertTo("var" + std::to_string(i), value));
+        CHECK(value == i);
+    }
+
+    CHECK(holder.Find("var50") >= holder.GetVariableCount());
+
+    SECTION("Removing")
+    {
+        holder.Remove("var10");
+
+        CHECK(holder.Find("var10") >= holder.GetVariableCount());
+        CHECK(holder.Find("var11") == 10);
+        CHECK(holder.Find("var49") == 48);
+    }
+
+    SECTION("Replacing")
+    {
+        holder.AddVar("var5", new VariableBlock(100));
+
+        int value = -1;
+        REQUIRE(holder.GetValueAndConvertTo("var5", value));
+        CHECK(value == 100);
+        CHECK(holder.GetVariableCount() == 50);
+    }
+
+    SECTION("Renaming through a list pointer")
+    {
+        holder.GetValueDirectRaw("var20")->SetName("renamed");
+
+        CHECK(holder.Find("var20") >= holder.GetVariableCount());
+        CHECK(holder.Find("renamed") == 20);
+    }
+
+    SECTION("Modifying the vector directly")
+    {
+        holder.GetVec()->push_back(std::make_shared<NamedVariableList>(
+            "pushed", new VariableBlock(1)));
+        std::swap((*holder.GetVec())[0], (*holder.GetVec())[1]);
+
+        CHECK(holder.Find("pushed") == 50);
+        CHECK(holder.Find("var0") == 1);
+        CHECK(holder.Find("var1") == 0);
+    }
+
+    SECTION("Modifying a held vector after lookups")
+    {
+        auto* vec = holder.GetVec();
+
+        CHECK(holder.Find("var3") == 3);
+
+        // Same count as before so that only checking the size wouldn't notice this //
+        vec->erase(vec->begin() + 3);
+        vec->push_back(std::make_shared<NamedVariableList>("added", new VariableBlock(1)));
+
+        CHECK(holder.Find("var3") >= holder.GetVariableCount());
+        CHECK(holder.Find("var4") == 3);
+        CHECK(holder.Find("added") == 49);
+
+        (*vec)[0]->SetName("first");
+
+        CHECK(holder.Find("first") == 0);
+        CHECK(holder.Find("var0") >= holder.GetVariableCount());
+    }
+
+    SECTION("Renaming through a held list after lookups")
+    {
+        auto held = holder.GetValueDirect("var7");
+        REQUIRE(held);
+
+        CHECK(holder.Find("var7") == 7);
+        CHECK(holder.Find("later") >= holder.GetVariableCount());
+
+        held->SetName("later");
+
+        CHECK(holder.Find("later") == 7);
+        CHECK(holder.Find("var7") >= holder.GetVariableCount());
+
+        // Assigning another list also renames //
+        *held = NamedVariableList("assigned", new VariableBlock(2));
+
+        CHECK(holder.Find("assigned") == 7);
+        CHECK(holder.Find("later") >= holder.GetVariableCount());
+    }
+
+    SECTION("Lists in multiple NamedVars")
+    {
+        NamedVars other;
+
+        for(int i = 0; i < 20; ++i)
+            other.AddVar("other" + std::to_string(i), new VariableBlock(i));
+
+        auto shared = holder.GetValueDirect("var9");
+        other.AddVar(shared);
+
+        CHECK(other.Find("var9") == 20);
+        CHECK(holder.Find("var9") == 9);
+
+        shared->SetName("shared");
+
+        CHECK(holder.Find("shared") == 9);
+        CHECK(other.Find("shared") == 20);
+        CHECK(holder.Find("var9") >= holder.GetVariableCount());
+        CHECK(other.Find("var9") >= other.GetVariableCount());
+    }
+
+    SECTION("Copies find the same values")
+    {
+        NamedVars copy(holder);
+        holder.Remove("var30");
+
+        CHECK(copy.Find("var30") == 30);
+        CHECK(holder.Find("var30") >= holder.GetVariableCount());
+
+        copy.GetValueDirect("var31")->SetName("copyrenamed");
+
+        CHECK(copy.Find("copyrenamed") == 31);
+        CHECK(holder.Find("var31") == 30);
+    }
+
+    SECTION("Stolen lists still update the index")
+    {
+        CHECK(holder.Find("var12") == 12);
+
+        auto held = holder.GetValueDirect("var12");
+        NamedVars stealer(&holder);
+
+        CHECK(holder.GetVariableCount() == 0);
+        CHECK(stealer.Find("var12") == 12);
+
+        held->SetName("stolen");
+
+        CHECK(stealer.Find("stolen") == 12);
+        CHECK(stealer.Find("var12") >= stealer.GetVariableCount());
+    }
+
+    SECTION("Changes after GetVec use the index again")
+    {
+        holder.GetVec();
+        holder.AddVar("appended", new VariableBlock(1));
+
+        CHECK(holder.Find("appended") == 50);
+
+        holder.GetValueDirect("var40")->SetName("renamedlater");
+
+        CHECK(holder.Find("renamedlater") == 40);
+        CHECK(holder.Find("var40") >= holder.GetVariableCount());
+    }
+}
+
 TEST_CASE("Access name")
 {
     // Not that useful, for making sure functions are defined properly
@@ -432,6 +594,29 @@ TEST_CASE(
     CHECK(variables.size() == 0);
 }
 
+TEST_CASE("Invalid utf8 is reported as a parse error", "[variable]")
+{
+    DummyReporter dummy;
+
+    SECTION("Line parsing")
+    {
+        CHECK_THROWS_AS(NamedVariableList("na\xffme = 1;", &dummy), InvalidArgument);
+        CHECK_THROWS_AS(NamedVariableList("name = \xff\xfe;", &dummy), InvalidArgument);
+        CHECK_THROWS_AS(
+            NamedVariableList("name = [\"\xff\", 2];", &dummy), InvalidArgument);
+    }
+
+    SECTION("ProcessDataDump")
+    {
+        RequireErrorReporter reporter;
+
+        std::vector<std::shared_ptr<NamedVariableList>> variables;
+        CHECK(!NamedVariableList::ProcessDataDump("a = 1;\nb\xff = 2;", variables, &reporter));
+
+        CHECK(variables.size() == 0);
+    }
+}
+
 TEST_CASE("NamedVariableList::ProcessDataDump data flow all p-uses 1", "[variable]")
 {
     DummyReporter dummy;
@@ -0,0 +1,138 @@
+#include "Networking/NetworkMessagePool.h"
+#include "Networking/NetworkResponse.h"
+
+#include "../PartialEngine.h"
+
+#include "catch.hpp"
+
+using namespace Leviathan;
+using namespace Leviathan::Test;
+
+namespace {
+//! Builds the data of messages like what a client receives while in a world. Mostly entity
+//! updates with some creations, destructions and keepalives mixed in
+std::vector<sf::Packet> GenerateResponseStream(int count)
+{
+    std::vector<sf::Packet> result;
+    result.reserve(count);
+
+    for(int i = 0; i < count; ++i) {
+
+        sf::Packet packet;
+
+        if(i % 50 == 0) {
+
+            sf::Packet componentData;
+            componentData << static_cast<uint16_t>(COMPONENT_TYPE::Position) << 1.f << 2.f
+                          << 3.f << "some component data";
+
+            ResponseEntityCreation(0, 1, i, 1, std::move(componentData))
+                .AddDataToPacket(packet);
+
+        } else if(i % 50 == 25) {
+
+            ResponseEntityDestruction(0, 1, i - 25).AddDataToPacket(packet);
+
+        } else if(i % 10 == 0) {
+
+            ResponseNone(NETWORK_RESPONSE_TYPE::Keepalive, i).AddDataToPacket(packet);
+
+        } else {
+
+            sf::Packet updateData;
+            updateData << static_cast<uint16_t>(COMPONENT_TYPE::Position) << 1.f << 2.f << 3.f
+                       << 0.f << 0.f << 0.f << 1.f;
+
+            ResponseEntityUpdate(0, 1, i, i - 1, i % 200, std::move(updateData))
+                .AddDataToPacket(packet);
+        }
+
+        result.push_back(std::move(packet));
+    }
+
+    return result;
+}
+} // namespace
+
+TEST_CASE("Pooled network messages stay valid while referenced", "[networking]")
+{
+    PartialEngine<false> engine;
+
+    std::vector<std::shared_ptr<NetworkResponse>> kept;
+
+    for(int round = 0; round < 3; ++round) {
+
+        for(auto& packet : GenerateResponseStream(100)) {
+
+            auto loaded = NetworkResponse::LoadFromPacket(packet);
+            REQUIRE(loaded);
+
+            if(loaded->GetType() == NETWORK_RESPONSE_TYPE::EntityUpdate && round == 0)
+                kept.push_back(loaded);
+        }
+    }
+
+    REQUIRE(!kept.empty());
+
+    for(size_t i = 0; i < kept.size(); ++i) {
+
+        REQUIRE(kept[i]->GetType() == NETWORK_RESPONSE_TYPE::EntityUpdate);
+
+        auto& update = static_cast<ResponseEntityUpdate&>(*kept[i]);
+        CHECK(update.WorldID == 1);
+        CHECK(update.ReferenceTick == update.TickNumber - 1);
+        CHECK(update.UpdateData->getDataSize() > 0);
+    }
+}
+
+TEST_CASE("Pooled network messages decode all message types", "[networking]")
+{
+    PartialEngine<false> engine;
+
+    auto stream = GenerateResponseStream(100);
+
+    for(size_t i = 0; i < stream.size(); ++i) {
+
+        auto loaded = NetworkResponse::LoadFromPacket(stream[i]);
+        REQUIRE(loaded);
+
+        if(i % 50 == 0) {
+            CHECK(loaded->GetType() == NETWORK_RESPONSE_TYPE::EntityCreation);
+        } else if(i % 50 == 25) {
+            CHECK(loaded->GetType() == NETWORK_RESPONSE_TYPE::EntityDestruction);
+        } else if(i % 10 == 0) {
+            CHECK(loaded->GetType() == NETWORK_RESPONSE_TYPE::Keepalive);
+        } else {
+            CHECK(loaded->GetType() == NETWORK_RESPONSE_TYPE::EntityUpdate);
+        }
+
+        CHECK(stream[i].endOfPacket());
+    }
+}
+
+TEST_CASE("PooledPacket stays usable after being moved from", "[networking]")
+{
+    PooledPacket original;
+    *original << 5 << 1.f;
+
+    PooledPacket moved(std::move(original));
+
+    int value = 0;
+    float floatValue = 0.f;
+    *moved >> value >> floatValue;
+
+    CHECK(value == 5);
+    CHECK(floatValue == 1.f);
+
+    CHECK(original->getDataSize() == 0);
+
+    *original << 7;
+    sf::Packet& asPacket = original;
+    asPacket >> value;
+
+    CHECK(value == 7);
+
+    PooledPacket assigned;
+    assigned = std::move(moved);
+    CHECK(moved->getDataSize() == 0);
+}
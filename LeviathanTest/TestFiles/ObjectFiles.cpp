@@ -1,3 +1,5 @@
+#include "FileSystem.h"
+#include "ObjectFiles/ObjectFileCompiled.h"
 #include "ObjectFiles/ObjectFileProcessor.h"
 
 #ifndef LEVIATHAN_UE_PLUGIN
@@ -9,6 +11,8 @@ using namespace Leviathan::Test;
 #include "catch.hpp"
 #include "../DummyLog.h"
 
+#include <cstdio>
+#include <filesystem>
 #include <regex>
 
 using namespace Leviathan;
@@ -308,6 +312,199 @@ TEST_CASE("Object file saving", "[objectfile]") {
 }
 
 
+TEST_CASE("Compiled object files", "[objectfile]") {
+
+    DummyReporter reporter;
+
+    SECTION("Basic file round trip") {
+
+        auto original = ObjectFileProcessor::ProcessObjectFileFromString(BasicTestStr,
+            "basic in memory test", &reporter);
+
+        REQUIRE(original);
+
+        constexpr auto CompiledFile = "Test/BasicCompiled.levof.compiled";
+        REQUIRE(ObjectFileProcessor::WriteObjectFile(*original, CompiledFile, &reporter,
+                true));
+
+        auto ofile = ObjectFileProcessor::LoadCompiledObjectFile(CompiledFile, &reporter);
+
+        REQUIRE(ofile);
+
+        NamedVars& vars = *ofile->GetVariables();
+        CHECK(vars.GetVariableCount() == 4);
+
+        std::string stringValue;
+        REQUIRE(vars.GetValueAndConvertTo("Astring?", stringValue));
+        CHECK(stringValue == "hello");
+
+        REQUIRE(ofile->GetTotalObjectCount() == 1);
+
+        auto* obj = dynamic_cast<ObjectFileObjectCompiled*>(ofile->GetObjectFromIndex(0));
+
+        REQUIRE(obj);
+        CHECK(obj->GetName() == "First object");
+        CHECK(obj->GetTypeName() == "TestType");
+
+        // Contents are loaded on demand
+        CHECK(!obj->IsLoaded());
+        CHECK(obj->GetListCount() == 1);
+        CHECK(!obj->IsLoaded());
+
+        ObjectFileList* list = obj->GetListWithName("list");
+        REQUIRE(list);
+        CHECK(obj->IsLoaded());
+
+        int firstValue;
+        CHECK(ObjectFileProcessor::LoadValueFromNamedVars(list->GetVariables(),
+                "firstValue", firstValue, 0));
+        CHECK(firstValue == 1);
+
+        REQUIRE(list->GetVariables().GetValueAndConvertTo("secondValue", stringValue));
+        CHECK(stringValue == "2");
+    }
+
+    SECTION("Templates and text blocks") {
+
+        constexpr auto TemplateFile = "template<Name> Thing: o \"Thing_Name\"{\n"
+            "    l values { id = \"Name\"; size = 1.5; }\n"
+            "    t desc {\n"
+            "        This is Name\n"
+            "    }\n"
+            "}\n"
+            "template<> Thing<first>\n"
+            "template<> Thing<second>\n";
+
+        auto original = ObjectFileProcessor::ProcessObjectFileFromString(TemplateFile,
+            "template test", &reporter);
+
+        REQUIRE(original);
+        REQUIRE(original->GetTotalObjectCount() == 2);
+
+        std::string binary;
+        REQUIRE(ObjectFileProcessor::SerializeObjectFileBinary(*original, binary, &reporter));
+
+        constexpr auto CompiledFile = "Test/TemplateCompiled.levof.compiled";
+        REQUIRE(FileSystem::WriteToFile(binary, CompiledFile));
+
+        auto ofile = ObjectFileProcessor::LoadCompiledObjectFile(CompiledFile, &reporter);
+
+        REQUIRE(ofile);
+        REQUIRE(ofile->GetTotalObjectCount() == 2);
+        CHECK(ofile->GetTemplateDefinitionCount() == 1);
+        CHECK(ofile->GetTemplateInstanceCount() == 2);
+
+        ObjectFileObject* second = ofile->GetObjectFromIndex(1);
+        REQUIRE(second);
+        CHECK(second->GetName() == "Thing_second");
+        CHECK(second->IsThisTemplated());
+
+        REQUIRE(second->GetTextBlockWithName("desc"));
+        REQUIRE(second->GetTextBlockWithName("desc")->GetLineCount() == 1);
+        CHECK(second->GetTextBlockWithName("desc")->GetLine(0) == "This is second");
+
+        float size = 0;
+        REQUIRE(second->GetListWithName("values"));
+        CHECK(second->GetListWithName("values")->GetVariables().GetValueAndConvertTo(
+            "size", size));
+        CHECK(size == 1.5f);
+
+        // Saving as text only saves the template definitions and instances //
+        std::string serialized;
+        REQUIRE(ObjectFileProcessor::SerializeObjectFile(*ofile, serialized));
+
+        auto reparsed = ObjectFileProcessor::ProcessObjectFileFromString(serialized,
+            "reparsed", &reporter);
+
+        REQUIRE(reparsed);
+        CHECK(reparsed->GetTotalObjectCount() == 2);
+    }
+
+    SECTION("Invalid compiled file is rejected") {
+
+        constexpr auto CompiledFile = "Test/InvalidCompiled.levof.compiled";
+        REQUIRE(FileSystem::WriteToFile("LOFC this is not valid", CompiledFile));
+
+        CHECK(!ObjectFileProcessor::LoadCompiledObjectFile(CompiledFile, &reporter));
+    }
+
+    SECTION("Stale compiled file is recompiled") {
+
+        constexpr auto SourceFile = "Test/CompiledSource.levof";
+        const auto compiledFile = ObjectFileProcessor::GetCompiledObjectFilePath(SourceFile);
+
+        REQUIRE(FileSystem::WriteToFile("Value = 1;\n", SourceFile));
+        std::remove(compiledFile.c_str());
+
+        auto ofile = ObjectFileProcessor::ProcessObjectFileCompiled(SourceFile, &reporter);
+
+        REQUIRE(ofile);
+        CHECK(FileSystem::FileExists(compiledFile));
+
+        int value = 0;
+        CHECK(ofile->GetVariables()->GetValueAndConvertTo("Value", value));
+        CHECK(value == 1);
+
+        // Make sure the text is newer even on filesystems with coarse timestamps
+        REQUIRE(FileSystem::WriteToFile("Value = 2;\n", SourceFile));
+        std::filesystem::last_write_time(SourceFile,
+            std::filesystem::last_write_time(compiledFile) + std::chrono::seconds(5));
+
+        ofile = ObjectFileProcessor::ProcessObjectFileCompiled(SourceFile, &reporter);
+
+        REQUIRE(ofile);
+        CHECK(ofile->GetVariables()->GetValueAndConvertTo("Value", value));
+        CHECK(value == 2);
+
+        // And the new compiled file is used
+        ofile = ObjectFileProcessor::LoadCompiledObjectFile(compiledFile, &reporter);
+
+        REQUIRE(ofile);
+        CHECK(ofile->GetVariables()->GetValueAndConvertTo("Value", value));
+        CHECK(value == 2);
+    }
+
+    SECTION("Compiled file is replaced while a loaded file still uses it") {
+
+        constexpr auto SourceFile = "Test/CompiledReplaced.levof";
+        const auto compiledFile = ObjectFileProcessor::GetCompiledObjectFilePath(SourceFile);
+
+        REQUIRE(FileSystem::WriteToFile(
+            "o Type \"First\"{\n    l values {\n        first = 1;\n    }\n}\n",
+            SourceFile));
+        std::remove(compiledFile.c_str());
+
+        REQUIRE(ObjectFileProcessor::ProcessObjectFileCompiled(SourceFile, &reporter));
+
+        // This keeps the compiled file mapped
+        auto old = ObjectFileProcessor::LoadCompiledObjectFile(compiledFile, &reporter);
+        REQUIRE(old);
+
+        // A shorter file would cause reading the old mapping to fail if it was truncated
+        REQUIRE(FileSystem::WriteToFile("Value = 2;\n", SourceFile));
+        std::filesystem::last_write_time(SourceFile,
+            std::filesystem::last_write_time(compiledFile) + std::chrono::seconds(5));
+
+        auto ofile = ObjectFileProcessor::ProcessObjectFileCompiled(SourceFile, &reporter);
+        REQUIRE(ofile);
+        CHECK(!FileSystem::FileExists(compiledFile + ".tmp"));
+
+        REQUIRE(old->GetTotalObjectCount() == 1);
+        auto* list = old->GetObjectFromIndex(0)->GetListWithName("values");
+        REQUIRE(list);
+
+        int value = 0;
+        CHECK(list->GetVariables().GetValueAndConvertTo("first", value));
+        CHECK(value == 1);
+
+        ofile = ObjectFileProcessor::LoadCompiledObjectFile(compiledFile, &reporter);
+
+        REQUIRE(ofile);
+        CHECK(ofile->GetVariables()->GetValueAndConvertTo("Value", value));
+        CHECK(value == 2);
+    }
+}
+
 TEST_CASE("Fabricators permissions parse test", "[objectfile]") {
 
     constexpr auto File = "permissions_version: 1;\n"
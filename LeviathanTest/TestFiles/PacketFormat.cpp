@@ -10,6 +10,8 @@
 
 #include "catch.hpp"
 
+#include <limits>
+
 /**!
  * @brief \file Tests that check that the \ref networkformat Is followed
  */
@@ -304,6 +306,7 @@ TEST_CASE("Packet serialization and deserialization", "[networking]")
         auto* deserialized = static_cast<RequestConnect*>(loaded.get());
 
         CHECK(deserialized->CheckValue == request.CheckValue);
+        CHECK(deserialized->CheckValue == LEVIATHAN_NETWORK_PROTOCOL_VERSION);
     }
 
     SECTION("RequestSecurity")
@@ -392,6 +395,93 @@ TEST_CASE("Packet serialization and deserialization", "[networking]")
     }
 }
 
+TEST_CASE("CompactObjectID serialization", "[networking]")
+{
+    const auto roundTrip = [](ObjectID id) {
+        sf::Packet packet;
+        packet << CompactObjectID(id);
+
+        CompactObjectID loaded;
+        packet >> loaded;
+
+        CHECK(packet);
+        CHECK(packet.endOfPacket());
+        return static_cast<ObjectID>(loaded);
+    };
+
+    const auto makeID = [](uint32_t index, uint32_t rest) {
+        return static_cast<ObjectID>((rest << ENTITY_ID_INDEX_BITS) | index);
+    };
+
+    SECTION("Boundary values round trip")
+    {
+        const uint32_t maxRest = UINT32_MAX >> ENTITY_ID_INDEX_BITS;
+
+        for(uint32_t index : {0u, 1u, 127u, 128u, 16383u, 16384u, ENTITY_ID_INDEX_MASK}) {
+            for(uint32_t rest : {0u, 1u, 127u, 128u, maxRest}) {
+
+                const auto id = makeID(index, rest);
+                CHECK(roundTrip(id) == id);
+            }
+        }
+
+        CHECK(roundTrip(NULL_OBJECT) == NULL_OBJECT);
+        CHECK(roundTrip(-1) == -1);
+        CHECK(roundTrip(std::numeric_limits<ObjectID>::min()) ==
+              std::numeric_limits<ObjectID>::min());
+    }
+
+    SECTION("IDs with the local flag round trip")
+    {
+        for(uint32_t index : {0u, 1u, 200u, ENTITY_ID_INDEX_MASK}) {
+
+            const auto id = static_cast<ObjectID>(ENTITY_ID_LOCAL_FLAG | index);
+            CHECK(roundTrip(id) == id);
+
+            const auto withGeneration = static_cast<ObjectID>(
+                ENTITY_ID_LOCAL_FLAG | ENTITY_ID_GENERATION_MASK | index);
+            CHECK(roundTrip(withGeneration) == withGeneration);
+        }
+    }
+
+    SECTION("Small IDs are compact")
+    {
+        sf::Packet packet;
+        packet << CompactObjectID(makeID(5, 1));
+
+        CHECK(packet.getDataSize() == 2);
+    }
+
+    SECTION("Invalid data throws")
+    {
+        const auto load = [](std::vector<uint8_t> bytes) {
+            sf::Packet packet;
+
+            for(uint8_t byte : bytes)
+                packet << byte;
+
+            CompactObjectID loaded;
+            packet >> loaded;
+        };
+
+        // Truncated //
+        CHECK_THROWS_AS(load({}), InvalidArgument);
+        CHECK_THROWS_AS(load({0x05}), InvalidArgument);
+        CHECK_THROWS_AS(load({0x80}), InvalidArgument);
+        CHECK_THROWS_AS(load({0x05, 0x81}), InvalidArgument);
+
+        // Over long //
+        CHECK_THROWS_AS(load({0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00}), InvalidArgument);
+        CHECK_THROWS_AS(load({0xff, 0xff, 0xff, 0xff, 0x1f, 0x00}), InvalidArgument);
+
+        // Values that don't fit in their part of the ID //
+        CHECK_THROWS_AS(load({0x80, 0x80, 0x80, 0x02, 0x00}), InvalidArgument);
+        CHECK_THROWS_AS(load({0x00, 0x80, 0x08}), InvalidArgument);
+
+        CHECK_NOTHROW(load({0x05, 0x00}));
+    }
+}
+
 TEST_CASE("Packet serialization and then deserialization with WireData", "[networking]")
 {
     sf::Packet packet;
@@ -1,16 +1,28 @@
 //! \file Tests for various supporting GUI methods. Doesn't actually
 //! try any rendering or anything like that
 
+#include "Entities/WorldSnapshot.h"
 #include "Generated/StandardWorld.h"
+#include "Networking/NetworkResponse.h"
 #include "Physics/PhysicalWorld.h"
+#include "Physics/PhysicsHistory.h"
 #include "Physics/PhysicsMaterialManager.h"
+#include "Script/ScriptExecutor.h"
+#include "Script/ScriptModule.h"
+#include "Threading/ThreadingManager.h"
 
 #include "../PartialEngine.h"
 
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <thread>
+
 using namespace Leviathan;
 using namespace Leviathan::Test;
 
@@ -91,6 +103,271 @@ TEST_CASE("Plane constrainted physics sphere doesn't fall", "[physics][entity]")
     world.DestroyBody(body.get());
 }
 
+TEST_CASE("Physics bodies are created and destroyed in bulk", "[physics]")
+{
+    PhysicsMaterialManager materials;
+    PhysicalWorld world(nullptr, &materials);
+
+    auto sphere = world.GetSharedSphere(1);
+    REQUIRE(sphere);
+    CHECK(world.GetSharedSphere(1) == sphere);
+    CHECK(world.GetSharedSphere(2) != sphere);
+    CHECK(world.GetSharedBox(1, 2, 3) == world.GetSharedBox(1, 2, 3));
+
+    auto single = world.CreateBodyFromCollision(sphere, 1, nullptr);
+    REQUIRE(single);
+
+    auto bodies = world.CreateBodiesFromCollision(
+        sphere, 1, std::vector<PhysicsPositionProvider*>(200, nullptr));
+
+    REQUIRE(bodies.size() == 200);
+    CHECK(world.GetBodyCount() == 201);
+
+    for(const auto& body : bodies)
+        CHECK(body->GetShape() == sphere.get());
+
+    SECTION("Destroying from the middle keeps the other bodies")
+    {
+        std::vector<PhysicsBody*> destroyed;
+
+        for(size_t i = 0; i < bodies.size(); i += 2)
+            destroyed.push_back(bodies[i].get());
+
+        CHECK(world.DestroyBodies(destroyed) == 100);
+        CHECK(world.GetBodyCount() == 101);
+
+        // Already destroyed bodies are rejected //
+        CHECK(!world.DestroyBody(bodies[0].get()));
+
+        CHECK(world.ChangeBodyShape(bodies[1], world.GetSharedBox(1, 1, 1)));
+        CHECK(bodies[1]->GetShape() == world.GetSharedBox(1, 1, 1).get());
+
+        world.SimulateWorld(0.1f);
+
+        for(size_t i = 1; i < bodies.size(); i += 2)
+            CHECK(world.DestroyBody(bodies[i].get()));
+    }
+
+    SECTION("Destroying everything")
+    {
+        std::vector<PhysicsBody*> destroyed;
+
+        for(const auto& body : bodies)
+            destroyed.push_back(body.get());
+
+        CHECK(world.DestroyBodies(destroyed) == 200);
+    }
+
+    CHECK(world.GetBodyCount() == 1);
+    CHECK(world.DestroyBody(single.get()));
+    CHECK(world.GetBodyCount() == 0);
+
+    bodies.clear();
+    single.reset();
+    sphere.reset();
+    world.ReleaseUnusedSharedShapes();
+}
+
+TEST_CASE("Physics bodies can be rewound and resimulated alone", "[physics]")
+{
+    PhysicsMaterialManager materials;
+    PhysicalWorld world(nullptr, &materials);
+    PhysicsHistory history(4);
+
+    auto rewound = world.CreateBodyFromCollision(world.GetSharedSphere(1), 10, nullptr);
+    auto other = world.CreateBodyFromCollision(world.GetSharedSphere(1), 10, nullptr);
+    REQUIRE(rewound);
+    REQUIRE(other);
+
+    rewound->SetPosition(Float3(0, 10, 0), Float4::IdentityQuaternion());
+    other->SetPosition(Float3(10, 10, 0), Float4::IdentityQuaternion());
+
+    for(int tick = 1; tick <= 3; ++tick) {
+        world.SimulateWorld(TICKSPEED / 1000.f);
+        history.Record(world, tick);
+    }
+
+    CHECK(!history.Find(0));
+    REQUIRE(history.Find(1));
+    REQUIRE(history.Find(3));
+    CHECK(history.Find(1)->GetBodyCount() == 2);
+
+    const auto* rewoundState = history.Find(1)->Find(*rewound);
+    REQUIRE(rewoundState);
+
+    const auto otherPosition = other->GetPosition();
+    const auto fallenPosition = rewound->GetPosition();
+
+    CHECK(fallenPosition.Y < rewoundState->Position.Y);
+
+    REQUIRE(history.Find(1)->RestoreBody(*rewound));
+    CHECK(rewound->GetPosition() == rewoundState->Position);
+
+    int resimulatedSteps = 0;
+
+    CHECK(world.ResimulateBodies(
+        {rewound.get()}, *history.Find(1), 2, TICKSPEED / 1000.f, [&](int step) {
+            CHECK(step == resimulatedSteps);
+            history.Find(2 + step)->UpdateBody(*rewound);
+            ++resimulatedSteps;
+        }));
+
+    CHECK(resimulatedSteps == 2);
+
+    // Only the rewound body moved //
+    CHECK(rewound->GetPosition().Y < rewoundState->Position.Y);
+    CHECK(history.Find(3)->Find(*rewound)->Position == rewound->GetPosition());
+    CHECK(other->GetPosition() == otherPosition);
+
+    // The oldest tick is overwritten once the history is full //
+    history.Record(world, 4);
+    history.Record(world, 5);
+    CHECK(!history.Find(1));
+    CHECK(history.Find(5));
+
+    world.DestroyBody(rewound.get());
+    world.DestroyBody(other.get());
+}
+
+TEST_CASE("Resimulating from a snapshot reproduces the original simulation", "[physics]")
+{
+    PhysicsMaterialManager materials;
+    PhysicalWorld world(nullptr, &materials);
+    PhysicsHistory history(8);
+
+    // Simulated alongside without resimulating anything in it
+    PhysicalWorld untouchedWorld(nullptr, &materials);
+
+    auto ball = world.CreateBodyFromCollision(world.GetSharedSphere(1), 10, nullptr);
+    auto untouchedBall =
+        untouchedWorld.CreateBodyFromCollision(untouchedWorld.GetSharedSphere(1), 10, nullptr);
+    REQUIRE(ball);
+    REQUIRE(untouchedBall);
+
+    ball->SetPosition(Float3(0, 20, 0), Float4::IdentityQuaternion());
+    untouchedBall->SetPosition(Float3(0, 20, 0), Float4::IdentityQuaternion());
+
+    // Ticks aren't a multiple of the fixed step so the substeps per tick vary
+    std::vector<Float3> positions;
+
+    for(int tick = 0; tick < 8; ++tick) {
+        world.SimulateWorld(TICKSPEED / 1000.f);
+        untouchedWorld.SimulateWorld(TICKSPEED / 1000.f);
+        history.Record(world, tick);
+        positions.push_back(ball->GetPosition());
+    }
+
+    CHECK(positions.back().Y < positions.front().Y);
+
+    const auto checkSame = [](const Float3& position, const Float3& expected) {
+        CHECK(position.X == Approx(expected.X).margin(0.0001f));
+        CHECK(position.Y == Approx(expected.Y).margin(0.0001f));
+        CHECK(position.Z == Approx(expected.Z).margin(0.0001f));
+    };
+
+    for(int from : {0, 1, 3}) {
+
+        REQUIRE(history.Find(from)->RestoreBody(*ball));
+
+        CHECK(world.ResimulateBodies({ball.get()}, *history.Find(from), 7 - from,
+            TICKSPEED / 1000.f,
+            [&](int step) { checkSame(ball->GetPosition(), positions[from + step + 1]); }));
+
+        checkSame(ball->GetPosition(), positions.back());
+    }
+
+    // Resimulating didn't change the leftover time of the world
+    for(int tick = 0; tick < 3; ++tick) {
+        world.SimulateWorld(TICKSPEED / 1000.f);
+        untouchedWorld.SimulateWorld(TICKSPEED / 1000.f);
+        checkSame(ball->GetPosition(), untouchedBall->GetPosition());
+    }
+
+    world.DestroyBody(ball.get());
+    untouchedWorld.DestroyBody(untouchedBall.get());
+}
+
+class LocalControlTestWorld : public StandardWorld {
+public:
+    using StandardWorld::StandardWorld;
+    using StandardWorld::_OnLocalControlCorrected;
+};
+
+TEST_CASE("Corrected local control entities are resimulated to the current tick",
+    "[physics][entity][networking]")
+{
+    PartialEngine<false> engine;
+
+    LocalControlTestWorld world(std::make_unique<PhysicsMaterialManager>());
+    world.SetRunInBackground(true);
+
+    // There is no server to send the updates of the controlled entity to
+    auto settings = WorldNetworkSettings::GetSettingsForClient();
+    settings.AutoCreateNetworkComponents = false;
+
+    REQUIRE(world.Init(settings, nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+
+    auto entity = world.CreateEntity();
+
+    auto& position =
+        world.Create_Position(entity, Float3(0, 20, 0), Float4::IdentityQuaternion());
+    auto& physics = world.Create_Physics(entity, position);
+
+    REQUIRE(physics.CreatePhysicsBody(physWorld, physWorld->CreateSphere(1), 10));
+
+    ResponseEntityLocalControlStatus status(0, world.GetID(), entity, true);
+    world.HandleEntityPacket(status);
+    REQUIRE(world.IsUnderOurLocalControl(entity));
+
+    std::map<int, Float3> predicted;
+
+    for(int tick = 1; tick <= 6; ++tick) {
+        world.Tick(tick);
+        predicted[tick] = physics.GetBody()->GetPosition();
+    }
+
+    const auto checkSame = [](const Float3& position, const Float3& expected) {
+        CHECK(position.X == Approx(expected.X).margin(0.0001f));
+        CHECK(position.Y == Approx(expected.Y).margin(0.0001f));
+        CHECK(position.Z == Approx(expected.Z).margin(0.0001f));
+    };
+
+    SECTION("Correction that matches the prediction keeps the prediction")
+    {
+        position.Members._Position = predicted[2];
+        position.Marked = true;
+
+        world._OnLocalControlCorrected(entity, 2);
+
+        checkSame(physics.GetBody()->GetPosition(), predicted[6]);
+    }
+
+    SECTION("Corrected position is carried to the current tick")
+    {
+        position.Members._Position = predicted[2] + Float3(5, 0, 0);
+        position.Marked = true;
+
+        world._OnLocalControlCorrected(entity, 2);
+
+        checkSame(physics.GetBody()->GetPosition(), predicted[6] + Float3(5, 0, 0));
+    }
+
+    SECTION("Corrections older than the history are applied directly")
+    {
+        position.Members._Position = Float3(1, 2, 3);
+        position.Marked = true;
+
+        world._OnLocalControlCorrected(entity, -100);
+
+        CHECK(physics.GetBody()->GetPosition() == Float3(1, 2, 3));
+    }
+
+    world.Release();
+}
+
 std::atomic<int> TestHit = 0;
 
 bool TestAABBCallback(PhysicalWorld& world, PhysicsBody& body1, PhysicsBody& body2)
@@ -170,6 +447,192 @@ TEST_CASE("Physical material callbacks work", "[physics][entity]")
     world.Release();
 }
 
+TEST_CASE("Physics material pairs are found in either order", "[physics]")
+{
+    PartialEngine<false> engine;
+
+    PhysicsMaterialManager manager;
+
+    auto first = std::make_unique<Leviathan::PhysicalMaterial>("First", 1);
+    auto second = std::make_unique<Leviathan::PhysicalMaterial>("Second", 2);
+    auto third = std::make_unique<Leviathan::PhysicalMaterial>("Third", 7);
+
+    first->FormPairWith(*second).SetCallbacks(TestAABBCallback, nullptr);
+
+    PhysicalMaterial* firstPtr = first.get();
+    PhysicalMaterial* thirdPtr = third.get();
+
+    manager.LoadedMaterialAdd(std::move(first));
+    manager.LoadedMaterialAdd(std::move(second));
+    manager.LoadedMaterialAdd(std::move(third));
+
+    const auto pair = manager.GetMaterialPair(1, 2);
+    REQUIRE(pair);
+    CHECK(pair->AABBCallback == TestAABBCallback);
+    CHECK(manager.GetMaterialPair(2, 1) == pair);
+    CHECK(manager.GetPairIndex(1, 2) == manager.GetPairIndex(2, 1));
+
+    CHECK(!manager.GetMaterialPair(1, 7));
+    CHECK(manager.GetPairIndex(1, 7) >= 0);
+    CHECK(manager.GetPairIndex(1, 3) == -1);
+    CHECK(manager.GetPairIndex(-1, 1) == -1);
+    CHECK(manager.GetPairIndex(1, 100) == -1);
+
+    // Pairs formed after adding are found as well
+    thirdPtr->FormPairWith(*firstPtr);
+
+    CHECK(manager.GetMaterialPair(1, 7));
+    CHECK(manager.GetMaterialPair(7, 1) == manager.GetMaterialPair(1, 7));
+    CHECK(manager.GetMaterialPair(1, 2) == pair);
+}
+
+int DestroyedByContact = 0;
+
+void DestroyingContactCallback(PhysicalWorld& world, PhysicsBody& body1, PhysicsBody& body2)
+{
+    PhysicsBody& ball = body1.GetMass() > 0 ? body1 : body2;
+
+    if(world.DestroyBody(&ball))
+        ++DestroyedByContact;
+}
+
+TEST_CASE("Physics contact callbacks can destroy bodies", "[physics]")
+{
+    DestroyedByContact = 0;
+
+    PartialEngine<false> engine;
+
+    auto physMan = std::make_unique<PhysicsMaterialManager>();
+
+    auto planeMaterial = std::make_unique<Leviathan::PhysicalMaterial>("PlaneMaterial", 1);
+    auto ballMaterial = std::make_unique<Leviathan::PhysicalMaterial>("BallMaterial", 2);
+
+    planeMaterial->FormPairWith(*ballMaterial)
+        .SetCallbacks(nullptr, DestroyingContactCallback);
+
+    physMan->LoadedMaterialAdd(std::move(planeMaterial));
+    physMan->LoadedMaterialAdd(std::move(ballMaterial));
+
+    StandardWorld world(std::move(physMan));
+    world.SetRunInBackground(true);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+
+    auto plane =
+        physWorld->CreateBodyFromCollision(physWorld->CreateBox(10, 1, 10), 0, nullptr, 1);
+    REQUIRE(plane);
+
+    auto ball = physWorld->CreateBodyFromCollision(physWorld->CreateSphere(1), 10, nullptr, 2);
+    REQUIRE(ball);
+    CHECK(ball->SetPosition(Float3(0, 3, 0), Float4::IdentityQuaternion()));
+
+    // The ball touches the plane on many substeps but is destroyed only once
+    physWorld->SimulateWorld(1.f, 100);
+
+    CHECK(DestroyedByContact == 1);
+    CHECK(!ball->GetBody());
+
+    // The world keeps working without the ball
+    physWorld->SimulateWorld(1.f, 100);
+    CHECK(DestroyedByContact == 1);
+
+    CHECK(physWorld->DestroyBody(plane.get()));
+
+    world.Release();
+}
+
+int CountedContacts = 0;
+
+void CountingContactCallback(PhysicalWorld& world, PhysicsBody& body1, PhysicsBody& body2)
+{
+    ++CountedContacts;
+}
+
+TEST_CASE("Script contact callbacks are called and can be replaced while running",
+    "[physics][script]")
+{
+    CountedContacts = 0;
+
+    PartialEngine<false> engine;
+    ScriptExecutor exec;
+
+    auto mod = exec.CreateNewModule("PhysicsContactScript", "ScriptGenerator").lock();
+    REQUIRE(mod->AddScriptSegmentFromFile("Data/Scripts/tests/PhysicsContactCallbackTest.as"));
+    REQUIRE(mod->GetModule());
+
+    auto physMan = std::make_unique<PhysicsMaterialManager>();
+
+    auto planeMaterial = std::make_unique<Leviathan::PhysicalMaterial>("PlaneMaterial", 1);
+    auto ballMaterial = std::make_unique<Leviathan::PhysicalMaterial>("BallMaterial", 2);
+
+    planeMaterial->FormPairWith(*ballMaterial)
+        .SetCallbacks(nullptr, CountingContactCallback);
+
+    physMan->LoadedMaterialAdd(std::move(planeMaterial));
+    physMan->LoadedMaterialAdd(std::move(ballMaterial));
+
+    StandardWorld world(std::move(physMan));
+    world.SetRunInBackground(true);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+
+    ScriptRunningSetup setup("SetupContactCallback");
+    auto setupResult = exec.RunScript<bool>(mod, setup, physWorld);
+    REQUIRE(setupResult.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(setupResult.Value);
+
+    auto plane =
+        physWorld->CreateBodyFromCollision(physWorld->CreateBox(10, 1, 10), 0, nullptr, 1);
+    REQUIRE(plane);
+
+    auto ball = physWorld->CreateBodyFromCollision(physWorld->CreateSphere(1), 10, nullptr, 2);
+    REQUIRE(ball);
+    CHECK(ball->SetPosition(Float3(0, 3, 0), Float4::IdentityQuaternion()));
+
+    physWorld->SimulateWorld(1.f, 100);
+
+    const auto getCount = [&](const char* function) {
+        ScriptRunningSetup countSetup(function);
+        auto result = exec.RunScript<int>(mod, countSetup);
+        REQUIRE(result.Result == SCRIPT_RUN_RESULT::Success);
+        return result.Value;
+    };
+
+    // The C++ callback is still called along with the script ones
+    CHECK(CountedContacts > 1);
+
+    // The first callback replaced itself on its first call, so the rest went to the new one
+    CHECK(getCount("GetFirstContacts") == 1);
+    const int secondContacts = getCount("GetSecondContacts");
+    CHECK(secondContacts > 0);
+    CHECK(getCount("GetFirstContacts") + secondContacts == CountedContacts);
+
+    SECTION("Removed callbacks aren't called")
+    {
+        ScriptRunningSetup removeSetup("RemoveContactCallback");
+        auto removeResult = exec.RunScript<bool>(mod, removeSetup, physWorld);
+        REQUIRE(removeResult.Result == SCRIPT_RUN_RESULT::Success);
+        CHECK(removeResult.Value);
+
+        CHECK(ball->SetPosition(Float3(0, 3, 0), Float4::IdentityQuaternion()));
+        physWorld->SimulateWorld(1.f, 100);
+
+        CHECK(CountedContacts > getCount("GetFirstContacts") + secondContacts);
+        CHECK(getCount("GetSecondContacts") == secondContacts);
+    }
+
+    CHECK(physWorld->DestroyBody(ball.get()));
+    CHECK(physWorld->DestroyBody(plane.get()));
+
+    world.Release();
+}
+
 TEST_CASE("Physical compound bodies work with callbacks", "[physics][entity]")
 {
     TestHit = 0;
@@ -271,3 +734,586 @@ TEST_CASE(
 
     world.DestroyBody(body.get());
 }
+
+TEST_CASE("Resting physics bodies fall asleep and are woken by changes", "[physics][entity]")
+{
+    PartialEngine<false> engine;
+
+    StandardWorld world(std::make_unique<PhysicsMaterialManager>());
+    world.SetRunInBackground(true);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+
+    auto box = world.CreateEntity();
+
+    auto& pos = world.Create_Position(box, Float3(0, 3, 0), Float4::IdentityQuaternion());
+    auto& physics = world.Create_Physics(box, pos);
+
+    CHECK(physics.CreatePhysicsBody(physWorld, physWorld->CreateBox(1, 1, 1), 10));
+
+    auto plane = world.CreateEntity();
+
+    auto& planePos =
+        world.Create_Position(plane, Float3(0, 0, 0), Float4::IdentityQuaternion());
+    auto& planePhysics = world.Create_Physics(plane, planePos);
+
+    CHECK(planePhysics.CreatePhysicsBody(physWorld, physWorld->CreateBox(10, 1, 10), 0));
+
+    PhysicsBody& body = *physics.GetBody();
+
+    CHECK(!body.IsSleeping());
+
+    // Fall and rest for a while
+    int tick = 1;
+    for(; tick <= 200 && !body.IsSleeping(); ++tick)
+        world.Tick(tick);
+
+    REQUIRE(body.IsSleeping());
+
+    // Sleeping bodies don't update their positions
+    pos.Marked = false;
+    world.Tick(tick++);
+    CHECK(!pos.Marked);
+
+    const auto restingPosition = pos.Members._Position;
+
+    body.GiveImpulse(Float3(0, 50, 0));
+    CHECK(!body.IsSleeping());
+
+    world.Tick(tick++);
+    CHECK(pos.Marked);
+    CHECK(pos.Members._Position.Y > restingPosition.Y);
+
+    SECTION("Bodies that can't sleep stay awake")
+    {
+        body.SetAllowSleeping(false);
+
+        for(int i = 0; i < 200; ++i)
+            world.Tick(tick++);
+
+        CHECK(!body.IsSleeping());
+    }
+
+    world.Release();
+}
+
+TEST_CASE("Worlds ticked in parallel simulate the same as when ticked one by one",
+    "[physics][entity][threading]")
+{
+    PartialEngine<false> engine;
+
+    ThreadingManager threads;
+    REQUIRE(threads.Init());
+
+    std::vector<std::shared_ptr<GameWorld>> worlds;
+    std::vector<Position*> positions;
+
+    for(int i = 0; i < 4; ++i) {
+
+        auto world =
+            std::make_shared<StandardWorld>(std::make_unique<PhysicsMaterialManager>());
+        world->SetRunInBackground(true);
+
+        REQUIRE(world->Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+
+        // The last world is ticked normally //
+        world->SetTickInParallel(i < 3);
+
+        PhysicalWorld* physWorld = world->GetPhysicalWorld();
+        REQUIRE(physWorld);
+
+        auto object = world->CreateEntity();
+
+        auto& pos =
+            world->Create_Position(object, Float3(0, 10, 0), Float4::IdentityQuaternion());
+        auto& physics = world->Create_Physics(object, pos);
+
+        CHECK(physics.CreatePhysicsBody(physWorld, physWorld->CreateSphere(1), 10));
+
+        positions.push_back(&pos);
+        worlds.push_back(world);
+    }
+
+    for(int tick = 1; tick <= 5; ++tick) {
+
+        GameWorld::TickWorlds(worlds, tick);
+
+        CHECK(!GameWorld::IsParallelTickOnThisThread());
+
+        for(const auto& world : worlds) {
+            CHECK(world->GetTickNumber() == tick);
+            CHECK(!world->IsTickingInParallel());
+        }
+    }
+
+    CHECK(positions[0]->Members._Position.Y < 9.9f);
+
+    for(Position* pos : positions)
+        CHECK(pos->Members._Position == positions.back()->Members._Position);
+
+    for(const auto& world : worlds)
+        world->Release();
+
+    threads.Release();
+}
+
+class SendingTestWorld : public StandardWorld {
+public:
+    using StandardWorld::StandardWorld;
+
+    std::vector<std::thread::id> SendThreads;
+    std::atomic<int> SendsDuringTick{0};
+
+protected:
+    void _RunTickSystems() override
+    {
+        StandardWorld::_RunTickSystems();
+
+        SendOrQueue([this]() {
+            if(IsTickingInParallel() || GameWorld::IsParallelTickOnThisThread())
+                ++SendsDuringTick;
+
+            SendThreads.push_back(std::this_thread::get_id());
+        });
+    }
+};
+
+TEST_CASE("Packets from worlds ticked in parallel are sent after the tick on the calling "
+          "thread",
+    "[entity][networking][threading]")
+{
+    PartialEngine<false> engine;
+
+    ThreadingManager threads;
+    REQUIRE(threads.Init());
+
+    std::vector<std::shared_ptr<GameWorld>> worlds;
+    std::vector<SendingTestWorld*> sendingWorlds;
+
+    for(int i = 0; i < 4; ++i) {
+
+        auto world =
+            std::make_shared<SendingTestWorld>(std::make_unique<PhysicsMaterialManager>());
+        world->SetRunInBackground(true);
+
+        REQUIRE(world->Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+        world->SetTickInParallel(true);
+
+        sendingWorlds.push_back(world.get());
+        worlds.push_back(world);
+    }
+
+    for(int tick = 1; tick <= 3; ++tick)
+        GameWorld::TickWorlds(worlds, tick);
+
+    for(SendingTestWorld* world : sendingWorlds) {
+
+        CHECK(world->SendsDuringTick == 0);
+        REQUIRE(world->SendThreads.size() == 3);
+
+        for(const auto& thread : world->SendThreads)
+            CHECK(thread == std::this_thread::get_id());
+    }
+
+    for(const auto& world : worlds)
+        world->Release();
+
+    threads.Release();
+}
+
+// Multithreaded simulation needs Bullet built with BULLET2_MULTITHREADING
+#ifdef LEVIATHAN_USING_BULLET_MULTITHREADING
+std::thread::id PhysicsTestThread;
+std::atomic<int> ContactsOnOtherThreads = 0;
+std::atomic<int> TestContacts = 0;
+
+void TestContactCallback(PhysicalWorld& world, PhysicsBody& body1, PhysicsBody& body2)
+{
+    ++TestContacts;
+
+    if(std::this_thread::get_id() != PhysicsTestThread)
+        ++ContactsOnOtherThreads;
+}
+
+TEST_CASE("Multithreaded physics world runs material callbacks on the simulating thread",
+    "[physics][entity][threading]")
+{
+    TestHit = 0;
+    TestContacts = 0;
+    ContactsOnOtherThreads = 0;
+    PhysicsTestThread = std::this_thread::get_id();
+
+    PartialEngine<false> engine;
+
+    ThreadingManager threads;
+    REQUIRE(threads.Init());
+
+    auto physMan = std::make_unique<PhysicsMaterialManager>();
+
+    auto planeMaterial = std::make_unique<Leviathan::PhysicalMaterial>("PlaneMaterial", 1);
+    auto ballMaterial = std::make_unique<Leviathan::PhysicalMaterial>("BallMaterial", 2);
+
+    planeMaterial->FormPairWith(*ballMaterial)
+        .SetCallbacks(TestAABBCallback, TestContactCallback);
+
+    physMan->LoadedMaterialAdd(std::move(planeMaterial));
+    physMan->LoadedMaterialAdd(std::move(ballMaterial));
+
+    StandardWorld world(std::move(physMan));
+    world.SetRunInBackground(true);
+    world.SetMultithreadedPhysics(true);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+    REQUIRE(physWorld->IsMultithreaded());
+
+    auto plane = world.CreateEntity();
+
+    auto& planePos =
+        world.Create_Position(plane, Float3(0, 0, 0), Float4::IdentityQuaternion());
+    auto& planePhysics = world.Create_Physics(plane, planePos);
+
+    CHECK(planePhysics.CreatePhysicsBody(physWorld, physWorld->CreateBox(50, 1, 50), 0, 1));
+
+    auto sphere = physWorld->CreateSphere(1);
+    std::vector<Position*> positions;
+
+    for(int i = 0; i < 256; ++i) {
+
+        auto ball = world.CreateEntity();
+
+        auto& pos = world.Create_Position(ball,
+            Float3((i % 16) * 3.f - 24.f, 5, (i / 16) * 3.f - 24.f),
+            Float4::IdentityQuaternion());
+        auto& physics = world.Create_Physics(ball, pos);
+
+        CHECK(physics.CreatePhysicsBody(physWorld, sphere, 10, 2));
+        positions.push_back(&pos);
+    }
+
+    physWorld->SimulateWorld(1.f, 100);
+
+    CHECK(TestHit > 0);
+    CHECK(TestContacts > 0);
+    CHECK(ContactsOnOtherThreads == 0);
+
+    for(Position* pos : positions) {
+        // Landed on the plane without falling through
+        CHECK(pos->Members._Position.Y < 4.f);
+        CHECK(pos->Members._Position.Y > 0.f);
+    }
+
+    world.Release();
+    threads.Release();
+}
+#endif // LEVIATHAN_USING_BULLET_MULTITHREADING
+
+TEST_CASE("Physics queries find bodies", "[physics][entity]")
+{
+    PartialEngine<false> engine;
+
+    StandardWorld world(std::make_unique<PhysicsMaterialManager>());
+    world.SetRunInBackground(true);
+
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForClient(), nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+
+    auto ground = world.CreateEntity();
+
+    auto& groundPos =
+        world.Create_Position(ground, Float3(0, -1, 0), Float4::IdentityQuaternion());
+    auto& groundPhysics = world.Create_Physics(ground, groundPos);
+
+    CHECK(groundPhysics.CreatePhysicsBody(physWorld, physWorld->CreateBox(20, 1, 20), 0));
+
+    // Spheres in a row along the x axis at x = 0, 5 and 10 //
+    std::vector<ObjectID> balls;
+
+    for(int i = 0; i < 3; ++i) {
+
+        auto ball = world.CreateEntity();
+
+        auto& pos =
+            world.Create_Position(ball, Float3(i * 5.f, 2, 0), Float4::IdentityQuaternion());
+        auto& physics = world.Create_Physics(ball, pos);
+
+        CHECK(physics.CreatePhysicsBody(physWorld, physWorld->CreateSphere(1), 1));
+        balls.push_back(ball);
+    }
+
+    SECTION("Rays hit the closest body")
+    {
+        auto hit = physWorld->CastRay(Float3(-10, 2, 0), Float3(20, 2, 0));
+
+        REQUIRE(hit.HasHit());
+        CHECK(hit.Entity == balls[0]);
+        CHECK(hit.Point.X == Approx(-1.f).margin(0.01f));
+        CHECK(hit.Normal.X == Approx(-1.f).margin(0.01f));
+        CHECK(hit.Fraction == Approx(9.f / 30.f).margin(0.001f));
+
+        CHECK(!physWorld->CastRay(Float3(-10, 10, 0), Float3(20, 10, 0)).HasHit());
+
+        hit = physWorld->CastRay(Float3(0, 10, 0), Float3(0, -10, 0));
+        REQUIRE(hit.HasHit());
+        CHECK(hit.Entity == balls[0]);
+        CHECK(hit.Point.Y == Approx(3.f).margin(0.01f));
+    }
+
+    SECTION("All hits are sorted by distance")
+    {
+        auto hits = physWorld->CastRayAll(Float3(20, 2, 0), Float3(-10, 2, 0));
+
+        REQUIRE(hits.size() == 3);
+        CHECK(hits[0].Entity == balls[2]);
+        CHECK(hits[1].Entity == balls[1]);
+        CHECK(hits[2].Entity == balls[0]);
+
+        // Only the closest are kept when there are too many
+        hits = physWorld->CastRayAll(Float3(20, 2, 0), Float3(-10, 2, 0), {}, 2);
+
+        REQUIRE(hits.size() == 2);
+        CHECK(hits[0].Entity == balls[2]);
+        CHECK(hits[1].Entity == balls[1]);
+    }
+
+    SECTION("Filters skip bodies")
+    {
+        PhysicsQueryFilter filter;
+        filter.IgnoredEntity = balls[0];
+
+        auto hit = physWorld->CastRay(Float3(-10, 2, 0), Float3(20, 2, 0), filter);
+
+        REQUIRE(hit.HasHit());
+        CHECK(hit.Entity == balls[1]);
+
+        filter = PhysicsQueryFilter();
+        filter.HitDynamic = false;
+
+        hit = physWorld->CastRay(Float3(0, 10, 0), Float3(0, -10, 0), filter);
+
+        REQUIRE(hit.HasHit());
+        CHECK(hit.Entity == ground);
+        CHECK(hit.Point.Y == Approx(0.f).margin(0.01f));
+    }
+
+    SECTION("Sweeps hit bodies a ray would miss")
+    {
+        CHECK(!physWorld->CastRay(Float3(-10, 3.5f, 0), Float3(20, 3.5f, 0)).HasHit());
+
+        auto hit = physWorld->SweepSphere(Float3(-10, 3.5f, 0), Float3(20, 3.5f, 0), 1);
+
+        REQUIRE(hit.HasHit());
+        CHECK(hit.Entity == balls[0]);
+        CHECK(hit.Fraction < 10.f / 30.f);
+
+        hit = physWorld->SweepBox(Float3(5, 10, 0), Float3(5, -10, 0), Float3(0.5f),
+            Float4::IdentityQuaternion());
+
+        REQUIRE(hit.HasHit());
+        CHECK(hit.Entity == balls[1]);
+    }
+
+    SECTION("Overlaps find touching bodies")
+    {
+        auto hits = physWorld->OverlapSphere(Float3(2.5f, 2.5f, 0), 2);
+
+        REQUIRE(hits.size() == 2);
+        CHECK(std::count_if(hits.begin(), hits.end(),
+                  [&](const PhysicsQueryHit& hit) { return hit.Entity == balls[2]; }) == 0);
+
+        // Would overlap ball 0 bounding box corner but not the sphere itself
+        hits = physWorld->OverlapSphere(Float3(-1, 3.1f, 0.9f), 0.2f);
+        CHECK(hits.empty());
+
+        hits = physWorld->OverlapAABB(Float3(-1, 1.5f, -1), Float3(11, 2.5f, 1));
+        CHECK(hits.size() == 3);
+
+        hits = physWorld->OverlapBox(
+            Float3(10, 0, 0), Float3(0.5f, 0.5f, 0.5f), Float4::IdentityQuaternion());
+
+        REQUIRE(hits.size() == 1);
+        CHECK(hits[0].Entity == ground);
+    }
+
+    SECTION("Batched queries return the same results as single queries")
+    {
+        ThreadingManager threads;
+        REQUIRE(threads.Init());
+
+        PhysicsQueryBatch batch;
+        std::vector<PhysicsQuery> queries;
+
+        for(int i = 0; i < 100; ++i) {
+
+            const float offset = (i % 10) * 1.5f - 2.f;
+
+            const Float3 above(offset, 10, 0);
+            const Float3 below(offset, -10, 0);
+
+            queries.push_back(PhysicsQuery::Ray(above, below));
+            queries.push_back(
+                PhysicsQuery::RayAll(Float3(-10, 2, offset * 0.1f), Float3(20, 2, 0)));
+            queries.push_back(PhysicsQuery::SphereSweep(above, below, 0.5f));
+            queries.push_back(PhysicsQuery::SphereOverlap(Float3(offset, 2, 0), 1.f));
+        }
+
+        for(const auto& query : queries)
+            batch.Add(query);
+
+        physWorld->RunQueries(batch);
+
+        REQUIRE(batch.GetQueryCount() == queries.size());
+
+        for(size_t i = 0; i < queries.size(); ++i) {
+
+            std::vector<PhysicsQueryHit> hits(queries[i].GetMaxHits());
+            const int count = physWorld->RunQuery(queries[i], hits.data());
+
+            REQUIRE(batch.GetHitCount(i) == count);
+
+            for(int hit = 0; hit < count; ++hit) {
+
+                CHECK(batch.GetHit(i, hit).Body == hits[hit].Body);
+                CHECK(batch.GetHit(i, hit).Fraction == hits[hit].Fraction);
+            }
+        }
+
+        CHECK(batch.GetHitCount(0) == 1);
+
+        threads.Release();
+    }
+
+    world.Release();
+}
+
+TEST_CASE("World snapshots recreate physics bodies", "[physics][entity]")
+{
+    PartialEngine<false> engine;
+
+    const auto createMaterials = []() {
+        auto materials = std::make_unique<PhysicsMaterialManager>();
+        materials->LoadedMaterialAdd(std::make_unique<PhysicalMaterial>("Ball", 1));
+        materials->LoadedMaterialAdd(std::make_unique<PhysicalMaterial>("Ground", 2));
+        return materials;
+    };
+
+    StandardWorld world(createMaterials());
+    REQUIRE(world.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    PhysicalWorld* physWorld = world.GetPhysicalWorld();
+    REQUIRE(physWorld);
+
+    const auto createBody = [&](const Float3& position, const PhysicsShape::pointer& shape,
+                                float mass, int material) {
+        const auto entity = world.CreateEntity();
+        auto& pos = world.Create_Position(entity, position, Float4::IdentityQuaternion());
+        auto& physics = world.Create_Physics(entity, pos);
+
+        const auto body = physics.CreatePhysicsBody(physWorld, shape, mass, material);
+        REQUIRE(body);
+        return entity;
+    };
+
+    const auto ground = createBody(Float3(0, -1, 0), physWorld->CreateBox(20, 1, 20), 0,
+        world.GetPhysicalMaterial("Ground"));
+
+    // The balls share a shape
+    const auto ballShape = physWorld->CreateSphere(1);
+    const auto ball1 = createBody(Float3(0, 5, 0), ballShape, 10, 1);
+    const auto ball2 = createBody(Float3(5, 3, 0), ballShape, 2, 1);
+
+    auto compoundShape = physWorld->CreateCompound();
+    compoundShape->AddChildShape(physWorld->CreateBox(1, 1, 1));
+    compoundShape->AddChildShape(physWorld->CreateSphere(0.5f), Float3(2, 0, 0),
+        Float4::CreateQuaternionFromAngles(Float3(0, 1, 0)));
+    const auto compound = createBody(Float3(-5, 4, 0), compoundShape, 5, -1);
+
+    PhysicsBody& ball1Body = *world.GetComponent_Physics(ball1).GetBody();
+    ball1Body.SetDamping(0.1f, 0.2f);
+    ball1Body.SetFriction(0.7f);
+    ball1Body.SetVelocity(Float3(1, 0, 0));
+    ball1Body.SetAngularVelocity(Float3(0, 2, 0));
+    ball1Body.ConstraintMovementAxises(Float3(1, 1, 0));
+
+    std::stringstream snapshot;
+    REQUIRE(world.SaveSnapshot(snapshot));
+
+    StandardWorld loaded(createMaterials());
+    REQUIRE(loaded.Init(WorldNetworkSettings::GetSettingsForSinglePlayer(), nullptr));
+
+    WorldSnapshotReader reader(snapshot);
+
+    while(loaded.LoadSnapshotChunk(reader)) {
+    }
+
+    REQUIRE(reader.HasEnded());
+    CHECK(!reader.HasFailed());
+
+    const auto checkSame = [](const Float3& value, const Float3& expected) {
+        CHECK(value.X == Approx(expected.X).margin(0.0001f));
+        CHECK(value.Y == Approx(expected.Y).margin(0.0001f));
+        CHECK(value.Z == Approx(expected.Z).margin(0.0001f));
+    };
+
+    std::map<ObjectID, PhysicsBody*> loadedBodies;
+
+    for(ObjectID entity : {ground, ball1, ball2, compound}) {
+
+        const auto loadedEntity = reader.GetLoadedEntity(entity);
+        REQUIRE(loadedEntity != NULL_OBJECT);
+
+        PhysicsBody* original = world.GetComponent_Physics(entity).GetBody();
+        PhysicsBody* body = loaded.GetComponent_Physics(loadedEntity).GetBody();
+        REQUIRE(body);
+
+        CHECK(body->GetMass() == original->GetMass());
+        CHECK(body->GetPhysicalMaterialID() == original->GetPhysicalMaterialID());
+        CHECK(body->GetShape()->GetShape()->getShapeType() ==
+              original->GetShape()->GetShape()->getShapeType());
+
+        PhysicsBodyProperties properties;
+        PhysicsBodyProperties expected;
+        body->GetProperties(properties);
+        original->GetProperties(expected);
+
+        CHECK(properties.LinearDamping == Approx(expected.LinearDamping));
+        CHECK(properties.AngularDamping == Approx(expected.AngularDamping));
+        CHECK(properties.Friction == Approx(expected.Friction));
+        checkSame(properties.LinearFactor, expected.LinearFactor);
+        checkSame(properties.AngularFactor, expected.AngularFactor);
+
+        checkSame(body->GetPosition(), original->GetPosition());
+        checkSame(body->GetVelocity(), original->GetVelocity());
+        checkSame(body->GetAngularVelocity(), original->GetAngularVelocity());
+
+        loadedBodies[entity] = body;
+    }
+
+    CHECK(loadedBodies[ball1]->GetShape() == loadedBodies[ball2]->GetShape());
+    CHECK(static_cast<btCompoundShape*>(loadedBodies[compound]->GetShape()->GetShape())
+              ->getNumChildShapes() == 2);
+
+    // Both worlds continue the same way
+    for(int tick = 0; tick < 20; ++tick) {
+
+        physWorld->SimulateWorld(TICKSPEED / 1000.f);
+        loaded.GetPhysicalWorld()->SimulateWorld(TICKSPEED / 1000.f);
+    }
+
+    CHECK(world.GetComponent_Physics(ball2).GetBody()->GetPosition().Y < 3);
+
+    for(ObjectID entity : {ball1, ball2, compound}) {
+        checkSame(loadedBodies[entity]->GetPosition(),
+            world.GetComponent_Physics(entity).GetBody()->GetPosition());
+    }
+
+    loaded.Release();
+    world.Release();
+}
@@ -1,12 +1,17 @@
 #include "../PartialEngine.h"
 
+#include "Events/Event.h"
 #include "Handlers/IDFactory.h"
 #include "Script/Bindings/BindHelpers.h"
+#include "Script/PreparedScriptCall.h"
 #include "Script/ScriptExecutor.h"
 #include "Script/ScriptModule.h"
 
 #include "catch.hpp"
 
+#include <filesystem>
+#include <thread>
+
 using namespace Leviathan;
 using namespace Leviathan::Test;
 
@@ -823,3 +828,277 @@ TEST_CASE("Script passing uint16_t works", "[script]")
     CHECK(returned.Result == SCRIPT_RUN_RESULT::Success);
     CHECK(returned.Value == value);
 }
+
+TEST_CASE("Script modules are loaded from the bytecode cache", "[script]")
+{
+    PartialEngine<false> engine;
+    IDFactory ids;
+
+    const std::string cacheFolder = "Data/Cache/ScriptTest/";
+
+    std::error_code error;
+    std::filesystem::remove_all(cacheFolder, error);
+
+    const auto buildModule = [&](ScriptExecutor& exec, const std::string& code) {
+        exec.SetBytecodeCacheFolder(cacheFolder);
+
+        auto mod = exec.CreateNewModule("CacheTestScript", "ScriptGenerator").lock();
+
+        mod->AddScriptSegment(std::make_shared<ScriptSourceFileData>("Script.cpp", 1, code));
+        return mod;
+    };
+
+    const std::string sourcecode = "[@Listener=\"OnInit\"]\n"
+                                   "int TestFunction(int value){\n"
+                                   "    return value * 2;\n"
+                                   "}";
+
+    const auto checkModule = [](ScriptExecutor& exec, std::shared_ptr<ScriptModule> mod,
+                                 int multiplier) {
+        REQUIRE(mod->GetModule() != nullptr);
+
+        // Metadata needs to also be cached //
+        CHECK(mod->GetListeningFunctionName(LISTENERNAME_ONINIT) == "TestFunction");
+
+        ScriptRunningSetup ssetup("TestFunction");
+        auto returned = exec.RunScript<int>(mod, ssetup, 21);
+
+        REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+        CHECK(returned.Value == 21 * multiplier);
+    };
+
+    {
+        ScriptExecutor exec;
+        auto mod = buildModule(exec, sourcecode);
+
+        checkModule(exec, mod, 2);
+        CHECK(!mod->WasLoadedFromBytecodeCache());
+
+        mod->DeleteThisModule();
+    }
+
+    {
+        ScriptExecutor exec;
+        auto mod = buildModule(exec, sourcecode);
+
+        checkModule(exec, mod, 2);
+        CHECK(mod->WasLoadedFromBytecodeCache());
+
+        mod->DeleteThisModule();
+    }
+
+    SECTION("Changed source isn't loaded from the cache")
+    {
+        ScriptExecutor exec;
+        auto mod = buildModule(exec, "[@Listener=\"OnInit\"]\n"
+                                     "int TestFunction(int value){\n"
+                                     "    return value * 3;\n"
+                                     "}");
+
+        checkModule(exec, mod, 3);
+        CHECK(!mod->WasLoadedFromBytecodeCache());
+
+        mod->DeleteThisModule();
+    }
+
+    SECTION("Registering new things invalidates the cache")
+    {
+        ScriptExecutor exec;
+
+        static int extraProperty = 0;
+        REQUIRE(exec.GetASEngine()->RegisterGlobalProperty(
+                    "int CacheTestExtraProperty", &extraProperty) >= 0);
+
+        auto mod = buildModule(exec, sourcecode);
+
+        checkModule(exec, mod, 2);
+        CHECK(!mod->WasLoadedFromBytecodeCache());
+
+        mod->DeleteThisModule();
+    }
+
+    std::filesystem::remove_all(cacheFolder, error);
+}
+
+TEST_CASE("Prepared script calls verify the signature once", "[script]")
+{
+    PartialEngine<false> engine;
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+
+    auto sourcecode = std::make_shared<ScriptSourceFileData>("Script.cpp", __LINE__ + 1,
+        "int32 TestFunction(int32 first, float second){\n"
+        "    return first + int32(second);\n"
+        "}");
+
+    mod->AddScriptSegment(sourcecode);
+
+    auto module = mod->GetModule();
+
+    REQUIRE(module != nullptr);
+
+    ScriptRunningSetup ssetup("TestFunction");
+    asIScriptFunction* func = exec.GetFunctionFromModule(mod.get(), ssetup);
+
+    REQUIRE(func != nullptr);
+
+    SECTION("Matching signature can be ran multiple times")
+    {
+        PreparedScriptCall<int32_t(int32_t, float)> call(&exec, func);
+
+        REQUIRE(call.IsValid());
+
+        for(int32_t i = 0; i < 5; ++i) {
+
+            auto returned = call.Run(i, 2.f);
+
+            CHECK(returned.Result == SCRIPT_RUN_RESULT::Success);
+            CHECK(returned.Value == i + 2);
+        }
+    }
+
+    SECTION("Mismatching parameters are rejected")
+    {
+        PreparedScriptCall<int32_t(int32_t, int32_t)> call(&exec, func, false);
+        CHECK(!call.IsValid());
+
+        PreparedScriptCall<int32_t(int32_t)> call2(&exec, func, false);
+        CHECK(!call2.IsValid());
+
+        CHECK(call.Run(1, 2).Result == SCRIPT_RUN_RESULT::Error);
+    }
+
+    SECTION("Mismatching return type is rejected")
+    {
+        PreparedScriptCall<float(int32_t, float)> call(&exec, func, false);
+        CHECK(!call.IsValid());
+    }
+}
+
+ScriptExecutor* NestedCallExecutor = nullptr;
+std::shared_ptr<ScriptModule> NestedCallModule;
+std::vector<asIScriptContext*> NestedCallContexts;
+
+int CallScriptNested(int depth)
+{
+    NestedCallContexts.push_back(asGetActiveContext());
+
+    ScriptRunningSetup setup("Recurse");
+    auto returned = NestedCallExecutor->RunScript<int>(NestedCallModule, setup, depth);
+
+    if(returned.Result != SCRIPT_RUN_RESULT::Success)
+        return -1000;
+
+    return returned.Value;
+}
+
+TEST_CASE("Scripts can be ran from inside running scripts", "[script]")
+{
+    PartialEngine<false> engine;
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    REQUIRE(exec.GetASEngine()->RegisterGlobalFunction("int CallScriptNested(int depth)",
+                asFUNCTION(CallScriptNested), asCALL_CDECL) >= 0);
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+
+    auto sourcecode = std::make_shared<ScriptSourceFileData>("Script.cpp", __LINE__ + 1,
+        "int Recurse(int depth){\n"
+        "    int local = depth * 10;\n"
+        "    if(depth <= 0)\n"
+        "        return 1;\n"
+        "    int inner = CallScriptNested(depth - 1);\n"
+        "    // The variables of this call need to be restored after the nested call\n"
+        "    return inner + local;\n"
+        "}");
+
+    mod->AddScriptSegment(sourcecode);
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    NestedCallExecutor = &exec;
+    NestedCallModule = mod;
+    NestedCallContexts.clear();
+
+    ScriptRunningSetup ssetup("Recurse");
+
+    auto returned = exec.RunScript<int>(mod, ssetup, 3);
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(returned.Value == 30 + 20 + 10 + 1);
+
+    // The nested calls reuse the context of the running script //
+    REQUIRE(NestedCallContexts.size() == 3);
+    CHECK(NestedCallContexts[0] != nullptr);
+    CHECK(NestedCallContexts[1] == NestedCallContexts[0]);
+    CHECK(NestedCallContexts[2] == NestedCallContexts[0]);
+
+    // Which is returned to the pool once the outermost call finishes //
+    CHECK(NestedCallContexts[0]->GetState() != asEXECUTION_ACTIVE);
+    CHECK(!NestedCallContexts[0]->IsNested());
+
+    // And works normally after that //
+    returned = exec.RunScript<int>(mod, ssetup, 1);
+
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(returned.Value == 11);
+
+    NestedCallModule.reset();
+    NestedCallExecutor = nullptr;
+}
+
+TEST_CASE("Script contexts of exited threads are released", "[script][threading]")
+{
+    PartialEngine<false> engine;
+    IDFactory ids;
+    ScriptExecutor exec;
+
+    auto mod = exec.CreateNewModule("TestScript", "ScriptGenerator").lock();
+
+    auto sourcecode = std::make_shared<ScriptSourceFileData>("Script.cpp", __LINE__ + 1,
+        "int TestFunction(int value){\n"
+        "    return value * 2;\n"
+        "}");
+
+    mod->AddScriptSegment(sourcecode);
+
+    REQUIRE(mod->GetModule() != nullptr);
+
+    ScriptRunningSetup ssetup("TestFunction");
+
+    auto returned = exec.RunScript<int>(mod, ssetup, 2);
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(returned.Value == 4);
+
+    CHECK(exec.GetThreadContextPoolCount() == 1);
+
+    int threadResult = 0;
+    size_t poolsInThread = 0;
+
+    std::thread other([&]() {
+        ScriptRunningSetup setup("TestFunction");
+        auto result = exec.RunScript<int>(mod, setup, 5);
+
+        if(result.Result == SCRIPT_RUN_RESULT::Success)
+            threadResult = result.Value;
+
+        poolsInThread = exec.GetThreadContextPoolCount();
+    });
+
+    other.join();
+
+    CHECK(threadResult == 10);
+
+    // The pool of the thread exists until it exits //
+    CHECK(poolsInThread == 2);
+    CHECK(exec.GetThreadContextPoolCount() == 1);
+
+    // This thread still uses its pool //
+    returned = exec.RunScript<int>(mod, ssetup, 3);
+    REQUIRE(returned.Result == SCRIPT_RUN_RESULT::Success);
+    CHECK(returned.Value == 6);
+    CHECK(exec.GetThreadContextPoolCount() == 1);
+}
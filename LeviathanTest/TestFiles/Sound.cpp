@@ -0,0 +1,119 @@
+//! \file Tests for the SoundDevice parts that work without an audio device
+
+#include "Sound/SoundDevice.h"
+
+#include "../PartialEngine.h"
+
+#include "catch.hpp"
+
+#include <fstream>
+
+using namespace Leviathan;
+using namespace Leviathan::Test;
+
+namespace {
+//! Creates a file with size bytes, without a device the file size is used as the buffer size
+std::string CreateTestSoundFile(const std::string& name, size_t size)
+{
+    const auto file = "Test/" + name;
+
+    std::ofstream writer(file, std::ios::binary | std::ios::trunc);
+    writer << std::string(size, 'a');
+
+    return file;
+}
+} // namespace
+
+TEST_CASE("SoundDevice buffer cache works without a device", "[sound]")
+{
+    PartialEngine<false> engine;
+    engine.Log.IgnoreWarnings = true;
+
+    SoundDevice sound;
+    REQUIRE(sound.Init(true));
+
+    const auto first = CreateTestSoundFile("sound_cache_1.ogg", 1000);
+    const auto second = CreateTestSoundFile("sound_cache_2.ogg", 1000);
+    const auto third = CreateTestSoundFile("sound_cache_3.ogg", 1000);
+
+    const auto buffer = sound.GetBufferFromFile(first);
+    REQUIRE(buffer);
+    CHECK(buffer->IsLoaded());
+    CHECK(buffer->GetSize() == 1000);
+
+    CHECK(sound.GetBufferFromFile(first) == buffer);
+    CHECK(sound.GetCachedBufferCount() == 1);
+
+    CHECK(!sound.GetAudioSource());
+
+    SECTION("Least recently used buffers are removed when over budget")
+    {
+        sound.SetBufferCacheBudget(2500);
+
+        CHECK(sound.GetBufferFromFile(second));
+        CHECK(sound.GetBufferFromFile(third));
+        CHECK(sound.GetBufferCacheSize() == 3000);
+
+        // Makes second the least recently used
+        CHECK(sound.GetBufferFromFile(first) == buffer);
+
+        sound.CleanBufferCache();
+
+        CHECK(sound.GetCachedBufferCount() == 2);
+        CHECK(sound.GetBufferCacheSize() == 2000);
+
+        // first is still cached
+        CHECK(sound.GetBufferFromFile(first) == buffer);
+    }
+
+    SECTION("Uncached buffers don't use the cache")
+    {
+        const auto uncached = sound.GetBufferFromFile(second, false);
+        REQUIRE(uncached);
+        CHECK(uncached->GetSize() == 1000);
+        CHECK(sound.GetCachedBufferCount() == 1);
+    }
+
+    SECTION("Precached buffers are kept")
+    {
+        sound.PrecacheBuffers({second});
+        sound.SetBufferCacheBudget(0);
+
+        sound.CleanBufferCache();
+
+        CHECK(sound.GetCachedBufferCount() == 1);
+        CHECK(sound.GetBufferCacheSize() == 1000);
+    }
+
+    sound.Release();
+}
+
+TEST_CASE("SoundDevice precaches sounds from the manifest on init", "[sound]")
+{
+    PartialEngine<false> engine;
+    engine.Log.IgnoreWarnings = true;
+
+    const auto first = CreateTestSoundFile("sound_manifest_1.ogg", 100);
+    const auto second = CreateTestSoundFile("sound_manifest_2.ogg", 200);
+
+    {
+        std::ofstream writer("Test/sound_manifest.txt", std::ios::trunc);
+        writer << "Sounds = [[\"" << first << "\"][\"" << second << "\"]];\n";
+    }
+
+    engine.Def.GetValues()->AddVar(std::make_shared<NamedVariableList>(
+        "SoundPrecacheManifest", new StringBlock("Test/sound_manifest.txt")));
+
+    SoundDevice sound;
+    REQUIRE(sound.Init(true));
+
+    CHECK(sound.GetCachedBufferCount() == 2);
+    CHECK(sound.GetBufferCacheSize() == 300);
+
+    // Precached ones aren't removed
+    sound.SetBufferCacheBudget(0);
+    sound.CleanBufferCache();
+    CHECK(sound.GetCachedBufferCount() == 2);
+
+    sound.Release();
+}
@@ -809,3 +809,96 @@ TEST_CASE("StringIterator new line handling", "[string]")
         CHECK(*result == "true");
     }
 }
+
+TEST_CASE("StringIterator view iterator matches the copying one", "[string][objectfile]")
+{
+    // Long enough runs for the scanning to go through multiple blocks //
+    const std::string source = "first = \"quoted ; value\";  \n"
+                               "  \t  \r\n      second: // comment; here\n"
+                               "third = a really long value without anything special in it "
+                               "\xc3\xa4\xc3\xb6 and some more of that text;\n"
+                               "fourth = /* block ; */ 4;\n"
+                               "fifth = escaped \\; semicolon;\n"
+                               "\xe2\x80\xa8"
+                               "sixth = line separator above;";
+
+    StringIterator copying(std::make_unique<UTF8DataIterator>(source));
+    StringIterator view(std::make_unique<UTF8ViewDataIterator>(source));
+
+    // The escaped ';' doesn't end the fifth value //
+    for(int i = 0; i < 5; ++i) {
+
+        copying.SkipWhiteSpace();
+        view.SkipWhiteSpace();
+
+        CHECK(view.GetPosition() == copying.GetPosition());
+        CHECK(view.GetCurrentLine() == copying.GetCurrentLine());
+
+        auto expected = copying.GetUntilNextCharacterOrAll<std::string>(
+            ';', SPECIAL_ITERATOR_HANDLECOMMENTS_ASSTRING);
+        auto result = view.GetUntilNextCharacterOrAll<std::string_view>(
+            ';', SPECIAL_ITERATOR_HANDLECOMMENTS_ASSTRING);
+
+        REQUIRE(expected);
+        REQUIRE(result);
+        CHECK(*result == *expected);
+
+        CHECK(view.GetPosition() == copying.GetPosition());
+        CHECK(view.GetCurrentLine() == copying.GetCurrentLine());
+        CHECK(view.IsInsideString() == copying.IsInsideString());
+
+        copying.MoveToNext();
+        view.MoveToNext();
+    }
+
+    CHECK(view.IsOutOfBounds());
+    CHECK(copying.IsOutOfBounds());
+}
+
+TEST_CASE("StringIterator view iterator returns views", "[string]")
+{
+    const std::string source = "name = \"value in quotes\";";
+
+    StringIterator itr(std::make_unique<UTF8ViewDataIterator>(source));
+
+    auto name = itr.GetUntilEqualityAssignment<std::string_view>(EQUALITYCHARACTER_TYPE_ALL);
+
+    REQUIRE(name);
+    CHECK(*name == "name");
+    CHECK(name->data() == source.data());
+
+    auto value = itr.GetStringInQuotes<std::string_view>(QUOTETYPE_DOUBLEQUOTES);
+
+    REQUIRE(value);
+    CHECK(*value == "value in quotes");
+    CHECK(value->data() == source.data() + 8);
+}
+
+TEST_CASE("StringScanning finds the same characters as a simple loop", "[string]")
+{
+    std::string data(100, 'a');
+
+    CHECK(StringScanning::FindSpecialCharacter(data.data(), data.size(), ';') == 100);
+    CHECK(StringScanning::CountLeadingWhitespace(data.data(), data.size(), false) == 0);
+
+    for(size_t i = 0; i < data.size(); i += 7) {
+
+        std::string modified = data;
+        modified[i] = '"';
+        CHECK(StringScanning::FindSpecialCharacter(modified.data(), modified.size(), ';') == i);
+
+        modified[i] = ';';
+        CHECK(StringScanning::FindSpecialCharacter(modified.data(), modified.size(), ';') == i);
+
+        modified[i] = '\xc3';
+        CHECK(StringScanning::FindSpecialCharacter(modified.data(), modified.size(), ';') ==
+              100);
+
+        std::string spaces(i, ' ');
+        spaces += "\nx";
+
+        CHECK(StringScanning::CountLeadingWhitespace(spaces.data(), spaces.size(), true) == i);
+        CHECK(StringScanning::CountLeadingWhitespace(spaces.data(), spaces.size(), false) ==
+              i + 1);
+    }
+}
@@ -0,0 +1,84 @@
+#include "Iterators/StringIterator.h"
+#include "ObjectFiles/ObjectFileProcessor.h"
+
+#include "../DummyLog.h"
+
+#include "catch.hpp"
+
+using namespace Leviathan;
+using namespace Leviathan::Test;
+
+// These are hidden by default, run with: LeviathanTest "[benchmark]"
+
+namespace {
+//! Builds an ObjectFile like text with lots of variables and objects
+std::string GenerateObjectFileText(int objects)
+{
+    std::string result;
+
+    for(int i = 0; i < objects; ++i) {
+
+        const auto number = std::to_string(i);
+
+        result += "Variable" + number + " = " + number + ";\n";
+        result += "// A comment about the next object that should be skipped quickly\n";
+        result += "o Type \"Object" + number + "\"{\n";
+        result += "    l values {\n";
+        result += "        first = \"a string value that is long enough to matter\";\n";
+        result += "        second = [1, 2, 3, 4];\n";
+        result += "        third: some plain text until the end of the value;\n";
+        result += "    }\n";
+        result += "}\n\n";
+    }
+
+    return result;
+}
+} // namespace
+
+TEST_CASE("StringIterator view and copying iterator speed", "[benchmark][.]")
+{
+    const auto text = GenerateObjectFileText(1000);
+    size_t copyingCount = 0;
+    size_t viewCount = 0;
+
+    BENCHMARK("UTF8DataIterator splitting to values")
+    {
+        StringIterator itr(std::make_unique<UTF8DataIterator>(text));
+
+        while(auto value = itr.GetUntilNextCharacterOrNothing<std::string>(
+                  ';', SPECIAL_ITERATOR_HANDLECOMMENTS_ASSTRING)) {
+            ++copyingCount;
+            itr.MoveToNext();
+            itr.SkipWhiteSpace();
+        }
+    }
+
+    BENCHMARK("UTF8ViewDataIterator splitting to values")
+    {
+        StringIterator itr(std::make_unique<UTF8ViewDataIterator>(text));
+
+        while(auto value = itr.GetUntilNextCharacterOrNothing<std::string_view>(
+                  ';', SPECIAL_ITERATOR_HANDLECOMMENTS_ASSTRING)) {
+            ++viewCount;
+            itr.MoveToNext();
+            itr.SkipWhiteSpace();
+        }
+    }
+
+    CHECK(copyingCount == viewCount);
+}
+
+TEST_CASE("ObjectFile text parsing speed", "[benchmark][objectfile][.]")
+{
+    const auto text = GenerateObjectFileText(1000);
+    DummyReporter reporter;
+
+    BENCHMARK("ProcessObjectFileFromString")
+    {
+        auto ofile =
+            ObjectFileProcessor::ProcessObjectFileFromString(text, "benchmark", &reporter);
+
+        REQUIRE(ofile);
+        CHECK(ofile->GetTotalObjectCount() == 1000);
+    }
+}
@@ -0,0 +1,65 @@
+// Script systems used by LeviathanBenchmarks to measure the per tick cost of script systems
+
+class BenchmarkSystemCached{
+
+    BenchmarkSystemCached(ObjectID id, Position@ position)
+    {
+        ID = id;
+        @Pos = position;
+    }
+
+    ObjectID ID;
+    Position@ Pos;
+};
+
+class BenchmarkSystem : ScriptSystem{
+
+    void Init(GameWorld@ world){
+
+        @World = cast<StandardWorld@>(world);
+    }
+
+    void Release(){
+
+    }
+
+    void Run(){
+
+        for(uint i = 0; i < CachedComponents.length(); ++i){
+
+            Position@ pos = CachedComponents[i].Pos;
+            Total += pos._Position.X + pos._Position.Y + pos._Position.Z;
+        }
+    }
+
+    void Clear(){
+
+        CachedComponents.resize(0);
+    }
+
+    void CreateAndDestroyNodes(){
+
+        // Delegate to helper //
+        ScriptSystemNodeHelper(World, @CachedComponents, SystemComponents);
+    }
+
+    float Total = 0;
+
+    private StandardWorld@ World;
+    private array<ScriptSystemUses> SystemComponents = {
+        ScriptSystemUses(Position::TYPE)
+    };
+
+    array<BenchmarkSystemCached@> CachedComponents;
+};
+
+
+bool SetupBenchmarkSystems(GameWorld@ world, int count){
+
+    for(int i = 0; i < count; ++i){
+
+        world.RegisterScriptSystem("BenchmarkSystem" + i, BenchmarkSystem());
+    }
+
+    return true;
+}
@@ -251,3 +251,544 @@ bool SetupCustomComponentsMultiple(GameWorld@ world){
     
     return true;
 }
+
+
+// Helpers for testing adding and removing nodes from the C++ side
+uint GetCachedNodeCount(GameWorld@ world){
+
+    CoolSystem@ system = cast<CoolSystem>(world.GetScriptSystem("CoolSystem"));
+
+    return system.CachedComponents.length();
+}
+
+int CountCachedNodes(GameWorld@ world, ObjectID id){
+
+    CoolSystem@ system = cast<CoolSystem>(world.GetScriptSystem("CoolSystem"));
+
+    int count = 0;
+
+    for(uint i = 0; i < system.CachedComponents.length(); ++i){
+
+        if(system.CachedComponents[i].ID == id)
+            ++count;
+    }
+
+    return count;
+}
+
+bool NodeUsesCurrentTimer(GameWorld@ world, ObjectID id){
+
+    CoolSystem@ system = cast<CoolSystem>(world.GetScriptSystem("CoolSystem"));
+
+    CoolTimer@ timer = cast<CoolTimer>(
+        world.GetScriptComponentHolder("CoolTimer").Find(id));
+
+    for(uint i = 0; i < system.CachedComponents.length(); ++i){
+
+        if(system.CachedComponents[i].ID == id)
+            return system.CachedComponents[i].First is timer;
+    }
+
+    return false;
+}
+
+void ClearCachedNodes(GameWorld@ world){
+
+    CoolSystem@ system = cast<CoolSystem>(world.GetScriptSystem("CoolSystem"));
+
+    system.Clear();
+}
+
+ObjectID CreateTimerEntity(GameWorld@ world){
+
+    ObjectID id = world.CreateEntity();
+    world.GetScriptComponentHolder("CoolTimer").Create(id);
+    cast<StandardWorld>(world).Create_Position(id, Float3(3, 0, 0),
+        Float4::IdentityQuaternion);
+    return id;
+}
+
+void RecreateTimer(GameWorld@ world, ObjectID id){
+
+    world.GetScriptComponentHolder("CoolTimer").Destroy(id);
+    world.GetScriptComponentHolder("CoolTimer").Create(id);
+}
+
+// Replaces the node of an entity with a node made by the script, without changing the size
+// of the array
+bool ReplaceNodeWithScriptNode(GameWorld@ world, ObjectID replaced){
+
+    CoolSystem@ system = cast<CoolSystem>(world.GetScriptSystem("CoolSystem"));
+
+    for(uint i = 0; i < system.CachedComponents.length(); ++i){
+
+        CoolSystemCached@ old = system.CachedComponents[i];
+
+        if(old.ID == replaced){
+
+            @system.CachedComponents[i] = CoolSystemCached(world.CreateEntity(), old.First,
+                old.Second);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Systems that are ran at the same time on different threads. They only modify their own
+// component type
+// When set the parallel systems also move and mark the Positions
+bool ParallelSystemsMarkPositions = false;
+
+class ParallelCoolSystem : ScriptSystem{
+
+    void Init(GameWorld@ world){
+
+        @World = cast<StandardWorld@>(world);
+    }
+
+    void Release(){
+
+    }
+
+    bool IsThreadSafe(){
+
+        return true;
+    }
+
+    void Run(){
+
+        for(uint i = 0; i < CachedComponents.length(); ++i){
+
+            CoolSystemCached@ cached = CachedComponents[i];
+
+            cached.First.TimeValue += int(cached.Second._Position.X);
+
+            if(ParallelSystemsMarkPositions && int(cached.Second._Position.X) % 2 == 0){
+
+                cached.Second._Position.Y += 1;
+                cached.Second.Marked = true;
+            }
+        }
+    }
+
+    void Clear(){
+
+        CachedComponents.resize(0);
+    }
+
+    void CreateAndDestroyNodes(){
+
+        ScriptSystemNodeHelper(World, @CachedComponents, SystemComponents);
+    }
+
+    private StandardWorld@ World;
+    private array<ScriptSystemUses> SystemComponents = {
+        ScriptSystemUses("CoolTimer"), ScriptSystemUses(Position::TYPE)
+    };
+
+    array<CoolSystemCached@> CachedComponents;
+};
+
+class ParallelSecondCached{
+
+    ParallelSecondCached(ObjectID id, SecondTimer@ first, Position@ second)
+    {
+        ID = id;
+        @First = first;
+        @Second = second;
+    }
+
+    ObjectID ID;
+    SecondTimer@ First;
+    Position@ Second;
+};
+
+class ParallelSecondSystem : ScriptSystem{
+
+    void Init(GameWorld@ world){
+
+        @World = cast<StandardWorld@>(world);
+    }
+
+    void Release(){
+
+    }
+
+    bool IsThreadSafe(){
+
+        return true;
+    }
+
+    void Run(){
+
+        for(uint i = 0; i < CachedComponents.length(); ++i){
+
+            ParallelSecondCached@ cached = CachedComponents[i];
+
+            cached.First.TimeValue += 2 * int(cached.Second._Position.X);
+
+            if(!ParallelSystemsMarkPositions)
+                continue;
+
+            const int x = int(cached.Second._Position.X);
+
+            if(x % 2 == 1){
+
+                cached.Second._Position.Z += 1;
+                cached.Second.Marked = true;
+
+            } else if(x % 3 == 0){
+
+                // The other system marks these at the same time
+                cached.Second.Marked = true;
+            }
+        }
+    }
+
+    void Clear(){
+
+        CachedComponents.resize(0);
+    }
+
+    void CreateAndDestroyNodes(){
+
+        ScriptSystemNodeHelper(World, @CachedComponents, SystemComponents);
+    }
+
+    private StandardWorld@ World;
+    private array<ScriptSystemUses> SystemComponents = {
+        ScriptSystemUses("SecondTimer"), ScriptSystemUses(Position::TYPE)
+    };
+
+    array<ParallelSecondCached@> CachedComponents;
+};
+
+bool SetupParallelSystems(GameWorld@ world){
+
+    world.RegisterScriptComponentType("CoolTimer", @CoolFactory);
+    world.RegisterScriptComponentType("SecondTimer", @SecondFactory);
+    world.RegisterScriptSystem("ParallelCoolSystem", ParallelCoolSystem());
+    world.RegisterScriptSystem("ParallelSecondSystem", ParallelSecondSystem());
+
+    StandardWorld@ asStandard = cast<StandardWorld>(world);
+
+    for(int i = 1; i <= 100; ++i){
+
+        ObjectID id = world.CreateEntity();
+
+        world.GetScriptComponentHolder("CoolTimer").Create(id);
+        world.GetScriptComponentHolder("SecondTimer").Create(id);
+        asStandard.Create_Position(id, Float3(i, 0, 0), Float4::IdentityQuaternion);
+    }
+
+    return true;
+}
+
+bool SetupParallelMarkingSystems(GameWorld@ world){
+
+    ParallelSystemsMarkPositions = true;
+    return SetupParallelSystems(world);
+}
+
+bool VerifyParallelRuns(GameWorld@ world, int ticks){
+
+    StandardWorld@ asStandard = cast<StandardWorld>(world);
+
+    auto index = world.GetScriptComponentHolder("CoolTimer").GetIndex();
+
+    if(index.length() != 100)
+        return false;
+
+    for(uint i = 0; i < index.length(); ++i){
+
+        CoolTimer@ first = cast<CoolTimer>(
+            world.GetScriptComponentHolder("CoolTimer").Find(index[i]));
+        SecondTimer@ second = cast<SecondTimer>(
+            world.GetScriptComponentHolder("SecondTimer").Find(index[i]));
+
+        const int x = int(asStandard.GetComponent_Position(index[i])._Position.X);
+
+        if(first.TimeValue != ticks * x || second.TimeValue != 2 * ticks * x)
+            return false;
+    }
+
+    return true;
+}
+
+// System that only uses C++ components
+class ReceivedPositionCached{
+
+    ReceivedPositionCached(ObjectID id, Received@ first, Position@ second)
+    {
+        ID = id;
+        @First = first;
+        @Second = second;
+    }
+
+    ObjectID ID;
+    Received@ First;
+    Position@ Second;
+};
+
+class ReceivedPositionSystem : ScriptSystem{
+
+    void Init(GameWorld@ world){
+
+        @World = cast<StandardWorld@>(world);
+    }
+
+    void Release(){
+
+    }
+
+    void Run(){
+
+    }
+
+    void Clear(){
+
+        CachedComponents.resize(0);
+    }
+
+    void CreateAndDestroyNodes(){
+
+        ScriptSystemNodeHelper(World, @CachedComponents, SystemComponents);
+    }
+
+    private StandardWorld@ World;
+    private array<ScriptSystemUses> SystemComponents = {
+        ScriptSystemUses(Received::TYPE), ScriptSystemUses(Position::TYPE)
+    };
+
+    array<ReceivedPositionCached@> CachedComponents;
+};
+
+bool SetupCppComponentSystem(GameWorld@ world){
+
+    world.RegisterScriptSystem("ReceivedPositionSystem", ReceivedPositionSystem());
+    return true;
+}
+
+ObjectID CreateCppComponentEntity(GameWorld@ world, float x){
+
+    StandardWorld@ asStandard = cast<StandardWorld>(world);
+
+    ObjectID id = world.CreateEntity();
+    asStandard.Create_Received(id);
+    asStandard.Create_Position(id, Float3(x, 0, 0), Float4::IdentityQuaternion);
+    return id;
+}
+
+uint GetCppComponentNodeCount(GameWorld@ world){
+
+    return cast<ReceivedPositionSystem>(
+        world.GetScriptSystem("ReceivedPositionSystem")).CachedComponents.length();
+}
+
+// Returns the number of nodes for id, -1 if a node doesn't use the current components
+int CountCppComponentNodes(GameWorld@ world, ObjectID id){
+
+    StandardWorld@ asStandard = cast<StandardWorld>(world);
+    ReceivedPositionSystem@ system = cast<ReceivedPositionSystem>(
+        world.GetScriptSystem("ReceivedPositionSystem"));
+
+    int count = 0;
+
+    for(uint i = 0; i < system.CachedComponents.length(); ++i){
+
+        ReceivedPositionCached@ cached = system.CachedComponents[i];
+
+        if(cached.ID != id)
+            continue;
+
+        if(!(cached.First is asStandard.GetComponent_Received(id)) ||
+            !(cached.Second is asStandard.GetComponent_Position(id)))
+            return -1;
+
+        ++count;
+    }
+
+    return count;
+}
+
+enum SAVED_MODE {
+    SAVED_MODE_NONE,
+    SAVED_MODE_FAST
+}
+
+class SavedState : ScriptComponent{
+
+    string Name;
+    float Speed = 0;
+    bool Enabled = false;
+    SAVED_MODE Mode = SAVED_MODE_NONE;
+    Float3 Target = Float3(0, 0, 0);
+
+    // Handles aren't saved in world snapshots
+    CoolTimer@ Timer;
+};
+
+ScriptComponent@ SavedStateFactory(GameWorld@ world){
+
+    return SavedState();
+}
+
+bool RegisterSnapshotComponents(GameWorld@ world){
+
+    return world.RegisterScriptComponentType("CoolTimer", @CoolFactory) &&
+        world.RegisterScriptComponentType("SavedState", @SavedStateFactory);
+}
+
+ObjectID CreateSavedStateEntity(GameWorld@ world){
+
+    ObjectID id = world.CreateEntity();
+
+    CoolTimer@ timer = cast<CoolTimer>(
+        world.GetScriptComponentHolder("CoolTimer").Create(id));
+    timer.TimeValue = 42;
+
+    SavedState@ state = cast<SavedState>(
+        world.GetScriptComponentHolder("SavedState").Create(id));
+    state.Name = "saved";
+    state.Speed = 2.5f;
+    state.Enabled = true;
+    state.Mode = SAVED_MODE_FAST;
+    state.Target = Float3(1, 2, 3);
+    @state.Timer = timer;
+
+    cast<StandardWorld>(world).Create_Position(id, Float3(1, 0, 0),
+        Float4::IdentityQuaternion);
+    return id;
+}
+
+bool VerifySavedState(GameWorld@ world, ObjectID id){
+
+    CoolTimer@ timer = cast<CoolTimer>(
+        world.GetScriptComponentHolder("CoolTimer").Find(id));
+    SavedState@ state = cast<SavedState>(
+        world.GetScriptComponentHolder("SavedState").Find(id));
+
+    if(timer is null || state is null)
+        return false;
+
+    return timer.TimeValue == 42 && state.Name == "saved" && state.Speed == 2.5f &&
+        state.Enabled && state.Mode == SAVED_MODE_FAST && state.Target.X == 1 &&
+        state.Target.Y == 2 && state.Target.Z == 3 && state.Timer is null;
+}
+
+
+// Systems whose node factories don't match the used components. Nodes must not be created
+// for these
+class MismatchedScriptCached{
+
+    MismatchedScriptCached(ObjectID id, SecondTimer@ first, Position@ second)
+    {
+        ID = id;
+    }
+
+    ObjectID ID;
+};
+
+class MismatchedCppCached{
+
+    MismatchedCppCached(ObjectID id, CoolTimer@ first, Received@ second)
+    {
+        ID = id;
+    }
+
+    ObjectID ID;
+};
+
+class MismatchedScriptSystem : ScriptSystem{
+
+    void Init(GameWorld@ world){
+
+        @World = cast<StandardWorld@>(world);
+    }
+
+    void Release(){
+
+    }
+
+    void Run(){
+
+    }
+
+    void Clear(){
+
+        CachedComponents.resize(0);
+    }
+
+    void CreateAndDestroyNodes(){
+
+        ScriptSystemNodeHelper(World, @CachedComponents, SystemComponents);
+    }
+
+    private StandardWorld@ World;
+    private array<ScriptSystemUses> SystemComponents = {
+        ScriptSystemUses("CoolTimer"), ScriptSystemUses(Position::TYPE)
+    };
+
+    array<MismatchedScriptCached@> CachedComponents;
+};
+
+class MismatchedCppSystem : ScriptSystem{
+
+    void Init(GameWorld@ world){
+
+        @World = cast<StandardWorld@>(world);
+    }
+
+    void Release(){
+
+    }
+
+    void Run(){
+
+    }
+
+    void Clear(){
+
+        CachedComponents.resize(0);
+    }
+
+    void CreateAndDestroyNodes(){
+
+        ScriptSystemNodeHelper(World, @CachedComponents, SystemComponents);
+    }
+
+    private StandardWorld@ World;
+    private array<ScriptSystemUses> SystemComponents = {
+        ScriptSystemUses("CoolTimer"), ScriptSystemUses(Position::TYPE)
+    };
+
+    array<MismatchedCppCached@> CachedComponents;
+};
+
+bool SetupMismatchedSystem(GameWorld@ world, bool scriptParameter){
+
+    world.RegisterScriptComponentType("CoolTimer", @CoolFactory);
+    world.RegisterScriptComponentType("SecondTimer", @SecondFactory);
+
+    if(scriptParameter){
+        world.RegisterScriptSystem("MismatchedSystem", MismatchedScriptSystem());
+    } else {
+        world.RegisterScriptSystem("MismatchedSystem", MismatchedCppSystem());
+    }
+
+    CreateTimerEntity(world);
+    return true;
+}
+
+uint GetMismatchedNodeCount(GameWorld@ world, bool scriptParameter){
+
+    if(scriptParameter){
+        return cast<MismatchedScriptSystem>(world.GetScriptSystem(
+            "MismatchedSystem")).CachedComponents.length();
+    }
+
+    return cast<MismatchedCppSystem>(world.GetScriptSystem(
+        "MismatchedSystem")).CachedComponents.length();
+}
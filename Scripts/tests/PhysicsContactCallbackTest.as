@@ -0,0 +1,40 @@
+// Contact callbacks for the physics tests. The first callback replaces itself while running
+int FirstContacts = 0;
+int SecondContacts = 0;
+
+void FirstContact(PhysicalWorld@ world, PhysicsBody@ body1, PhysicsBody@ body2)
+{
+    ++FirstContacts;
+
+    // Contacts after this one are given to SecondContact
+    world.SetContactCallback(1, 2, @SecondContact);
+}
+
+void SecondContact(PhysicalWorld@ world, PhysicsBody@ body1, PhysicsBody@ body2)
+{
+    ++SecondContacts;
+}
+
+bool SetupContactCallback(PhysicalWorld@ world)
+{
+    FirstContacts = 0;
+    SecondContacts = 0;
+
+    // Materials are given in the opposite order on purpose
+    return world.SetContactCallback(2, 1, @FirstContact);
+}
+
+bool RemoveContactCallback(PhysicalWorld@ world)
+{
+    return world.SetContactCallback(1, 2, null);
+}
+
+int GetFirstContacts()
+{
+    return FirstContacts;
+}
+
+int GetSecondContacts()
+{
+    return SecondContacts;
+}